@@ -23,6 +23,11 @@
 
 namespace ccvt {
 
+  /* A metric gives the distance between two points, its square and the
+     centroid of the points of a site near its center. period(i) is the period
+     of the space in the dimension i, 0 if it does not wrap around; the grid of
+     the optimizer uses it to wrap its cells. */
+
   struct MetricEuclidean2 {
 
     inline double distance(const Point2& p1, const Point2& p2) const {
@@ -45,6 +50,10 @@ namespace ccvt {
       return centroid;
     }
 
+    inline double period(const int) const {
+      return 0;
+    }
+
   };
 
   struct MetricEuclidean3 {
@@ -71,6 +80,10 @@ namespace ccvt {
       return centroid;
     }
 
+    inline double period(const int) const {
+      return 0;
+    }
+
   };
 
   template<class Point>
@@ -102,6 +115,10 @@ namespace ccvt {
       return centroid;
     }
 
+    inline double period(const int) const {
+      return 0;
+    }
+
   };
 
   struct MetricToroidalEuclidean2 {
@@ -179,6 +196,10 @@ namespace ccvt {
       return centroid;
     }
 
+    inline double period(const int i) const {
+      return size[i];
+    }
+
   };
 
   struct MetricToroidalEuclidean3 {
@@ -281,6 +302,10 @@ namespace ccvt {
       return centroid;
     }
 
+    inline double period(const int i) const {
+      return size[i];
+    }
+
   };
 
   template<class Point>
@@ -346,6 +371,10 @@ namespace ccvt {
       return centroid;
     }
 
+    inline double period(const int i) const {
+      return size[i];
+    }
+
   };
 
 }
@@ -22,6 +22,8 @@
 #include <assert.h>
 #include <limits>
 #include <map>
+#include <math.h>
+#include <vector>
 
 namespace ccvt {
 
@@ -30,89 +32,111 @@ namespace ccvt {
 
   private:
 
+    // the number of sites whose pairs are computed at the same time in the parallel pass
+    static const int PARALLEL_GROUP_SIZE = 256;
+
+    struct Bounding;
     struct Entry;
 
+    // runs the function for each index in the thread that calls it
+    struct SequentialFor {
+
+      template<class Function>
+      void operator()(const int count, Function function) const {
+        for (int k = 0; k < count; ++k) {
+          function(k);
+        }
+      }
+
+    };
+
     /* The initialization of the optimizer uses a kd-tree to initially assign
        the points to the sites. A faster method is to use the ordinary Voronoi
        tessellation for that matter. However, the kd-tree is used because it 
-       can easily be implemented for the n-dimensional case. */
+       can easily be implemented for the n-dimensional case.
+       The tree is implicit: the nodes are in arrays, the children of the node n
+       are 2n+1 and 2n+2, so it is built without allocating each node. The
+       search of the nearest site does not modify the tree, so it can be done
+       from several threads while the sites are not disabled. */
     class KdTree {
 
     public:
 
       KdTree(std::vector<Entry> &entries, const Metric& metric, const int dimensions)
-        : dimensions_(dimensions), root_(NULL), metric_(metric), lastNearestNeighborNode_(NULL) {
+        : dimensions_(dimensions), metric_(metric), lastNearestNeighborNode_(-1) {
         if (!entries.empty()) {
           std::vector<Entry*> entriesPtr(entries.size());
           for (int i = 0; i < static_cast<int>(entriesPtr.size()); ++i) {
             entriesPtr[i] = &entries[i];
           }
-          build(root_, entriesPtr, 0, static_cast<int>(entriesPtr.size() - 1), 0);
-        }
-      }
-      
-      ~KdTree() {
-        if (root_ != NULL) {
-          delete root_;
+          // the depth is the one of a complete tree with the next power of 2 leaves
+          int nodesSize = 2;
+          while (nodesSize < 2 * static_cast<int>(entries.size())) {
+            nodesSize *= 2;
+          }
+          median_.resize(nodesSize, 0);
+          entry_.resize(nodesSize, static_cast<Entry*>(NULL));
+          location_.resize(nodesSize);
+          disabled_.resize(nodesSize, 1);
+          build(0, entriesPtr, 0, static_cast<int>(entriesPtr.size() - 1), 0);
         }
       }
 
       bool empty() {
-        return root_ == NULL || root_->disabled;
+        return disabled_.empty() || disabled_[0];
       }
 
-      Entry* nearest_neighbor(const Point& point) {
-        if (root_ == NULL || root_->disabled) {
-          return NULL;
+      // the node of the nearest enabled site, -1 if all of them are disabled
+      int nearest_node(const Point& point) const {
+        if (disabled_.empty() || disabled_[0]) {
+          return -1;
         }
         double minDistance = std::numeric_limits<double>::max();
-        NearestNeighborResult result = nearest_neighbor(root_, point, 0, minDistance);      
-        lastNearestNeighborNode_ = result.first;
-        return result.second;
+        return nearest_neighbor(0, point, 0, minDistance);
       }
 
-      void disable_last_nearest_neighbor_node() {
-        if (lastNearestNeighborNode_ != NULL) {
-          lastNearestNeighborNode_->disabled = true;
-          Node* parentNode = lastNearestNeighborNode_->parent;
-          while (parentNode != NULL && parentNode->left->disabled && parentNode->right->disabled) {
-              parentNode->disabled = true;
-              parentNode = parentNode->parent;
-          }
-          lastNearestNeighborNode_ = NULL;
-        }
+      inline int size() const {
+        return static_cast<int>(entry_.size());
       }
 
-    private:
-
-      KdTree(const KdTree& kdTree);
-      KdTree& operator=(const KdTree& kdTree);
+      inline Entry* entry(const int node) const {
+        return entry_[node];
+      }
 
-      struct Node {
+      inline bool disabled(const int node) const {
+        return disabled_[node] != 0;
+      }
 
-        Node()
-          : median(0), left(NULL), right(NULL), entry(NULL), parent(NULL), disabled(false) {
+      Entry* nearest_neighbor(const Point& point) {
+        lastNearestNeighborNode_ = nearest_node(point);
+        if (lastNearestNeighborNode_ < 0) {
+          return NULL;
         }
+        return entry_[lastNearestNeighborNode_];
+      }
 
-        ~Node() {
-          if (left != NULL) {
-            delete left;
-          }
-          if (right != NULL) {
-            delete right;
+      void disable(int node) {
+        disabled_[node] = 1;
+        while (node > 0) {
+          node = (node - 1) / 2;
+          if (!disabled_[2 * node + 1] || !disabled_[2 * node + 2]) {
+            break;
           }
+          disabled_[node] = 1;
         }
+      }
 
-        double      median;
-        Node*       left;
-        Node*       right;
-        Entry*      entry;
-        Node*       parent;
-        bool        disabled;
+      void disable_last_nearest_neighbor_node() {
+        if (lastNearestNeighborNode_ >= 0) {
+          disable(lastNearestNeighborNode_);
+          lastNearestNeighborNode_ = -1;
+        }
+      }
 
-      };
+    private:
 
-      typedef std::pair<Node*, Entry*> NearestNeighborResult;
+      KdTree(const KdTree& kdTree);
+      KdTree& operator=(const KdTree& kdTree);
 
       struct Less {
         
@@ -128,50 +152,53 @@ namespace ccvt {
 
       };
 
-      void build(Node*& node, std::vector<Entry*>& entries, const int min, const int max, const int depth) {
-        node = new Node();      
+      void build(const int node, std::vector<Entry*>& entries, const int min, const int max, const int depth) {
+        disabled_[node] = 0;
         if (min == max) {
-          node->entry = entries[min];
+          entry_[node] = entries[min];
+          location_[node] = entries[min]->site->location;
           return;
         }
-        std::sort(entries.begin() + min, entries.begin() + max + 1, Less(depth % dimensions_));
+        // only the median is needed, so the entries are partitioned instead of sorted
+        int dimension = depth % dimensions_;
         int medianIndex = (min + max) / 2;
-        node->median = (entries[medianIndex]->site->location[depth % dimensions_] + entries[medianIndex + 1]->site->location[depth % dimensions_]) / 2;
-        build(node->left, entries, min, medianIndex, depth + 1);
-        build(node->right, entries, medianIndex + 1, max, depth + 1);
-        node->left->parent = node;
-        node->right->parent = node;
+        std::nth_element(entries.begin() + min, entries.begin() + medianIndex, entries.begin() + max + 1, Less(dimension));
+        Entry* next = *std::min_element(entries.begin() + medianIndex + 1, entries.begin() + max + 1, Less(dimension));
+        median_[node] = (entries[medianIndex]->site->location[dimension] + next->site->location[dimension]) / 2;
+        build(2 * node + 1, entries, min, medianIndex, depth + 1);
+        build(2 * node + 2, entries, medianIndex + 1, max, depth + 1);
       }
 
-      NearestNeighborResult nearest_neighbor(Node* node, const Point& point, const int depth, double& minDistance) {
-        if (node->disabled) {
-          return NearestNeighborResult(NULL, NULL);
+      int nearest_neighbor(const int node, const Point& point, const int depth, double& minDistance) const {
+        if (disabled_[node]) {
+          return -1;
         }
 
-        if (node->entry != NULL) {
-          minDistance = metric_.distance(point, node->entry->site->location);
-          return NearestNeighborResult(node, node->entry);
+        if (entry_[node] != NULL) {
+          // the squared distances are compared, without the square roots
+          minDistance = metric_.distance_square(point, location_[node]);
+          return node;
         }
 
-        Node* child;
+        int child;
         double otherDistance;
-        if (point[depth % dimensions_] <= node->median) {
-          child = node->left;
-          otherDistance = node->median - point[depth % dimensions_];
+        if (point[depth % dimensions_] <= median_[node]) {
+          child = 2 * node + 1;
+          otherDistance = median_[node] - point[depth % dimensions_];
         } else {
-          child = node->right;
-          otherDistance = point[depth % dimensions_] - node->median;
+          child = 2 * node + 2;
+          otherDistance = point[depth % dimensions_] - median_[node];
         }
 
-        NearestNeighborResult result = nearest_neighbor(child, point, depth + 1, minDistance);
+        int result = nearest_neighbor(child, point, depth + 1, minDistance);
 
-        if (minDistance > otherDistance) {
+        if (minDistance > otherDistance * otherDistance) {
           double newMinDistance = minDistance;
-          Node* otherChild = node->left;
+          int otherChild = 2 * node + 1;
           if (otherChild == child) {
-            otherChild = node->right;
+            otherChild = 2 * node + 2;
           }
-          NearestNeighborResult newResult = nearest_neighbor(otherChild, point, depth + 1, newMinDistance);
+          int newResult = nearest_neighbor(otherChild, point, depth + 1, newMinDistance);
           if (newMinDistance < minDistance) {
             result = newResult;
             minDistance = newMinDistance;
@@ -181,10 +208,199 @@ namespace ccvt {
         return result;
       }
 
-      const int     dimensions_;
-      Node*         root_;
-      const Metric& metric_;
-      Node*         lastNearestNeighborNode_;
+      const int             dimensions_;
+      const Metric&         metric_;
+      std::vector<double>   median_;
+      std::vector<Entry*>   entry_;
+      // the locations of the sites of the leaves, next to each other for the search
+      std::vector<Point>    location_;
+      std::vector<char>     disabled_;
+      int                   lastNearestNeighborNode_;
+
+    };
+
+    /* The pairs of sites that can exchange points are the sites whose bounding
+       spheres overlap. They are found with a uniform grid: each site is stored in
+       the cells covered by the bounding box of its sphere, so two sites are only
+       tested if they share a cell. The size of the cells is about the diameter
+       of the spheres, so each site is in a few cells and the cost is linear with
+       the number of sites. The grid wraps around in the dimensions with a period
+       (toroidal metrics), and the cells are clamped to the border in the other
+       ones, so no overlapping pair is lost. */
+    class Grid {
+
+    public:
+
+      Grid()
+        : numCells_(0), currentMark_(0) {
+      }
+
+      void build(const std::vector<Entry>& entries, const Metric& metric) {
+        int entriesSize = static_cast<int>(entries.size());
+        double sumRadius = 0;
+        double minCoordinate[Point::D];
+        double maxCoordinate[Point::D];
+        for (int d = 0; d < Point::D; ++d) {
+          minCoordinate[d] = std::numeric_limits<double>::max();
+          maxCoordinate[d] = -std::numeric_limits<double>::max();
+        }
+        for (int i = 0; i < entriesSize; ++i) {
+          const Bounding& bounding = entries[i].bounding;
+          sumRadius += bounding.radius;
+          for (int d = 0; d < Point::D; ++d) {
+            minCoordinate[d] = std::min(minCoordinate[d], bounding.center[d] - bounding.radius);
+            maxCoordinate[d] = std::max(maxCoordinate[d], bounding.center[d] + bounding.radius);
+          }
+        }
+
+        double extent[Point::D];
+        for (int d = 0; d < Point::D; ++d) {
+          period_[d] = metric.period(d);
+          if (period_[d] > 0) {
+            origin_[d] = 0;
+            extent[d] = period_[d];
+          } else {
+            origin_[d] = entriesSize > 0 ? minCoordinate[d] : 0;
+            extent[d] = entriesSize > 0 ? std::max(maxCoordinate[d] - minCoordinate[d], 0.0) : 0;
+          }
+        }
+
+        // the cells are enlarged until there are not many more cells than sites
+        double cellSize = entriesSize > 0 ? 2 * sumRadius / entriesSize : 0;
+        if (cellSize <= 0) {
+          cellSize = 1;
+          for (int d = 0; d < Point::D; ++d) {
+            cellSize = std::max(cellSize, extent[d]);
+          }
+        }
+        double maxCells = 4.0 * entriesSize + 1;
+        double cells;
+        do {
+          cells = 1;
+          for (int d = 0; d < Point::D; ++d) {
+            dimensions_[d] = std::max(1, static_cast<int>(std::min(extent[d] / cellSize, maxCells)));
+            cellSize_[d] = extent[d] > 0 ? extent[d] / dimensions_[d] : 1;
+            cells *= dimensions_[d];
+          }
+          cellSize *= 1.5;
+        } while (cells > maxCells);
+
+        numCells_ = static_cast<int>(cells);
+        cells_.resize(numCells_);
+        for (int c = 0; c < numCells_; ++c) {
+          cells_[c].clear();
+        }
+        entryCells_.resize(entriesSize);
+        marks_.assign(entriesSize, 0);
+        currentMark_ = 0;
+        for (int i = 0; i < entriesSize; ++i) {
+          entryCells_[i].clear();
+          insert(i, entries[i].bounding);
+        }
+      }
+
+      // the site has been moved or its sphere has changed
+      void update(const int index, const Bounding& bounding) {
+        std::vector<int>& entryCells = entryCells_[index];
+        int entryCellsSize = static_cast<int>(entryCells.size());
+        for (int k = 0; k < entryCellsSize; ++k) {
+          std::vector<int>& cell = cells_[entryCells[k]];
+          typename std::vector<int>::iterator it = std::find(cell.begin(), cell.end(), index);
+          if (it != cell.end()) {
+            *it = cell.back();
+            cell.pop_back();
+          }
+        }
+        entryCells.clear();
+        insert(index, bounding);
+      }
+
+      // the sites with a greater index than the site that share a cell with it, sorted
+      void neighbors(const int index, std::vector<int>& result) {
+        result.clear();
+        if (++currentMark_ == 0) {
+          std::fill(marks_.begin(), marks_.end(), 0);
+          currentMark_ = 1;
+        }
+        const std::vector<int>& entryCells = entryCells_[index];
+        int entryCellsSize = static_cast<int>(entryCells.size());
+        for (int k = 0; k < entryCellsSize; ++k) {
+          const std::vector<int>& cell = cells_[entryCells[k]];
+          int cellSize = static_cast<int>(cell.size());
+          for (int n = 0; n < cellSize; ++n) {
+            int other = cell[n];
+            if (other > index && marks_[other] != currentMark_) {
+              marks_[other] = currentMark_;
+              result.push_back(other);
+            }
+          }
+        }
+        std::sort(result.begin(), result.end());
+      }
+
+    private:
+
+      void insert(const int index, const Bounding& bounding) {
+        int first[Point::D];
+        int count[Point::D];
+        for (int d = 0; d < Point::D; ++d) {
+          double low = (bounding.center[d] - bounding.radius - origin_[d]) / cellSize_[d];
+          double high = (bounding.center[d] + bounding.radius - origin_[d]) / cellSize_[d];
+          if (period_[d] > 0) {
+            if (high - low >= dimensions_[d]) {
+              first[d] = 0;
+              count[d] = dimensions_[d];
+            } else {
+              first[d] = static_cast<int>(floor(low));
+              count[d] = std::min(static_cast<int>(floor(high)) - first[d] + 1, dimensions_[d]);
+            }
+          } else {
+            first[d] = std::min(std::max(static_cast<int>(floor(low)), 0), dimensions_[d] - 1);
+            int last = std::min(std::max(static_cast<int>(floor(high)), 0), dimensions_[d] - 1);
+            count[d] = last - first[d] + 1;
+          }
+        }
+
+        // all the cells of the box, like an odometer
+        int offset[Point::D];
+        for (int d = 0; d < Point::D; ++d) {
+          offset[d] = 0;
+        }
+        while (true) {
+          int cell = 0;
+          for (int d = Point::D - 1; d >= 0; --d) {
+            int position = first[d] + offset[d];
+            if (period_[d] > 0) {
+              position %= dimensions_[d];
+              if (position < 0) {
+                position += dimensions_[d];
+              }
+            }
+            cell = cell * dimensions_[d] + position;
+          }
+          cells_[cell].push_back(index);
+          entryCells_[index].push_back(cell);
+
+          int d = 0;
+          while (d < Point::D && ++offset[d] == count[d]) {
+            offset[d] = 0;
+            ++d;
+          }
+          if (d == Point::D) {
+            break;
+          }
+        }
+      }
+
+      double                          origin_[Point::D];
+      double                          period_[Point::D];
+      double                          cellSize_[Point::D];
+      int                             dimensions_[Point::D];
+      int                             numCells_;
+      std::vector<std::vector<int> >  cells_;
+      std::vector<std::vector<int> >  entryCells_;
+      std::vector<unsigned int>       marks_;
+      unsigned int                    currentMark_;
 
     };
 
@@ -201,143 +417,208 @@ namespace ccvt {
     }
 
     void initialize(typename std::list<Site>& sites, typename std::list<Point>& points, const Metric& metric) {
+      std::vector<Point> pointsVector(points.begin(), points.end());
+      points.clear();
+      initialize(sites, pointsVector, metric);
+    }
+
+    void initialize(typename std::list<Site>& sites, typename std::vector<Point>& points, const Metric& metric) {
+      initialize(sites, points, metric, SequentialFor());
+    }
+
+    /* The points are assigned from the last one to the first one, each one to
+       the nearest site that is not full. The nearest sites are first searched
+       with parallelFor(count, function) as if no site was full, and only the
+       points whose site is full when they are assigned are searched again, so
+       the result does not depend on the number of threads. The memory of the
+       points is freed. */
+    template<class ParallelFor>
+    void initialize(typename std::list<Site>& sites, typename std::vector<Point>& points, const Metric& metric, ParallelFor parallelFor) {
       clear();
 
       metric_ = metric;
 
-      int sitesSize = static_cast<int>(sites.size());
-      sites_.reserve(sitesSize);
-      entries_.reserve(sitesSize);
-      int sumCapacities = 0;
-      for (int i = 0; i < sitesSize; ++i) {
-        Site& site = sites.front();
-        sumCapacities += site.capacity;
-        if (site.capacity > 0) {
-          sites_.push_back(site);
-          entries_.push_back(Entry(&sites_.back()));
-          mapping_.insert(std::make_pair(site.id, &entries_.back()));
-        }
-        sites.pop_front();
-      }
-      assert(sumCapacities == points.size()); // the sum of the site capacities must be equal to the number of points
-      sites_.resize(sites_.size());
-      entries_.resize(entries_.size());
+      int sumCapacities = add_sites(sites, NULL);
+      int pointsSize = static_cast<int>(points.size());
+      assert(sumCapacities == pointsSize); // the sum of the site capacities must be equal to the number of points
 
       KdTree kdTree(entries_, metric_, Point::D);
-      while (!points.empty() && !kdTree.empty()) {
-        const Point& point = points.back();
-        Entry* entry = kdTree.nearest_neighbor(point);
-        entry->points.push_back(point);
+      std::vector<int> nearestNodes(pointsSize);
+      parallelFor(pointsSize, [&](int k) {
+        nearestNodes[k] = kdTree.nearest_node(points[k]);
+      });
+      for (int k = pointsSize - 1; k >= 0 && !kdTree.empty(); --k) {
+        int node = nearestNodes[k];
+        if (kdTree.disabled(node)) {
+          node = kdTree.nearest_node(points[k]);
+        }
+        Entry* entry = kdTree.entry(node);
+        entry->points.push_back(points[k]);
         if (static_cast<int>(entry->points.size()) == entry->site->capacity) {
-          entry->points.resize(entry->points.size());
-          kdTree.disable_last_nearest_neighbor_node();
+          kdTree.disable(node);
         }
-        points.pop_back();
       }
+      std::vector<int>().swap(nearestNodes);
+      std::vector<Point>().swap(points);
 
-      for (unsigned int i = 0; i < entries_.size(); ++i) {
-        entries_[i].energy = 0;
-        int pointsSize = static_cast<int>(entries_[i].points.size());
-        for (int j = 0; j < pointsSize; ++j) {
-          entries_[i].energy += energy(entries_[i].points[j], entries_[i].site);
+      update_entries(parallelFor);
+    }
+
+    /* The points are first assigned to the given sites: owners[k] is the
+       position in the list of the site of the point k, or -1. The points
+       without a site, or whose site is full, are then assigned to the nearest
+       site that is not full, as in the other initialization. So a solution of
+       a coarser level can be refined. The memory of the points is freed. */
+    template<class ParallelFor>
+    void initialize(typename std::list<Site>& sites, typename std::vector<Point>& points, const std::vector<int>& owners, const Metric& metric, ParallelFor parallelFor) {
+      clear();
+
+      metric_ = metric;
+
+      std::vector<int> entryIndices;
+      int sumCapacities = add_sites(sites, &entryIndices);
+      int pointsSize = static_cast<int>(points.size());
+      assert(sumCapacities == pointsSize); // the sum of the site capacities must be equal to the number of points
+      assert(static_cast<int>(owners.size()) == pointsSize);
+
+      std::vector<int> remaining;
+      int entryIndicesSize = static_cast<int>(entryIndices.size());
+      for (int k = pointsSize - 1; k >= 0; --k) {
+        int owner = owners[k];
+        if (owner >= 0 && owner < entryIndicesSize && entryIndices[owner] >= 0) {
+          Entry& entry = entries_[entryIndices[owner]];
+          if (static_cast<int>(entry.points.size()) < entry.site->capacity) {
+            entry.points.push_back(points[k]);
+            continue;
+          }
         }
-        entries_[i].update(metric_);
+        remaining.push_back(k);
       }
+
+      KdTree kdTree(entries_, metric_, Point::D);
+      for (int node = 0; node < kdTree.size(); ++node) {
+        Entry* entry = kdTree.entry(node);
+        if (entry != NULL && !kdTree.disabled(node) && static_cast<int>(entry->points.size()) == entry->site->capacity) {
+          kdTree.disable(node);
+        }
+      }
+      int remainingSize = static_cast<int>(remaining.size());
+      for (int r = 0; r < remainingSize && !kdTree.empty(); ++r) {
+        int node = kdTree.nearest_node(points[remaining[r]]);
+        Entry* entry = kdTree.entry(node);
+        entry->points.push_back(points[remaining[r]]);
+        if (static_cast<int>(entry->points.size()) == entry->site->capacity) {
+          kdTree.disable(node);
+        }
+      }
+      std::vector<int>().swap(remaining);
+      std::vector<Point>().swap(points);
+
+      update_entries(parallelFor);
     }
 
     bool optimize(const bool centroidalize,int &Count_falses) {
       int entriesSize = static_cast<int>(entries_.size());
       std::vector<bool> stability(entriesSize, true);
+      grid_.build(entries_, metric_);
+      std::vector<int> neighbors;
       for (int i = 0; i < entriesSize; ++i) {
-        for (int j = i + 1; j < entriesSize; ++j) {
-          Entry* entry1 = &entries_[i];
-          Entry* entry2 = &entries_[j];
-          
-          if (entry1->stable && entry2->stable ||
-              metric_.distance(entry1->bounding.center, entry2->bounding.center) > entry1->bounding.radius + entry2->bounding.radius) {
-            continue;
-          }
-
-          if (entry1->points.size() > entry2->points.size()) {
-            std::swap(entry1, entry2);
+        grid_.neighbors(i, neighbors);
+        int neighborsSize = static_cast<int>(neighbors.size());
+        for (int n = 0; n < neighborsSize; ++n) {
+          int j = neighbors[n];
+          if (exchange(i, j, centroidalize)) {
+            stability[i] = false;
+            stability[j] = false;
+            grid_.update(i, entries_[i].bounding);
+            grid_.update(j, entries_[j].bounding);
           }
+        }
+      }
 
-          Site* site1 = entry1->site;
-          Site* site2 = entry2->site;
-          std::vector<Point>* points1 = &entry1->points;
-          std::vector<Point>* points2 = &entry2->points;
-
-          double maxSquaredRadius = std::max(entry1->bounding.squaredRadius, entry2->bounding.squaredRadius);
+      bool stable = true;
+      for (int i = 0; i < entriesSize; ++i) {
+        entries_[i].stable = stability[i];
+        stable &= stability[i];
+        // code for doing UI
+        if (stability[i]==false) Count_falses++;
+      }
+      return stable;
+    }
 
-          typename Candidate::Vector candidates1(points1->size());
-          int size = static_cast<int>(points1->size());
-          int count = 0;
-          for (int k = 0; k < size; ++k) {
-            Point& point = (*points1)[k];
-            if (metric_.distance_square(point, entry2->bounding.center) <= maxSquaredRadius) {
-              candidates1[count++] = Candidate(&point, energy(point, site1), energy(point, site2));
-            }
-          }
-          if (count == 0) {
-            continue;
-          }
-          candidates1.resize(count);
-          std::make_heap(candidates1.begin(), candidates1.end());
-
-          double minEnergy = -(candidates1.front().energySelf - candidates1.front().energyOther);
-          typename Candidate::Vector candidates2(points2->size());
-          size = static_cast<int>(points2->size());
-          count = 0;
-          for (int k = 0; k < size; ++k) {
-            Point& point = (*points2)[k];
-            if (metric_.distance_square(point, entry1->bounding.center) <= maxSquaredRadius) {
-              double eSelf = energy(point, site2);
-              double eOther = energy(point, site1);
-              if (eSelf - eOther > minEnergy) {
-                candidates2[count++] = Candidate(&point, eSelf, eOther);
+    /* The same pass in parallel. The sites are taken in groups of
+       PARALLEL_GROUP_SIZE in their order, and the pairs of sites of each group
+       that share a cell of the grid are divided in batches where each site
+       appears once at most (a greedy edge coloring of the graph of neighbors),
+       so the pairs of a batch are independent. The overlap and the stability
+       are tested when the pair is run, as in the sequential pass. Each pair goes to the batch after the previous pairs of
+       its two sites, so the pairs of each site are run in the same order as in
+       the sequential pass. The batches are run one after the other, and the
+       pairs of each batch are run with parallelFor(count, function), that must
+       call function(k) for each k of [0, count) and wait until all of them
+       finish. The groups and the batches do not depend on the number of
+       threads, so the result is the same one with any number of threads. */
+    template<class ParallelFor>
+    bool optimize(const bool centroidalize, int &Count_falses, ParallelFor parallelFor) {
+      int entriesSize = static_cast<int>(entries_.size());
+      // a vector<bool> cannot be written from several threads
+      std::vector<char> stability(entriesSize, 1);
+      grid_.build(entries_, metric_);
+
+      std::vector<std::vector<std::pair<int, int> > > batches;
+      std::vector<char> exchanged;
+      std::vector<int> nextBatch(entriesSize, 0);
+      std::vector<int> neighbors;
+      for (int first = 0; first < entriesSize; first += PARALLEL_GROUP_SIZE) {
+        int last = std::min(first + PARALLEL_GROUP_SIZE, entriesSize);
+        int batchesSize = 0;
+        for (int i = first; i < last; ++i) {
+          grid_.neighbors(i, neighbors);
+          int neighborsSize = static_cast<int>(neighbors.size());
+          for (int n = 0; n < neighborsSize; ++n) {
+            int j = neighbors[n];
+            // the first batch after the previous pairs of i and j
+            int batch = std::max(nextBatch[i], nextBatch[j]);
+            nextBatch[i] = batch + 1;
+            nextBatch[j] = batch + 1;
+            if (batch == batchesSize) {
+              if (batchesSize == static_cast<int>(batches.size())) {
+                batches.push_back(std::vector<std::pair<int, int> >());
               }
+              batches[batchesSize++].clear();
             }
+            batches[batch].push_back(std::make_pair(i, j));
           }
-          if (count == 0) {
-            continue;
-          }
-          candidates2.resize(count);
-          std::make_heap(candidates2.begin(), candidates2.end());
-
-          int maxSwaps = static_cast<int>(std::min(candidates1.size(), candidates2.size()));
-          int swaps;
-          for (swaps = 0; swaps < maxSwaps; ++swaps) {
-            Candidate& candidate1 = candidates1.front();
-            Candidate& candidate2 = candidates2.front();
-            if (candidate1.energySelf - candidate1.energyOther + candidate2.energySelf - candidate2.energyOther <= 0) {
-              break;
-            }
-            std::swap(*candidate1.point, *candidate2.point);
-            entry1->energy += candidate2.energyOther - candidate1.energySelf;
-            entry2->energy += candidate1.energyOther - candidate2.energySelf;
-            std::pop_heap(candidates1.begin(), candidates1.end() - swaps);
-            std::pop_heap(candidates2.begin(), candidates2.end() - swaps);
-          }
+        }
 
-          if (swaps > 0) {
-            stability[i] = false;
-            stability[j] = false;
-            if (centroidalize) {
-              entry1->site->location = metric_.centroid(entry1->site->location, entry1->points);
-              entry2->site->location = metric_.centroid(entry2->site->location, entry2->points);
+        for (int b = 0; b < batchesSize; ++b) {
+          const std::vector<std::pair<int, int> >& batch = batches[b];
+          int batchSize = static_cast<int>(batch.size());
+          exchanged.assign(batchSize, 0);
+          parallelFor(batchSize, [&](int k) {
+            exchanged[k] = exchange(batch[k].first, batch[k].second, centroidalize);
+          });
+          for (int k = 0; k < batchSize; ++k) {
+            int i = batch[k].first;
+            int j = batch[k].second;
+            nextBatch[i] = 0;
+            nextBatch[j] = 0;
+            if (exchanged[k]) {
+              stability[i] = 0;
+              stability[j] = 0;
+              grid_.update(i, entries_[i].bounding);
+              grid_.update(j, entries_[j].bounding);
             }
-            entry1->update(metric_);
-            entry2->update(metric_);
           }
         }
       }
 
       bool stable = true;
       for (int i = 0; i < entriesSize; ++i) {
-        entries_[i].stable = stability[i];
-        stable &= stability[i];
+        entries_[i].stable = stability[i] != 0;
+        stable &= entries_[i].stable;
         // code for doing UI
-        if (stability[i]==false) Count_falses++;
+        if (stability[i]==0) Count_falses++;
       }
       return stable;
     }
@@ -463,6 +744,135 @@ namespace ccvt {
 
     };
 
+    /* The sites without capacity are not used. entryIndices gets the entry of
+       each site of the list, -1 if it is not used. It returns the sum of the
+       capacities. */
+    int add_sites(typename std::list<Site>& sites, std::vector<int>* entryIndices) {
+      int sitesSize = static_cast<int>(sites.size());
+      sites_.reserve(sitesSize);
+      entries_.reserve(sitesSize);
+      if (entryIndices != NULL) {
+        entryIndices->assign(sitesSize, -1);
+      }
+      int sumCapacities = 0;
+      for (int i = 0; i < sitesSize; ++i) {
+        Site& site = sites.front();
+        sumCapacities += site.capacity;
+        if (site.capacity > 0) {
+          if (entryIndices != NULL) {
+            (*entryIndices)[i] = static_cast<int>(entries_.size());
+          }
+          sites_.push_back(site);
+          entries_.push_back(Entry(&sites_.back()));
+          entries_.back().points.reserve(site.capacity);
+          mapping_.insert(std::make_pair(site.id, &entries_.back()));
+        }
+        sites.pop_front();
+      }
+      sites_.resize(sites_.size());
+      entries_.resize(entries_.size());
+      return sumCapacities;
+    }
+
+    // the energies and the bounding spheres of the sites with their points
+    template<class ParallelFor>
+    void update_entries(ParallelFor parallelFor) {
+      parallelFor(static_cast<int>(entries_.size()), [&](int i) {
+        entries_[i].energy = 0;
+        int entryPointsSize = static_cast<int>(entries_[i].points.size());
+        for (int j = 0; j < entryPointsSize; ++j) {
+          entries_[i].energy += energy(entries_[i].points[j], entries_[i].site);
+        }
+        entries_[i].update(metric_);
+      });
+    }
+
+    /* Exchanges the points of the two sites that reduce the energy. It returns
+       true if there are exchanges; then the sites are updated. Only the two
+       entries are modified, so the pairs without common sites can be run at
+       the same time. */
+    bool exchange(const int i, const int j, const bool centroidalize) {
+      Entry* entry1 = &entries_[i];
+      Entry* entry2 = &entries_[j];
+      
+      if (entry1->stable && entry2->stable ||
+          metric_.distance(entry1->bounding.center, entry2->bounding.center) > entry1->bounding.radius + entry2->bounding.radius) {
+        return false;
+      }
+
+      if (entry1->points.size() > entry2->points.size()) {
+        std::swap(entry1, entry2);
+      }
+
+      Site* site1 = entry1->site;
+      Site* site2 = entry2->site;
+      std::vector<Point>* points1 = &entry1->points;
+      std::vector<Point>* points2 = &entry2->points;
+
+      double maxSquaredRadius = std::max(entry1->bounding.squaredRadius, entry2->bounding.squaredRadius);
+
+      typename Candidate::Vector candidates1(points1->size());
+      int size = static_cast<int>(points1->size());
+      int count = 0;
+      for (int k = 0; k < size; ++k) {
+        Point& point = (*points1)[k];
+        if (metric_.distance_square(point, entry2->bounding.center) <= maxSquaredRadius) {
+          candidates1[count++] = Candidate(&point, energy(point, site1), energy(point, site2));
+        }
+      }
+      if (count == 0) {
+        return false;
+      }
+      candidates1.resize(count);
+      std::make_heap(candidates1.begin(), candidates1.end());
+
+      double minEnergy = -(candidates1.front().energySelf - candidates1.front().energyOther);
+      typename Candidate::Vector candidates2(points2->size());
+      size = static_cast<int>(points2->size());
+      count = 0;
+      for (int k = 0; k < size; ++k) {
+        Point& point = (*points2)[k];
+        if (metric_.distance_square(point, entry1->bounding.center) <= maxSquaredRadius) {
+          double eSelf = energy(point, site2);
+          double eOther = energy(point, site1);
+          if (eSelf - eOther > minEnergy) {
+            candidates2[count++] = Candidate(&point, eSelf, eOther);
+          }
+        }
+      }
+      if (count == 0) {
+        return false;
+      }
+      candidates2.resize(count);
+      std::make_heap(candidates2.begin(), candidates2.end());
+
+      int maxSwaps = static_cast<int>(std::min(candidates1.size(), candidates2.size()));
+      int swaps;
+      for (swaps = 0; swaps < maxSwaps; ++swaps) {
+        Candidate& candidate1 = candidates1.front();
+        Candidate& candidate2 = candidates2.front();
+        if (candidate1.energySelf - candidate1.energyOther + candidate2.energySelf - candidate2.energyOther <= 0) {
+          break;
+        }
+        std::swap(*candidate1.point, *candidate2.point);
+        entry1->energy += candidate2.energyOther - candidate1.energySelf;
+        entry2->energy += candidate1.energyOther - candidate2.energySelf;
+        std::pop_heap(candidates1.begin(), candidates1.end() - swaps);
+        std::pop_heap(candidates2.begin(), candidates2.end() - swaps);
+      }
+
+      if (swaps == 0) {
+        return false;
+      }
+      if (centroidalize) {
+        entry1->site->location = metric_.centroid(entry1->site->location, entry1->points);
+        entry2->site->location = metric_.centroid(entry2->site->location, entry2->points);
+      }
+      entry1->update(metric_);
+      entry2->update(metric_);
+      return true;
+    }
+
     inline double energy(const Point& point, const Site *const site) const {
       return metric_.distance_square(point, site->location);
     }
@@ -471,6 +881,7 @@ namespace ccvt {
     typename Entry::Vector	    entries_;
     typename Entry::MapPtr      mapping_;
     typename std::vector<Site>  sites_;
+    Grid                        grid_;
 
   };
 
@@ -0,0 +1,329 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include <QCoreApplication>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <clocale>
+
+#include "pipeline.h"
+#include "image_IO.h"
+
+namespace _f_bench_ns
+{
+  const int NUM_REPETITIONS_DEFAULT=5;
+  const std::string OUTPUT_FILE_DEFAULT="stippleshop_bench.csv";
+
+  // the real images and the sizes of the synthetic gradients
+  const std::vector<std::string> VEC_IMAGES={"images/frog_512.png","images/plant_512x512.png"};
+  const std::vector<int> VEC_GRADIENT_SIZES={1024,4096,8192};
+  const int GRADIENT_BASE_SIZE=512;
+
+  class _input
+  {
+  public:
+    std::string Name;
+    cv::Mat Image;
+  };
+
+  class _result
+  {
+  public:
+    std::string Filter;
+    std::string Image;
+    int Width;
+    int Height;
+    int Num_threads;
+    int Num_repetitions;
+    double Median;
+    double Percentile_90;
+    double Min;
+    double Megapixels_per_second;
+    double Speedup;
+  };
+}
+
+using namespace _f_bench_ns;
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void usage()
+{
+  std::cout << "Usage: stippleshop_bench [-f filter]... [-s size]... [-t threads]... [-r repetitions] [-o results.csv]" << std::endl;
+  std::cout << "  -f  only this filter (type name of the effect: HALFTONING_OST, CCVT...). It can be repeated" << std::endl;
+  std::cout << "  -s  only the images of this width: 512 (frog and plant), 1024, 4096 or 8192 (gradients). It can be repeated" << std::endl;
+  std::cout << "  -t  number of threads of OpenCV. It can be repeated. By default 1, 2, 4... up to the number of cores" << std::endl;
+  std::cout << "  -r  number of timed repetitions (" << NUM_REPETITIONS_DEFAULT << " by default). There is one more that is not timed" << std::endl;
+  std::cout << "  -o  the results in CSV format, one line for each filter, image and number of threads (" << OUTPUT_FILE_DEFAULT << " by default)" << std::endl;
+}
+
+
+/*****************************************************************************//**
+ * A smooth color gradient that is upscaled, so the filters find the same
+ * structure at any size
+ *
+ *****************************************************************************/
+
+cv::Mat gradient(int Size)
+{
+  cv::Mat Image(GRADIENT_BASE_SIZE,GRADIENT_BASE_SIZE,CV_8UC3);
+  float Center=GRADIENT_BASE_SIZE/2.0f;
+
+  for (int Row=0;Row<GRADIENT_BASE_SIZE;Row++){
+    for (int Col=0;Col<GRADIENT_BASE_SIZE;Col++){
+      float Distance=sqrtf((Row-Center)*(Row-Center)+(Col-Center)*(Col-Center))/Center;
+      cv::Vec3b &Pixel=Image.at<cv::Vec3b>(Row,Col);
+      Pixel[0]=(unsigned char)(255*Col/(GRADIENT_BASE_SIZE-1));
+      Pixel[1]=(unsigned char)(255*Row/(GRADIENT_BASE_SIZE-1));
+      Pixel[2]=(unsigned char)(255*std::min(Distance,1.0f));
+    }
+  }
+
+  cv::resize(Image,Image,cv::Size(Size,Size),0,0,cv::INTER_CUBIC);
+  return Image;
+}
+
+
+/*****************************************************************************//**
+ * Value of the sorted times for the percentage
+ *
+ *
+ *****************************************************************************/
+
+double percentile(std::vector<double> &Times, float Percentage)
+{
+  int Position=(int)ceil(Percentage*Times.size())-1;
+
+  if (Position<0) Position=0;
+  if (Position>=(int)Times.size()) Position=Times.size()-1;
+  return Times[Position];
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+double median(std::vector<double> &Times)
+{
+  if (Times.size()%2==1) return Times[Times.size()/2];
+  else return (Times[Times.size()/2-1]+Times[Times.size()/2])/2.0;
+}
+
+
+/*****************************************************************************//**
+ * Creates an effect with only the filter. The input is COLOR for the filters that
+ * use color images and GRAY for the rest. The filters with two inputs use the
+ * same image twice
+ *****************************************************************************/
+
+bool create_filter(_pipeline &Pipeline, std::string Type, cv::Mat &Image)
+{
+  std::vector<std::map<std::string,std::string>> Effect(1);
+  _f_filter_ns::_filter_parameters &Parameters=_f_filter_ns::Filter_name_parameters[_f_filter_ns::Type_filter_name[Type]];
+  std::string Input=(Parameters.Num_channels==3)?"COLOR":"GRAY";
+
+  Effect[0]["type_filter"]=Type;
+  Effect[0]["output_image_0"]="bench";
+  Effect[0]["input_image_0"]=Input;
+  Effect[0]["input_image_1"]=(Parameters.Num_input_ports==2)?Input:"NULL";
+
+  if (Pipeline.set_effect(Effect)==false) return false;
+  // the default values of the parameters
+  Pipeline.Map_filters_parameters["bench"]["_INI_"]="EDITOR";
+
+  if (Pipeline.set_image(Image)==false) return false;
+  return Pipeline.create_filters_from_blocks();
+}
+
+
+/*****************************************************************************//**
+ * Times the update of the base class of the filter. The first computation is not
+ * included (caches, allocation of the output image, seeds...)
+ *
+ *****************************************************************************/
+
+bool run_filter(std::string Type, _input &Input, int Num_threads, int Num_repetitions, _result &Result)
+{
+  _pipeline Pipeline;
+  std::vector<double> Times;
+
+  if (create_filter(Pipeline,Type,Input.Image)==false) return false;
+
+  std::shared_ptr<_filter> Filter=Pipeline.Filters.get_data("bench");
+
+  cv::setNumThreads(Num_threads);
+
+  Filter->update();
+  for (int i=0;i<Num_repetitions;i++){
+    // each repetition is a complete computation
+    Filter->clear_warm_start();
+    auto Start=std::chrono::steady_clock::now();
+    Filter->update();
+    Times.push_back(std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-Start).count());
+  }
+
+  std::sort(Times.begin(),Times.end());
+
+  Result.Filter=Type;
+  Result.Image=Input.Name;
+  Result.Width=Input.Image.cols;
+  Result.Height=Input.Image.rows;
+  Result.Num_threads=Num_threads;
+  Result.Num_repetitions=Num_repetitions;
+  Result.Median=median(Times);
+  Result.Percentile_90=percentile(Times,0.9f);
+  Result.Min=Times[0];
+  Result.Megapixels_per_second=(double(Input.Image.cols)*double(Input.Image.rows)/1e6)/(Result.Median/1000.0);
+  Result.Speedup=1;
+
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * Runs the base classes of the filters on real and synthetic images of several
+ * sizes, with several numbers of threads
+ *
+ *****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> Vec_filters;
+  std::vector<int> Vec_sizes;
+  std::vector<int> Vec_threads;
+  int Num_repetitions=NUM_REPETITIONS_DEFAULT;
+  std::string Output_name=OUTPUT_FILE_DEFAULT;
+  std::vector<_input> Vec_inputs;
+  std::vector<_result> Vec_results;
+
+  QCoreApplication Application(argc, argv);
+
+  setlocale(LC_NUMERIC, "C");
+
+  for (int i=1;i<argc;i++){
+    std::string Argument(argv[i]);
+    if (Argument=="-f" && i+1<argc) Vec_filters.push_back(argv[++i]);
+    else if (Argument=="-s" && i+1<argc) Vec_sizes.push_back(atoi(argv[++i]));
+    else if (Argument=="-t" && i+1<argc) Vec_threads.push_back(atoi(argv[++i]));
+    else if (Argument=="-r" && i+1<argc) Num_repetitions=atoi(argv[++i]);
+    else if (Argument=="-o" && i+1<argc) Output_name=argv[++i];
+    else{
+      usage();
+      return -1;
+    }
+  }
+
+  if (Num_repetitions<1){
+    usage();
+    return -1;
+  }
+
+  // all the filters. The ones that are not compiled are discarded later
+  if (Vec_filters.size()==0){
+    for (auto &Filter: _f_filter_ns::Type_filter_name) Vec_filters.push_back(Filter.first);
+  }
+
+  if (Vec_threads.size()==0){
+    int Num_cores=std::max(1,(int)std::thread::hardware_concurrency());
+    for (int Num_threads=1;Num_threads<Num_cores;Num_threads*=2) Vec_threads.push_back(Num_threads);
+    Vec_threads.push_back(Num_cores);
+  }
+
+  // the images
+  auto Selected=[&Vec_sizes](int Size){return Vec_sizes.size()==0 || std::find(Vec_sizes.begin(),Vec_sizes.end(),Size)!=Vec_sizes.end();};
+
+  for (auto &Name: VEC_IMAGES){
+    _input Input;
+    _image_IO Image_io;
+
+    if (Image_io.read_image(Name,Input.Image)==false) continue;
+    if (Selected(Input.Image.cols)==false) continue;
+    Input.Name=Name.substr(Name.find_last_of('/')+1);
+    Vec_inputs.push_back(Input);
+  }
+
+  for (auto Size: VEC_GRADIENT_SIZES){
+    if (Selected(Size)==false) continue;
+    _input Input;
+    Input.Name="gradient_"+std::to_string(Size);
+    Input.Image=gradient(Size);
+    Vec_inputs.push_back(Input);
+  }
+
+  for (auto &Type: Vec_filters){
+    if (_f_filter_ns::Type_filter_name.find(Type)==_f_filter_ns::Type_filter_name.end()){
+      std::cout << "Error: the filter " << Type << " does not exist" << std::endl;
+      return -1;
+    }
+
+    // the filters that are not compiled or cannot be created are skipped
+    bool Available=true;
+
+    for (auto &Input: Vec_inputs){
+      double Median_1_thread=0;
+
+      for (auto Num_threads: Vec_threads){
+        _result Result;
+
+        std::cout << Type << " " << Input.Name << " " << Num_threads << " threads" << std::endl;
+        if (run_filter(Type,Input,Num_threads,Num_repetitions,Result)==false){
+          Available=false;
+          break;
+        }
+
+        // the scaling is relative to the first number of threads
+        if (Median_1_thread==0) Median_1_thread=Result.Median;
+        Result.Speedup=Median_1_thread/Result.Median;
+
+        std::cout << "  median " << Result.Median << " ms, " << Result.Megapixels_per_second << " MP/s" << std::endl;
+        Vec_results.push_back(Result);
+      }
+      if (Available==false) break;
+    }
+  }
+
+  std::ofstream File(Output_name);
+  if (!File.good()){
+    std::cout << "Error: the results cannot be saved in " << Output_name << std::endl;
+    return -1;
+  }
+
+  File << "filter,image,width,height,threads,repetitions,median_ms,p90_ms,min_ms,mpixels_per_s,speedup" << std::endl;
+  for (auto &Result: Vec_results){
+    File << Result.Filter << "," << Result.Image << "," << Result.Width << "," << Result.Height << ",";
+    File << Result.Num_threads << "," << Result.Num_repetitions << ",";
+    File << Result.Median << "," << Result.Percentile_90 << "," << Result.Min << ",";
+    File << Result.Megapixels_per_second << "," << Result.Speedup << std::endl;
+  }
+
+  return 0;
+}
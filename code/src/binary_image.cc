@@ -0,0 +1,393 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#include "binary_image.h"
+#include "image_IO.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdio>
+
+#ifdef DEFINE_IO_PNG
+#include <png.h>
+#endif
+
+#ifdef DEFINE_IO_TIFF
+#include <tiffio.h>
+#endif
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::create(int Rows1, int Cols1)
+{
+  Rows=Rows1;
+  Cols=Cols1;
+  Words_per_row=(Cols+63)/64;
+  Words.assign((size_t)Rows*Words_per_row,0);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _binary_image::from_mat(const cv::Mat &Image)
+{
+  if (Image.type()!=CV_8UC1) return false;
+
+  create(Image.rows,Image.cols);
+
+  for (int Row=0;Row<Rows;Row++){
+    const unsigned char *Pixels=Image.ptr<unsigned char>(Row);
+    uint64_t *Row_words=row(Row);
+
+    for (int Col=0;Col<Cols;Col++){
+      if (Pixels[Col]==0) Row_words[Col>>6]|=(uint64_t)1<<(Col & 63);
+      else if (Pixels[Col]!=255){
+        Words.clear();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::to_mat(cv::Mat &Image) const
+{
+  Image.create(Rows,Cols,CV_8UC1);
+
+  for (int Row=0;Row<Rows;Row++){
+    unsigned char *Pixels=Image.ptr<unsigned char>(Row);
+    const uint64_t *Row_words=row(Row);
+
+    for (int Col=0;Col<Cols;Col++){
+      Pixels[Col]=((Row_words[Col>>6]>>(Col & 63)) & 1)?0:255;
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+size_t _binary_image::count() const
+{
+  size_t Count=0;
+
+  for (size_t i=0;i<Words.size();i++) Count+=std::bitset<64>(Words[i]).count();
+  return Count;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::and_image(const _binary_image &Image)
+{
+  for (size_t i=0;i<Words.size();i++) Words[i]&=Image.Words[i];
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::or_image(const _binary_image &Image)
+{
+  for (size_t i=0;i<Words.size();i++) Words[i]|=Image.Words[i];
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::invert()
+{
+  for (size_t i=0;i<Words.size();i++) Words[i]=~Words[i];
+  clear_padding();
+}
+
+
+/*****************************************************************************//**
+ * The square is separable: first the rows and then the columns
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::dilate(int Radius)
+{
+  if (Radius<=0) return;
+
+  dilate_rows(Radius);
+  dilate_cols(Radius);
+}
+
+
+/*****************************************************************************//**
+ * The erosion of the set pixels is the dilation of the white ones. The pixels
+ * outside the image are 0 for the dilation, so they are not used in the erosion
+ *
+ *****************************************************************************/
+
+void _binary_image::erode(int Radius)
+{
+  if (Radius<=0) return;
+
+  invert();
+  dilate(Radius);
+  invert();
+}
+
+
+/*****************************************************************************//**
+ * The dilation with the columns -Shift, 0 and +Shift after a dilation of Done
+ * gives a dilation of Done+Shift without holes if Shift<=Done+1. So the shifts
+ * are 1, 2, 4... and the rest, and only log2(Radius) steps are needed
+ *****************************************************************************/
+
+int _binary_image::next_shift(int Done,int Radius)
+{
+  return std::min(Done+1,Radius-Done);
+}
+
+
+/*****************************************************************************//**
+ * Each step adds the row shifted Shift columns to both sides. The row is copied
+ * in one buffer, and the words are shifted by Shift/64 words and Shift%64 bits
+ *
+ *****************************************************************************/
+
+void _binary_image::dilate_rows(int Radius)
+{
+  std::vector<uint64_t> Previous(Words_per_row);
+  auto Word_at=[&](int Word)->uint64_t{return (Word>=0 && Word<Words_per_row)?Previous[Word]:0;};
+
+  for (int Done=0,Shift;Done<Radius;Done+=Shift){
+    Shift=next_shift(Done,Radius);
+    int Word_shift=Shift>>6;
+    int Bit_shift=Shift & 63;
+
+    for (int Row=0;Row<Rows;Row++){
+      uint64_t *Row_words=row(Row);
+
+      Previous.assign(Row_words,Row_words+Words_per_row);
+      for (int Word=0;Word<Words_per_row;Word++){
+        // the pixels of the columns Col-Shift and Col+Shift
+        uint64_t Left=Word_at(Word-Word_shift)<<Bit_shift;
+        uint64_t Right=Word_at(Word+Word_shift)>>Bit_shift;
+        if (Bit_shift>0){
+          Left|=Word_at(Word-Word_shift-1)>>(64-Bit_shift);
+          Right|=Word_at(Word+Word_shift+1)<<(64-Bit_shift);
+        }
+        Row_words[Word]|=Left | Right;
+      }
+      // the bits that have passed the last column cannot come back
+      if (Cols & 63) Row_words[Words_per_row-1]&=((uint64_t)1<<(Cols & 63))-1;
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ * Each step adds the rows Shift up and down in place. From the bottom each row
+ * adds the row Shift up, that has not changed yet. Then from the top each row
+ * adds the row Shift down, that has the original row Shift down and itself
+ *****************************************************************************/
+
+void _binary_image::dilate_cols(int Radius)
+{
+  for (int Done=0,Shift;Done<Radius;Done+=Shift){
+    Shift=next_shift(Done,Radius);
+
+    for (int Row=Rows-1;Row>=Shift;Row--){
+      uint64_t *Row_words=row(Row);
+      const uint64_t *Up=row(Row-Shift);
+      for (int Word=0;Word<Words_per_row;Word++) Row_words[Word]|=Up[Word];
+    }
+    for (int Row=0;Row<Rows-Shift;Row++){
+      uint64_t *Row_words=row(Row);
+      const uint64_t *Down=row(Row+Shift);
+      for (int Word=0;Word<Words_per_row;Word++) Row_words[Word]|=Down[Word];
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::clear_padding()
+{
+  if ((Cols & 63)==0) return;
+
+  uint64_t Mask=((uint64_t)1<<(Cols & 63))-1;
+  for (int Row=0;Row<Rows;Row++) row(Row)[Words_per_row-1]&=Mask;
+}
+
+
+/*****************************************************************************//**
+ * PBM and TIFF use 1 for black and PNG uses 1 for white (Invert)
+ *
+ *
+ *****************************************************************************/
+
+void _binary_image::row_bytes(int Row, std::vector<unsigned char> &Bytes, bool Invert) const
+{
+  const uint64_t *Row_words=row(Row);
+  int Num_bytes=(Cols+7)/8;
+
+  Bytes.resize(Num_bytes);
+  for (int Byte=0;Byte<Num_bytes;Byte++){
+    unsigned char Bits=(unsigned char)(Row_words[Byte>>3]>>((Byte & 7)*8));
+    unsigned char Value=0;
+    // the first column is the bit 0 of the word and the most significant bit of the byte
+    for (int i=0;i<8;i++){
+      if (Bits & (1<<i)) Value|=0x80>>i;
+    }
+    if (Invert){
+      Value=~Value;
+      // the bits after the last column are written as in the rest of formats
+      if (Byte==Num_bytes-1 && (Cols & 7)) Value&=(unsigned char)(0xff<<(8-(Cols & 7)));
+    }
+    Bytes[Byte]=Value;
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _binary_image::write(std::string Name) const
+{
+  std::vector<unsigned char> Bytes;
+  bool Result=true;
+
+  switch (_f_image_IO_ns::format(Name)){
+  case _f_image_IO_ns::FORMAT_PBM:
+    {
+      FILE *File=fopen(Name.c_str(),"wb");
+      if (File==nullptr){
+        Result=false;
+        break;
+      }
+
+      fprintf(File,"P4\n%d %d\n",Cols,Rows);
+      for (int Row=0;Row<Rows && Result;Row++){
+        row_bytes(Row,Bytes,false);
+        if (fwrite(Bytes.data(),1,Bytes.size(),File)!=Bytes.size()) Result=false;
+      }
+      if (fclose(File)!=0) Result=false;
+    }
+    break;
+  #ifdef DEFINE_IO_PNG
+  case _f_image_IO_ns::FORMAT_PNG:
+    {
+      FILE *File=fopen(Name.c_str(),"wb");
+      if (File==nullptr){
+        Result=false;
+        break;
+      }
+
+      png_structp Png=png_create_write_struct(PNG_LIBPNG_VER_STRING,nullptr,nullptr,nullptr);
+      png_infop Png_info=png_create_info_struct(Png);
+
+      if (setjmp(png_jmpbuf(Png))) Result=false;
+      else{
+        png_init_io(Png,File);
+        png_set_IHDR(Png,Png_info,Cols,Rows,1,PNG_COLOR_TYPE_GRAY,PNG_INTERLACE_NONE,PNG_COMPRESSION_TYPE_DEFAULT,PNG_FILTER_TYPE_DEFAULT);
+        png_write_info(Png,Png_info);
+        for (int Row=0;Row<Rows;Row++){
+          row_bytes(Row,Bytes,true);
+          png_write_row(Png,Bytes.data());
+        }
+        png_write_end(Png,Png_info);
+      }
+
+      png_destroy_write_struct(&Png,&Png_info);
+      if (fclose(File)!=0) Result=false;
+    }
+    break;
+  #endif
+  #ifdef DEFINE_IO_TIFF
+  case _f_image_IO_ns::FORMAT_TIFF:
+    {
+      TIFF *Tiff=TIFFOpen(Name.c_str(),"w");
+      if (Tiff==nullptr){
+        Result=false;
+        break;
+      }
+
+      TIFFSetField(Tiff,TIFFTAG_IMAGEWIDTH,(uint32_t)Cols);
+      TIFFSetField(Tiff,TIFFTAG_IMAGELENGTH,(uint32_t)Rows);
+      TIFFSetField(Tiff,TIFFTAG_SAMPLESPERPIXEL,(uint16_t)1);
+      TIFFSetField(Tiff,TIFFTAG_BITSPERSAMPLE,(uint16_t)1);
+      TIFFSetField(Tiff,TIFFTAG_PLANARCONFIG,PLANARCONFIG_CONTIG);
+      TIFFSetField(Tiff,TIFFTAG_PHOTOMETRIC,PHOTOMETRIC_MINISWHITE);
+      TIFFSetField(Tiff,TIFFTAG_COMPRESSION,COMPRESSION_CCITTFAX4);
+      TIFFSetField(Tiff,TIFFTAG_ROWSPERSTRIP,TIFFDefaultStripSize(Tiff,0));
+
+      for (int Row=0;Row<Rows && Result;Row++){
+        row_bytes(Row,Bytes,false);
+        if (TIFFWriteScanline(Tiff,Bytes.data(),Row,0)<0) Result=false;
+      }
+      TIFFClose(Tiff);
+    }
+    break;
+  #endif
+  default:
+    {
+      cv::Mat Image;
+      to_mat(Image);
+      Result=cv::imwrite(Name,Image);
+    }
+    break;
+  }
+
+  if (Result==false) std::cout << "Error writing the image: " << Name << std::endl;
+  return Result;
+}
@@ -0,0 +1,117 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#ifndef BINARY_IMAGE_H
+#define BINARY_IMAGE_H
+
+#include <opencv.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+/*****************************************************************************//**
+ * An image of 1 bit per pixel for the results of halftoning and stippling, that
+ * only have black and white pixels. The black pixels (the dots) are the bits set
+ * to 1. Each row is saved in words of 64 bits: the pixel of column Col is the bit
+ * Col%64 of the word Col/64. The bits after the last column are always 0.
+ * The operations use complete words
+ *****************************************************************************/
+
+class _binary_image
+{
+public:
+  _binary_image(){};
+  _binary_image(int Rows1,int Cols1){create(Rows1,Cols1);};
+
+  // all the pixels are white
+  void create(int Rows1,int Cols1);
+  // the pixels with 0 are set. Returns false if there are values different of 0 and 255
+  bool from_mat(const cv::Mat &Image);
+  // the set pixels are 0 and the rest 255. The image is CV_8UC1
+  void to_mat(cv::Mat &Image) const;
+
+  int rows() const {return Rows;};
+  int cols() const {return Cols;};
+  bool empty() const {return Words.empty();};
+  int words_per_row() const {return Words_per_row;};
+  uint64_t *row(int Row){return &Words[(size_t)Row*Words_per_row];};
+  const uint64_t *row(int Row) const {return &Words[(size_t)Row*Words_per_row];};
+
+  bool get(int Row,int Col) const {return (row(Row)[Col>>6]>>(Col & 63)) & 1;};
+  void set(int Row,int Col){row(Row)[Col>>6]|=(uint64_t)1<<(Col & 63);};
+
+  // the number of set pixels
+  size_t count() const;
+  // the same size is needed
+  void and_image(const _binary_image &Image);
+  void or_image(const _binary_image &Image);
+  void invert();
+  // the set pixels grow (dilate) or shrink (erode) with a square of 2*Radius+1.
+  // The pixels outside the image are not used
+  void dilate(int Radius);
+  void erode(int Radius);
+
+  // calls Function(Row,Col) for each set pixel, by rows from the top
+  template<class _function> void for_each(_function Function) const
+  {
+    for (int Row=0;Row<Rows;Row++){
+      const uint64_t *Row_words=row(Row);
+      for (int Word=0;Word<Words_per_row;Word++){
+        uint64_t Bits=Row_words[Word];
+        while (Bits!=0){
+          Function(Row,Word*64+lowest_bit(Bits));
+          Bits&=Bits-1;
+        }
+      }
+    }
+  };
+
+  // PBM, PNG and TIFF are written with 1 bit. The rest as gray images
+  bool write(std::string Name) const;
+
+protected:
+  static int lowest_bit(uint64_t Bits)
+  {
+    #ifdef _MSC_VER
+    unsigned long Position;
+    _BitScanForward64(&Position,Bits);
+    return (int)Position;
+    #else
+    return __builtin_ctzll(Bits);
+    #endif
+  };
+
+  void clear_padding();
+  static int next_shift(int Done,int Radius);
+  void dilate_rows(int Radius);
+  void dilate_cols(int Radius);
+  // the bits of the row from the left (the first column is the most significant bit)
+  void row_bytes(int Row,std::vector<unsigned char> &Bytes,bool Invert) const;
+
+  int Rows=0;
+  int Cols=0;
+  int Words_per_row=0;
+  std::vector<uint64_t> Words;
+};
+
+#endif
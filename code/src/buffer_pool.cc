@@ -0,0 +1,200 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include "buffer_pool.h"
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_buffer_pool::_buffer_pool(size_t Max_bytes1)
+{
+  Max_bytes=Max_bytes1;
+  Bytes=0;
+  Reused=0;
+}
+
+
+/*****************************************************************************//**
+ * The contents of the image are not initialized
+ *
+ *
+ *****************************************************************************/
+
+cv::Mat _buffer_pool::get(int Rows,int Cols,int Type)
+{
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    auto Position=Map_buffers.find(_key(Rows,Cols,Type));
+    if (Position!=Map_buffers.end() && Position->second.size()>0){
+      cv::Mat Image=Position->second.back();
+      Position->second.pop_back();
+      Bytes-=Image.total()*Image.elemSize();
+      Reused++;
+      return Image;
+    }
+  }
+
+  return cv::Mat(Rows,Cols,Type);
+}
+
+
+/*****************************************************************************//**
+ * The image is empty after the call. If its data is shared with other image, the
+ * memory is not saved (the other image continues using it)
+ *
+ *****************************************************************************/
+
+void _buffer_pool::put(cv::Mat &Image)
+{
+  size_t Size=Image.total()*Image.elemSize();
+
+  // only the images that own all their memory (not a region of other image)
+  if (Image.empty() || Image.u==nullptr || Image.u->refcount!=1 || Image.datastart!=Image.data || Image.dataend!=Image.data+Size){
+    Image.release();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    if (Bytes+Size<=Max_bytes){
+      Map_buffers[_key(Image.rows,Image.cols,Image.type())].push_back(Image);
+      Bytes+=Size;
+    }
+  }
+
+  Image.release();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _buffer_pool::clear()
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  Map_buffers.clear();
+  Bytes=0;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _buffer_pool::max_bytes(size_t Max_bytes1)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  Max_bytes=Max_bytes1;
+  if (Bytes>Max_bytes){
+    Map_buffers.clear();
+    Bytes=0;
+  }
+}
+
+
+thread_local long long _allocation_counter::Current=0;
+thread_local long long _allocation_counter::Base=0;
+thread_local long long _allocation_counter::Peak=0;
+
+
+/*****************************************************************************//**
+ * The allocator is never deleted because the images can be released after the
+ * end of main
+ *
+ *****************************************************************************/
+
+void _allocation_counter::start()
+{
+  static std::once_flag Installed;
+
+  std::call_once(Installed,[]{cv::Mat::setDefaultAllocator(new _allocation_counter(cv::Mat::getStdAllocator()));});
+
+  Base=Current;
+  Peak=Current;
+}
+
+
+/*****************************************************************************//**
+ * The maximum of bytes that the thread has had allocated since the call to start
+ *
+ *
+ *****************************************************************************/
+
+size_t _allocation_counter::peak()
+{
+  return size_t(std::max(0LL,Peak-Base));
+}
+
+
+/*****************************************************************************//**
+ * The data is allocated by the original allocator, but this allocator is set as
+ * the owner, so the deallocation is counted too
+ *
+ *****************************************************************************/
+
+cv::UMatData* _allocation_counter::allocate(int Dims,const int* Sizes,int Type,void* Data,size_t* Step,cv::AccessFlag Flags,cv::UMatUsageFlags Usage_flags) const
+{
+  cv::UMatData *User_data=Allocator->allocate(Dims,Sizes,Type,Data,Step,Flags,Usage_flags);
+
+  if (User_data!=nullptr){
+    User_data->currAllocator=User_data->prevAllocator=this;
+    if (!(User_data->flags & cv::UMatData::USER_ALLOCATED)){
+      Current+=(long long)User_data->size;
+      if (Current>Peak) Peak=Current;
+    }
+  }
+  return User_data;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _allocation_counter::allocate(cv::UMatData* Data,cv::AccessFlag Access_flags,cv::UMatUsageFlags Usage_flags) const
+{
+  return Allocator->allocate(Data,Access_flags,Usage_flags);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _allocation_counter::deallocate(cv::UMatData* Data) const
+{
+  if (Data==nullptr) return;
+
+  if (!(Data->flags & cv::UMatData::USER_ALLOCATED)) Current-=(long long)Data->size;
+  Allocator->deallocate(Data);
+}
@@ -0,0 +1,95 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <opencv.hpp>
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include <mutex>
+
+namespace _f_buffer_pool_ns
+{
+  const size_t MAX_BYTES_DEFAULT=256*1024*1024;
+}
+
+
+/*****************************************************************************//**
+ * Saves the memory of the images that are not needed, so the next image with the
+ * same size and type reuses it instead of allocating new memory.
+ * Only the images that do not share their data are saved
+ *****************************************************************************/
+
+class _buffer_pool
+{
+public:
+  _buffer_pool(size_t Max_bytes1=_f_buffer_pool_ns::MAX_BYTES_DEFAULT);
+
+  cv::Mat get(int Rows,int Cols,int Type);
+  void put(cv::Mat &Image);
+  void clear();
+
+  void max_bytes(size_t Max_bytes1);
+  size_t max_bytes(){return Max_bytes;};
+  size_t bytes(){return Bytes;};
+  unsigned long reused(){return Reused;};
+
+protected:
+  typedef std::tuple<int,int,int> _key;
+
+  std::map<_key,std::vector<cv::Mat>> Map_buffers;
+  size_t Max_bytes;
+  size_t Bytes;
+  unsigned long Reused;
+
+  std::mutex Mutex;
+};
+
+
+
+/*****************************************************************************//**
+ * Counts the memory of the images that is allocated by each thread, so the peak
+ * of memory of a computation can be known. The memory reused from the pool and
+ * the memory allocated by other threads (parallel_for_) are not counted.
+ * It replaces the default allocator of OpenCV the first time that it is started
+ *****************************************************************************/
+
+class _allocation_counter: public cv::MatAllocator
+{
+public:
+  static void start();
+  static size_t peak();
+
+  cv::UMatData* allocate(int Dims,const int* Sizes,int Type,void* Data,size_t* Step,cv::AccessFlag Flags,cv::UMatUsageFlags Usage_flags) const override;
+  bool allocate(cv::UMatData* Data,cv::AccessFlag Access_flags,cv::UMatUsageFlags Usage_flags) const override;
+  void deallocate(cv::UMatData* Data) const override;
+
+protected:
+  _allocation_counter(cv::MatAllocator *Allocator1):Allocator(Allocator1){};
+
+  cv::MatAllocator *Allocator;
+
+  // the memory can be released by a thread different to the one that allocated it,
+  // so the values can be negative
+  static thread_local long long Current;
+  static thread_local long long Base;
+  static thread_local long long Peak;
+};
+
+#endif
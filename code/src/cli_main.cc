@@ -0,0 +1,152 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include <QCoreApplication>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <clocale>
+#include <cstdlib>
+
+#include "pipeline.h"
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void usage()
+{
+  std::cout << "Usage: stippleshop-cli -e effect.json -i input_image [-o output_image] [-s image_name output_image]... [-v image_name vector_file]... [-p image_name plotter_file]... [-r ppi] [-t trace.json] [-T tile_size]" << std::endl;
+  std::cout << "  -e  the effect (json file saved by StippleShop)" << std::endl;
+  std::cout << "  -i  the input image" << std::endl;
+  std::cout << "  -o  saves the image produced by the last filter of the effect" << std::endl;
+  std::cout << "  -s  saves the image with that name (the output_image_0 of one filter, COLOR or GRAY)" << std::endl;
+  std::cout << "  -v  saves the dots of the DOT_EBG filter that produces the image as vectors (SVG, SVGZ, PDF or EPS)." << std::endl;
+  std::cout << "      The complete images are used" << std::endl;
+  std::cout << "  -p  saves the dots of the image for a pen plotter (HPGL or G-code), ordered to reduce the travel of the pen." << std::endl;
+  std::cout << "      For a DOT_EBG filter the dots of its input are used. The complete images are used" << std::endl;
+  std::cout << "  -r  the resolution of the images for -p, in pixels per inch (300 by default)" << std::endl;
+  std::cout << "  -t  saves the time and memory of each filter (trace event format, for chrome://tracing or Perfetto)" << std::endl;
+  std::cout << "  -T  computes the effect by tiles of tile_size x tile_size pixels (for very big images). The images are" << std::endl;
+  std::cout << "      read and written by strips (PNG, TIFF, PBM, PGM and PPM), so they do not need to fit in memory" << std::endl;
+}
+
+
+/*****************************************************************************//**
+ * Runs an effect on an image without the graphical interface
+ *
+ *
+ *****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+  std::string Effect_name;
+  std::string Image_name;
+  std::string Trace_name;
+  int Tile_size=0;
+  std::vector<std::pair<std::string,std::string>> Outputs;
+  std::vector<std::pair<std::string,std::string>> Vector_outputs;
+  std::vector<std::pair<std::string,std::string>> Plotter_outputs;
+  float Resolution=_f_plotter_writer_ns::RESOLUTION_DEFAULT;
+
+  QCoreApplication Application(argc, argv);
+
+  setlocale(LC_NUMERIC, "C");
+
+  for (int i=1;i<argc;i++){
+    std::string Argument(argv[i]);
+    if (Argument=="-e" && i+1<argc) Effect_name=argv[++i];
+    else if (Argument=="-i" && i+1<argc) Image_name=argv[++i];
+    else if (Argument=="-t" && i+1<argc) Trace_name=argv[++i];
+    else if (Argument=="-T" && i+1<argc) Tile_size=atoi(argv[++i]);
+    else if (Argument=="-o" && i+1<argc) Outputs.push_back(std::make_pair(std::string(""),std::string(argv[++i])));
+    else if (Argument=="-s" && i+2<argc){
+      std::string Name(argv[++i]);
+      Outputs.push_back(std::make_pair(Name,std::string(argv[++i])));
+    }
+    else if (Argument=="-v" && i+2<argc){
+      std::string Name(argv[++i]);
+      Vector_outputs.push_back(std::make_pair(Name,std::string(argv[++i])));
+    }
+    else if (Argument=="-p" && i+2<argc){
+      std::string Name(argv[++i]);
+      Plotter_outputs.push_back(std::make_pair(Name,std::string(argv[++i])));
+    }
+    else if (Argument=="-r" && i+1<argc) Resolution=(float)atof(argv[++i]);
+    else{
+      usage();
+      return -1;
+    }
+  }
+
+  if (Effect_name=="" || Image_name=="" || (Outputs.size()==0 && Vector_outputs.size()==0 && Plotter_outputs.size()==0) || Resolution<=0){
+    usage();
+    return -1;
+  }
+
+  _pipeline Pipeline;
+
+  if (Pipeline.read_effect(Effect_name)==false) return -1;
+
+  // the dots are read from the complete images
+  if (Tile_size>0 && (Vector_outputs.size()>0 || Plotter_outputs.size()>0)){
+    std::cout << "The dots are saved as vectors, so the complete images are used" << std::endl;
+    Tile_size=0;
+  }
+
+  if (Tile_size>0){
+    if (Pipeline.stream_effect(Image_name,Outputs,Tile_size)==false) return -1;
+  }
+  else{
+    if (Pipeline.read_image(Image_name)==false) return -1;
+    if (Pipeline.create_filters_from_blocks()==false) return -1;
+
+    // the intermediate images that are saved must not be released
+    for (auto &Output: Outputs){
+      if (Output.first!="") Pipeline.keep_image(Output.first);
+    }
+    for (auto &Output: Vector_outputs) Pipeline.keep_inputs(Output.first);
+    for (auto &Output: Plotter_outputs){
+      Pipeline.keep_image(Output.first);
+      Pipeline.keep_inputs(Output.first);
+    }
+
+    if (Pipeline.update_all_filters()==false) return -1;
+
+    for (auto &Output: Outputs){
+      if (Output.first=="") Output.first=Pipeline.final_image();
+      if (Pipeline.save_image(Output.first,Output.second)==false) return -1;
+    }
+
+    for (auto &Output: Vector_outputs){
+      if (Pipeline.save_dots(Output.first,Output.second)==false) return -1;
+    }
+
+    for (auto &Output: Plotter_outputs){
+      if (Pipeline.save_plot(Output.first,Output.second,Resolution)==false) return -1;
+    }
+  }
+
+  if (Trace_name!="" && Pipeline.save_trace(Trace_name)==false){
+    std::cout << "Error: the trace cannot be saved in " << Trace_name << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,211 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#include "conversion_cache.h"
+
+
+/*****************************************************************************//**
+ * Returns the views of the image, creating them if they do not exist
+ *
+ *
+ *****************************************************************************/
+
+std::shared_ptr<_conversion_cache::_views> _conversion_cache::views(cv::Mat *Image)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  std::shared_ptr<_views> &Views=Map_views[Image];
+  if (!Views) Views=std::make_shared<_views>();
+  return Views;
+}
+
+
+/*****************************************************************************//**
+ * The conversion is done with the lock of the views of this image, so two filters
+ * that need the same view wait for only one conversion
+ *
+ *****************************************************************************/
+
+cv::Mat _conversion_cache::gray(cv::Mat *Image)
+{
+  if (Image->channels()==1) return *Image;
+
+  std::shared_ptr<_views> Views=views(Image);
+  std::lock_guard<std::mutex> Lock(Views->Mutex);
+
+  if (Views->Gray_image.empty()) cv::cvtColor(*Image,Views->Gray_image,cv::COLOR_BGR2GRAY,1);
+
+  return Views->Gray_image;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+cv::Mat _conversion_cache::color(cv::Mat *Image)
+{
+  if (Image->channels()==3) return *Image;
+
+  std::shared_ptr<_views> Views=views(Image);
+  std::lock_guard<std::mutex> Lock(Views->Mutex);
+
+  if (Views->Color_image.empty()) cv::cvtColor(*Image,Views->Color_image,cv::COLOR_GRAY2RGB,3);
+
+  return Views->Color_image;
+}
+
+
+/*****************************************************************************//**
+ * The result is saved also when the image is not binary, so it is checked only
+ * once
+ *
+ *****************************************************************************/
+
+std::shared_ptr<const _binary_image> _conversion_cache::binary(cv::Mat *Image)
+{
+  if (Image->type()!=CV_8UC1) return nullptr;
+
+  std::shared_ptr<_views> Views=views(Image);
+  std::lock_guard<std::mutex> Lock(Views->Mutex);
+
+  if (Views->Binary_checked==false){
+    std::shared_ptr<_binary_image> Binary_image=std::make_shared<_binary_image>();
+    if (Binary_image->from_mat(*Image)) Views->Binary_image=Binary_image;
+    Views->Binary_checked=true;
+  }
+
+  return Views->Binary_image;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+std::shared_ptr<const _point_set> _conversion_cache::points(cv::Mat *Image)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  auto Position=Map_views.find(Image);
+  if (Position==Map_views.end()) return nullptr;
+
+  std::lock_guard<std::mutex> Lock_views(Position->second->Mutex);
+  return Position->second->Points;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _conversion_cache::set_gray(cv::Mat *Image, cv::Mat &Gray_image)
+{
+  std::shared_ptr<_views> Views=views(Image);
+  std::lock_guard<std::mutex> Lock(Views->Mutex);
+
+  Views->Gray_image=Gray_image;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _conversion_cache::set_color(cv::Mat *Image, cv::Mat &Color_image)
+{
+  std::shared_ptr<_views> Views=views(Image);
+  std::lock_guard<std::mutex> Lock(Views->Mutex);
+
+  Views->Color_image=Color_image;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _conversion_cache::set_points(cv::Mat *Image, std::shared_ptr<const _point_set> Points)
+{
+  std::shared_ptr<_views> Views=views(Image);
+  std::lock_guard<std::mutex> Lock(Views->Mutex);
+
+  Views->Points=Points;
+}
+
+
+/*****************************************************************************//**
+ * The contents of the image have changed. The filters that are using the old
+ * views keep them until they finish
+ *
+ *****************************************************************************/
+
+void _conversion_cache::invalidate(cv::Mat *Image)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  Map_views.erase(Image);
+}
+
+
+/*****************************************************************************//**
+ * The views follow the contents
+ *
+ *
+ *****************************************************************************/
+
+void _conversion_cache::swap(cv::Mat *Image1, cv::Mat *Image2)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  std::shared_ptr<_views> Views1;
+  std::shared_ptr<_views> Views2;
+
+  auto Position1=Map_views.find(Image1);
+  if (Position1!=Map_views.end()) Views1=Position1->second;
+  auto Position2=Map_views.find(Image2);
+  if (Position2!=Map_views.end()) Views2=Position2->second;
+
+  Map_views.erase(Image1);
+  Map_views.erase(Image2);
+  if (Views2) Map_views[Image1]=Views2;
+  if (Views1) Map_views[Image2]=Views1;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _conversion_cache::clear()
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  Map_views.clear();
+}
@@ -0,0 +1,78 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#ifndef CONVERSION_CACHE_H
+#define CONVERSION_CACHE_H
+
+#include <opencv.hpp>
+
+#include "binary_image.h"
+#include "point_set.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+
+/*****************************************************************************//**
+ * Saves the gray, color and binary versions of the images and their dots, so when several filters read
+ * the same image with a different number of channels the conversion is done only
+ * once. The key is the address of the image (the entries of Images).
+ * When an image changes it must be invalidated: the next request creates a new
+ * version of its views, and the old ones are freed when nobody uses them.
+ * The returned images share the memory with the cache, so they must not be changed
+ *****************************************************************************/
+
+class _conversion_cache
+{
+public:
+  // 1 channel
+  cv::Mat gray(cv::Mat *Image);
+  // 3 channels
+  cv::Mat color(cv::Mat *Image);
+  // 1 bit per pixel. nullptr if the image is not only black and white
+  std::shared_ptr<const _binary_image> binary(cv::Mat *Image);
+  // the dots that a stippling filter has drawn in the image. nullptr if they are not known
+  std::shared_ptr<const _point_set> points(cv::Mat *Image);
+  // for the views that have been computed in other place (GRAY of COLOR)
+  void set_gray(cv::Mat *Image, cv::Mat &Gray_image);
+  void set_color(cv::Mat *Image, cv::Mat &Color_image);
+  void set_points(cv::Mat *Image, std::shared_ptr<const _point_set> Points);
+
+  void invalidate(cv::Mat *Image);
+  // for the images whose contents are swapped
+  void swap(cv::Mat *Image1, cv::Mat *Image2);
+  void clear();
+
+protected:
+  typedef struct {
+    cv::Mat Gray_image;
+    cv::Mat Color_image;
+    bool Binary_checked=false;
+    std::shared_ptr<const _binary_image> Binary_image;
+    std::shared_ptr<const _point_set> Points;
+    std::mutex Mutex;
+  } _views;
+
+  std::shared_ptr<_views> views(cv::Mat *Image);
+
+  std::map<cv::Mat *,std::shared_ptr<_views>> Map_views;
+
+  std::mutex Mutex;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#include "dots_cache.h"
+
+using namespace _f_dots_cache_ns;
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_dots_cache::_dots_cache()
+{
+  Folder=FOLDER_DEFAULT;
+  Packets.resize(RESOLUTION_LAST);
+}
+
+
+/*****************************************************************************//**
+ * Returns the images of the packet, reading them the first time. If a file
+ * cannot be read the packet is not valid and it is not tried again
+ *
+ *****************************************************************************/
+
+std::vector<cv::Mat> *_dots_cache::packet(int Resolution)
+{
+  if (Resolution<0 || Resolution>=RESOLUTION_LAST) return nullptr;
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  _packet &Packet=Packets[Resolution];
+
+  if (Packet.Read==false){
+    Packet.Read=true;
+    Packet.Valid=true;
+    Packet.Images.resize(MAX_DOT_SIZE+1);
+
+    for (int Size=MIN_DOT_SIZE;Size<=MAX_DOT_SIZE;Size++){
+      std::string Name=Folder+"/dots_"+std::to_string(Size)+"_"+std::to_string(VEC_RESOLUTION[Resolution])+".pgm";
+
+      std::unique_ptr<_image_reader> Reader(new _image_reader);
+      // the complete image in one strip
+      if (Reader->open(Name)==false || Reader->channels()!=1 || Reader->read_rows(Reader->rows(),Packet.Images[Size])==false){
+        std::cout << "Error: the file of dots " << Name << " cannot be read" << std::endl;
+        Packet.Valid=false;
+        break;
+      }
+      Packet.Readers.push_back(std::move(Reader));
+    }
+
+    if (Packet.Valid==false){
+      Packet.Images.clear();
+      Packet.Readers.clear();
+    }
+  }
+
+  if (Packet.Valid) return &Packet.Images;
+  else return nullptr;
+}
@@ -0,0 +1,74 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#ifndef DOTS_CACHE_H
+#define DOTS_CACHE_H
+
+#include <opencv.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include "image_IO.h"
+
+namespace _f_dots_cache_ns
+{
+  // the resolutions of the images of dots
+  typedef enum {RESOLUTION_300PPI,RESOLUTION_600PPI,RESOLUTION_1200PPI,RESOLUTION_LAST} _resolution;
+
+  const int VEC_RESOLUTION[]={300,600,1200};
+
+  const int MIN_DOT_SIZE=4;
+  const int MAX_DOT_SIZE=8;
+
+  const std::string FOLDER_DEFAULT="dots";
+}
+
+
+/*****************************************************************************//**
+ * The images of dots of the example based filters. Each packet (the sizes of
+ * one resolution) is read the first time that a filter asks for it, and then it
+ * is shared by all the filters and threads. The files are raw PGM, so they are
+ * mapped in memory and the images use the pages of the files: they must not be
+ * changed. The packets are indexed by the size of the dot
+ *****************************************************************************/
+
+class _dots_cache
+{
+public:
+  _dots_cache();
+
+  // nullptr if the files of the packet cannot be read
+  std::vector<cv::Mat> *packet(int Resolution);
+
+protected:
+  typedef struct {
+    bool Read=false;
+    bool Valid=false;
+    std::vector<std::unique_ptr<_image_reader>> Readers;
+    std::vector<cv::Mat> Images;
+  } _packet;
+
+  std::string Folder;
+  std::vector<_packet> Packets;
+
+  std::mutex Mutex;
+};
+
+#endif
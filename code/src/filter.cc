@@ -16,6 +16,21 @@
 
 #include "filter.h"
 
+#include <algorithm>
+#include <cmath>
+
+#ifndef HEADLESS
+#include <QMessageBox>
+#include <QCoreApplication>
+#include <QThread>
+#endif
+
+std::mutex _filter::Mutex_warnings;
+std::vector<std::pair<std::string,std::string>> _filter::Pending_warnings;
+_buffer_pool _filter::Buffer_pool;
+_conversion_cache _filter::Conversion_cache;
+_dots_cache _filter::Dots_cache;
+
 
 
 /*****************************************************************************//**
@@ -47,6 +62,149 @@ void _filter::set_images(cv::Mat *Input_image0,cv::Mat *Output_image0,cv::Mat *I
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter::update(_task_control *Task_control1)
+{
+  Task_control=Task_control1;
+  update();
+  Task_control=nullptr;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _filter::cancelled()
+{
+  if (Task_control!=nullptr) return Task_control->cancelled();
+  else return false;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter::progress(const std::string &Text,float Value)
+{
+  if (Task_control!=nullptr) Task_control->progress(Text,Value);
+}
+
+
+/*****************************************************************************//**
+ * The contents of the image are not initialized
+ *
+ *
+ *****************************************************************************/
+
+cv::Mat *_filter::new_aux_image(int Rows,int Cols,int Type)
+{
+  return new cv::Mat(Buffer_pool.get(Rows,Cols,Type));
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter::delete_aux_image(cv::Mat *Image)
+{
+  Buffer_pool.put(*Image);
+  delete Image;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+cv::Mat *_filter::new_gray_image(cv::Mat *Image)
+{
+  return new cv::Mat(Conversion_cache.gray(Image));
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter::create_output_image(int Rows,int Cols,int Type)
+{
+  Buffer_pool.put(*Output_image_0);
+  *Output_image_0=Buffer_pool.get(Rows,Cols,Type);
+}
+
+
+/*****************************************************************************//**
+ * The values are not changed with the full image, so the result is the same with
+ * or without proxy mode
+ *
+ *****************************************************************************/
+
+int _filter::proxy_length(float Length)
+{
+  if (Proxy_factor==1.0f) return (int)Length;
+  return std::max(1,(int)lroundf(Length*Proxy_factor));
+}
+
+
+/*****************************************************************************//**
+ * The radius of the kernel is scaled
+ *
+ *
+ *****************************************************************************/
+
+int _filter::proxy_kernel_size(int Size)
+{
+  if (Proxy_factor==1.0f || Size<=1) return Size;
+  return 2*(int)lroundf((float)(Size/2)*Proxy_factor)+1;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+unsigned int _filter::proxy_count(unsigned int Count)
+{
+  if (Proxy_factor==1.0f) return Count;
+  return std::max(1u,(unsigned int)lroundf((float)Count*Proxy_factor*Proxy_factor));
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+std::vector<cv::Mat> *_filter::dots_packet(int Resolution)
+{
+  std::vector<cv::Mat> *Packet=Dots_cache.packet(Resolution);
+
+  if (Packet==nullptr) warning("Images of dots","Error: the images of dots cannot be read. The folder 'dots' must be in the working folder");
+  return Packet;
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -71,3 +229,59 @@ void _filter::copy_input_to_output()
   cv::line(*Output_image_0, cv::Point(0,0),cv::Point(Output_image_0->cols,Output_image_0->rows),0,5);
   cv::line(*Output_image_0, cv::Point(0,Output_image_0->rows),cv::Point(Output_image_0->cols,0),0,5);
 }
+
+
+/*****************************************************************************//**
+ * Shows a warning. With the GUI a message box is used; in headless mode the
+ * text is written to the standard output.
+ * The message boxes can only be created in the main thread, so the warnings of
+ * the filters that run in other threads are saved and shown later
+ *****************************************************************************/
+
+void _filter::warning(std::string Text1, std::string Informative_text1)
+{
+  std::lock_guard<std::mutex> Lock(Mutex_warnings);
+
+  #ifdef HEADLESS
+  std::cout << Name << ": " << Text1;
+  if (Informative_text1!="") std::cout << " " << Informative_text1;
+  std::cout << std::endl;
+  #else
+  if (QThread::currentThread()!=QCoreApplication::instance()->thread()){
+    Pending_warnings.push_back(std::make_pair(Text1,Informative_text1));
+    return;
+  }
+  QMessageBox MsgBox;
+  MsgBox.setText(Text1.c_str());
+  if (Informative_text1!="") MsgBox.setInformativeText(Informative_text1.c_str());
+  MsgBox.setStandardButtons(QMessageBox::Ok);
+  MsgBox.exec();
+  #endif
+}
+
+
+/*****************************************************************************//**
+ * Shows the warnings produced in other threads. It must be called from the main
+ * thread
+ *
+ *****************************************************************************/
+
+void _filter::show_pending_warnings()
+{
+  std::vector<std::pair<std::string,std::string>> Vec_warnings;
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_warnings);
+    Vec_warnings.swap(Pending_warnings);
+  }
+
+  #ifndef HEADLESS
+  for (auto &Warning: Vec_warnings){
+    QMessageBox MsgBox;
+    MsgBox.setText(Warning.first.c_str());
+    if (Warning.second!="") MsgBox.setInformativeText(Warning.second.c_str());
+    MsgBox.setStandardButtons(QMessageBox::Ok);
+    MsgBox.exec();
+  }
+  #endif
+}
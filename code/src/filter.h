@@ -17,10 +17,20 @@
 #ifndef FILTER_H
 #define FILTER_H
 
+#include <QtGlobal>
 #include <opencv.hpp>
 #include <string>
 #include <memory>
 #include <string>
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <map>
+
+#include "task_control.h"
+#include "buffer_pool.h"
+#include "conversion_cache.h"
+#include "dots_cache.h"
 
 namespace _f_filter_ns
 {
@@ -180,22 +190,115 @@ public:
   void set_scaling_factor(float Scaling_factor1){Scaling_factor=Scaling_factor1;};
 
   float scaling_factor(){return Scaling_factor;};
+  // the size of the input image in relation to the image at full resolution (1 if
+  // it is the full image). The parameters that are lengths in pixels or numbers of
+  // dots are scaled, so a preview with a reduced image is similar to the result
+  void set_proxy_factor(float Proxy_factor1){Proxy_factor=Proxy_factor1;};
+  float proxy_factor(){return Proxy_factor;};
 
   virtual void update()=0;
-  virtual void show()=0;
-  virtual void hide()=0;
-  virtual void *get_link()=0;
+  // computes the filter with the control of the task (cancellation and progress)
+  void update(_task_control *Task_control1);
+  // the widgets are only created by the _ui classes. The headless filters use these empty versions
+  virtual void show(){};
+  virtual void hide(){};
+  virtual void *get_link(){return nullptr;};
   virtual void reset_data()=0;
   virtual void read_parameters(std::map<std::string,std::string> &Parameters)=0;
   virtual void write_parameters(std::map<std::string,std::string> &Parameters)=0;
   virtual bool use_dots()=0;
+  // the filters that use OpenGL or dialogs must be computed in the main thread
+  virtual bool main_thread_only(){return false;};
+  // the widgets that show data of the computation (number of dots, measures...) can
+  // only be changed in the main thread, so update() saves the data and this function,
+  // that is called in the main thread when the computation is finished, shows it
+  virtual void update_widgets(){};
+  // for the cache of results. The internal state is the data that changes the result
+  // but it is not saved with the parameters (seeds, selected dots...)
+  virtual bool cacheable(){return true;};
+  virtual void write_internal_state(std::map<std::string,std::string> &State){Q_UNUSED(State)};
+  // the data of the computation that update_widgets() shows. It is saved with the
+  // result, so the result taken from the cache shows the same data
+  virtual void write_results(std::map<std::string,std::string> &Results){Q_UNUSED(Results)};
+  virtual void read_results(std::map<std::string,std::string> &Results){Q_UNUSED(Results)};
+  // the filters that start from their last result when only some parameters change
+  // (CCVT, WCVD) forget it, so the next computation starts from the beginning
+  virtual void clear_warm_start(){};
+  // for the computation by tiles: the number of pixels around the output that are
+  // read from the input. -1 if the filter needs the complete image
+  virtual int halo(){return -1;};
+  // false if the result by tiles is not the same as with the complete image
+  virtual bool exact_by_tiles(){return true;};
+  // Tile_origin is the position of the input image in the complete image
+  void set_tile(bool Tiled1,cv::Point Tile_origin1=cv::Point(0,0)){Tiled=Tiled1;Tile_origin=Tile_origin1;};
 
   void copy_input_to_output();
+  void warning(std::string Text1, std::string Informative_text1="");
+  static void show_pending_warnings();
+
+  // for the long loops of the filters
+  bool cancelled();
+  void progress(const std::string &Text,float Value);
+
+  // the auxiliary images take their memory from the pool of buffers and return it
+  cv::Mat *new_aux_image(int Rows,int Cols,int Type);
+  void delete_aux_image(cv::Mat *Image);
+  // the gray version of a color image is shared with the other filters that need it.
+  // It must not be changed, and it is deleted with delete_aux_image
+  cv::Mat *new_gray_image(cv::Mat *Image);
+  // the 1 bit version of an image with only black and white pixels, shared with the
+  // other filters. nullptr if the image has other values
+  std::shared_ptr<const _binary_image> binary_image(cv::Mat *Image){return Conversion_cache.binary(Image);};
+  // the stippling filters save the dots that they draw in the output image, so the
+  // filters that draw dots can use the positions instead of looking for black pixels
+  void set_output_points(std::shared_ptr<const _point_set> Points){Conversion_cache.set_points(Output_image_0,Points);};
+  // nullptr if the dots of the input image 0 are not known
+  std::shared_ptr<const _point_set> input_points(){return Conversion_cache.points(Input_image_0);};
+  // calls Function(Row,Col) for each dot of the image. If it is the input image 0,
+  // the dots of the stippling filter are used (the position has decimals) or only
+  // the black pixels of the 1 bit version are visited. If not, all the pixels are read
+  template<class _function> void for_each_dot(cv::Mat *Image,_function Function)
+  {
+    std::shared_ptr<const _point_set> Points=(Image==Input_image_0)?input_points():nullptr;
+    if (Points){
+      for (auto &Point: *Points){
+        if ((int)Point.y<Image->rows && (int)Point.x<Image->cols) Function(Point.y,Point.x);
+      }
+      return;
+    }
+
+    std::shared_ptr<const _binary_image> Binary_image=(Image==Input_image_0)?binary_image(Image):nullptr;
+    if (Binary_image){
+      Binary_image->for_each(Function);
+      return;
+    }
+
+    for (int Row=0;Row<Image->rows;Row++){
+      for (int Col=0;Col<Image->cols;Col++){
+        if (Image->at<unsigned char>(Row,Col)==0) Function(Row,Col);
+      }
+    }
+  };
+  // the parameters scaled with the proxy factor. The lengths are at least 1, the
+  // sizes of the kernels remain odd and the numbers of dots change with the area
+  int proxy_length(float Length);
+  int proxy_kernel_size(int Size);
+  unsigned int proxy_count(unsigned int Count);
+  // the previous memory of the output image is returned to the pool
+  void create_output_image(int Rows,int Cols,int Type);
+  // the images of dots of the resolution, indexed by size. They are read the first
+  // time they are needed and they must not be changed. nullptr if they do not exist
+  std::vector<cv::Mat> *dots_packet(int Resolution);
 
   cv::Mat *Input_image_0;
   cv::Mat *Output_image_0;
   cv::Mat *Input_image_1;
 
+  // shared by all the filters
+  static _buffer_pool Buffer_pool;
+  static _conversion_cache Conversion_cache;
+  static _dots_cache Dots_cache;
+
   int Num_channels_input_image_0;
   int Num_channels_output_image_0;
   int Num_channels_input_image_1;
@@ -205,7 +308,17 @@ public:
   _f_filter_ns::_type_filter Type_filter;
   bool Change_output_image_size=false;
   float Scaling_factor=1.0;
+  float Proxy_factor=1.0;
   bool Use_dots=false;
+  bool Tiled=false;
+  cv::Point Tile_origin=cv::Point(0,0);
+
+protected:
+  // only valid during update(Task_control1)
+  _task_control *Task_control=nullptr;
+
+  static std::mutex Mutex_warnings;
+  static std::vector<std::pair<std::string,std::string>> Pending_warnings;
 };
 
 #endif
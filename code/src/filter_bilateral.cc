@@ -15,7 +15,9 @@
 
 
 #include "filter_bilateral.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_bilateral_ns;
 
@@ -66,20 +68,18 @@ void _filter_bilateral::update()
 
   cv::Mat *Aux_input_image=nullptr;
   cv::Mat *Aux_output_image=nullptr;
+  int Kernel_size1=proxy_kernel_size((int)Kernel_size);
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -91,21 +91,20 @@ void _filter_bilateral::update()
   if (Input_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
-      cv::bilateralFilter(*Aux_input_image,*Aux_output_image,(int)Kernel_size,Kernel_size*2,Kernel_size/2);
+      cv::bilateralFilter(*Aux_input_image,*Aux_output_image,Kernel_size1,Kernel_size*2,(float)Kernel_size1/2);
 
       cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
     }
     else std::cout << "Error in the number of channels in the output image " << __LINE__ << " " << __FILE__ << std::endl;
   }
   else{// the same number of channels
-    cv::bilateralFilter(*Aux_input_image,*Output_image_0,(int)Kernel_size,Kernel_size*2,Kernel_size/2);
+    cv::bilateralFilter(*Aux_input_image,*Output_image_0,Kernel_size1,Kernel_size*2,(float)Kernel_size1/2);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -139,10 +138,24 @@ void _filter_bilateral::num_iterations(int Num_iterations1)
  *
  *****************************************************************************/
 
-_filter_bilateral_ui::_filter_bilateral_ui(_gl_widget *GL_widget1, std::string Name1)
+void _filter_bilateral::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_bilateral=new _qtw_filter_bilateral(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(BILATERAL_KERNEL_SIZE_DEFAULT);
+    parameter2(BILATERAL_NUM_ITERATIONS_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["kernel_size"]=="default") parameter1(BILATERAL_KERNEL_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["kernel_size"].c_str()));
+      if (Parameters["iterations"]=="default") parameter2(BILATERAL_NUM_ITERATIONS_DEFAULT);
+      else parameter2(atoi(Parameters["iterations"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of BILATERAL filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -152,23 +165,28 @@ _filter_bilateral_ui::_filter_bilateral_ui(_gl_widget *GL_widget1, std::string N
  *
  *****************************************************************************/
 
-_filter_bilateral_ui::_filter_bilateral_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_bilateral::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_bilateral=new _qtw_filter_bilateral(GL_widget1,this,Name1);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["kernel_size"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["iterations"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_bilateral_ui::~_filter_bilateral_ui()
+_filter_bilateral_ui::_filter_bilateral_ui(_gl_widget *GL_widget1, std::string Name1)
 {
-  delete Qtw_filter_bilateral;
+  Name=Name1;
+  Qtw_filter_bilateral=new _qtw_filter_bilateral(GL_widget1,this,Name1);
 }
 
 
@@ -178,12 +196,11 @@ _filter_bilateral_ui::~_filter_bilateral_ui()
  *
  *****************************************************************************/
 
-void _filter_bilateral_ui::reset_data()
+_filter_bilateral_ui::_filter_bilateral_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_bilateral::reset_data();
-  Qtw_filter_bilateral->set_parameter1(parameter1());
-  Qtw_filter_bilateral->set_parameter2(parameter2());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_bilateral=new _qtw_filter_bilateral(GL_widget1,this,Name1);
 }
 
 
@@ -193,9 +210,9 @@ void _filter_bilateral_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_bilateral_ui::show()
+_filter_bilateral_ui::~_filter_bilateral_ui()
 {
-  Qtw_filter_bilateral->show();
+  delete Qtw_filter_bilateral;
 }
 
 
@@ -205,9 +222,12 @@ void _filter_bilateral_ui::show()
  *
  *****************************************************************************/
 
-void _filter_bilateral_ui::hide()
+void _filter_bilateral_ui::reset_data()
 {
-  Qtw_filter_bilateral->hide();
+  _filter_bilateral::reset_data();
+  Qtw_filter_bilateral->set_parameter1(parameter1());
+  Qtw_filter_bilateral->set_parameter2(parameter2());
+  hide();
 }
 
 
@@ -217,9 +237,9 @@ void _filter_bilateral_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_bilateral_ui::get_link()
+void _filter_bilateral_ui::show()
 {
-  return Qtw_filter_bilateral->get_link();
+  Qtw_filter_bilateral->show();
 }
 
 
@@ -229,26 +249,9 @@ void *_filter_bilateral_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_bilateral_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_bilateral_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(BILATERAL_KERNEL_SIZE_DEFAULT);
-    parameter2(BILATERAL_NUM_ITERATIONS_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["kernel_size"]=="default") parameter1(BILATERAL_KERNEL_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["kernel_size"].c_str()));
-      if (Parameters["iterations"]=="default") parameter2(BILATERAL_NUM_ITERATIONS_DEFAULT);
-      else parameter2(atoi(Parameters["iterations"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of BILATERAL filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_bilateral->hide();
 }
 
 
@@ -258,14 +261,9 @@ void _filter_bilateral_ui::read_parameters(std::map<std::string,std::string> &Pa
  *
  *****************************************************************************/
 
-void _filter_bilateral_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_bilateral_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["kernel_size"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["iterations"]=std::string(Aux);
+  return Qtw_filter_bilateral->get_link();
 }
 
 
@@ -408,6 +406,7 @@ void _qtw_filter_bilateral::set_parameter2(int Value)
 
 void _qtw_filter_bilateral::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
 
   Str=Str.number(Size);
@@ -425,6 +424,7 @@ void _qtw_filter_bilateral::set_parameter1_slot(int Size)
 
 void _qtw_filter_bilateral::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -434,3 +434,4 @@ void _qtw_filter_bilateral::set_parameter2_slot(int Size)
   Filter->parameter2(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
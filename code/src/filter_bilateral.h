@@ -17,11 +17,13 @@
 #ifndef _FILTER_BILATERAL_H
 #define _FILTER_BILATERAL_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -80,8 +82,18 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string, std::string> &Parameters);
+
+    void parameter1(int Value){_filter_bilateral::kernel_size(Value);};
+    int parameter1(){return _filter_bilateral::kernel_size();};
+
+    void parameter2(int Value){_filter_bilateral::num_iterations(Value);};
+    int parameter2(){return _filter_bilateral::num_iterations();};
+
 
     void update();
+    int halo(){return proxy_kernel_size((int)Kernel_size)/2+1;};
     void kernel_size(int Kernel_size1);
     void num_iterations(int Num_iterations1);
 
@@ -92,6 +104,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -106,18 +119,9 @@ public:
   ~_filter_bilateral_ui();
   void reset_data();
 
-
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Value){_filter_bilateral::kernel_size(Value);};
-  int parameter1(){return _filter_bilateral::kernel_size();};
-
-  void parameter2(int Value){_filter_bilateral::num_iterations(Value);};
-  int parameter2(){return _filter_bilateral::num_iterations();};
 
 private:
   _qtw_filter_bilateral *Qtw_filter_bilateral;
@@ -165,4 +169,5 @@ private:
   _filter_bilateral_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
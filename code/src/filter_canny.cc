@@ -15,7 +15,9 @@
 
 
 #include "filter_canny.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_canny_ns;
 
@@ -71,8 +73,7 @@ void _filter_canny::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -80,9 +81,7 @@ void _filter_canny::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -94,8 +93,7 @@ void _filter_canny::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       cv::Canny(*Aux_input_image,*Aux_output_image,(double)Threshold1,(double)Threshold2,Canny_size);
       *Aux_output_image=255-*Aux_output_image;
@@ -110,8 +108,8 @@ void _filter_canny::update()
     *Output_image_0=255-*Output_image_0;
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -151,6 +149,56 @@ void _filter_canny::threshold2(int Value)
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_canny::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(CANNY_SIZE_DEFAULT);
+    parameter2(CANNY_THRESHOLD1_DEFAULT);
+    parameter3(CANNY_THRESHOLD2_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["kernel_size"]=="default") parameter1(CANNY_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["kernel_size"].c_str()));
+      if (Parameters["threshold1"]=="default") parameter2(CANNY_THRESHOLD1_DEFAULT);
+      else parameter2(atoi(Parameters["threshold1"].c_str()));
+      if (Parameters["threshold2"]=="default") parameter3(CANNY_THRESHOLD2_DEFAULT);
+      else parameter3(atoi(Parameters["threshold2"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of CANNY filter" << std::endl;
+      exit(-1);
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_canny::write_parameters(std::map<std::string,std::string> &Parameters)
+{
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["kernel_size"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["threshold1"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter3());
+  Parameters["threshold2"]=std::string(Aux);
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -242,57 +290,6 @@ void *_filter_canny_ui::get_link()
 }
 
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_canny_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(CANNY_SIZE_DEFAULT);
-    parameter2(CANNY_THRESHOLD1_DEFAULT);
-    parameter3(CANNY_THRESHOLD2_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["kernel_size"]=="default") parameter1(CANNY_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["kernel_size"].c_str()));
-      if (Parameters["threshold1"]=="default") parameter2(CANNY_THRESHOLD1_DEFAULT);
-      else parameter2(atoi(Parameters["threshold1"].c_str()));
-      if (Parameters["threshold2"]=="default") parameter3(CANNY_THRESHOLD2_DEFAULT);
-      else parameter3(atoi(Parameters["threshold2"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of CANNY filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_canny_ui::write_parameters(std::map<std::string,std::string> &Parameters)
-{
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["kernel_size"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["threshold1"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter3());
-  Parameters["threshold2"]=std::string(Aux);
-}
-
-
 /*****************************************************************************//**
  *
  *
@@ -484,6 +481,7 @@ void _qtw_filter_canny::set_parameter3(int Value)
 
 void _qtw_filter_canny::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -503,6 +501,7 @@ void _qtw_filter_canny::set_parameter1_slot(int Size)
 
 void _qtw_filter_canny::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -522,6 +521,7 @@ void _qtw_filter_canny::set_parameter2_slot(int Size)
 
 void _qtw_filter_canny::set_parameter3_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter3_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -531,3 +531,4 @@ void _qtw_filter_canny::set_parameter3_slot(int Size)
   Filter->parameter3(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
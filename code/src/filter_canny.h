@@ -17,11 +17,13 @@
 #ifndef _FILTER_CANNY_H
 #define _FILTER_CANNY_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -98,6 +100,18 @@ public:
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
 
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string,std::string> &Parameters);
+
+  void parameter1(int Value){_filter_canny::canny_size(Value);};
+  int parameter1(){return _filter_canny::canny_size();};
+
+  void parameter2(int Value){_filter_canny::threshold1(Value);};
+  int parameter2(){return _filter_canny::threshold1();};
+
+  void parameter3(int Value){_filter_canny::threshold2(Value);};
+  int parameter3(){return _filter_canny::threshold2();};
+
   void update();
   void canny_size(int Size);
   void threshold1(int Threshold);
@@ -111,6 +125,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -128,19 +143,8 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
   void get_parameters(std::map<std::string,std::string> &Parameters);
 
-  void parameter1(int Value){_filter_canny::canny_size(Value);};
-  int parameter1(){return _filter_canny::canny_size();};
-
-  void parameter2(int Value){_filter_canny::threshold1(Value);};
-  int parameter2(){return _filter_canny::threshold1();};
-
-  void parameter3(int Value){_filter_canny::threshold2(Value);};
-  int parameter3(){return _filter_canny::threshold2();};
-
 private:
   _qtw_filter_canny *Qtw_filter_canny;
 };
@@ -192,4 +196,5 @@ private:
   _filter_canny_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
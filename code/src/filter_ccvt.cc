@@ -15,16 +15,25 @@
 
 
 #include "filter_ccvt.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 #include "aux_code/ccvt/ccvt_metric.h"
 #include "aux_code/ccvt/ccvt_optimizer.h"
 #include "aux_code/ccvt/ccvt_point.h"
 #include "aux_code/ccvt/ccvt_site.h"
+#include "thread_pool.h"
+#include "result_cache.h"
+#include "random.h"
+#include <algorithm>
+#include <mutex>
 
 using namespace _f_ccvt_ns;
 using namespace ccvt;
 
+typedef Optimizer<Site<Point2>, Point2, MetricToroidalEuclidean2> _optimizer;
+
 
 /*****************************************************************************//**
  *
@@ -36,6 +45,14 @@ _filter_ccvt::_filter_ccvt()
 {
   Number_of_dots=CCVT_NUMBER_OF_DOTS_DEFAULT;
   Number_of_points_per_dot=CCVT_NUMBER_OF_POINTS_PER_DOT_DEFAULT;
+  Multilevel=CCVT_MULTILEVEL_DEFAULT;
+  Seed=CCVT_SEED_DEFAULT;
+  Parallel=CCVT_PARALLEL_DEFAULT;
+  Used_number_of_points_per_dot=0;
+  Warm_input_hash=0;
+  Warm_points_per_dot=0;
+  Warm_num_levels=0;
+  Warm_seed=0;
 
   Num_channels_input_image_0=1;
   Num_channels_output_image_0=1;
@@ -59,110 +76,406 @@ void _filter_ccvt::reset_data()
 {
   Number_of_dots=CCVT_NUMBER_OF_DOTS_DEFAULT;
   Number_of_points_per_dot=CCVT_NUMBER_OF_POINTS_PER_DOT_DEFAULT;
+  Multilevel=CCVT_MULTILEVEL_DEFAULT;
+  Seed=CCVT_SEED_DEFAULT;
+  Parallel=CCVT_PARALLEL_DEFAULT;
+
+  clear_warm_start();
 }
 
 
 /*****************************************************************************//**
- *
- *
- *
+ * The pixels that have a gray level are the points, ordered from darker to
+ * clearer. There are only 256 levels, so they are sorted by counting the pixels
+ * of each level
  *****************************************************************************/
 
-void _filter_ccvt::ccvt(cv::Mat *Input_image,cv::Mat *Output_image)
+static void image_points(cv::Mat *Image,unsigned int Gray_level,Point2::Vector &Points)
 {
-  double  Torus_size;
-  bool CENTROIDAL=true;
-  unsigned int GRAY_LEVEL=250;
+  std::vector<unsigned int> Vec_counts(256,0);
+  for (int Row=0;Row<Image->rows;Row++){
+    const unsigned char *Row_data=Image->ptr<unsigned char>(Row);
+    for (int Col=0;Col<Image->cols;Col++){
+      if (Row_data[Col]<Gray_level) Vec_counts[Row_data[Col]]++;
+    }
+  }
 
-  std::vector<_dot_data> Vec_dots_data;
+  // the first position of each level
+  unsigned int Num_points=0;
+  for (unsigned int Level=0;Level<256;Level++){
+    unsigned int Count=Vec_counts[Level];
+    Vec_counts[Level]=Num_points;
+    Num_points+=Count;
+  }
 
-  if (Input_image->cols>Input_image->rows) Torus_size=Input_image->cols;
-  else Torus_size=Input_image->rows;
+  Points.resize(Num_points);
+  for (int Row=0;Row<Image->rows;Row++){
+    const unsigned char *Row_data=Image->ptr<unsigned char>(Row);
+    for (int Col=0;Col<Image->cols;Col++){
+      if (Row_data[Col]<Gray_level) Points[Vec_counts[Row_data[Col]]++]=Point2(Col,Row);
+    }
+  }
+}
 
-  Vec_dots_data.resize(Input_image->cols*Input_image->rows);
 
-  // save all the dots that have a gray level in a vector
-  unsigned int Num_points=0;
-  for (int Row=0;Row<Input_image->rows;Row++){
-    for (int Col=0;Col<Input_image->cols;Col++){
-      if (Input_image->at<unsigned char>(Row,Col)<GRAY_LEVEL){
-        Vec_dots_data[Num_points].x=Col;
-        Vec_dots_data[Num_points].y=Row;
-        Vec_dots_data[Num_points].Value=Input_image->at<unsigned char>(Row,Col);
-        Num_points++;
+/*****************************************************************************//**
+ * The image of a level reduced by Factor. The points of the level keep the
+ * density of the points of the image: the fraction of points of each block is
+ * accumulated along the rows (in alternate directions), and there is a point
+ * each time that it reaches 1/2. The gray level of the points is the mean of the
+ * block, and the rest of pixels are white
+ *****************************************************************************/
+
+static void reduce_points(cv::Mat *Image,unsigned int Gray_level,int Factor,cv::Mat &Level_image)
+{
+  cv::Size Size((Image->cols+Factor-1)/Factor,(Image->rows+Factor-1)/Factor);
+  cv::Mat Points_mask;
+  cv::Mat Fractions;
+
+  cv::compare(*Image,cv::Scalar(Gray_level),Points_mask,cv::CMP_LT);
+  cv::resize(Points_mask,Fractions,Size,0,0,cv::INTER_AREA);
+  cv::resize(*Image,Level_image,Size,0,0,cv::INTER_AREA);
+
+  for (int Row=0;Row<Level_image.rows;Row++){
+    const unsigned char *Row_fractions=Fractions.ptr<unsigned char>(Row);
+    unsigned char *Row_data=Level_image.ptr<unsigned char>(Row);
+    float Accumulated=0;
+    for (int i=0;i<Level_image.cols;i++){
+      int Col=(Row%2==0)?i:Level_image.cols-1-i;
+      Accumulated+=(float)Row_fractions[Col]/255.0f;
+      if (Accumulated>=0.5f){
+        Accumulated-=1;
+        if (Row_data[Col]>=Gray_level) Row_data[Col]=(unsigned char)(Gray_level-1);
       }
+      else Row_data[Col]=255;
     }
   }
+}
 
-  // order from darker to clearer
-  // the priority list is ordered using the compare function
-  std::sort(Vec_dots_data.begin(),Vec_dots_data.begin()+Num_points);
 
-  Point2 P2;
-  typedef Optimizer<Site<Point2>, Point2, MetricToroidalEuclidean2> Optimizer;
-  // intializing the underlying discrete space
-  Point2::List points;
+/*****************************************************************************//**
+ * The data of each cell of the CCVT that are needed to add or remove sites in
+ * the next computation
+ *
+ *****************************************************************************/
+
+static void warm_cells(_optimizer &Optimizer1,std::vector<_warm_cell> &Cells)
+{
+  const Site<Point2>::Vector& Sites = Optimizer1.sites();
+  Point2::Vector Points;
+
+  Cells.resize(Sites.size());
+  for (unsigned int i=0;i<Sites.size();i++){
+    _warm_cell &Cell=Cells[i];
+    Cell.Site=Sites[i].location;
+    Cell.Spread=0;
+    Cell.Half1=Cell.Site;
+    Cell.Half2=Cell.Site;
+
+    const Point2::Vector *Site_points=Optimizer1.site_points(Sites[i].id);
+    if (Site_points==nullptr || Site_points->size()<2) continue;
+    Points=*Site_points;
+
+    Point2 Centroid(0,0),Min=Points[0],Max=Points[0];
+    for (const Point2 &Point: Points){
+      Centroid.x+=Point.x;
+      Centroid.y+=Point.y;
+      Min.x=std::min(Min.x,Point.x);
+      Min.y=std::min(Min.y,Point.y);
+      Max.x=std::max(Max.x,Point.x);
+      Max.y=std::max(Max.y,Point.y);
+    }
+    Centroid.x/=Points.size();
+    Centroid.y/=Points.size();
+    for (const Point2 &Point: Points) Cell.Spread+=(Point.x-Centroid.x)*(Point.x-Centroid.x)+(Point.y-Centroid.y)*(Point.y-Centroid.y);
+
+    bool Split_x=(Max.x-Min.x>=Max.y-Min.y);
+    auto Median=Points.begin()+Points.size()/2;
+    std::nth_element(Points.begin(),Median,Points.end(),[Split_x](const Point2 &Point1,const Point2 &Point2){
+      return Split_x?(Point1.x<Point2.x):(Point1.y<Point2.y);
+    });
+
+    Point2 Sum1(0,0),Sum2(0,0);
+    for (auto Position=Points.begin();Position!=Median;Position++){
+      Sum1.x+=Position->x;
+      Sum1.y+=Position->y;
+    }
+    for (auto Position=Median;Position!=Points.end();Position++){
+      Sum2.x+=Position->x;
+      Sum2.y+=Position->y;
+    }
+    double Size1=Median-Points.begin();
+    double Size2=Points.end()-Median;
+    Cell.Half1=Point2(Sum1.x/Size1,Sum1.y/Size1);
+    Cell.Half2=Point2(Sum2.x/Size2,Sum2.y/Size2);
+  }
+}
+
 
-  for (unsigned int i=0; i<Num_points;i++){
-    points.push_back(Point2(Vec_dots_data[i].x,Vec_dots_data[i].y));
+/*****************************************************************************//**
+ * The sites of the previous CCVT changed to Num_sites. The capacities are equal,
+ * so the cells with more spread are the ones of the clear zones: to add sites,
+ * these cells are split in the sites of their halves, and to remove sites, the
+ * cells with less spread are removed. It returns false if the number of sites
+ * is more than the double
+ *****************************************************************************/
+
+static bool warm_sites(const std::vector<_warm_cell> &Cells,unsigned int Num_sites,std::vector<Point2> &Sites)
+{
+  if (Cells.size()==0 || Num_sites>2*Cells.size()) return false;
+
+  // from less to more spread
+  std::vector<int> Order(Cells.size());
+  for (unsigned int i=0;i<Order.size();i++) Order[i]=i;
+  std::stable_sort(Order.begin(),Order.end(),[&Cells](int Cell1,int Cell2){return Cells[Cell1].Spread<Cells[Cell2].Spread;});
+
+  std::vector<char> Selected(Cells.size(),1);
+  unsigned int Num_splits=0;
+  if (Num_sites<Cells.size()){
+    for (unsigned int i=0;i<Cells.size()-Num_sites;i++) Selected[Order[i]]=0;
+  }
+  else{
+    Num_splits=Num_sites-Cells.size();
+    for (unsigned int i=0;i<Num_splits;i++) Selected[Order[Order.size()-1-i]]=2;
   }
 
+  // the order of the sites is kept
+  Sites.clear();
+  Sites.reserve(Num_sites);
+  for (unsigned int i=0;i<Cells.size();i++){
+    if (Selected[i]==1) Sites.push_back(Cells[i].Site);
+    else if (Selected[i]==2){
+      Sites.push_back(Cells[i].Half1);
+      Sites.push_back(Cells[i].Half2);
+    }
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * The pool uses the threads of OpenCV. It is shared by the CCVTs (parallel_for()
+ * can be called from several threads) and it is created again when the number of
+ * threads changes. A CCVT that is running keeps the previous pool until it ends
+ *****************************************************************************/
+
+static std::shared_ptr<_thread_pool> thread_pool()
+{
+  static std::mutex Mutex;
+  static std::shared_ptr<_thread_pool> Pool;
+  unsigned int Num_threads=(unsigned int)std::max(1,cv::getNumThreads());
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  if (Pool==nullptr || Pool->num_threads()!=Num_threads) Pool=std::make_shared<_thread_pool>(Num_threads);
+  return Pool;
+}
+
+
+/*****************************************************************************//**
+ * In the multilevel mode the CCVT is computed first with the image reduced by
+ * 2, 4..., with the same number of dots and less points per dot. The dots of
+ * each level are the initial sites of the next one, and each point starts in
+ * the site of its pixel in the previous level, so the complete image only needs
+ * the last iterations.
+ *
+ * When the input image is the same as in the last computation (only the number
+ * of dots has changed), the initial sites of the first level are the sites of
+ * the last CCVT with the cells split or removed, instead of random positions
+ *****************************************************************************/
+
+void _filter_ccvt::ccvt(cv::Mat *Input_image,cv::Mat *Output_image)
+{
+  bool CENTROIDAL=true;
+  unsigned int GRAY_LEVEL=250;
+
+  // the widgets can change the parameters while the filter is computed in another
+  // thread, so they are read once
+  unsigned int Num_dots=Number_of_dots;
+  unsigned int Points_per_dot=Number_of_points_per_dot;
+  bool Use_multilevel=Multilevel;
+  unsigned int Seed1=Seed;
+  bool Use_parallel=Parallel;
+
+  // intializing the underlying discrete space
+  Point2::Vector points;
+  image_points(Input_image,GRAY_LEVEL,points);
+  unsigned int Num_points=points.size();
+
   // compute the number of dots=sites
-  if (Number_of_points_per_dot<=0) Number_of_points_per_dot=1;
+  if (Points_per_dot<=0) Points_per_dot=1;
   else{
-    if (Number_of_points_per_dot>Num_points) Number_of_points_per_dot=Num_points;
+    if (Points_per_dot>Num_points) Points_per_dot=Num_points;
   }
+  // it is shown by update_widgets()
+  Used_number_of_points_per_dot=Points_per_dot;
+
+  // the number of dots is for the image at full resolution
+  unsigned int Number_of_dots1=proxy_count(Num_dots);
+  if (Number_of_dots1<=0) Number_of_dots1=CCVT_MINIMUM_NUMBER_OF_DOTS_DEFAULT;
 
-  if (Number_of_dots<=0) Number_of_dots=CCVT_MINIMUM_NUMBER_OF_DOTS_DEFAULT;
+  if (Num_points/Points_per_dot<Number_of_dots1){
+    Number_of_dots1=Num_points/Points_per_dot;
+  }
 
-  if (Num_points/Number_of_points_per_dot<Number_of_dots){
-    Number_of_dots=Num_points/Number_of_points_per_dot;
+  // the coarsest level keeps a minimum of points per dot (each level has 1/4 of the points)
+  int Num_levels=1;
+  if (Use_multilevel && Number_of_dots1>0){
+    while (Num_levels<CCVT_MAXIMUM_NUMBER_OF_LEVELS && (Num_points>>(2*Num_levels))/Number_of_dots1>=CCVT_MINIMUM_POINTS_PER_DOT_LEVEL) Num_levels++;
   }
 
-  // initializing the Voronoi sites with equal capacity
-  unsigned int overallCapacity = static_cast<int>(points.size());
-  Site<Point2>::List sites;
-  for (unsigned int i = 0; i <Number_of_dots; ++i) {
-    double x = static_cast<double>(rand() % RAND_MAX) / RAND_MAX * Torus_size;;
-    double y = static_cast<double>(rand() % RAND_MAX) / RAND_MAX * Torus_size;;
-    int capacity = overallCapacity / (Number_of_dots - i);
-    overallCapacity -= capacity;
-  //    sites.push_back(Site<Point2>(i, capacity, Point2(x, y)));
-    sites.push_back(Site<Point2>(i, capacity, Point2(x, y)));
+  // the start from the last CCVT. It is only valid with the same points per dot,
+  // levels and seed, otherwise it is discarded
+  uint64_t Input_hash=_result_cache::hash(Input_image);
+  if (Points_per_dot!=Warm_points_per_dot || Num_levels!=Warm_num_levels || Seed1!=Warm_seed) clear_warm_start();
+  std::vector<Point2> Vec_warm_sites;
+  bool Warm_start=(Input_hash==Warm_input_hash && warm_sites(Warm_cells,Number_of_dots1,Vec_warm_sites));
+
+  std::shared_ptr<_thread_pool> Pool=thread_pool();
+  auto Parallel_for=[Pool](int Count,const std::function<void(int)> &Function){Pool->parallel_for(Count,Function);};
+
+  // the random positions only depend on the seed, so the same parameters give the
+  // same dots
+  _random_uniform_double Random_position;
+  _random_uniform_int Random_point;
+  Random_position.set_seed(Seed1);
+  Random_point.set_seed(Seed1);
+
+  _optimizer optimizer;
+  cv::Mat Level_image;
+  // the site of each pixel of the previous level, -1 if it is not a point
+  cv::Mat Sites_image;
+  bool First_level=true;
+  // the points of a reduced level replace the ones of the input image, even if the
+  // level is skipped
+  bool Points_are_reduced=false;
+  // the reduction of the last computed level. A level can be skipped, so the next
+  // one can be more than 2 times bigger
+  int Previous_factor=1;
+  for (int Level=Num_levels-1;Level>=0;Level--){
+    cv::Mat *Image=Input_image;
+    if (Level>0){
+      reduce_points(Input_image,GRAY_LEVEL,1<<Level,Level_image);
+      Image=&Level_image;
+      image_points(Image,GRAY_LEVEL,points);
+      Points_are_reduced=true;
+      if (points.size()<Number_of_dots1*CCVT_MINIMUM_POINTS_PER_DOT_LEVEL) continue;
+    }
+    else{
+      if (Points_are_reduced) image_points(Input_image,GRAY_LEVEL,points);
+      Level_image.release();
+    }
+
+    double Torus_size;
+    if (Image->cols>Image->rows) Torus_size=Image->cols;
+    else Torus_size=Image->rows;
+
+    // initializing the Voronoi sites with equal capacity. The first level uses random
+    // positions or the sites of the last CCVT, the next ones the positions of the
+    // previous level in the centers of its pixels, that are Ratio times bigger
+    int Ratio=Previous_factor/(1<<Level);
+    std::vector<Point2> Vec_locations(Number_of_dots1);
+    if (First_level && Warm_start){
+      double Factor=1<<Level;
+      for (unsigned int i = 0; i <Number_of_dots1; ++i) {
+        double x=std::min(Vec_warm_sites[i].x/Factor,Torus_size-0.5);
+        double y=std::min(Vec_warm_sites[i].y/Factor,Torus_size-0.5);
+        Vec_locations[i]=Point2(x,y);
+      }
+    }
+    else if (First_level){
+      Random_position.init(0,Torus_size);
+      for (unsigned int i = 0; i <Number_of_dots1; ++i) {
+        double x = Random_position.value();
+        double y = Random_position.value();
+        Vec_locations[i]=Point2(x,y);
+      }
+    }
+    else{
+      const Site<Point2>::Vector& Previous_sites = optimizer.sites();
+      double Offset=double(Ratio-1)/2.0;
+      unsigned int i=0;
+      for (; i <Number_of_dots1 && i<Previous_sites.size(); ++i) {
+        double x=std::min(std::max(Previous_sites[i].location.x*Ratio+Offset,0.0),Torus_size-0.5);
+        double y=std::min(std::max(Previous_sites[i].location.y*Ratio+Offset,0.0),Torus_size-0.5);
+        Vec_locations[i]=Point2(x,y);
+      }
+      // the sites that the previous level did not have start in random points
+      Random_point.init(0,(int)points.size()-1);
+      for (; i <Number_of_dots1; ++i) {
+        Vec_locations[i]=points[Random_point.value()];
+      }
+    }
+
+    unsigned int overallCapacity = static_cast<int>(points.size());
+    Site<Point2>::List sites;
+    for (unsigned int i = 0; i <Number_of_dots1; ++i) {
+      int capacity = overallCapacity / (Number_of_dots1 - i);
+      overallCapacity -= capacity;
+      sites.push_back(Site<Point2>(i, capacity, Vec_locations[i]));
+    }
+
+    // the nearest sites of the points are searched in parallel. The result does not
+    // depend on the number of threads
+    MetricToroidalEuclidean2 metric(Point2(Torus_size,Torus_size));
+    if (First_level) optimizer.initialize(sites, points, metric, Parallel_for);
+    else{
+      std::vector<int> Vec_owners(points.size());
+      for (unsigned int i=0;i<points.size();i++){
+        int Row=std::min((int)points[i].y/Ratio,Sites_image.rows-1);
+        int Col=std::min((int)points[i].x/Ratio,Sites_image.cols-1);
+        Vec_owners[i]=Sites_image.at<int>(Row,Col);
+      }
+      optimizer.initialize(sites, points, Vec_owners, metric, Parallel_for);
+    }
+    First_level=false;
+    Previous_factor=1<<Level;
+
+    // optimization
+    int Count_progress;
+
+    bool stable;
+    int Count_falses;
+    do {
+  //    printf("iteration %d...", ++iteration);
+      Count_falses=0;
+      if (Use_parallel) stable = optimizer.optimize(CENTROIDAL,Count_falses,Parallel_for);
+      else stable = optimizer.optimize(CENTROIDAL,Count_falses);
+      Count_progress=Number_of_dots1-Count_falses;
+      if (Level>0) progress("Computing CCVT (level "+std::to_string(Level)+")...",float(Count_progress)/float(Number_of_dots1));
+      else progress("Computing CCVT...",float(Count_progress)/float(Number_of_dots1));
+      if (cancelled()) return;
+  //    printf("done\n");
+    } while (!stable);
+
+    if (Level>0){
+      Sites_image.create(Image->rows,Image->cols,CV_32S);
+      Sites_image.setTo(-1);
+      for (unsigned int i = 0; i <Number_of_dots1; ++i) {
+        const Point2::Vector *Site_points=optimizer.site_points(i);
+        if (Site_points==nullptr) continue;
+        for (const Point2 &Point: *Site_points) Sites_image.at<int>((int)Point.y,(int)Point.x)=(int)i;
+      }
+    }
   }
 
-  Optimizer optimizer;
-  MetricToroidalEuclidean2 metric(Point2(Torus_size,Torus_size));
-  optimizer.initialize(sites, points, metric);
-
-  // optimization
-  int Count_progress;
-  QProgressDialog Progress("Computing CCVT...", "Abort",0,Number_of_dots);
-  Progress.setWindowModality(Qt::WindowModal);
-  Progress.setMinimumDuration(0);
-  Progress.setCancelButton(0);
-
-  bool stable;
-  int Count_falses;
-  do {
-//    printf("iteration %d...", ++iteration);
-    Count_falses=0;
-    stable = optimizer.optimize(CENTROIDAL,Count_falses);
-    Count_progress=Number_of_dots-Count_falses;
-    Progress.setValue(Count_progress);
-    if (Progress.wasCanceled()) break;
-//    printf("done\n");
-  } while (!stable);
-
-  Progress.setValue(Number_of_dots);
+  Warm_input_hash=Input_hash;
+  Warm_points_per_dot=Points_per_dot;
+  Warm_num_levels=Num_levels;
+  Warm_seed=Seed1;
+  warm_cells(optimizer,Warm_cells);
 
   const Site<Point2>::Vector& result = optimizer.sites();
 
   // drawing the Voronoi sites
+  std::shared_ptr<_point_set> Point_set=std::make_shared<_point_set>(result.size());
+
   Output_image->setTo(255);
   for (unsigned int i = 0; i < result.size(); ++i) {
   Output_image->at<unsigned char>(result[i].location.y,result[i].location.x)=(unsigned char)0;
+  (*Point_set)[i]={(float)result[i].location.x,(float)result[i].location.y,0,-1};
   }
+
+  set_output_points(Point_set);
 }
 
 
@@ -179,8 +492,7 @@ void _filter_ccvt::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -188,9 +500,7 @@ void _filter_ccvt::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -202,8 +512,7 @@ void _filter_ccvt::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       ccvt(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
@@ -214,11 +523,8 @@ void _filter_ccvt::update()
     ccvt(Input_image_0,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
-
-  update_number_of_dots();
-  update_number_of_points_per_dots();
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -228,24 +534,44 @@ void _filter_ccvt::update()
  *
  *****************************************************************************/
 
-_filter_ccvt_ui::_filter_ccvt_ui(_gl_widget *GL_widget1, std::string Name1)
+void _filter_ccvt::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_ccvt=new _qtw_filter_ccvt(GL_widget1,this,Name);
-}
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(CCVT_NUMBER_OF_DOTS_DEFAULT);
+    parameter2(CCVT_NUMBER_OF_POINTS_PER_DOT_DEFAULT);
+    parameter3(CCVT_MULTILEVEL_DEFAULT);
+    parameter4(CCVT_SEED_DEFAULT);
+    parameter5(CCVT_PARALLEL_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["number_of_dots"]=="default") parameter1(CCVT_NUMBER_OF_DOTS_DEFAULT);
+      else parameter1(atoi(Parameters["number_of_dots"].c_str()));
 
+      if (Parameters["number_of_points_per_dots"]=="default") parameter2(CCVT_NUMBER_OF_POINTS_PER_DOT_DEFAULT);
+      else parameter2(atoi(Parameters["number_of_points_per_dots"].c_str()));
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
+      // the files of previous versions do not have this parameter
+      if (Parameters["multilevel"]=="default" || Parameters["multilevel"]=="") parameter3(CCVT_MULTILEVEL_DEFAULT);
+      else{
+        if (Parameters["multilevel"]=="true") parameter3(true);
+        else parameter3(false);
+      }
 
-_filter_ccvt_ui::_filter_ccvt_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
-{
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_ccvt=new _qtw_filter_ccvt(GL_widget1,this,Name);
+      if (Parameters["seed"]=="default" || Parameters["seed"]=="") parameter4(CCVT_SEED_DEFAULT);
+      else parameter4(atoi(Parameters["seed"].c_str()));
+
+      if (Parameters["parallel_exchanges"]=="default" || Parameters["parallel_exchanges"]=="") parameter5(CCVT_PARALLEL_DEFAULT);
+      else{
+        if (Parameters["parallel_exchanges"]=="true") parameter5(true);
+        else parameter5(false);
+      }
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of CCVT filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -255,23 +581,36 @@ _filter_ccvt_ui::_filter_ccvt_ui(_gl_widget *GL_widget1, std::map<std::string, s
  *
  *****************************************************************************/
 
-_filter_ccvt_ui::~_filter_ccvt_ui()
+void _filter_ccvt::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  delete Qtw_filter_ccvt;
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["number_of_dots"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["number_of_points_per_dots"]=std::string(Aux);
+  if (parameter3()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["multilevel"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter4());
+  Parameters["seed"]=std::string(Aux);
+  if (parameter5()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["parallel_exchanges"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-void _filter_ccvt_ui::reset_data()
+_filter_ccvt_ui::_filter_ccvt_ui(_gl_widget *GL_widget1, std::string Name1)
 {
-  _filter_ccvt::reset_data();
-  Qtw_filter_ccvt->set_parameter1(parameter1());
-  hide();
+  Name=Name1;
+  Qtw_filter_ccvt=new _qtw_filter_ccvt(GL_widget1,this,Name);
 }
 
 
@@ -281,9 +620,11 @@ void _filter_ccvt_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_ccvt_ui::show()
+_filter_ccvt_ui::_filter_ccvt_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  Qtw_filter_ccvt->show();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_ccvt=new _qtw_filter_ccvt(GL_widget1,this,Name);
 }
 
 
@@ -293,9 +634,9 @@ void _filter_ccvt_ui::show()
  *
  *****************************************************************************/
 
-void _filter_ccvt_ui::hide()
+_filter_ccvt_ui::~_filter_ccvt_ui()
 {
-  Qtw_filter_ccvt->hide();
+  delete Qtw_filter_ccvt;
 }
 
 
@@ -305,9 +646,15 @@ void _filter_ccvt_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_ccvt_ui::get_link()
+void _filter_ccvt_ui::reset_data()
 {
-  return Qtw_filter_ccvt->get_link();
+  _filter_ccvt::reset_data();
+  Qtw_filter_ccvt->set_parameter1(parameter1());
+  Qtw_filter_ccvt->set_parameter2(parameter2());
+  Qtw_filter_ccvt->set_parameter3(parameter3());
+  Qtw_filter_ccvt->set_parameter4(parameter4());
+  Qtw_filter_ccvt->set_parameter5(parameter5());
+  hide();
 }
 
 
@@ -317,27 +664,9 @@ void *_filter_ccvt_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_ccvt_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_ccvt_ui::show()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(CCVT_NUMBER_OF_DOTS_DEFAULT);
-    parameter2(CCVT_NUMBER_OF_POINTS_PER_DOT_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["number_of_dots"]=="default") parameter1(CCVT_NUMBER_OF_DOTS_DEFAULT);
-      else parameter1(atoi(Parameters["number_of_dots"].c_str()));
-
-      if (Parameters["number_of_points_per_dots"]=="default") parameter2(CCVT_NUMBER_OF_POINTS_PER_DOT_DEFAULT);
-      else parameter2(atoi(Parameters["number_of_points_per_dots"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of CCVT filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_ccvt->show();
 }
 
 
@@ -347,14 +676,9 @@ void _filter_ccvt_ui::read_parameters(std::map<std::string,std::string> &Paramet
  *
  *****************************************************************************/
 
-void _filter_ccvt_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_ccvt_ui::hide()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["number_of_dots"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["number_of_points_per_dots"]=std::string(Aux);
+  Qtw_filter_ccvt->hide();
 }
 
 
@@ -364,9 +688,9 @@ void _filter_ccvt_ui::write_parameters(std::map<std::string,std::string> &Parame
  *
  *****************************************************************************/
 
-void _filter_ccvt_ui::update_number_of_dots()
+void *_filter_ccvt_ui::get_link()
 {
-  Qtw_filter_ccvt->set_parameter1(parameter1());
+  return Qtw_filter_ccvt->get_link();
 }
 
 
@@ -376,9 +700,11 @@ void _filter_ccvt_ui::update_number_of_dots()
  *
  *****************************************************************************/
 
-void _filter_ccvt_ui::update_number_of_points_per_dots()
+void _filter_ccvt_ui::update_widgets()
 {
-  Qtw_filter_ccvt->set_parameter2(parameter2());
+  // the number of points per dot is reduced when the image has less points
+  Qtw_filter_ccvt->set_parameter1(parameter1());
+  if (Used_number_of_points_per_dot>0) Qtw_filter_ccvt->set_parameter2((int)Used_number_of_points_per_dot);
 }
 
 
@@ -440,9 +766,68 @@ _qtw_filter_ccvt::_qtw_filter_ccvt(_gl_widget *GL_widget1,_filter_ccvt_ui *Filte
 
   Group_box_parameter2->setLayout(Vertical_box_parameter2);
 
+  // Parameter3
+  // Multilevel
+  Group_box_parameter3=new QGroupBox(tr(String_group_box_parameter3.c_str()));
+  Group_box_parameter3->setAlignment(Qt::AlignCenter);
+
+  QVBoxLayout *Vertical_box_parameter3 = new QVBoxLayout;
+
+  Checkbox_parameter3=new QCheckBox(tr(String_checkbox_parameter3.c_str()));
+  if (Filter->parameter3()) Checkbox_parameter3->setChecked(true);
+  else Checkbox_parameter3->setChecked(false);
+  Checkbox_parameter3->setToolTip(tr(String_parameter3_tooltip.c_str()));
+
+  connect(Checkbox_parameter3,SIGNAL(stateChanged(int)),this,SLOT(set_parameter3_slot(int)));
+
+  Vertical_box_parameter3->addWidget(Checkbox_parameter3);
+
+  Group_box_parameter3->setLayout(Vertical_box_parameter3);
+
+  // Parameter4
+  // Seed
+  Group_box_parameter4=new QGroupBox(tr(String_group_box_parameter4.c_str()));
+  Group_box_parameter4->setAlignment(Qt::AlignCenter);
+
+  QVBoxLayout *Vertical_box_parameter4 = new QVBoxLayout;
+
+  Spinbox_parameter4=new QSpinBox;
+  Spinbox_parameter4->setRange(0,CCVT_SEED_MAX);
+  Spinbox_parameter4->setValue(Filter->parameter4());
+  Spinbox_parameter4->setToolTip(tr(String_parameter4_tooltip.c_str()));
+  Spinbox_parameter4->setKeyboardTracking(false);
+  Spinbox_parameter4->setAlignment(Qt::AlignRight);
+
+  connect(Spinbox_parameter4, SIGNAL(valueChanged(int)),this,SLOT(set_parameter4_slot(int)));
+
+  Vertical_box_parameter4->addWidget(Spinbox_parameter4);
+
+  Group_box_parameter4->setLayout(Vertical_box_parameter4);
+
+  // Parameter5
+  // Parallel exchanges
+  Group_box_parameter5=new QGroupBox(tr(String_group_box_parameter5.c_str()));
+  Group_box_parameter5->setAlignment(Qt::AlignCenter);
+
+  QVBoxLayout *Vertical_box_parameter5 = new QVBoxLayout;
+
+  Checkbox_parameter5=new QCheckBox(tr(String_checkbox_parameter5.c_str()));
+  if (Filter->parameter5()) Checkbox_parameter5->setChecked(true);
+  else Checkbox_parameter5->setChecked(false);
+  Checkbox_parameter5->setToolTip(tr(String_parameter5_tooltip.c_str()));
+
+  connect(Checkbox_parameter5,SIGNAL(stateChanged(int)),this,SLOT(set_parameter5_slot(int)));
+
+  Vertical_box_parameter5->addWidget(Checkbox_parameter5);
+
+  Group_box_parameter5->setLayout(Vertical_box_parameter5);
+
   //
   Vertical_box_main->addWidget(Group_box_parameter1);
   Vertical_box_main->addWidget(Group_box_parameter2);
+  Vertical_box_main->addWidget(Group_box_parameter3);
+  Vertical_box_main->addWidget(Group_box_parameter4);
+  Vertical_box_main->addWidget(Group_box_parameter5);
 
   Group_box_main->setLayout(Vertical_box_main);
 }
@@ -476,6 +861,50 @@ void _qtw_filter_ccvt::set_parameter2(int Value)
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _qtw_filter_ccvt::set_parameter3(bool Value)
+{
+  Checkbox_parameter3->blockSignals(true);
+  if (Value) Checkbox_parameter3->setChecked(true);
+  else Checkbox_parameter3->setChecked(false);
+  Checkbox_parameter3->blockSignals(false);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _qtw_filter_ccvt::set_parameter4(int Value)
+{
+  Spinbox_parameter4->blockSignals(true);
+  Spinbox_parameter4->setValue(Value);
+  Spinbox_parameter4->blockSignals(false);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _qtw_filter_ccvt::set_parameter5(bool Value)
+{
+  Checkbox_parameter5->blockSignals(true);
+  if (Value) Checkbox_parameter5->setChecked(true);
+  else Checkbox_parameter5->setChecked(false);
+  Checkbox_parameter5->blockSignals(false);
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -484,6 +913,7 @@ void _qtw_filter_ccvt::set_parameter2(int Value)
 
 void _qtw_filter_ccvt::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   Filter->parameter1(Size);
   GL_widget->update_effect(Filter->Name);
 }
@@ -497,6 +927,52 @@ void _qtw_filter_ccvt::set_parameter1_slot(int Size)
 
 void _qtw_filter_ccvt::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   Filter->parameter2(Size);
   GL_widget->update_effect(Filter->Name);
 }
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _qtw_filter_ccvt::set_parameter3_slot(int Value)
+{
+  if (GL_widget->defer_change([this,Value]{set_parameter3_slot(Value);})) return;
+  if (Value==Qt::Checked) Filter->parameter3(true);
+  else Filter->parameter3(false);
+  GL_widget->update_effect(Filter->Name);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _qtw_filter_ccvt::set_parameter4_slot(int Value)
+{
+  if (GL_widget->defer_change([this,Value]{set_parameter4_slot(Value);})) return;
+  Filter->parameter4(Value);
+  GL_widget->update_effect(Filter->Name);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _qtw_filter_ccvt::set_parameter5_slot(int Value)
+{
+  if (GL_widget->defer_change([this,Value]{set_parameter5_slot(Value);})) return;
+  if (Value==Qt::Checked) Filter->parameter5(true);
+  else Filter->parameter5(false);
+  GL_widget->update_effect(Filter->Name);
+}
+#endif // HEADLESS
@@ -17,14 +17,18 @@
 #ifndef _FILTER_CCVT_H
 #define _FILTER_CCVT_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSpinBox>
+#include <QCheckBox>
 #include <QLabel>
-#include <QProgressDialog>
 #include "line_edit.h"
+#endif
 #include <string>
+#include <vector>
 #include "filter.h"
+#include "aux_code/ccvt/ccvt_point.h"
 
 #define DEFINED_FILTER_CCVT
 
@@ -40,24 +44,48 @@ namespace _f_ccvt_ns
   const std::string String_group_box_parameter2("Number of points per dot");
   const std::string String_parameter2_tooltip("Controls the number of points (sites) per dot");
 
+  // Multilevel
+  // parameter 3
+  const std::string String_group_box_parameter3("Multilevel");
+  const std::string String_checkbox_parameter3("Coarse to fine");
+  const std::string String_parameter3_tooltip("Computes the CCVT first with the image reduced, and uses the dots as the start of the complete image. It is faster with many points per dot");
+
+  // Seed
+  // parameter 4
+  const std::string String_group_box_parameter4("Seed");
+  const std::string String_parameter4_tooltip("Controls the random positions of the initial dots. The same seed gives the same dots");
+
+  // Parallel exchanges
+  // parameter 5
+  const std::string String_group_box_parameter5("Parallel exchanges");
+  const std::string String_checkbox_parameter5("Exchanges by pairs of dots");
+  const std::string String_parameter5_tooltip("Computes the exchanges of points between the dots in parallel. It is faster with many dots, but the dots are not the same as without it");
+
   // Default values
   const int CCVT_NUMBER_OF_DOTS_DEFAULT=1000;
   const int CCVT_MINIMUM_NUMBER_OF_DOTS_DEFAULT=10;
   const int CCVT_NUMBER_OF_POINTS_PER_DOT_DEFAULT=10;
-
-  class _dot_data
-  {
-  public:
-
-    bool operator<( const _dot_data& Dot_data1) const
-    {
-          return Value < Dot_data1.Value;
-    };
-
-    unsigned int x;
-    unsigned int y;
-    unsigned int Value;
-  };
+  // off, so the effects of previous versions give the same dots
+  const bool CCVT_MULTILEVEL_DEFAULT=false;
+  const int CCVT_SEED_DEFAULT=1;
+  const int CCVT_SEED_MAX=999999;
+  // the exchanges between the sites are computed in parallel. The result does not
+  // depend on the number of threads, but it is different than the sequential one
+  const bool CCVT_PARALLEL_DEFAULT=false;
+  // the image is reduced by 2 in each level, until the number of points per dot would
+  // be less than the minimum
+  const int CCVT_MAXIMUM_NUMBER_OF_LEVELS=4;
+  const unsigned int CCVT_MINIMUM_POINTS_PER_DOT_LEVEL=16;
+
+  // a cell of the last CCVT: the site, the sum of the squared distances of its points
+  // to their centroid, and the centroids of the two halves of the points (divided by
+  // the longest side), that are the sites when the cell is split
+  typedef struct {
+    ccvt::Point2 Site;
+    double Spread;
+    ccvt::Point2 Half1;
+    ccvt::Point2 Half2;
+  } _warm_cell;
 }
 
 class _gl_widget;
@@ -79,8 +107,31 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string,std::string> &Parameters);
+
+    void parameter1(int Value){number_of_dots((unsigned int)Value);};
+    int parameter1(){return (int)number_of_dots();};
+
+    void parameter2(int Value){number_of_points_per_dot((unsigned int)Value);};
+    int parameter2(){return (int)number_of_points_per_dot();};
+
+    void parameter3(bool Value){multilevel(Value);};
+    bool parameter3(){return multilevel();};
+
+    void parameter4(int Value){seed((unsigned int)Value);};
+    int parameter4(){return (int)seed();};
+
+    void parameter5(bool Value){parallel(Value);};
+    bool parameter5(){return parallel();};
+
     void ccvt(cv::Mat *Input_image,cv::Mat *Output_image);
     void update();
+    void clear_warm_start(){Warm_cells.clear();};
+    // the result depends on the last CCVT
+    bool cacheable(){return Warm_cells.empty();};
+    void write_results(std::map<std::string,std::string> &Results){Results["used_number_of_points_per_dot"]=std::to_string(Used_number_of_points_per_dot);};
+    void read_results(std::map<std::string,std::string> &Results){Used_number_of_points_per_dot=(unsigned int)atoi(Results["used_number_of_points_per_dot"].c_str());};
 
     void number_of_dots(unsigned int Number_of_dots1){Number_of_dots=Number_of_dots1;};
     unsigned int number_of_dots(){return Number_of_dots;};
@@ -88,15 +139,37 @@ public:
     void number_of_points_per_dot(unsigned int Number_of_points_per_dot1){Number_of_points_per_dot=Number_of_points_per_dot1;};
     unsigned int number_of_points_per_dot(){return Number_of_points_per_dot;};
 
-    virtual void update_number_of_dots(){};
-    virtual void update_number_of_points_per_dots(){};
+    void multilevel(bool Multilevel1){Multilevel=Multilevel1;};
+    bool multilevel(){return Multilevel;};
+
+    void seed(unsigned int Seed1){Seed=Seed1;};
+    unsigned int seed(){return Seed;};
+
+    void parallel(bool Parallel1){Parallel=Parallel1;};
+    bool parallel(){return Parallel;};
+
+protected:
+    // the number of points per dot of the last computation
+    unsigned int Used_number_of_points_per_dot;
 
 private:
     unsigned int Number_of_dots;
     unsigned int Number_of_points_per_dot;
+    bool Multilevel;
+    unsigned int Seed;
+    bool Parallel;
+
+    // the last CCVT that was finished. When the input image and the rest of parameters
+    // are the same, its cells give the initial sites of the next computation
+    uint64_t Warm_input_hash;
+    unsigned int Warm_points_per_dot;
+    int Warm_num_levels;
+    unsigned int Warm_seed;
+    std::vector<_f_ccvt_ns::_warm_cell> Warm_cells;
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -111,22 +184,12 @@ public:
   ~_filter_ccvt_ui();
   void reset_data();
 
-
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
   void get_parameters(std::map<std::string,std::string> &Parameters);
 
-  void parameter1(int Value){number_of_dots((unsigned int)Value);};
-  int parameter1(){return (int)number_of_dots();};
-
-  void parameter2(int Value){number_of_points_per_dot((unsigned int)Value);};
-  int parameter2(){return (int)number_of_points_per_dot();};
-
-  void update_number_of_dots();
-  void update_number_of_points_per_dots();
+  void update_widgets();
 
 private:
   _qtw_filter_ccvt *Qtw_filter_ccvt;
@@ -152,16 +215,25 @@ public:
 
   void set_parameter1(int Value);
   void set_parameter2(int Value);
+  void set_parameter3(bool Value);
+  void set_parameter4(int Value);
+  void set_parameter5(bool Value);
 
 protected slots:
   void set_parameter1_slot(int Value);
   void set_parameter2_slot(int Value);
+  void set_parameter3_slot(int Value);
+  void set_parameter4_slot(int Value);
+  void set_parameter5_slot(int Value);
 
 
 private:
   QGroupBox *Group_box_main;
   QGroupBox *Group_box_parameter1;
   QGroupBox *Group_box_parameter2;
+  QGroupBox *Group_box_parameter3;
+  QGroupBox *Group_box_parameter4;
+  QGroupBox *Group_box_parameter5;
 
   // Number of dots
   QSpinBox *Spinbox_parameter1;
@@ -169,7 +241,17 @@ private:
   // Number of points per dot
   QSpinBox *Spinbox_parameter2;
 
+  // Multilevel
+  QCheckBox *Checkbox_parameter3;
+
+  // Seed
+  QSpinBox *Spinbox_parameter4;
+
+  // Parallel exchanges
+  QCheckBox *Checkbox_parameter5;
+
   _filter_ccvt_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
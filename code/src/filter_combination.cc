@@ -15,7 +15,9 @@
 
 
 #include "filter_combination.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_combination_ns;
 
@@ -66,11 +68,7 @@ void _filter_combination::reset_data()
 void _filter_combination::update()
 {
   if (Input_image_0->cols!=Input_image_1->cols || Input_image_0->rows!=Input_image_1->rows){
-    QMessageBox MsgBox;
-    MsgBox.setText("Filter Combination");
-    MsgBox.setInformativeText("Warning: the input images must have the same sizes");
-    MsgBox.setStandardButtons(QMessageBox::Ok);
-    MsgBox.exec();
+    warning("Filter Combination","Warning: the input images must have the same sizes");
     copy_input_to_output();
   }
   else{
@@ -78,16 +76,30 @@ void _filter_combination::update()
 
     // check the output size
     if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-      Output_image_0->release();
-      Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
     }
 
     if (Input_image_1->channels()!=Num_channels_input_image_1){// Different number of channels
       std::cout << "Error: the number of channels in the input_image_1 is not 1" << __LINE__ << " " << __FILE__ << std::endl;
     }
 
-    Aux_input_image_0=new cv::Mat;
-    Aux_input_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    // with black and white inputs, the logical operations are done by words of 64 pixels
+    if (Output_image_0->channels()==1 && (Combination_type==COMBINATION_PRODUCT || Combination_type==COMBINATION_AND || Combination_type==COMBINATION_OR)){
+      std::shared_ptr<const _binary_image> Binary_image0=binary_image(Input_image_0);
+      std::shared_ptr<const _binary_image> Binary_image1=(Binary_image0)?binary_image(Input_image_1):nullptr;
+
+      if (Binary_image0 && Binary_image1){
+        // the black pixels are the set bits: a pixel is black if it is black in one of
+        // the inputs (product, and) or in both (or)
+        _binary_image Result=*Binary_image0;
+        if (Combination_type==COMBINATION_OR) Result.and_image(*Binary_image1);
+        else Result.or_image(*Binary_image1);
+        Result.to_mat(*Output_image_0);
+        return;
+      }
+    }
+
+    Aux_input_image_0=new_aux_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
     // Check the number of input channels
     if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
       if (Input_image_0->channels()==3){
@@ -97,7 +109,7 @@ void _filter_combination::update()
       else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
     }
     else{// the same number of channels
-      *Aux_input_image_0=Input_image_0->clone();
+      Input_image_0->copyTo(*Aux_input_image_0);
     }
 
     switch(Combination_type) {
@@ -135,10 +147,11 @@ void _filter_combination::update()
       else std::cout << "Error in the number of channels in the output image " << __LINE__ << " " << __FILE__ << std::endl;
     }
     else{// the same number of channels
-      *Output_image_0=*Aux_input_image_0;
+      // it is copied, as the buffer of the auxiliar image returns to the pool
+      Aux_input_image_0->copyTo(*Output_image_0);
     }
 
-    delete Aux_input_image_0;
+    delete_aux_image(Aux_input_image_0);
   }
 }
 
@@ -149,10 +162,21 @@ void _filter_combination::update()
  *
  *****************************************************************************/
 
-_filter_combination_ui::_filter_combination_ui(_gl_widget *GL_widget1,std::string Name1)
+void _filter_combination::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_combination=new _qtw_filter_combination(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(COMBINATION_PRODUCT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["operation"]=="default") parameter1(COMBINATION_PRODUCT);
+      else parameter1(Operations_inv[Parameters["operation"]]);
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of COMBINATION filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -162,23 +186,23 @@ _filter_combination_ui::_filter_combination_ui(_gl_widget *GL_widget1,std::strin
  *
  *****************************************************************************/
 
-_filter_combination_ui::_filter_combination_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_combination::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_combination=new _qtw_filter_combination(GL_widget1,this,Name1);
+  Parameters["operation"]=Operations[parameter1()];
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_combination_ui::~_filter_combination_ui()
+_filter_combination_ui::_filter_combination_ui(_gl_widget *GL_widget1,std::string Name1)
 {
-  delete Qtw_filter_combination;
+  Name=Name1;
+  Qtw_filter_combination=new _qtw_filter_combination(GL_widget1,this,Name1);
 }
 
 
@@ -188,11 +212,11 @@ _filter_combination_ui::~_filter_combination_ui()
  *
  *****************************************************************************/
 
-void _filter_combination_ui::reset_data()
+_filter_combination_ui::_filter_combination_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_combination::reset_data();
-  Qtw_filter_combination->set_parameter1(parameter1());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_combination=new _qtw_filter_combination(GL_widget1,this,Name1);
 }
 
 
@@ -202,9 +226,9 @@ void _filter_combination_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_combination_ui::show()
+_filter_combination_ui::~_filter_combination_ui()
 {
-  Qtw_filter_combination->show();
+  delete Qtw_filter_combination;
 }
 
 
@@ -214,9 +238,11 @@ void _filter_combination_ui::show()
  *
  *****************************************************************************/
 
-void _filter_combination_ui::hide()
+void _filter_combination_ui::reset_data()
 {
-  Qtw_filter_combination->hide();
+  _filter_combination::reset_data();
+  Qtw_filter_combination->set_parameter1(parameter1());
+  hide();
 }
 
 
@@ -226,9 +252,9 @@ void _filter_combination_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_combination_ui::get_link()
+void _filter_combination_ui::show()
 {
-  return Qtw_filter_combination->get_link();
+  Qtw_filter_combination->show();
 }
 
 
@@ -238,23 +264,9 @@ void *_filter_combination_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_combination_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_combination_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(COMBINATION_PRODUCT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["operation"]=="default") parameter1(COMBINATION_PRODUCT);
-      else parameter1(Operations_inv[Parameters["operation"]]);
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of COMBINATION filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_combination->hide();
 }
 
 
@@ -264,9 +276,9 @@ void _filter_combination_ui::read_parameters(std::map<std::string,std::string> &
  *
  *****************************************************************************/
 
-void _filter_combination_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_combination_ui::get_link()
 {
-  Parameters["operation"]=Operations[parameter1()];
+  return Qtw_filter_combination->get_link();
 }
 
 
@@ -332,6 +344,8 @@ void _qtw_filter_combination::set_parameter1(_combination_type Value)
 
 void _qtw_filter_combination::set_parameter1_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter1_slot(Value);})) return;
   Filter->parameter1((_combination_type) Value);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -17,13 +17,17 @@
 #ifndef _FILTER_COMBINATION_H
 #define _FILTER_COMBINATION_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QComboBox>
+#endif
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -72,8 +76,15 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string, std::string> &Parameters);
+
+    void parameter1(_f_combination_ns:: _combination_type Value){_filter_combination::combination_type(Value);};
+    _f_combination_ns::_combination_type parameter1(){return _filter_combination::combination_type();};
+
 
     void update();
+    int halo(){return 0;};
 
     void combination_type(_f_combination_ns::_combination_type Combination_type1){Combination_type=Combination_type1;};
     _f_combination_ns::_combination_type combination_type(){return Combination_type;};
@@ -84,6 +95,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -101,11 +113,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(_f_combination_ns:: _combination_type Value){_filter_combination::combination_type(Value);};
-  _f_combination_ns::_combination_type parameter1(){return _filter_combination::combination_type();};
 
   private:
   _qtw_filter_combination *Qtw_filter_combination;
@@ -145,4 +152,5 @@ private:
   _filter_combination_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,9 @@
 
 
 #include "filter_contrast_bright.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_contrast_bright_ns;
 
@@ -69,8 +71,7 @@ void _filter_contrast_bright::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -78,9 +79,7 @@ void _filter_contrast_bright::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
 
       Aux_input_image->convertTo(Aux_float_image,CV_32F);
     }
@@ -96,8 +95,7 @@ void _filter_contrast_bright::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       Aux_float_image.convertTo(*Aux_output_image,CV_8UC1);
 
@@ -109,8 +107,8 @@ void _filter_contrast_bright::update()
     Aux_float_image.convertTo(*Output_image_0,CV_8UC1);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -144,10 +142,24 @@ void _filter_contrast_bright::bright(float Bright1)
  *
  *****************************************************************************/
 
-_filter_contrast_bright_ui::_filter_contrast_bright_ui(_gl_widget *GL_widget1,std::string Box_name)
+void _filter_contrast_bright::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Box_name;
-  Qtw_filter_contrast_bright=new _qtw_filter_contrast_bright(GL_widget1,this,Box_name);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(CANNY_CONTRAST_DEFAULT);
+    parameter2(CANNY_BRIGHT_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["contrast"]=="default") parameter1(CANNY_CONTRAST_DEFAULT);
+      else parameter1(atof(Parameters["contrast"].c_str()));
+      if (Parameters["bright"]=="default") parameter2(CANNY_BRIGHT_DEFAULT);
+      else parameter2(atof(Parameters["bright"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of CONTRAST filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -157,23 +169,28 @@ _filter_contrast_bright_ui::_filter_contrast_bright_ui(_gl_widget *GL_widget1,st
  *
  *****************************************************************************/
 
-_filter_contrast_bright_ui::_filter_contrast_bright_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Box_name)
+void _filter_contrast_bright::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Box_name;
-  Qtw_filter_contrast_bright=new _qtw_filter_contrast_bright(GL_widget1,this,Box_name);
+  char Aux[100];
+
+  sprintf(Aux,"%5.2f",parameter1());
+  Parameters["contrast"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["bright"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_contrast_bright_ui::~_filter_contrast_bright_ui()
+_filter_contrast_bright_ui::_filter_contrast_bright_ui(_gl_widget *GL_widget1,std::string Box_name)
 {
-  delete Qtw_filter_contrast_bright;
+  Name=Box_name;
+  Qtw_filter_contrast_bright=new _qtw_filter_contrast_bright(GL_widget1,this,Box_name);
 }
 
 
@@ -183,12 +200,11 @@ _filter_contrast_bright_ui::~_filter_contrast_bright_ui()
  *
  *****************************************************************************/
 
-void _filter_contrast_bright_ui::reset_data()
+_filter_contrast_bright_ui::_filter_contrast_bright_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Box_name)
 {
-  _filter_contrast_bright::reset_data();
-  Qtw_filter_contrast_bright->set_parameter1(parameter1());
-  Qtw_filter_contrast_bright->set_parameter2(parameter2());
-  hide();
+  read_parameters(Parameters);
+  Name=Box_name;
+  Qtw_filter_contrast_bright=new _qtw_filter_contrast_bright(GL_widget1,this,Box_name);
 }
 
 
@@ -198,9 +214,9 @@ void _filter_contrast_bright_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_contrast_bright_ui::show()
+_filter_contrast_bright_ui::~_filter_contrast_bright_ui()
 {
-  Qtw_filter_contrast_bright->show();
+  delete Qtw_filter_contrast_bright;
 }
 
 
@@ -210,9 +226,12 @@ void _filter_contrast_bright_ui::show()
  *
  *****************************************************************************/
 
-void _filter_contrast_bright_ui::hide()
+void _filter_contrast_bright_ui::reset_data()
 {
-  Qtw_filter_contrast_bright->hide();
+  _filter_contrast_bright::reset_data();
+  Qtw_filter_contrast_bright->set_parameter1(parameter1());
+  Qtw_filter_contrast_bright->set_parameter2(parameter2());
+  hide();
 }
 
 
@@ -222,9 +241,9 @@ void _filter_contrast_bright_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_contrast_bright_ui::get_link()
+void _filter_contrast_bright_ui::show()
 {
-  return Qtw_filter_contrast_bright->get_link();
+  Qtw_filter_contrast_bright->show();
 }
 
 
@@ -234,26 +253,9 @@ void *_filter_contrast_bright_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_contrast_bright_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_contrast_bright_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(CANNY_CONTRAST_DEFAULT);
-    parameter2(CANNY_BRIGHT_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["contrast"]=="default") parameter1(CANNY_CONTRAST_DEFAULT);
-      else parameter1(atof(Parameters["contrast"].c_str()));
-      if (Parameters["bright"]=="default") parameter2(CANNY_BRIGHT_DEFAULT);
-      else parameter2(atof(Parameters["bright"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of CONTRAST filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_contrast_bright->hide();
 }
 
 
@@ -263,14 +265,9 @@ void _filter_contrast_bright_ui::read_parameters(std::map<std::string,std::strin
  *
  *****************************************************************************/
 
-void _filter_contrast_bright_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_contrast_bright_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%5.2f",parameter1());
-  Parameters["contrast"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["bright"]=std::string(Aux);
+  return Qtw_filter_contrast_bright->get_link();
 }
 
 
@@ -419,6 +416,7 @@ void _qtw_filter_contrast_bright::set_parameter2(int Value)
 
 void _qtw_filter_contrast_bright::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
   float Value=(float) Size/(float)Parameter1_divisor;
@@ -439,6 +437,7 @@ void _qtw_filter_contrast_bright::set_parameter1_slot(int Size)
 
 void _qtw_filter_contrast_bright::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -448,3 +447,4 @@ void _qtw_filter_contrast_bright::set_parameter2_slot(int Size)
   Filter->parameter2(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -17,11 +17,13 @@
 #ifndef _FILTER_CONTRAST_BRIGHT_H
 #define _FILTER_CONTRAST_BRIGHT_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -81,7 +83,17 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string,std::string> &Parameters);
+
+    void parameter1(float Value){_filter_contrast_bright::contrast(Value);};
+    float parameter1(){return _filter_contrast_bright::contrast();};
+
+    void parameter2(int Value){_filter_contrast_bright::bright(Value);};  
+    int parameter2(){return _filter_contrast_bright::bright();};
+
     void update();
+    int halo(){return 0;};
     void contrast(float Contrast1);
     void bright(float Bright1);
 
@@ -93,6 +105,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -107,18 +120,9 @@ public:
   ~_filter_contrast_bright_ui();
   void reset_data();
 
-
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
-
-  void parameter1(float Value){_filter_contrast_bright::contrast(Value);};
-  float parameter1(){return _filter_contrast_bright::contrast();};
-
-  void parameter2(int Value){_filter_contrast_bright::bright(Value);};  
-  int parameter2(){return _filter_contrast_bright::bright();};
 
 private:
   _qtw_filter_contrast_bright *Qtw_filter_contrast_bright;
@@ -166,4 +170,5 @@ private:
   _filter_contrast_bright_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,9 @@
 
 
 #include "filter_distance_field.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_distance_field_ns;
 
@@ -176,9 +178,10 @@ void _filter_distance_field::jump_flooding(cv::Mat *Input_image,cv::Mat *Output_
   }
 
   float Value;
+  float Line_width1=(float)proxy_length(Line_width);
   for (unsigned int i=0;i<Input_image->total();i++){
     Value=(*Write)[i].Distance;
-    Value=Value/(float) Line_width;
+    Value=Value/Line_width1;
     if ((int)Value%2==0) Value=255;
     else Value=0;
     Output_image->at<unsigned char>(i)=(int)Value;
@@ -200,8 +203,7 @@ void _filter_distance_field::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -209,9 +211,7 @@ void _filter_distance_field::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -223,8 +223,7 @@ void _filter_distance_field::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       jump_flooding(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
@@ -235,8 +234,8 @@ void _filter_distance_field::update()
     jump_flooding(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -246,10 +245,21 @@ void _filter_distance_field::update()
  *
  *****************************************************************************/
 
-_filter_distance_field_ui::_filter_distance_field_ui(_gl_widget *GL_widget1,std::string Name1)
+void _filter_distance_field::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_distance_field=new _qtw_filter_distance_field(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(DISTANCE_FIELD_LINE_WIDTH_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["line_width"]=="default") parameter1(DISTANCE_FIELD_LINE_WIDTH_DEFAULT);
+      else parameter1(atoi(Parameters["line_width"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of DISTACE FIELD filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -259,23 +269,26 @@ _filter_distance_field_ui::_filter_distance_field_ui(_gl_widget *GL_widget1,std:
  *
  *****************************************************************************/
 
-_filter_distance_field_ui::_filter_distance_field_ui(_gl_widget *GL_widget1, std::map<std::string,std::string> &Parameters, std::string Name1)
+void _filter_distance_field::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_distance_field=new _qtw_filter_distance_field(GL_widget1,this,Name1);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["line_width"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_distance_field_ui::~_filter_distance_field_ui()
+_filter_distance_field_ui::_filter_distance_field_ui(_gl_widget *GL_widget1,std::string Name1)
 {
-  delete Qtw_filter_distance_field;
+  Name=Name1;
+  Qtw_filter_distance_field=new _qtw_filter_distance_field(GL_widget1,this,Name1);
 }
 
 
@@ -285,11 +298,11 @@ _filter_distance_field_ui::~_filter_distance_field_ui()
  *
  *****************************************************************************/
 
-void _filter_distance_field_ui::reset_data()
+_filter_distance_field_ui::_filter_distance_field_ui(_gl_widget *GL_widget1, std::map<std::string,std::string> &Parameters, std::string Name1)
 {
-  _filter_distance_field::reset_data();
-  Qtw_filter_distance_field->set_parameter1(parameter1());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_distance_field=new _qtw_filter_distance_field(GL_widget1,this,Name1);
 }
 
 
@@ -299,9 +312,9 @@ void _filter_distance_field_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_distance_field_ui::show()
+_filter_distance_field_ui::~_filter_distance_field_ui()
 {
-  Qtw_filter_distance_field->show();
+  delete Qtw_filter_distance_field;
 }
 
 
@@ -311,9 +324,11 @@ void _filter_distance_field_ui::show()
  *
  *****************************************************************************/
 
-void _filter_distance_field_ui::hide()
+void _filter_distance_field_ui::reset_data()
 {
-  Qtw_filter_distance_field->hide();
+  _filter_distance_field::reset_data();
+  Qtw_filter_distance_field->set_parameter1(parameter1());
+  hide();
 }
 
 
@@ -323,9 +338,9 @@ void _filter_distance_field_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_distance_field_ui::get_link()
+void _filter_distance_field_ui::show()
 {
-  return Qtw_filter_distance_field->get_link();
+  Qtw_filter_distance_field->show();
 }
 
 
@@ -335,23 +350,9 @@ void *_filter_distance_field_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_distance_field_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_distance_field_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(DISTANCE_FIELD_LINE_WIDTH_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["line_width"]=="default") parameter1(DISTANCE_FIELD_LINE_WIDTH_DEFAULT);
-      else parameter1(atoi(Parameters["line_width"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of DISTACE FIELD filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_distance_field->hide();
 }
 
 
@@ -361,12 +362,9 @@ void _filter_distance_field_ui::read_parameters(std::map<std::string,std::string
  *
  *****************************************************************************/
 
-void _filter_distance_field_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_distance_field_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["line_width"]=std::string(Aux);
+  return Qtw_filter_distance_field->get_link();
 }
 
 
@@ -455,6 +453,7 @@ void _qtw_filter_distance_field::set_parameter1(int Value)
 
 void _qtw_filter_distance_field::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -464,3 +463,4 @@ void _qtw_filter_distance_field::set_parameter1_slot(int Size)
   Filter->parameter1(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
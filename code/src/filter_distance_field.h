@@ -1,11 +1,13 @@
 #ifndef _FILTER_DISTANCE_FIELD_H
 #define _FILTER_DISTANCE_FIELD_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -57,6 +59,12 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string,std::string> &Parameters);
+
+    void parameter1(int Value){_filter_distance_field::line_width(Value);};
+    int parameter1(){return _filter_distance_field::line_width();};
+
     void jump_flooding(cv::Mat *Input_image,cv::Mat *Output_image);
     void update();
     void line_width(int Line_width1){Line_width=Line_width1;}
@@ -67,6 +75,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -84,11 +93,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
-
-  void parameter1(int Value){_filter_distance_field::line_width(Value);};
-  int parameter1(){return _filter_distance_field::line_width();};
 
 private:
   _qtw_filter_distance_field *Qtw_filter_distance_field;
@@ -130,4 +134,5 @@ private:
   _filter_distance_field_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
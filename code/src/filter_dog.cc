@@ -15,7 +15,9 @@
 
 
 #include "filter_dog.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_dog_ns;
 
@@ -69,8 +71,7 @@ void _filter_dog::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -78,9 +79,7 @@ void _filter_dog::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -92,8 +91,10 @@ void _filter_dog::update()
 
   Borders_dog_big.create(Aux_input_image->rows,Aux_input_image->cols,CV_8U);
   Borders_dog_small.create(Aux_input_image->rows,Aux_input_image->cols,CV_8U);
-  cv::GaussianBlur(*Aux_input_image, Borders_dog_big,cv::Size(Big_gaussian_size,Big_gaussian_size),0,0);
-  cv::GaussianBlur(*Aux_input_image, Borders_dog_small,cv::Size(Small_gaussian_size,Small_gaussian_size),0,0);
+  int Big_gaussian_size1=proxy_kernel_size(Big_gaussian_size);
+  int Small_gaussian_size1=proxy_kernel_size(Small_gaussian_size);
+  cv::GaussianBlur(*Aux_input_image, Borders_dog_big,cv::Size(Big_gaussian_size1,Big_gaussian_size1),0,0);
+  cv::GaussianBlur(*Aux_input_image, Borders_dog_small,cv::Size(Small_gaussian_size1,Small_gaussian_size1),0,0);
   Borders_dog_big=Borders_dog_big-Borders_dog_small;
   //invert
   Borders_dog_big=255-Borders_dog_big;
@@ -111,7 +112,7 @@ void _filter_dog::update()
     *Output_image_0=Borders_dog_big;
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
 }
 
 
@@ -151,6 +152,56 @@ void _filter_dog::small_gaussian_size(int Size)
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_dog::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(DOG_UMBRAL_DEFAULT);
+    parameter2(DOG_BIG_GAUSSIAN_SIZE_DEFAULT);
+    parameter3(DOG_SMALL_GAUSSIAN_SIZE_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["umbral"]=="default") parameter1(DOG_UMBRAL_DEFAULT);
+      else parameter1(atoi(Parameters["umbral"].c_str()));
+      if (Parameters["kernel_size_big"]=="default") parameter2(DOG_BIG_GAUSSIAN_SIZE_DEFAULT);
+      else parameter2(atoi(Parameters["kernel_size_big"].c_str()));
+      if (Parameters["kernel_size_small"]=="default") parameter3(DOG_SMALL_GAUSSIAN_SIZE_DEFAULT);
+      else parameter3(atoi(Parameters["kernel_size_small"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of DOG filter" << std::endl;
+      exit(-1);
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_dog::write_parameters(std::map<std::string, std::string> &Parameters)
+{
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["umbral"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["kernel_size_big"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter3());
+  Parameters["kernel_size_small"]=std::string(Aux);
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -242,57 +293,6 @@ void *_filter_dog_ui::get_link()
 }
 
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_dog_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(DOG_UMBRAL_DEFAULT);
-    parameter2(DOG_BIG_GAUSSIAN_SIZE_DEFAULT);
-    parameter3(DOG_SMALL_GAUSSIAN_SIZE_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["umbral"]=="default") parameter1(DOG_UMBRAL_DEFAULT);
-      else parameter1(atoi(Parameters["umbral"].c_str()));
-      if (Parameters["kernel_size_big"]=="default") parameter2(DOG_BIG_GAUSSIAN_SIZE_DEFAULT);
-      else parameter2(atoi(Parameters["kernel_size_big"].c_str()));
-      if (Parameters["kernel_size_small"]=="default") parameter3(DOG_SMALL_GAUSSIAN_SIZE_DEFAULT);
-      else parameter3(atoi(Parameters["kernel_size_small"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of DOG filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_dog_ui::write_parameters(std::map<std::string, std::string> &Parameters)
-{
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["umbral"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["kernel_size_big"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter3());
-  Parameters["kernel_size_small"]=std::string(Aux);
-}
-
-
 /*****************************************************************************//**
  *
  *
@@ -481,6 +481,7 @@ void _qtw_filter_dog::set_parameter3(int Value)
 
 void _qtw_filter_dog::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -500,6 +501,7 @@ void _qtw_filter_dog::set_parameter1_slot(int Size)
 
 void _qtw_filter_dog::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -521,6 +523,7 @@ void _qtw_filter_dog::set_parameter2_slot(int Size)
 
 void _qtw_filter_dog::set_parameter3_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter3_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -531,3 +534,4 @@ void _qtw_filter_dog::set_parameter3_slot(int Size)
   Filter->parameter3(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -17,14 +17,18 @@
 #ifndef _FILTER_DOG_H
 #define _FILTER_DOG_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
+#endif
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -99,8 +103,20 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string,std::string> &Parameters);
+
+    void parameter1(int Value){_filter_dog::dog_umbral(Value);};
+    void parameter2(int Value){_filter_dog::big_gaussian_size(Value);};
+    void parameter3(int Value){_filter_dog::small_gaussian_size(Value);};
+
+    int parameter1(){return _filter_dog::dog_umbral();};
+    int parameter2(){return _filter_dog::big_gaussian_size();};
+    int parameter3(){return _filter_dog::small_gaussian_size();};
+
 
     void update();
+    int halo(){return proxy_kernel_size(std::max(Big_gaussian_size,Small_gaussian_size))/2;};
     void dog_umbral(int Umbral);
     void big_gaussian_size(int Size);
     void small_gaussian_size(int Size);
@@ -113,6 +129,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -130,16 +147,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
-
-  void parameter1(int Value){_filter_dog::dog_umbral(Value);};
-  void parameter2(int Value){_filter_dog::big_gaussian_size(Value);};
-  void parameter3(int Value){_filter_dog::small_gaussian_size(Value);};
-
-  int parameter1(){return _filter_dog::dog_umbral();};
-  int parameter2(){return _filter_dog::big_gaussian_size();};
-  int parameter3(){return _filter_dog::small_gaussian_size();};
 
   private:
   _qtw_filter_dog *Qtw_filter_dog;
@@ -193,4 +200,5 @@ private:
   _filter_dog_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,11 +15,35 @@
 
 
 #include "filter_dot_ebg.h"
+#include "vector_writer.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_dot_ebg_ns;
 
 
+/*****************************************************************************//**
+ * A random value between Min and Max that only depends on the position of the
+ * pixel and the seed. It is used in the computation by tiles, where the pixels
+ * are not visited in the same order
+ *
+ *****************************************************************************/
+
+static int position_value(int Row,int Col,unsigned int Seed,int Min,int Max)
+{
+  uint32_t Value=Seed^((uint32_t)Row*0x9E3779B1u)^((uint32_t)Col*0x85EBCA77u);
+
+  Value^=Value>>16;
+  Value*=0x7FEB352Du;
+  Value^=Value>>15;
+  Value*=0x846CA68Bu;
+  Value^=Value>>16;
+
+  return Min+(int)(Value%(uint32_t)(Max-Min+1));
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -77,18 +101,6 @@ void _filter_dot_ebg::reset_data()
 }
 
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_dot_ebg::set_dots_images(std::vector<std::vector<cv::Mat *> > *Dots1)
-{
-  Dots=Dots1;
-}
-
-
 /*****************************************************************************//**
  *
  *
@@ -102,8 +114,7 @@ void _filter_dot_ebg::pixel_density(_f_dot_ebg_ns::_pixel_density Pixel_density1
     Scaling_factor=_f_dot_ebg_ns::VEC_PIXEL_DENSITY_FACTOR[(int)Pixel_density];
 
     // the size of the output image must be changed
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows*Scaling_factor,Input_image_0->cols*Scaling_factor,CV_8U);
+    create_output_image(Input_image_0->rows*Scaling_factor,Input_image_0->cols*Scaling_factor,CV_8U);
   }
 }
 
@@ -129,10 +140,10 @@ void _filter_dot_ebg::put_dot(cv::Mat *Output_image0,float Row1,float Col1,unsig
     for (Col=0;Col<(int)(Selected_dot_size1*Scaling_factor);Col++){
       // get the value of the image of dots of size Selected_dot_size1
 
-      Value=(*Dots)[(int)Pixel_density][Selected_dot_size1]->at<unsigned char>(Row+Row_aux,Col+Col_aux);
-      // output position
-      Row_out=Row1+Row;
-      Col_out=Col1+Col;
+      Value=(*Dots)[Selected_dot_size1].at<unsigned char>(Row+Row_aux,Col+Col_aux);
+      // output position (Row1 and Col1 are in the complete image)
+      Row_out=(int)(Row1+Row)-Tile_origin.y;
+      Col_out=(int)(Col1+Col)-Tile_origin.x;
 
       if (Row_out<0 || Row_out>=Output_image0->rows || Col_out<0 || Col_out>=Output_image0->cols) continue;
       // the row and col are correct, the color is changed
@@ -147,80 +158,42 @@ void _filter_dot_ebg::put_dot(cv::Mat *Output_image0,float Row1,float Col1,unsig
 
 
 /*****************************************************************************//**
- * computes the stippling process
- *
- *
+ * The dots are written one by one as circles, so the number of dots is not limited
+ * by the memory
  *
  *****************************************************************************/
 
-void _filter_dot_ebg::stippling_svg(QPainter &Painter)
+bool _filter_dot_ebg::save_vector(std::string File_name1)
 {
-  int Row,Col,Selected_dot_size;
-  float Pos_row,Pos_col;
-  _vertex2f Position;
-  unsigned int Counter_of_dots=0;
+  _vector_writer Writer;
+  int Selected_dot_size;
   unsigned int Gray_value;
 
-  cv::flip(*Input_image_0,*Input_image_0,0);
-
-  QPainterPath starPath;
-  starPath.moveTo(90,50);
-  for (int i = 1; i < 5; ++i) {
-    starPath.lineTo(50 + 40* std::cos(0.8 * i * M_PI),50 + 40* std::sin(0.8 * i * M_PI));
+  if (Writer.open(File_name1,Output_image_0->cols,Output_image_0->rows)==false){
+    warning("Filter Dot EBG","Error: the dots cannot be saved in "+File_name1);
+    return false;
   }
-  starPath.closeSubpath();
-  starPath.setFillRule(Qt::WindingFill);
-
-  QPainterPath textPath;
-  QFont timesFont("Times", 50);
-  timesFont.setStyleStrategy(QFont::ForceOutline);
-  textPath.addText(10,70, timesFont,"@");
 
-  Index_row.init(0,Num_rows_dot_matrix-1);
-  Index_col.init(0,Num_cols_dot_matrix-1);
   Dot_size.init(Dot_size_min,Dot_size_max);
-
-  Index_row.set_seed(1000);
   Dot_size.set_seed(5000);
-  Index_col.set_seed(300);
 
-  for (Row=0;Row<Input_image_0->rows;Row++){
-    for (Col=0;Col<Input_image_0->cols;Col++){
-      if (Input_image_0->at<unsigned char>(Row,Col)==BLACK){
-        // compute a random dot size
-        if (Modulate_dot_size==false) Selected_dot_size=Dot_size.value();
-        else{
-          Gray_value=255-Input_image_1->at<unsigned char>(Row,Col);
-          Selected_dot_size=Gray_value/52+4;
-        }
-
-        Pos_row=(float)Row*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
-        Pos_col=(float)Col*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
-
-        // for dot
-        Painter.drawEllipse(QPoint(Pos_col,Pos_row),Selected_dot_size,Selected_dot_size);
-
-        // for star
-//        Scale=((0.4-0.2)*(Selected_dot_size-4)/(8-4))+0.2; // for star
-//        Painter.save();
-//        Painter.translate(Pos_col,Pos_row);
-//        Painter.rotate(-90); // for star
-//        Painter.scale(Scale,Scale);
-//        Painter.drawPath(starPath); // for star
-//        Painter.restore();
-
-        // for text
-//        Scale=((0.6-0.3)*(Selected_dot_size-4)/(8-4))+0.3; // for text
-//        Painter.save();
-//        Painter.translate(Pos_col,Pos_row);
-//        Painter.scale(Scale,Scale);
-//        Painter.drawPath(textPath);
-//        Painter.restore();
-      }
+  for_each_dot(Input_image_0,[&](float Row,float Col){
+    // compute a random dot size
+    if (Modulate_dot_size==false) Selected_dot_size=Dot_size.value();
+    else{
+      Gray_value=255-Input_image_1->at<unsigned char>((int)Row,(int)Col);
+      Selected_dot_size=Gray_value/52+4;
     }
-  }
 
-  set_info1(Counter_of_dots);
+    // the images of the dots have Selected_dot_size*Scaling_factor pixels
+    Writer.dot(Col*Scaling_factor,Row*Scaling_factor,(float)Selected_dot_size*Scaling_factor/2);
+  });
+
+  if (Writer.close()==false){
+    warning("Filter Dot EBG","Error: the dots cannot be saved in "+File_name1);
+    return false;
+  }
+  return true;
 }
 
 
@@ -232,7 +205,7 @@ void _filter_dot_ebg::stippling_svg(QPainter &Painter)
 
 void _filter_dot_ebg::stippling(cv::Mat *Input_image0,cv::Mat *Input_image1,cv::Mat *Output_image0)
 {
-  int Row,Col,Selected_dot_size;
+  int Selected_dot_size;
   float Pos_row,Pos_col;
   int Selected_row,Selected_col;
   _vertex2f Position;
@@ -247,28 +220,40 @@ void _filter_dot_ebg::stippling(cv::Mat *Input_image0,cv::Mat *Input_image1,cv::
   Dot_size.set_seed(5000);
   Index_col.set_seed(300);
 
-  for (Row=0;Row<Input_image0->rows;Row++){
-    for (Col=0;Col<Input_image0->cols;Col++){
-      if (Input_image0->at<unsigned char>(Row,Col)==BLACK){
-        // compute a random dot size
-        if (Modulate_dot_size==false) Selected_dot_size=Dot_size.value();
-        else{
-          Gray_value=255-Input_image1->at<unsigned char>(Row,Col);
-          Selected_dot_size=Gray_value/52+4; // 52 to get 5 values
-        }
-
-        Counter_of_dots++;
-        //
-        Selected_row=Index_row.value();
-        Selected_col=Index_col.value();
-
-        Pos_row=(float)Row*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
-        Pos_col=(float)Col*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
-
-        put_dot(Output_image0,Pos_row,Pos_col,Selected_dot_size,Selected_row,Selected_col);
-      }
+  // a dot for each black pixel. The position can have decimals
+  auto Put_dot=[&](float Row,float Col){
+    // position in the complete image
+    float Row_image=Row+Tile_origin.y;
+    float Col_image=Col+Tile_origin.x;
+
+    // compute a random dot size
+    if (Modulate_dot_size==false){
+      if (Tiled) Selected_dot_size=position_value((int)Row_image,(int)Col_image,5000,Dot_size_min,Dot_size_max);
+      else Selected_dot_size=Dot_size.value();
     }
-  }
+    else{
+      Gray_value=255-Input_image1->at<unsigned char>((int)Row,(int)Col);
+      Selected_dot_size=Gray_value/52+4; // 52 to get 5 values
+    }
+
+    Counter_of_dots++;
+    //
+    if (Tiled){
+      Selected_row=position_value((int)Row_image,(int)Col_image,1000,0,Num_rows_dot_matrix-1);
+      Selected_col=position_value((int)Row_image,(int)Col_image,300,0,Num_cols_dot_matrix-1);
+    }
+    else{
+      Selected_row=Index_row.value();
+      Selected_col=Index_col.value();
+    }
+
+    Pos_row=Row_image*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
+    Pos_col=Col_image*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
+
+    put_dot(Output_image0,Pos_row,Pos_col,Selected_dot_size,Selected_row,Selected_col);
+  };
+
+  for_each_dot(Input_image0,Put_dot);
 
   set_info1(Counter_of_dots);
 }
@@ -282,14 +267,14 @@ void _filter_dot_ebg::stippling(cv::Mat *Input_image0,cv::Mat *Input_image1,cv::
 
 void _filter_dot_ebg::update()
 {
+  // the images of dots are read the first time that they are used
+  Dots=dots_packet((int)Pixel_density);
+
   if (Input_image_0->cols!=Input_image_1->cols || Input_image_0->rows!=Input_image_1->rows){
-    QMessageBox MsgBox;
-    MsgBox.setText("Filter Dot EBG");
-    MsgBox.setInformativeText("Warning: the input images must have the same sizes");
-    MsgBox.setStandardButtons(QMessageBox::Ok);
-    MsgBox.exec();
+    warning("Filter Dot EBG","Warning: the input images must have the same sizes");
     copy_input_to_output();
   }
+  else if (Dots==nullptr) copy_input_to_output();
   else{
     cv::Mat *Aux_input_image0=nullptr;
     cv::Mat *Aux_input_image1=nullptr;
@@ -297,8 +282,7 @@ void _filter_dot_ebg::update()
 
     // check the output size
     if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-      Output_image_0->release();
-      Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
     }
 
     // Check the number of input channels of input image 1
@@ -306,9 +290,7 @@ void _filter_dot_ebg::update()
       if (Input_image_0->channels()==3){
         // conversion
 
-        Aux_input_image0=new cv::Mat;
-        Aux_input_image0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-        cvtColor(*Input_image_0,*Aux_input_image0,cv::COLOR_BGR2GRAY,1);
+        Aux_input_image0=new_gray_image(Input_image_0);
       }
       else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
     }
@@ -321,9 +303,7 @@ void _filter_dot_ebg::update()
       if (Input_image_1->channels()==3){
         // conversion
 
-        Aux_input_image1=new cv::Mat;
-        Aux_input_image1->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-        cvtColor(*Input_image_0,*Aux_input_image1,cv::COLOR_BGR2GRAY,1);
+        Aux_input_image1=new_gray_image(Input_image_0);
       }
       else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
     }
@@ -335,8 +315,7 @@ void _filter_dot_ebg::update()
     if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
       if (Output_image_0->channels()==3){
         // conversion
-        Aux_output_image=new cv::Mat;
-        Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+        Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
         // set the output image to white
         Output_image_0->setTo(cv::Scalar(255,255,255));
@@ -351,13 +330,26 @@ void _filter_dot_ebg::update()
       stippling(Aux_input_image0,Aux_input_image1,Output_image_0);
     }
 
-    if (Aux_input_image0!=nullptr && Aux_input_image0!=Input_image_0) delete Aux_input_image0;
-    if (Aux_input_image1!=nullptr && Aux_input_image1!=Input_image_1) delete Aux_input_image1;
-    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+    if (Aux_input_image0!=nullptr && Aux_input_image0!=Input_image_0) delete_aux_image(Aux_input_image0);
+    if (Aux_input_image1!=nullptr && Aux_input_image1!=Input_image_1) delete_aux_image(Aux_input_image1);
+    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
   }
 }
 
 
+/*****************************************************************************//**
+ * A dot is drawn around its pixel. With other scaling factor the output is not
+ * aligned with the input
+ *
+ *****************************************************************************/
+
+int _filter_dot_ebg::halo()
+{
+  if (Scaling_factor!=1) return -1;
+  return std::max(Dot_size_max,(int)MAX_DOT_SIZE)/2+1;
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -386,6 +378,83 @@ void _filter_dot_ebg::load_seeds()
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_dot_ebg::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(DOT_EBG_PIXEL_DENSITY_DEFAULT);
+    parameter2(DOT_EBG_MODULATE_DOT_SIZE_DEFAULT);
+    parameter3(DOT_EBG_BLACK_DOTS_DEFAULT);
+    parameter4(DOT_EBG_BLACK_THRESHOLD_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["pixel_density"]=="default") parameter1(DOT_EBG_PIXEL_DENSITY_DEFAULT);
+      else{
+        if (Parameters["pixel_density"]=="300PPI") parameter1(_f_dot_ebg_ns::PIXEL_DENSITY_300PPI);
+        if (Parameters["pixel_density"]=="600PPI") parameter1(_f_dot_ebg_ns::PIXEL_DENSITY_600PPI);
+        if (Parameters["pixel_density"]=="1200PPI") parameter1(_f_dot_ebg_ns::PIXEL_DENSITY_1200PPI);
+      }
+
+      if (Parameters["modulate_dot_size"]=="default") parameter2(DOT_EBG_MODULATE_DOT_SIZE_DEFAULT);
+      else{
+        if (Parameters["modulate_dot_size"]=="true") parameter2(true);
+        else parameter2(false);
+      }
+
+      if (Parameters["black_dots"]=="default") parameter3(DOT_EBG_BLACK_DOTS_DEFAULT);
+      else{
+        if (Parameters["black_dots"]=="true") parameter3(true);
+        else parameter3(false);
+      }
+
+      if (Parameters["black_threshold"]=="default") parameter4(DOT_EBG_BLACK_THRESHOLD_DEFAULT);
+      else parameter4(atoi(Parameters["black_threshold"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of STIPPLING_EBG filter" << std::endl;
+      exit(-1);
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_dot_ebg::write_parameters(std::map<std::string,std::string> &Parameters)
+{
+  char Aux[100];
+
+  switch((int)parameter1()){
+  case 0:sprintf(Aux,"%s","300PPI");break;
+  case 1:sprintf(Aux,"%s","600PPI");break;
+  case 2:sprintf(Aux,"%s","1200PPI");break;
+  }
+  Parameters["pixel_density"]=std::string(Aux);
+
+  if (parameter2()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["modulate_dot_size"]=std::string(Aux);
+
+  if (parameter3()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["black_dots"]=std::string(Aux);
+
+  sprintf(Aux,"%d",parameter4());
+  Parameters["black_threshold"]=std::string(Aux);
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -481,75 +550,9 @@ void *_filter_dot_ebg_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_dot_ebg_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(DOT_EBG_PIXEL_DENSITY_DEFAULT);
-    parameter2(DOT_EBG_MODULATE_DOT_SIZE_DEFAULT);
-    parameter3(DOT_EBG_BLACK_DOTS_DEFAULT);
-    parameter4(DOT_EBG_BLACK_THRESHOLD_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["pixel_density"]=="default") parameter1(DOT_EBG_PIXEL_DENSITY_DEFAULT);
-      else{
-        if (Parameters["pixel_density"]=="300PPI") parameter1(_f_dot_ebg_ns::PIXEL_DENSITY_300PPI);
-        if (Parameters["pixel_density"]=="600PPI") parameter1(_f_dot_ebg_ns::PIXEL_DENSITY_600PPI);
-        if (Parameters["pixel_density"]=="1200PPI") parameter1(_f_dot_ebg_ns::PIXEL_DENSITY_1200PPI);
-      }
-
-      if (Parameters["modulate_dot_size"]=="default") parameter2(DOT_EBG_MODULATE_DOT_SIZE_DEFAULT);
-      else{
-        if (Parameters["modulate_dot_size"]=="true") parameter2(true);
-        else parameter2(false);
-      }
-
-      if (Parameters["black_dots"]=="default") parameter3(DOT_EBG_BLACK_DOTS_DEFAULT);
-      else{
-        if (Parameters["black_dots"]=="true") parameter3(true);
-        else parameter3(false);
-      }
-
-      if (Parameters["black_threshold"]=="default") parameter4(DOT_EBG_BLACK_THRESHOLD_DEFAULT);
-      else parameter4(atoi(Parameters["black_threshold"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of STIPPLING_EBG filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_dot_ebg_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_dot_ebg_ui::set_info1(unsigned int Value1)
 {
-  char Aux[100];
-
-  switch((int)parameter1()){
-  case 0:sprintf(Aux,"%s","300PPI");break;
-  case 1:sprintf(Aux,"%s","600PPI");break;
-  case 2:sprintf(Aux,"%s","1200PPI");break;
-  }
-  Parameters["pixel_density"]=std::string(Aux);
-
-  if (parameter2()) sprintf(Aux,"%s","true");
-  else sprintf(Aux,"%s","false");
-  Parameters["modulate_dot_size"]=std::string(Aux);
-
-  if (parameter3()) sprintf(Aux,"%s","true");
-  else sprintf(Aux,"%s","false");
-  Parameters["black_dots"]=std::string(Aux);
-
-  sprintf(Aux,"%d",parameter4());
-  Parameters["black_threshold"]=std::string(Aux);
+  Info1=Value1;
 }
 
 
@@ -559,9 +562,9 @@ void _filter_dot_ebg_ui::write_parameters(std::map<std::string,std::string> &Par
  *
  *****************************************************************************/
 
-void _filter_dot_ebg_ui::set_info1(unsigned int Value1)
+void _filter_dot_ebg_ui::update_widgets()
 {
-  Qtw_filter_dot_ebg->set_info1(Value1);
+  Qtw_filter_dot_ebg->set_info1(Info1);
 }
 
 
@@ -782,6 +785,7 @@ void _qtw_filter_dot_ebg::set_info1(unsigned int Value)
 
 void _qtw_filter_dot_ebg::set_parameter1_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter1_slot(Value);})) return;
   Filter->parameter1(Value);
   GL_widget->update_effect(Filter->Name);
 }
@@ -795,6 +799,7 @@ void _qtw_filter_dot_ebg::set_parameter1_slot(int Value)
 
 void _qtw_filter_dot_ebg::set_parameter2_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter2_slot(Value);})) return;
   if (Value==Qt::Checked) Filter->parameter2(true);
   else Filter->parameter2(false);
   GL_widget->update_effect(Filter->Name);
@@ -809,6 +814,7 @@ void _qtw_filter_dot_ebg::set_parameter2_slot(int Value)
 
 void _qtw_filter_dot_ebg::set_parameter3_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter3_slot(Value);})) return;
   if (Value==Qt::Checked) Filter->parameter3(true);
   else Filter->parameter3(false);
   GL_widget->update_effect(Filter->Name);
@@ -823,6 +829,7 @@ void _qtw_filter_dot_ebg::set_parameter3_slot(int Value)
 
 void _qtw_filter_dot_ebg::set_parameter4_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter4_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -832,3 +839,4 @@ void _qtw_filter_dot_ebg::set_parameter4_slot(int Size)
   Filter->parameter4(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -17,16 +17,20 @@
 #ifndef _FILTER_DOT_EBG_H
 #define _FILTER_DOT_EBG_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include <QCheckBox>
 #include <QComboBox>
+#include <QPainter>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 #include "random.h"
+#include "vertex.h"
 
 #define DEFINED_FILTER_EXAMPLE_BASED_STIPPLING
 
@@ -121,10 +125,28 @@ public:
   ~_filter_dot_ebg(){};
   void reset_data();
   void update();
+  int halo();
+  // by tiles the dots are chosen by position, not by the sequence of the seeds
+  bool exact_by_tiles(){return false;};
 
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
 
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string, std::string> &Parameters);
+
+  void parameter1(int Resolution1){pixel_density((_f_dot_ebg_ns::_pixel_density) Resolution1);};
+  int parameter1(){return (int)pixel_density();};
+
+  void parameter2(bool Value){modulate_dot_size(Value);};
+  bool parameter2(){return modulate_dot_size();};
+
+  void parameter3(bool Value){black_dots(Value);};
+  bool parameter3(){return black_dots();};
+
+  void parameter4(unsigned int Value){black_threshold(Value);};
+  unsigned int parameter4(){return black_threshold();};
+
   void pixel_density(_f_dot_ebg_ns::_pixel_density Resolution1);
   _f_dot_ebg_ns::_pixel_density pixel_density(){return Pixel_density;};
 
@@ -137,13 +159,14 @@ public:
   void black_threshold(unsigned int Black_threshold1){Black_threshold=Black_threshold1;};
   unsigned int black_threshold(){return Black_threshold;};
 
-  void set_dots_images(std::vector<std::vector<cv::Mat *>> *Dots);
   void set_dots_texture_packet(int Dots_texture_packet1){Dots_texture_packet=Dots_texture_packet1;}
+  void write_internal_state(std::map<std::string,std::string> &State){State["_dots_texture_packet"]=std::to_string(Dots_texture_packet);};
 
   void put_dot(cv::Mat *Output_image1, float Row1, float Col1, unsigned int Selected_dot_size1, unsigned int Index_row1, unsigned int Index_col1);
   void stippling(cv::Mat *Input_image0, cv::Mat *Input_image1, cv::Mat *Output_image0);
 
-  void stippling_svg(QPainter &Painter);
+  // SVG, SVGZ, PDF or EPS
+  bool save_vector(std::string File_name1);
 
   void save_seeds();
   void load_seeds();
@@ -158,7 +181,8 @@ public:
   int Dot_size_min,Dot_size_max;
   int Dots_texture_packet;
   int Pixel_density_factor;
-  std::vector<std::vector<cv::Mat *>> *Dots;
+  // the packet of the dots cache that is used in the computation
+  std::vector<cv::Mat> *Dots;
 
   _random_uniform_int Index_row,Index_col;
   _random_uniform_int Dot_size;
@@ -170,6 +194,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -184,29 +209,18 @@ public:
   ~_filter_dot_ebg_ui();
   void reset_data();
 
-
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Resolution1){pixel_density((_f_dot_ebg_ns::_pixel_density) Resolution1);};
-  int parameter1(){return (int)pixel_density();};
-
-  void parameter2(bool Value){modulate_dot_size(Value);};
-  bool parameter2(){return modulate_dot_size();};
-
-  void parameter3(bool Value){black_dots(Value);};
-  bool parameter3(){return black_dots();};
-
-  void parameter4(unsigned int Value){black_threshold(Value);};
-  unsigned int parameter4(){return black_threshold();};
 
   void set_info1(unsigned int Value1);
+  void update_widgets();
+  void write_results(std::map<std::string,std::string> &Results){Results["info1"]=std::to_string(Info1);};
+  void read_results(std::map<std::string,std::string> &Results){Info1=(unsigned int)atoi(Results["info1"].c_str());};
 
 private:
   _qtw_filter_dot_ebg *Qtw_filter_dot_ebg;
+  unsigned int Info1=0;
 };
 
 
@@ -267,4 +281,5 @@ private:
   _filter_dot_ebg_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,12 @@
 
 
 #include "filter_dot_svg.h"
+#include <QPainterPath>
+#include <QFont>
+#include "vector_writer.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_dot_svg_ns;
 
@@ -69,18 +74,6 @@ void _filter_dot_svg::reset_data()
 }
 
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_dot_svg::set_dots_images(std::vector<std::vector<cv::Mat *> > *Dots1)
-{
-  Dots=Dots1;
-}
-
-
 /*****************************************************************************//**
  *
  *
@@ -95,12 +88,15 @@ void _filter_dot_svg::put_dot(cv::Mat *Output_image0,float Row1,float Col1,unsig
   unsigned int Row_aux=Selected_dot_size1*Index_row1*Scaling_factor;
   unsigned int Col_aux=Selected_dot_size1*Index_col1*Scaling_factor;
 
+  if (Dots==nullptr) Dots=dots_packet(_f_dots_cache_ns::RESOLUTION_300PPI);
+  if (Dots==nullptr) return;
+
   // All the pixels of the dot are modified
   for (Row=0;Row<(int)(Selected_dot_size1*Scaling_factor);Row++){
     for (Col=0;Col<(int)(Selected_dot_size1*Scaling_factor);Col++){
       // get the value of the image of dots of size Selected_dot_size1
 
-      Value=(*Dots)[0][Selected_dot_size1]->at<unsigned char>(Row+Row_aux,Col+Col_aux);
+      Value=(*Dots)[Selected_dot_size1].at<unsigned char>(Row+Row_aux,Col+Col_aux);
       // output position
       Row_out=Row1+Row;
       Col_out=Col1+Col;
@@ -146,11 +142,11 @@ void _filter_dot_svg::stippling_svg(QPainter &Painter)
 
   for (Row=0;Row<Input_image_0->rows;Row++){
     for (Col=0;Col<Input_image_0->cols;Col++){
-      if (Input_image_0->at<unsigned char>(Input_image_0->rows-Row-1,Col)==BLACK){
+      if (Input_image_0->at<unsigned char>(Row,Col)==BLACK){
         // compute a random dot size
         if (Modulate_dot_size==false) Selected_dot_size=Dot_size.value();
         else{
-          Gray_value=255-Input_image_1->at<unsigned char>(Input_image_1->rows-Row-1,Col);
+          Gray_value=255-Input_image_1->at<unsigned char>(Row,Col);
           Selected_dot_size=round(((float)(Max_dot_size-Min_dot_size)*(float)Gray_value/255.0)+(float)Min_dot_size);
         }
 
@@ -191,17 +187,13 @@ void _filter_dot_svg::stippling_svg(QPainter &Painter)
  *
  *****************************************************************************/
 
-void _filter_dot_svg::save_svg(QString File_name1)
+void _filter_dot_svg::save_svg(std::string File_name1)
 {
-  cv::Mat Aux_image;
-
-  // get the image
-  Aux_image=Output_image_0->clone();
-
-  cv::flip(Aux_image,Aux_image,0);
+  // the size of the image
+  cv::Mat &Aux_image=*Output_image_0;
 
   QSvgGenerator Generator;
-  Generator.setFileName(File_name1);
+  Generator.setFileName(QString::fromStdString(File_name1));
   Generator.setSize(QSize(Aux_image.cols,Aux_image.rows));
   Generator.setViewBox(QRect(0, 0, Aux_image.cols,Aux_image.rows));
   Generator.setTitle("SVG file");
@@ -221,6 +213,54 @@ void _filter_dot_svg::save_svg(QString File_name1)
 }
 
 
+/*****************************************************************************//**
+ * The circles are written one by one, so the number of dots is not limited by the
+ * memory. The stars and the letters are drawn by Qt, only as SVG
+ *
+ *****************************************************************************/
+
+bool _filter_dot_svg::save_vector(std::string File_name1)
+{
+  if (Dot_type!=DOT_TYPE_CIRCLE){
+    if (_f_vector_writer_ns::format(File_name1)==_f_vector_writer_ns::FORMAT_SVG){
+      save_svg(File_name1);
+      return true;
+    }
+    warning("Filter Dot SVG","Warning: the stars and the letters can only be saved as SVG");
+    return false;
+  }
+
+  _vector_writer Writer;
+  int Selected_dot_size;
+  unsigned int Gray_value;
+
+  if (Writer.open(File_name1,Output_image_0->cols,Output_image_0->rows)==false){
+    warning("Filter Dot SVG","Error: the dots cannot be saved in "+File_name1);
+    return false;
+  }
+
+  Dot_size.init(Min_dot_size,Max_dot_size);
+  Dot_size.set_seed(5000);
+
+  for_each_dot(Input_image_0,[&](float Row,float Col){
+    // compute a random dot size
+    if (Modulate_dot_size==false) Selected_dot_size=Dot_size.value();
+    else{
+      Gray_value=255-Input_image_1->at<unsigned char>((int)Row,(int)Col);
+      Selected_dot_size=round(((float)(Max_dot_size-Min_dot_size)*(float)Gray_value/255.0)+(float)Min_dot_size);
+    }
+
+    Writer.dot(Col*Scaling_factor,Row*Scaling_factor,(float)Selected_dot_size*0.4f);
+  });
+
+  if (Writer.close()==false){
+    warning("Filter Dot SVG","Error: the dots cannot be saved in "+File_name1);
+    return false;
+  }
+  return true;
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -236,7 +276,7 @@ void _filter_dot_svg::save_svg(QString File_name1)
 
 void _filter_dot_svg::stippling(cv::Mat *Input_image0,cv::Mat *Input_image1,cv::Mat *Output_image0)
 {
-  int Row,Col,Selected_dot_size;
+  int Selected_dot_size;
   float Pos_row,Pos_col;
   _vertex2f Position;
   unsigned int Counter_of_dots=0;
@@ -293,28 +333,28 @@ void _filter_dot_svg::stippling(cv::Mat *Input_image0,cv::Mat *Input_image1,cv::
   }
 
   glColor3ub(0,0,0);
-  for (Row=0;Row<Input_image0->rows;Row++){
-    for (Col=0;Col<Input_image0->cols;Col++){
-      if (Input_image0->at<unsigned char>(Row,Col)==BLACK){
-        // compute a random dot size
-        if (Modulate_dot_size==false) Selected_dot_size=Dot_size.value();
-        else{
-          Gray_value=255-Input_image1->at<unsigned char>(Row,Col);
-          Selected_dot_size=round(((float)(Max_dot_size-Min_dot_size)*(float)Gray_value/255.0)+(float)Min_dot_size);
-        }
 
-        Counter_of_dots++;
+  // a dot for each black pixel. The position can have decimals
+  auto Draw_dot=[&](float Row,float Col){
+    // compute a random dot size
+    if (Modulate_dot_size==false) Selected_dot_size=Dot_size.value();
+    else{
+      Gray_value=255-Input_image1->at<unsigned char>((int)Row,(int)Col);
+      Selected_dot_size=round(((float)(Max_dot_size-Min_dot_size)*(float)Gray_value/255.0)+(float)Min_dot_size);
+    }
 
-        Pos_row=(float)Row*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
-        Pos_col=(float)Col*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
+    Counter_of_dots++;
 
-        glPointSize((float)Selected_dot_size);
-        glBegin(GL_POINTS);
-        glVertex2i(Pos_col,Pos_row);
-        glEnd();
-      }
-    }
-  }
+    Pos_row=Row*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
+    Pos_col=Col*(float)Scaling_factor-((float)Selected_dot_size*Scaling_factor)/2;
+
+    glPointSize((float)Selected_dot_size);
+    glBegin(GL_POINTS);
+    glVertex2f(Pos_col,Pos_row);
+    glEnd();
+  };
+
+  for_each_dot(Input_image0,Draw_dot);
 
   // read the image
   std::vector<GLubyte> Pixels;
@@ -353,11 +393,7 @@ void _filter_dot_svg::stippling(cv::Mat *Input_image0,cv::Mat *Input_image1,cv::
 void _filter_dot_svg::update()
 {
   if (Input_image_0->cols!=Input_image_1->cols || Input_image_0->rows!=Input_image_1->rows){
-    QMessageBox MsgBox;
-    MsgBox.setText("Filter Dot SVG");
-    MsgBox.setInformativeText("Warning: the input images must have the same sizes");
-    MsgBox.setStandardButtons(QMessageBox::Ok);
-    MsgBox.exec();
+    warning("Filter Dot SVG","Warning: the input images must have the same sizes");
     copy_input_to_output();
   }
   else{
@@ -367,17 +403,14 @@ void _filter_dot_svg::update()
 
     // check the output size
     if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-      Output_image_0->release();
-      Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
     }
 
     // Check the number of input channels of input image 1
     if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
       if (Input_image_0->channels()==3){
         // conversion
-        Aux_input_image0=new cv::Mat;
-        Aux_input_image0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-        cvtColor(*Input_image_0,*Aux_input_image0,cv::COLOR_BGR2GRAY,1);
+        Aux_input_image0=new_gray_image(Input_image_0);
       }
       else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
     }
@@ -389,9 +422,7 @@ void _filter_dot_svg::update()
     if (Input_image_1->channels()!=Num_channels_input_image_1){// Different number of channels
       if (Input_image_1->channels()==3){
         // conversion
-        Aux_input_image1=new cv::Mat;
-        Aux_input_image1->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-        cvtColor(*Input_image_0,*Aux_input_image1,cv::COLOR_BGR2GRAY,1);
+        Aux_input_image1=new_gray_image(Input_image_0);
       }
       else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
     }
@@ -403,8 +434,7 @@ void _filter_dot_svg::update()
     if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
       if (Output_image_0->channels()==3){
         // conversion
-        Aux_output_image=new cv::Mat;
-        Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+        Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
         // set the output image to white
         Output_image_0->setTo(cv::Scalar(255,255,255));
@@ -419,9 +449,9 @@ void _filter_dot_svg::update()
       stippling(Aux_input_image0,Aux_input_image1,Output_image_0);
     }
 
-    if (Aux_input_image0!=nullptr && Aux_input_image0!=Input_image_0) delete Aux_input_image0;
-    if (Aux_input_image1!=nullptr && Aux_input_image1!=Input_image_1) delete Aux_input_image1;
-    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+    if (Aux_input_image0!=nullptr && Aux_input_image0!=Input_image_0) delete_aux_image(Aux_input_image0);
+    if (Aux_input_image1!=nullptr && Aux_input_image1!=Input_image_1) delete_aux_image(Aux_input_image1);
+    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
   }
 }
 
@@ -460,10 +490,44 @@ void _filter_dot_svg::load_seeds()
  *
  *****************************************************************************/
 
-_filter_dot_svg_ui::_filter_dot_svg_ui(_gl_widget *GL_widget1, std::string Name1)
+void _filter_dot_svg::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_dot_svg=new _qtw_filter_dot_svg(GL_widget1,this,Name);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(DOT_SVG_DOT_TYPE_DEFAULT);
+    parameter2(DOT_SVG_MODULATE_DOT_SIZE_DEFAULT);
+    parameter2(DOT_SVG_ANTIALIAS_DEFAULT);
+    parameter4(DOT_SVG_MIN_DOT_SIZE_DEFAULT);
+    parameter5(DOT_SVG_MAX_DOT_SIZE_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["dot_type"]=="default") parameter1(DOT_TYPE_CIRCLE);
+      else{
+        if (Parameters["dot_type"]=="circle") parameter1(DOT_TYPE_CIRCLE);
+        if (Parameters["dot_type"]=="star") parameter1(DOT_TYPE_STAR);
+        if (Parameters["dot_type"]=="at") parameter1(DOT_TYPE_AT);
+      }
+      if (Parameters["modulate_dot_size"]=="default") parameter2(DOT_SVG_MODULATE_DOT_SIZE_DEFAULT);
+      else{
+        if (Parameters["modulate_dot_size"]=="true") parameter2(true);
+        else parameter2(false);
+      }
+      if (Parameters["antialias"]=="default") parameter3(DOT_SVG_ANTIALIAS_DEFAULT);
+      else{
+        if (Parameters["antialias"]=="true") parameter3(true);
+        else parameter3(false);
+      }
+      if (Parameters["min_dot_size"]=="default") parameter4(DOT_SVG_MIN_DOT_SIZE_DEFAULT);
+      else parameter4(atoi(Parameters["min_dot_size"].c_str()));
+      if (Parameters["max_dot_size"]=="default") parameter5(DOT_SVG_MAX_DOT_SIZE_DEFAULT);
+      else parameter5(atoi(Parameters["max_dot_size"].c_str()));
+
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of STIPPLING_SVG filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -473,23 +537,44 @@ _filter_dot_svg_ui::_filter_dot_svg_ui(_gl_widget *GL_widget1, std::string Name1
  *
  *****************************************************************************/
 
-_filter_dot_svg_ui::_filter_dot_svg_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Box_name)
+void _filter_dot_svg::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Box_name;
-  Qtw_filter_dot_svg=new _qtw_filter_dot_svg(GL_widget1,this,Box_name);
+  char Aux[100];
+
+  switch((int)parameter1()){
+  case 0:sprintf(Aux,"%s","circle");break; // circle
+  case 1:sprintf(Aux,"%s","star");break; // star
+  case 2:sprintf(Aux,"%s","at");break; // at
+  }
+  Parameters["dot_type"]=std::string(Aux);
+
+  if (parameter2()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["modulate_dot_size"]=std::string(Aux);
+
+  if (parameter3()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["antialias"]=std::string(Aux);
+
+  sprintf(Aux,"%d",parameter4());
+  Parameters["min_dot_size"]=std::string(Aux);
+
+  sprintf(Aux,"%d",parameter5());
+  Parameters["max_dot_size"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_dot_svg_ui::~_filter_dot_svg_ui()
+_filter_dot_svg_ui::_filter_dot_svg_ui(_gl_widget *GL_widget1, std::string Name1)
 {
-  delete Qtw_filter_dot_svg;
+  Name=Name1;
+  Qtw_filter_dot_svg=new _qtw_filter_dot_svg(GL_widget1,this,Name);
 }
 
 
@@ -499,11 +584,11 @@ _filter_dot_svg_ui::~_filter_dot_svg_ui()
  *
  *****************************************************************************/
 
-void _filter_dot_svg_ui::reset_data()
+_filter_dot_svg_ui::_filter_dot_svg_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Box_name)
 {
-  _filter_dot_svg::reset_data();
-  Qtw_filter_dot_svg->set_parameter1(parameter1());
-  hide();
+  read_parameters(Parameters);
+  Name=Box_name;
+  Qtw_filter_dot_svg=new _qtw_filter_dot_svg(GL_widget1,this,Box_name);
 }
 
 
@@ -513,9 +598,9 @@ void _filter_dot_svg_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_dot_svg_ui::show()
+_filter_dot_svg_ui::~_filter_dot_svg_ui()
 {
-  Qtw_filter_dot_svg->show();
+  delete Qtw_filter_dot_svg;
 }
 
 
@@ -525,9 +610,11 @@ void _filter_dot_svg_ui::show()
  *
  *****************************************************************************/
 
-void _filter_dot_svg_ui::hide()
+void _filter_dot_svg_ui::reset_data()
 {
-  Qtw_filter_dot_svg->hide();
+  _filter_dot_svg::reset_data();
+  Qtw_filter_dot_svg->set_parameter1(parameter1());
+  hide();
 }
 
 
@@ -537,9 +624,9 @@ void _filter_dot_svg_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_dot_svg_ui::get_link()
+void _filter_dot_svg_ui::show()
 {
-  return Qtw_filter_dot_svg->get_link();
+  Qtw_filter_dot_svg->show();
 }
 
 
@@ -549,46 +636,9 @@ void *_filter_dot_svg_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_dot_svg_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_dot_svg_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(DOT_SVG_DOT_TYPE_DEFAULT);
-    parameter2(DOT_SVG_MODULATE_DOT_SIZE_DEFAULT);
-    parameter2(DOT_SVG_ANTIALIAS_DEFAULT);
-    parameter4(DOT_SVG_MIN_DOT_SIZE_DEFAULT);
-    parameter5(DOT_SVG_MAX_DOT_SIZE_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["dot_type"]=="default") parameter1(DOT_TYPE_CIRCLE);
-      else{
-        if (Parameters["dot_type"]=="circle") parameter1(DOT_TYPE_CIRCLE);
-        if (Parameters["dot_type"]=="star") parameter1(DOT_TYPE_STAR);
-        if (Parameters["dot_type"]=="at") parameter1(DOT_TYPE_AT);
-      }
-      if (Parameters["modulate_dot_size"]=="default") parameter2(DOT_SVG_MODULATE_DOT_SIZE_DEFAULT);
-      else{
-        if (Parameters["modulate_dot_size"]=="true") parameter2(true);
-        else parameter2(false);
-      }
-      if (Parameters["antialias"]=="default") parameter3(DOT_SVG_ANTIALIAS_DEFAULT);
-      else{
-        if (Parameters["antialias"]=="true") parameter3(true);
-        else parameter3(false);
-      }
-      if (Parameters["min_dot_size"]=="default") parameter4(DOT_SVG_MIN_DOT_SIZE_DEFAULT);
-      else parameter4(atoi(Parameters["min_dot_size"].c_str()));
-      if (Parameters["max_dot_size"]=="default") parameter5(DOT_SVG_MAX_DOT_SIZE_DEFAULT);
-      else parameter5(atoi(Parameters["max_dot_size"].c_str()));
-
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of STIPPLING_SVG filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_dot_svg->hide();
 }
 
 
@@ -598,30 +648,9 @@ void _filter_dot_svg_ui::read_parameters(std::map<std::string,std::string> &Para
  *
  *****************************************************************************/
 
-void _filter_dot_svg_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_dot_svg_ui::get_link()
 {
-  char Aux[100];
-
-  switch((int)parameter1()){
-  case 0:sprintf(Aux,"%s","circle");break; // circle
-  case 1:sprintf(Aux,"%s","star");break; // star
-  case 2:sprintf(Aux,"%s","at");break; // at
-  }
-  Parameters["dot_type"]=std::string(Aux);
-
-  if (parameter2()) sprintf(Aux,"%s","true");
-  else sprintf(Aux,"%s","false");
-  Parameters["modulate_dot_size"]=std::string(Aux);
-
-  if (parameter3()) sprintf(Aux,"%s","true");
-  else sprintf(Aux,"%s","false");
-  Parameters["antialias"]=std::string(Aux);
-
-  sprintf(Aux,"%d",parameter4());
-  Parameters["min_dot_size"]=std::string(Aux);
-
-  sprintf(Aux,"%d",parameter5());
-  Parameters["max_dot_size"]=std::string(Aux);
+  return Qtw_filter_dot_svg->get_link();
 }
 
 
@@ -912,6 +941,7 @@ void _qtw_filter_dot_svg::set_info1(unsigned int Value)
 
 void _qtw_filter_dot_svg::set_parameter1_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter1_slot(Value);})) return;
   Filter->parameter1(Value);
   GL_widget->update_effect(Filter->Name);
 }
@@ -925,6 +955,7 @@ void _qtw_filter_dot_svg::set_parameter1_slot(int Value)
 
 void _qtw_filter_dot_svg::set_parameter2_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter2_slot(Value);})) return;
   if (Value==Qt::Checked) Filter->parameter2(true);
   else Filter->parameter2(false);
   GL_widget->update_effect(Filter->Name);
@@ -939,6 +970,7 @@ void _qtw_filter_dot_svg::set_parameter2_slot(int Value)
 
 void _qtw_filter_dot_svg::set_parameter3_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter3_slot(Value);})) return;
   if (Value==Qt::Checked) Filter->parameter3(true);
   else Filter->parameter3(false);
   GL_widget->update_effect(Filter->Name);
@@ -953,6 +985,7 @@ void _qtw_filter_dot_svg::set_parameter3_slot(int Value)
 
 void _qtw_filter_dot_svg::set_parameter4_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter4_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -980,6 +1013,7 @@ void _qtw_filter_dot_svg::set_parameter4_slot(int Size)
 
 void _qtw_filter_dot_svg::set_parameter5_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter5_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -1007,7 +1041,8 @@ void _qtw_filter_dot_svg::set_parameter5_slot(int Size)
 
 void _qtw_filter_dot_svg::set_parameter6_slot()
 {
-  QString File_name1 = QFileDialog::getSaveFileName(this, tr("Save SVG"),"./images",tr("SVG (*.svg)"));
+  QString File_name1 = QFileDialog::getSaveFileName(this, tr("Save dots"),"./images",tr("SVG (*.svg);;Compressed SVG (*.svgz);;PDF (*.pdf);;EPS (*.eps)"));
 
-  if (!File_name1.isEmpty()) Filter->save_svg(File_name1);
+  if (!File_name1.isEmpty()) Filter->save_vector(File_name1.toStdString());
 }
+#endif // HEADLESS
@@ -17,18 +17,23 @@
 #ifndef _FILTER_DOT_SVG_H
 #define _FILTER_DOT_SVG_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include <QCheckBox>
 #include <QComboBox>
+#endif
 #include <QPainter>
 #include <QSvgGenerator>
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 #include "random.h"
+#include "vertex.h"
 
 #define DEFINED_FILTER_EXAMPLE_BASED_STIPPLING
 
@@ -135,6 +140,26 @@ public:
 
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
+  // it uses OpenGL
+  bool main_thread_only(){return true;};
+
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string, std::string> &Parameters);
+
+  void parameter1(int Dot_type1){dot_type((_f_dot_svg_ns::_dot_type) Dot_type1);};
+  int parameter1(){return (int)dot_type();};
+
+  void parameter2(bool Value){modulate_dot_size(Value);};
+  bool parameter2(){return modulate_dot_size();};
+
+  void parameter3(bool Value){antialias(Value);};
+  bool parameter3(){return antialias();};
+
+  void parameter4(int Value){min_dot_size(Value);};
+  int parameter4(){return min_dot_size();};
+
+  void parameter5(int Value){max_dot_size(Value);};
+  int parameter5(){return max_dot_size();};
 
   void dot_type(_f_dot_svg_ns::_dot_type Dot_type1){Dot_type=Dot_type1;}
   _f_dot_svg_ns::_dot_type dot_type(){return Dot_type;};
@@ -151,14 +176,16 @@ public:
   void max_dot_size(int Max_dot_size1){Max_dot_size=Max_dot_size1;};
   int max_dot_size(){return Max_dot_size;};
 
-  void set_dots_images(std::vector<std::vector<cv::Mat *>> *Dots);
   void set_dots_texture_packet(int Dots_texture_packet1){Dots_texture_packet=Dots_texture_packet1;}
+  void write_internal_state(std::map<std::string,std::string> &State){State["_dots_texture_packet"]=std::to_string(Dots_texture_packet);};
 
   void put_dot(cv::Mat *Output_image1, float Row1, float Col1, unsigned int Selected_dot_size1, unsigned int Index_row1, unsigned int Index_col1);
   void stippling(cv::Mat *Input_image0, cv::Mat *Input_image1, cv::Mat *Output_image0);
 
   void stippling_svg(QPainter &Painter);
-  void save_svg(QString File_name1);
+  void save_svg(std::string File_name1);
+  // SVG, SVGZ, PDF or EPS
+  bool save_vector(std::string File_name1);
 
   void save_seeds();
   void load_seeds();
@@ -172,7 +199,8 @@ public:
 
   int Min_dot_size;
   int Max_dot_size;
-  std::vector<std::vector<cv::Mat *>> *Dots;
+  // the packet of the dots cache that is used in the computation
+  std::vector<cv::Mat> *Dots;
 
   _random_uniform_int Index_row,Index_col;
   _random_uniform_int Dot_size;
@@ -186,6 +214,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -203,23 +232,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Dot_type1){dot_type((_f_dot_svg_ns::_dot_type) Dot_type1);};
-  int parameter1(){return (int)dot_type();};
-
-  void parameter2(bool Value){modulate_dot_size(Value);};
-  bool parameter2(){return modulate_dot_size();};
-
-  void parameter3(bool Value){antialias(Value);};
-  bool parameter3(){return antialias();};
-
-  void parameter4(int Value){min_dot_size(Value);};
-  int parameter4(){return min_dot_size();};
-
-  void parameter5(int Value){max_dot_size(Value);};
-  int parameter5(){return max_dot_size();};
 
   void set_info1(unsigned int Value1);
 
@@ -295,4 +307,5 @@ private:
   _filter_dot_svg_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,9 @@
 
 
 #include "filter_erotion.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_erotion;
 
@@ -65,20 +67,18 @@ void _filter_erotion::update()
 {
   cv::Mat *Aux_input_image=nullptr;
   cv::Mat *Aux_output_image=nullptr;
+  int Kernel_size1=proxy_length(Kernel_size);
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -90,10 +90,9 @@ void _filter_erotion::update()
   if (Input_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
-      cv::Mat Kernel=cv::getStructuringElement(cv::MORPH_ELLIPSE,cv::Size(2*Kernel_size+1,2*Kernel_size+1));
+      cv::Mat Kernel=cv::getStructuringElement(cv::MORPH_ELLIPSE,cv::Size(2*Kernel_size1+1,2*Kernel_size1+1));
       cv::erode(*Aux_input_image,*Aux_output_image,Kernel,cv::Point(-1,-1),Num_iterations);
 
       cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
@@ -101,13 +100,24 @@ void _filter_erotion::update()
     else std::cout << "Error in the number of channels in the output image " << __LINE__ << " " << __FILE__ << std::endl;
   }
   else{// the same number of channels
-
-    cv::Mat Kernel=cv::getStructuringElement(cv::MORPH_RECT,cv::Size(2*Kernel_size+1,2*Kernel_size+1));
-    cv::erode(*Aux_input_image,*Output_image_0,Kernel,cv::Point(-1,-1),Num_iterations);
+    // only the images of the effect are in the cache, not the temporary conversions
+    std::shared_ptr<const _binary_image> Binary_image=(Aux_input_image==Input_image_0)?binary_image(Input_image_0):nullptr;
+
+    if (Binary_image){
+      // the iterations of the square are a bigger square. The black pixels are the
+      // set bits, so they grow
+      _binary_image Result=*Binary_image;
+      Result.dilate(Kernel_size1*(int)Num_iterations);
+      Result.to_mat(*Output_image_0);
+    }
+    else{
+      cv::Mat Kernel=cv::getStructuringElement(cv::MORPH_RECT,cv::Size(2*Kernel_size1+1,2*Kernel_size1+1));
+      cv::erode(*Aux_input_image,*Output_image_0,Kernel,cv::Point(-1,-1),Num_iterations);
+    }
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -141,10 +151,24 @@ void _filter_erotion::num_iterations(int Num_iterations1)
  *
  *****************************************************************************/
 
-_filter_erotion_ui::_filter_erotion_ui(_gl_widget *GL_widget1, std::string Name1)
+void _filter_erotion::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_erotion=new _qtw_filter_erotion(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(EROTION_KERNEL_SIZE_DEFAULT);
+    parameter2(EROTION_NUM_ITERATIONS_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["kernel_size"]=="default") parameter1(EROTION_KERNEL_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["kernel_size"].c_str()));
+      if (Parameters["iterations"]=="default") parameter2(EROTION_NUM_ITERATIONS_DEFAULT);
+      else parameter2(atoi(Parameters["iterations"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of EROTION filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -154,23 +178,28 @@ _filter_erotion_ui::_filter_erotion_ui(_gl_widget *GL_widget1, std::string Name1
  *
  *****************************************************************************/
 
-_filter_erotion_ui::_filter_erotion_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_erotion::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_erotion=new _qtw_filter_erotion(GL_widget1,this,Name1);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["kernel_size"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["iterations"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_erotion_ui::~_filter_erotion_ui()
+_filter_erotion_ui::_filter_erotion_ui(_gl_widget *GL_widget1, std::string Name1)
 {
-  delete Qtw_filter_erotion;
+  Name=Name1;
+  Qtw_filter_erotion=new _qtw_filter_erotion(GL_widget1,this,Name1);
 }
 
 
@@ -180,12 +209,11 @@ _filter_erotion_ui::~_filter_erotion_ui()
  *
  *****************************************************************************/
 
-void _filter_erotion_ui::reset_data()
+_filter_erotion_ui::_filter_erotion_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_erotion::reset_data();
-  Qtw_filter_erotion->set_parameter1(parameter1());
-  Qtw_filter_erotion->set_parameter2(parameter2());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_erotion=new _qtw_filter_erotion(GL_widget1,this,Name1);
 }
 
 
@@ -195,9 +223,9 @@ void _filter_erotion_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_erotion_ui::show()
+_filter_erotion_ui::~_filter_erotion_ui()
 {
-  Qtw_filter_erotion->show();
+  delete Qtw_filter_erotion;
 }
 
 
@@ -207,9 +235,12 @@ void _filter_erotion_ui::show()
  *
  *****************************************************************************/
 
-void _filter_erotion_ui::hide()
+void _filter_erotion_ui::reset_data()
 {
-  Qtw_filter_erotion->hide();
+  _filter_erotion::reset_data();
+  Qtw_filter_erotion->set_parameter1(parameter1());
+  Qtw_filter_erotion->set_parameter2(parameter2());
+  hide();
 }
 
 
@@ -219,9 +250,9 @@ void _filter_erotion_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_erotion_ui::get_link()
+void _filter_erotion_ui::show()
 {
-  return Qtw_filter_erotion->get_link();
+  Qtw_filter_erotion->show();
 }
 
 
@@ -231,26 +262,9 @@ void *_filter_erotion_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_erotion_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_erotion_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(EROTION_KERNEL_SIZE_DEFAULT);
-    parameter2(EROTION_NUM_ITERATIONS_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["kernel_size"]=="default") parameter1(EROTION_KERNEL_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["kernel_size"].c_str()));
-      if (Parameters["iterations"]=="default") parameter2(EROTION_NUM_ITERATIONS_DEFAULT);
-      else parameter2(atoi(Parameters["iterations"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of EROTION filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_erotion->hide();
 }
 
 
@@ -260,14 +274,9 @@ void _filter_erotion_ui::read_parameters(std::map<std::string,std::string> &Para
  *
  *****************************************************************************/
 
-void _filter_erotion_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_erotion_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["kernel_size"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["iterations"]=std::string(Aux);
+  return Qtw_filter_erotion->get_link();
 }
 
 
@@ -409,6 +418,7 @@ void _qtw_filter_erotion::set_parameter2(int Value)
 
 void _qtw_filter_erotion::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
 
   Str=Str.number(Size);
@@ -426,6 +436,7 @@ void _qtw_filter_erotion::set_parameter1_slot(int Size)
 
 void _qtw_filter_erotion::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -435,3 +446,4 @@ void _qtw_filter_erotion::set_parameter2_slot(int Size)
   Filter->parameter2(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
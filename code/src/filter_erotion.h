@@ -17,11 +17,13 @@
 #ifndef _FILTER_EROTION_H
 #define _FILTER_EROTION_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -80,8 +82,18 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string, std::string> &Parameters);
+
+    void parameter1(int Value){_filter_erotion::kernel_size(Value);};
+    int parameter1(){return _filter_erotion::kernel_size();};
+
+    void parameter2(int Value){_filter_erotion::num_iterations(Value);};
+    int parameter2(){return _filter_erotion::num_iterations();};
+
 
     void update();
+    int halo(){return proxy_length(Kernel_size)*(int)Num_iterations;};
     void kernel_size(int Kernel_size1);
     void num_iterations(int Num_iterations1);
 
@@ -92,6 +104,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -109,14 +122,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Value){_filter_erotion::kernel_size(Value);};
-  int parameter1(){return _filter_erotion::kernel_size();};
-
-  void parameter2(int Value){_filter_erotion::num_iterations(Value);};
-  int parameter2(){return _filter_erotion::num_iterations();};
 
 private:
   _qtw_filter_erotion *Qtw_filter_erotion;
@@ -162,4 +167,5 @@ private:
   _filter_erotion_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,9 @@
 
 
 #include "filter_gaussian.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_gaussian_ns;
 
@@ -63,11 +65,11 @@ void _filter_gaussian::update()
 {
   cv::Mat *Aux_input_image=nullptr;
   cv::Mat *Aux_output_image=nullptr;
+  int Kernel_size1=proxy_kernel_size(Kernel_size);
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -75,38 +77,33 @@ void _filter_gaussian::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
   else{// the same number of channels
-    Aux_input_image=new cv::Mat;
-    Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-    *Aux_input_image=Input_image_0->clone();
+    Aux_input_image=Input_image_0;
   }
 
   // Check the number of output channels
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
-      if (Kernel_size>1) cv::GaussianBlur(*Aux_input_image,*Aux_output_image,cv::Size(Kernel_size,Kernel_size),0,0);
+      if (Kernel_size1>1) cv::GaussianBlur(*Aux_input_image,*Aux_output_image,cv::Size(Kernel_size1,Kernel_size1),0,0);
       else *Aux_output_image=*Aux_input_image;
       cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
     }
     else std::cout << "Error in the number of channels in the output image " << __LINE__ << " " << __FILE__ << std::endl;
   }
   else{// the same number of channels
-    if (Kernel_size>1) cv::GaussianBlur(*Aux_input_image,*Output_image_0,cv::Size(Kernel_size,Kernel_size),0,0);
-    else *Output_image_0=*Aux_input_image;
+    if (Kernel_size1>1) cv::GaussianBlur(*Aux_input_image,*Output_image_0,cv::Size(Kernel_size1,Kernel_size1),0,0);
+    else Aux_input_image->copyTo(*Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Input_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Input_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -116,10 +113,21 @@ void _filter_gaussian::update()
  *
  *****************************************************************************/
 
-_filter_gaussian_ui::_filter_gaussian_ui(_gl_widget *GL_widget1,std::string Name1)
+void _filter_gaussian::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_gaussian=new _qtw_filter_gaussian(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(GAUSSIAN_KERNEL_SIZE_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["kernel_size"]=="default") parameter1(GAUSSIAN_KERNEL_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["kernel_size"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of GAUSSIAN filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -129,23 +137,26 @@ _filter_gaussian_ui::_filter_gaussian_ui(_gl_widget *GL_widget1,std::string Name
  *
  *****************************************************************************/
 
-_filter_gaussian_ui::_filter_gaussian_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_gaussian::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_gaussian=new _qtw_filter_gaussian(GL_widget1,this,Name1);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["kernel_size"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_gaussian_ui::~_filter_gaussian_ui()
+_filter_gaussian_ui::_filter_gaussian_ui(_gl_widget *GL_widget1,std::string Name1)
 {
-  delete Qtw_filter_gaussian;
+  Name=Name1;
+  Qtw_filter_gaussian=new _qtw_filter_gaussian(GL_widget1,this,Name1);
 }
 
 
@@ -155,11 +166,11 @@ _filter_gaussian_ui::~_filter_gaussian_ui()
  *
  *****************************************************************************/
 
-void _filter_gaussian_ui::reset_data()
+_filter_gaussian_ui::_filter_gaussian_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_gaussian::reset_data();
-  Qtw_filter_gaussian->set_parameter1(parameter1());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_gaussian=new _qtw_filter_gaussian(GL_widget1,this,Name1);
 }
 
 
@@ -169,9 +180,9 @@ void _filter_gaussian_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_gaussian_ui::show()
+_filter_gaussian_ui::~_filter_gaussian_ui()
 {
-  Qtw_filter_gaussian->show();
+  delete Qtw_filter_gaussian;
 }
 
 
@@ -181,9 +192,11 @@ void _filter_gaussian_ui::show()
  *
  *****************************************************************************/
 
-void _filter_gaussian_ui::hide()
+void _filter_gaussian_ui::reset_data()
 {
-  Qtw_filter_gaussian->hide();
+  _filter_gaussian::reset_data();
+  Qtw_filter_gaussian->set_parameter1(parameter1());
+  hide();
 }
 
 
@@ -193,9 +206,9 @@ void _filter_gaussian_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_gaussian_ui::get_link()
+void _filter_gaussian_ui::show()
 {
-  return Qtw_filter_gaussian->get_link();
+  Qtw_filter_gaussian->show();
 }
 
 
@@ -205,23 +218,9 @@ void *_filter_gaussian_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_gaussian_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_gaussian_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(GAUSSIAN_KERNEL_SIZE_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["kernel_size"]=="default") parameter1(GAUSSIAN_KERNEL_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["kernel_size"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of GAUSSIAN filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_gaussian->hide();
 }
 
 
@@ -231,12 +230,9 @@ void _filter_gaussian_ui::read_parameters(std::map<std::string,std::string> &Par
  *
  *****************************************************************************/
 
-void _filter_gaussian_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_gaussian_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["kernel_size"]=std::string(Aux);
+  return Qtw_filter_gaussian->get_link();
 }
 
 
@@ -325,6 +321,7 @@ void _qtw_filter_gaussian::set_parameter1(int Value)
 
 void _qtw_filter_gaussian::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -339,3 +336,4 @@ void _qtw_filter_gaussian::set_parameter1_slot(int Size)
   Filter->parameter1(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
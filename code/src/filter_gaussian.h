@@ -17,14 +17,18 @@
 #ifndef _FILTER_GAUSSIAN_H
 #define _FILTER_GAUSSIAN_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
+#endif
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -69,8 +73,15 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string, std::string> &Parameters);
+
+    void parameter1(int Value){_filter_gaussian::kernel_size(Value);};
+    int parameter1(){return _filter_gaussian::kernel_size();};
+
 
     void update();
+    int halo(){return proxy_kernel_size(Kernel_size)/2;};
     void kernel_size(int Kernel_size1){Kernel_size=Kernel_size1;};
     int kernel_size(){return Kernel_size;};
 
@@ -78,6 +89,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -95,11 +107,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Value){_filter_gaussian::kernel_size(Value);};
-  int parameter1(){return _filter_gaussian::kernel_size();};
 
   private:
   _qtw_filter_gaussian *Qtw_filter_gaussian;
@@ -137,4 +144,5 @@ private:
   _filter_gaussian_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,9 @@
 
 
 #include "filter_halftoning_acsp.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_halftoning_acsp;
 
@@ -273,12 +275,7 @@ void _filter_halftoning_acsp::move(int &x,int &y)
 void _filter_halftoning_acsp::update()
 {
   if (Input_image_0->cols!=Input_image_0->rows || (log2(Input_image_0->cols)-(int)log2(Input_image_0->cols)!=0)){
-    QMessageBox MsgBox;
-    MsgBox.setIcon(QMessageBox::Warning);
-    MsgBox.setText("Filter Adaptive Clustering Selective Precipitation");
-    MsgBox.setInformativeText("Warning: the input image must be square and power of 2.");
-    MsgBox.setStandardButtons(QMessageBox::Ok);
-    MsgBox.exec();
+    warning("Filter Adaptive Clustering Selective Precipitation","Warning: the input image must be square and power of 2.");
     copy_input_to_output();
   }
   else{
@@ -287,8 +284,7 @@ void _filter_halftoning_acsp::update()
 
     // check the output size
     if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-      Output_image_0->release();
-      Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
     }
 
     // Check the number of input channels
@@ -296,9 +292,7 @@ void _filter_halftoning_acsp::update()
       if (Input_image_0->channels()==3){
         // conversion
 
-        Aux_input_image=new cv::Mat;
-        Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-        cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+        Aux_input_image=new_gray_image(Input_image_0);
       }
       else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
     }
@@ -310,8 +304,7 @@ void _filter_halftoning_acsp::update()
     if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
       if (Output_image_0->channels()==3){
         // conversion
-        Aux_output_image=new cv::Mat;
-        Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+        Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
         space_fill(Aux_input_image,Aux_output_image);
         cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
@@ -323,8 +316,8 @@ void _filter_halftoning_acsp::update()
       space_fill(Aux_input_image,Output_image_0);
     }
 
-    if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+    if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
   }
 }
 
@@ -335,10 +328,39 @@ void _filter_halftoning_acsp::update()
  *
  *****************************************************************************/
 
-_filter_halftoning_acsp_ui::_filter_halftoning_acsp_ui(_gl_widget *GL_widget1, std::string Name1)
+void _filter_halftoning_acsp::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_halftoning_acsp=new _qtw_filter_halftoning_acsp(GL_widget1,this,Name);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(HALFTONING_ACSP_CLUSTER_SIZE_DEFAULT);
+    parameter2(HALFTONING_ACSP_THRESHOLD_DEFAULT);
+    parameter3(HALFTONING_ACSP_ADAPTIVE_CLUSTERING_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["cluster_size"]=="default") parameter1(HALFTONING_ACSP_CLUSTER_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["cluster_size"].c_str()));
+
+      if (Parameters["threshold"]=="default") parameter2(HALFTONING_ACSP_THRESHOLD_DEFAULT);
+      else parameter2(atoi(Parameters["threshold"].c_str()));
+
+      if (Parameters["adaptive_clustering"]=="default") parameter3(HALFTONING_ACSP_ADAPTIVE_CLUSTERING_DEFAULT);
+      else{
+        if (Parameters["adaptive_clustering"]=="true") parameter3(true);
+        else parameter3(false);
+      }
+
+      if (Parameters["selective_precipitation"]=="default") parameter4(HALFTONING_ACSP_SELECTIVE_PRECIPITATION_DEFAULT);
+      else{
+        if (Parameters["selective_precipitation"]=="true") parameter4(true);
+        else parameter4(false);
+      }
+
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of HALFTONING_ACSP filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -348,23 +370,34 @@ _filter_halftoning_acsp_ui::_filter_halftoning_acsp_ui(_gl_widget *GL_widget1, s
  *
  *****************************************************************************/
 
-_filter_halftoning_acsp_ui::_filter_halftoning_acsp_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_halftoning_acsp::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_halftoning_acsp=new _qtw_filter_halftoning_acsp(GL_widget1,this,Name);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["cluster_size"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["threshold"]=std::string(Aux);
+  if (parameter3()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["adaptive_clustering"]=std::string(Aux);
+  if (parameter4()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["selective_precipitation"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_halftoning_acsp_ui::~_filter_halftoning_acsp_ui()
+_filter_halftoning_acsp_ui::_filter_halftoning_acsp_ui(_gl_widget *GL_widget1, std::string Name1)
 {
-  delete Qtw_filter_halftoning_acsp;
+  Name=Name1;
+  Qtw_filter_halftoning_acsp=new _qtw_filter_halftoning_acsp(GL_widget1,this,Name);
 }
 
 
@@ -374,11 +407,11 @@ _filter_halftoning_acsp_ui::~_filter_halftoning_acsp_ui()
  *
  *****************************************************************************/
 
-void _filter_halftoning_acsp_ui::reset_data()
+_filter_halftoning_acsp_ui::_filter_halftoning_acsp_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_halftoning_acsp::reset_data();
-  Qtw_filter_halftoning_acsp->set_parameter1(parameter1());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_halftoning_acsp=new _qtw_filter_halftoning_acsp(GL_widget1,this,Name);
 }
 
 
@@ -388,9 +421,9 @@ void _filter_halftoning_acsp_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_halftoning_acsp_ui::show()
+_filter_halftoning_acsp_ui::~_filter_halftoning_acsp_ui()
 {
-  Qtw_filter_halftoning_acsp->show();
+  delete Qtw_filter_halftoning_acsp;
 }
 
 
@@ -400,9 +433,11 @@ void _filter_halftoning_acsp_ui::show()
  *
  *****************************************************************************/
 
-void _filter_halftoning_acsp_ui::hide()
+void _filter_halftoning_acsp_ui::reset_data()
 {
-  Qtw_filter_halftoning_acsp->hide();
+  _filter_halftoning_acsp::reset_data();
+  Qtw_filter_halftoning_acsp->set_parameter1(parameter1());
+  hide();
 }
 
 
@@ -412,9 +447,9 @@ void _filter_halftoning_acsp_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_halftoning_acsp_ui::get_link()
+void _filter_halftoning_acsp_ui::show()
 {
-  return Qtw_filter_halftoning_acsp->get_link();
+  Qtw_filter_halftoning_acsp->show();
 }
 
 
@@ -424,41 +459,9 @@ void *_filter_halftoning_acsp_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_halftoning_acsp_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_halftoning_acsp_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(HALFTONING_ACSP_CLUSTER_SIZE_DEFAULT);
-    parameter2(HALFTONING_ACSP_THRESHOLD_DEFAULT);
-    parameter3(HALFTONING_ACSP_ADAPTIVE_CLUSTERING_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["cluster_size"]=="default") parameter1(HALFTONING_ACSP_CLUSTER_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["cluster_size"].c_str()));
-
-      if (Parameters["threshold"]=="default") parameter2(HALFTONING_ACSP_THRESHOLD_DEFAULT);
-      else parameter2(atoi(Parameters["threshold"].c_str()));
-
-      if (Parameters["adaptive_clustering"]=="default") parameter3(HALFTONING_ACSP_ADAPTIVE_CLUSTERING_DEFAULT);
-      else{
-        if (Parameters["adaptive_clustering"]=="true") parameter3(true);
-        else parameter3(false);
-      }
-
-      if (Parameters["selective_precipitation"]=="default") parameter4(HALFTONING_ACSP_SELECTIVE_PRECIPITATION_DEFAULT);
-      else{
-        if (Parameters["selective_precipitation"]=="true") parameter4(true);
-        else parameter4(false);
-      }
-
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of HALFTONING_ACSP filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_halftoning_acsp->hide();
 }
 
 
@@ -468,20 +471,9 @@ void _filter_halftoning_acsp_ui::read_parameters(std::map<std::string,std::strin
  *
  *****************************************************************************/
 
-void _filter_halftoning_acsp_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_halftoning_acsp_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["cluster_size"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["threshold"]=std::string(Aux);
-  if (parameter3()) sprintf(Aux,"%s","true");
-  else sprintf(Aux,"%s","false");
-  Parameters["adaptive_clustering"]=std::string(Aux);
-  if (parameter4()) sprintf(Aux,"%s","true");
-  else sprintf(Aux,"%s","false");
-  Parameters["selective_precipitation"]=std::string(Aux);
+  return Qtw_filter_halftoning_acsp->get_link();
 }
 
 
@@ -689,6 +681,7 @@ void _qtw_filter_halftoning_acsp::set_parameter4(bool Value)
 
 void _qtw_filter_halftoning_acsp::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -708,6 +701,7 @@ void _qtw_filter_halftoning_acsp::set_parameter1_slot(int Size)
 
 void _qtw_filter_halftoning_acsp::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -727,6 +721,7 @@ void _qtw_filter_halftoning_acsp::set_parameter2_slot(int Size)
 
 void _qtw_filter_halftoning_acsp::set_parameter3_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter3_slot(Value);})) return;
   if (Value==Qt::Checked) Filter->parameter3(true);
   else Filter->parameter3(false);
   GL_widget->update_effect(Filter->Name);
@@ -741,7 +736,9 @@ void _qtw_filter_halftoning_acsp::set_parameter3_slot(int Value)
 
 void _qtw_filter_halftoning_acsp::set_parameter4_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter4_slot(Value);})) return;
   if (Value==Qt::Checked) Filter->parameter4(true);
   else Filter->parameter4(false);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -19,12 +19,14 @@
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include <QCheckBox>
 #include "line_edit.h"
+#endif
 #include <string>
 #include <vector>
 #include "filter.h"
@@ -105,6 +107,21 @@ public:
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
 
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string,std::string> &Parameters);
+
+  void parameter1(int Value){_filter_halftoning_acsp::cluster_size(Value);};
+  int parameter1(){return _filter_halftoning_acsp::cluster_size();};
+
+  void parameter2(int Value){_filter_halftoning_acsp::threshold(Value);};
+  int parameter2(){return _filter_halftoning_acsp::threshold();};
+
+  void parameter3(bool Value){_filter_halftoning_acsp::adaptive_clustering(Value);};
+  bool parameter3(){return _filter_halftoning_acsp::adaptive_clustering();};
+
+  void parameter4(bool Value){_filter_halftoning_acsp::selective_precipitation(Value);};
+  bool parameter4(){return _filter_halftoning_acsp::selective_precipitation();};
+
   void update();
 
   void cluster_size(int Cluster_size1){Cluster_size=Cluster_size1;}
@@ -137,6 +154,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -154,22 +172,8 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
   void get_parameters(std::map<std::string,std::string> &Parameters);
 
-  void parameter1(int Value){_filter_halftoning_acsp::cluster_size(Value);};
-  int parameter1(){return _filter_halftoning_acsp::cluster_size();};
-
-  void parameter2(int Value){_filter_halftoning_acsp::threshold(Value);};
-  int parameter2(){return _filter_halftoning_acsp::threshold();};
-
-  void parameter3(bool Value){_filter_halftoning_acsp::adaptive_clustering(Value);};
-  bool parameter3(){return _filter_halftoning_acsp::adaptive_clustering();};
-
-  void parameter4(bool Value){_filter_halftoning_acsp::selective_precipitation(Value);};
-  bool parameter4(){return _filter_halftoning_acsp::selective_precipitation();};
-
 private:
   _qtw_filter_halftoning_acsp *Qtw_filter_halftoning_acsp;
 };
@@ -226,4 +230,5 @@ private:
   _filter_halftoning_acsp_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
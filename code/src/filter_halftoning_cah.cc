@@ -15,7 +15,9 @@
 
 
 #include "filter_halftoning_cah.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_halftoning_cah_ns;
 
@@ -191,8 +193,7 @@ void _filter_halftoning_cah::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
 //  *Output_image_0=Input_image_0->clone();
@@ -201,9 +202,7 @@ void _filter_halftoning_cah::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -215,8 +214,7 @@ void _filter_halftoning_cah::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
       halftoning(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_input_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
     }
@@ -226,8 +224,8 @@ void _filter_halftoning_cah::update()
     halftoning(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -237,10 +235,24 @@ void _filter_halftoning_cah::update()
  *
  *****************************************************************************/
 
-_filter_halftoning_cah_ui::_filter_halftoning_cah_ui(_gl_widget *GL_widget1,std::string Name1)
+void _filter_halftoning_cah::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_halftoning_cah=new _qtw_filter_halftoning_cah(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
+    parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["kernel_size"]=="default") parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["kernel_size"].c_str()));
+      if (Parameters["exponent"]=="default") parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
+      else parameter2(atof(Parameters["exponent"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of HALFTONING_CAH filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -250,23 +262,28 @@ _filter_halftoning_cah_ui::_filter_halftoning_cah_ui(_gl_widget *GL_widget1,std:
  *
  *****************************************************************************/
 
-_filter_halftoning_cah_ui::_filter_halftoning_cah_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_halftoning_cah::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_halftoning_cah=new _qtw_filter_halftoning_cah(GL_widget1,this,Name1);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["kernel_size"]=std::string(Aux);
+  sprintf(Aux,"%5.2f",parameter2());
+  Parameters["exponent"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_halftoning_cah_ui::~_filter_halftoning_cah_ui()
+_filter_halftoning_cah_ui::_filter_halftoning_cah_ui(_gl_widget *GL_widget1,std::string Name1)
 {
-  delete Qtw_filter_halftoning_cah;
+  Name=Name1;
+  Qtw_filter_halftoning_cah=new _qtw_filter_halftoning_cah(GL_widget1,this,Name1);
 }
 
 
@@ -276,12 +293,11 @@ _filter_halftoning_cah_ui::~_filter_halftoning_cah_ui()
  *
  *****************************************************************************/
 
-void _filter_halftoning_cah_ui::reset_data()
+_filter_halftoning_cah_ui::_filter_halftoning_cah_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_halftoning_cah::reset_data();
-  Qtw_filter_halftoning_cah->set_parameter1(parameter1());
-  Qtw_filter_halftoning_cah->set_parameter2(parameter2());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_halftoning_cah=new _qtw_filter_halftoning_cah(GL_widget1,this,Name1);
 }
 
 
@@ -291,9 +307,9 @@ void _filter_halftoning_cah_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_halftoning_cah_ui::show()
+_filter_halftoning_cah_ui::~_filter_halftoning_cah_ui()
 {
-  Qtw_filter_halftoning_cah->show();
+  delete Qtw_filter_halftoning_cah;
 }
 
 
@@ -303,9 +319,12 @@ void _filter_halftoning_cah_ui::show()
  *
  *****************************************************************************/
 
-void _filter_halftoning_cah_ui::hide()
+void _filter_halftoning_cah_ui::reset_data()
 {
-  Qtw_filter_halftoning_cah->hide();
+  _filter_halftoning_cah::reset_data();
+  Qtw_filter_halftoning_cah->set_parameter1(parameter1());
+  Qtw_filter_halftoning_cah->set_parameter2(parameter2());
+  hide();
 }
 
 
@@ -315,9 +334,9 @@ void _filter_halftoning_cah_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_halftoning_cah_ui::get_link()
+void _filter_halftoning_cah_ui::show()
 {
-  return Qtw_filter_halftoning_cah->get_link();
+  Qtw_filter_halftoning_cah->show();
 }
 
 
@@ -327,26 +346,9 @@ void *_filter_halftoning_cah_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_halftoning_cah_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_halftoning_cah_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
-    parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["kernel_size"]=="default") parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["kernel_size"].c_str()));
-      if (Parameters["exponent"]=="default") parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
-      else parameter2(atof(Parameters["exponent"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of HALFTONING_CAH filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_halftoning_cah->hide();
 }
 
 
@@ -356,14 +358,9 @@ void _filter_halftoning_cah_ui::read_parameters(std::map<std::string,std::string
  *
  *****************************************************************************/
 
-void _filter_halftoning_cah_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_halftoning_cah_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["kernel_size"]=std::string(Aux);
-  sprintf(Aux,"%5.2f",parameter2());
-  Parameters["exponent"]=std::string(Aux);
+  return Qtw_filter_halftoning_cah->get_link();
 }
 
 
@@ -507,6 +504,7 @@ void _qtw_filter_halftoning_cah::set_parameter2(float Value)
 
 void _qtw_filter_halftoning_cah::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -529,6 +527,7 @@ void _qtw_filter_halftoning_cah::set_parameter1_slot(int Size)
 
 void _qtw_filter_halftoning_cah::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
   float Value=(float)Size/Parameter2_factor;
@@ -539,3 +538,4 @@ void _qtw_filter_halftoning_cah::set_parameter2_slot(int Size)
   Filter->parameter2(Value);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -17,14 +17,18 @@
 #ifndef _FILTER_HALFTONING_CAH_H
 #define _FILTER_HALFTONING_CAH_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
+#endif
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -85,6 +89,15 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string, std::string> &Parameters);
+
+    void parameter1(int Value){_filter_halftoning_cah::kernel_size(Value);};
+    int parameter1(){return _filter_halftoning_cah::kernel_size();};
+
+    void parameter2(float Value){_filter_halftoning_cah::exponent(Value);};  
+    float parameter2(){return _filter_halftoning_cah::exponent();};
+
 
     void halftoning(cv::Mat *Input_image0,cv::Mat *Output_image0);
     void update();
@@ -99,6 +112,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -116,14 +130,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Value){_filter_halftoning_cah::kernel_size(Value);};
-  int parameter1(){return _filter_halftoning_cah::kernel_size();};
-
-  void parameter2(float Value){_filter_halftoning_cah::exponent(Value);};  
-  float parameter2(){return _filter_halftoning_cah::exponent();};
 
   private:
   _qtw_filter_halftoning_cah *Qtw_filter_halftoning_cah;
@@ -170,4 +176,5 @@ private:
   _filter_halftoning_cah_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,9 @@
 
 
 #include "filter_halftoning_ost.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_halftoning_ost_ns;
 
@@ -171,17 +173,14 @@ void _filter_halftoning_ost::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -193,8 +192,7 @@ void _filter_halftoning_ost::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
       halftoning(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_input_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
     }
@@ -204,11 +202,12 @@ void _filter_halftoning_ost::update()
     halftoning(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -300,3 +299,4 @@ _qtw_filter_halftoning_ost::_qtw_filter_halftoning_ost(_gl_widget *GL_widget1,_f
  Group_box_main=new QGroupBox(tr(Box_name.c_str()));
  Group_box_main->hide();
 }
+#endif // HEADLESS
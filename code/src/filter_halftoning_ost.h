@@ -17,8 +17,10 @@
 #ifndef _FILTER_HALFTONING_OST_H
 #define _FILTER_HALFTONING_OST_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
+#endif
 #include <string>
 #include "filter.h"
 
@@ -324,6 +326,9 @@ public:
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
 
+  void read_parameters(std::map<std::string,std::string> &Parameters){Q_UNUSED(Parameters)};
+  void write_parameters(std::map<std::string,std::string> &Parameters){Q_UNUSED(Parameters)};
+
 
   void update();
 
@@ -334,6 +339,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -349,9 +355,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters){Q_UNUSED(Parameters)};
-  void write_parameters(std::map<std::string,std::string> &Parameters){Q_UNUSED(Parameters)};
-
 
   private:
   _qtw_filter_halftoning_ost *Qtw_filter_halftoning_ost;
@@ -380,4 +383,5 @@ private:
   _filter_halftoning_ost_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
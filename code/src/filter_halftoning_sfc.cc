@@ -15,7 +15,9 @@
 
 
 #include "filter_halftoning_sfc.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_halftoning_sfc_ns;
 
@@ -189,11 +191,7 @@ void _filter_halftoning_sfc::space_fill(cv::Mat *Input_image0, cv::Mat *Output_i
 void _filter_halftoning_sfc::update()
 {
   if (Input_image_0->cols!=Input_image_0->rows || (log2(Input_image_0->cols)-(int)log2(Input_image_0->cols)!=0)){
-    QMessageBox MsgBox;
-    MsgBox.setText("Filter Space Filling Curve");
-    MsgBox.setInformativeText("Warning: the input image must be square and power of 2.");
-    MsgBox.setStandardButtons(QMessageBox::Ok);
-    MsgBox.exec();
+    warning("Filter Space Filling Curve","Warning: the input image must be square and power of 2.");
     copy_input_to_output();
   }
   else{
@@ -202,17 +200,14 @@ void _filter_halftoning_sfc::update()
 
     // check the output size
     if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-      Output_image_0->release();
-      Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
     }
 
     // Check the number of input channels
     if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
       if (Input_image_0->channels()==3){
         // conversion
-        Aux_input_image=new cv::Mat;
-        Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-        cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+        Aux_input_image=new_gray_image(Input_image_0);
       }
       else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
     }
@@ -224,8 +219,7 @@ void _filter_halftoning_sfc::update()
     if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
       if (Output_image_0->channels()==3){
         // conversion
-        Aux_output_image=new cv::Mat;
-        Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+        Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
         space_fill(Aux_input_image,Aux_output_image);
         cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
@@ -237,8 +231,8 @@ void _filter_halftoning_sfc::update()
       space_fill(Aux_input_image,Output_image_0);
     }
 
-    if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+    if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+    if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
   }
 }
 
@@ -249,10 +243,21 @@ void _filter_halftoning_sfc::update()
  *
  *****************************************************************************/
 
-_filter_halftoning_sfc_ui::_filter_halftoning_sfc_ui(_gl_widget *GL_widget1, std::string Name1)
+void _filter_halftoning_sfc::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_halftoning_sfc=new _qtw_filter_halftoning_sfc(GL_widget1,this,Name);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(HALFTONING_SFC_CLUSTER_SIZE_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["cluster_size"]=="default") parameter1(HALFTONING_SFC_CLUSTER_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["cluster_size"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of HALFTONING_SFC filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -262,23 +267,26 @@ _filter_halftoning_sfc_ui::_filter_halftoning_sfc_ui(_gl_widget *GL_widget1, std
  *
  *****************************************************************************/
 
-_filter_halftoning_sfc_ui::_filter_halftoning_sfc_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_halftoning_sfc::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_halftoning_sfc=new _qtw_filter_halftoning_sfc(GL_widget1,this,Name);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["cluster_size"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_halftoning_sfc_ui::~_filter_halftoning_sfc_ui()
+_filter_halftoning_sfc_ui::_filter_halftoning_sfc_ui(_gl_widget *GL_widget1, std::string Name1)
 {
-  delete Qtw_filter_halftoning_sfc;
+  Name=Name1;
+  Qtw_filter_halftoning_sfc=new _qtw_filter_halftoning_sfc(GL_widget1,this,Name);
 }
 
 
@@ -288,11 +296,11 @@ _filter_halftoning_sfc_ui::~_filter_halftoning_sfc_ui()
  *
  *****************************************************************************/
 
-void _filter_halftoning_sfc_ui::reset_data()
+_filter_halftoning_sfc_ui::_filter_halftoning_sfc_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_halftoning_sfc::reset_data();
-  Qtw_filter_halftoning_sfc->set_parameter1(parameter1());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_halftoning_sfc=new _qtw_filter_halftoning_sfc(GL_widget1,this,Name);
 }
 
 
@@ -302,9 +310,9 @@ void _filter_halftoning_sfc_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_halftoning_sfc_ui::show()
+_filter_halftoning_sfc_ui::~_filter_halftoning_sfc_ui()
 {
-  Qtw_filter_halftoning_sfc->show();
+  delete Qtw_filter_halftoning_sfc;
 }
 
 
@@ -314,9 +322,11 @@ void _filter_halftoning_sfc_ui::show()
  *
  *****************************************************************************/
 
-void _filter_halftoning_sfc_ui::hide()
+void _filter_halftoning_sfc_ui::reset_data()
 {
-  Qtw_filter_halftoning_sfc->hide();
+  _filter_halftoning_sfc::reset_data();
+  Qtw_filter_halftoning_sfc->set_parameter1(parameter1());
+  hide();
 }
 
 
@@ -326,9 +336,9 @@ void _filter_halftoning_sfc_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_halftoning_sfc_ui::get_link()
+void _filter_halftoning_sfc_ui::show()
 {
-  return Qtw_filter_halftoning_sfc->get_link();
+  Qtw_filter_halftoning_sfc->show();
 }
 
 
@@ -338,23 +348,9 @@ void *_filter_halftoning_sfc_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_halftoning_sfc_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_halftoning_sfc_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(HALFTONING_SFC_CLUSTER_SIZE_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["cluster_size"]=="default") parameter1(HALFTONING_SFC_CLUSTER_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["cluster_size"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of HALFTONING_SFC filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_halftoning_sfc->hide();
 }
 
 
@@ -364,12 +360,9 @@ void _filter_halftoning_sfc_ui::read_parameters(std::map<std::string,std::string
  *
  *****************************************************************************/
 
-void _filter_halftoning_sfc_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_halftoning_sfc_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["cluster_size"]=std::string(Aux);
+  return Qtw_filter_halftoning_sfc->get_link();
 }
 
 
@@ -459,6 +452,7 @@ void _qtw_filter_halftoning_sfc::set_parameter1(int Value)
 
 void _qtw_filter_halftoning_sfc::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -468,3 +462,4 @@ void _qtw_filter_halftoning_sfc::set_parameter1_slot(int Size)
   Filter->parameter1(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -19,11 +19,13 @@
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include <vector>
 #include "filter.h"
@@ -79,6 +81,12 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string,std::string> &Parameters);
+
+    void parameter1(int Value){_filter_halftoning_sfc::cluster_size(Value);};
+    int parameter1(){return _filter_halftoning_sfc::cluster_size();};
+
     void update();
     void cluster_size(int Cluster_size1){Cluster_size=Cluster_size1;}
     int  cluster_size(){return Cluster_size;};
@@ -97,6 +105,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -111,18 +120,11 @@ public:
   ~_filter_halftoning_sfc_ui();
   void reset_data();
 
-
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
   void get_parameters(std::map<std::string,std::string> &Parameters);
 
-  void parameter1(int Value){_filter_halftoning_sfc::cluster_size(Value);};
-  int parameter1(){return _filter_halftoning_sfc::cluster_size();};
-
-
 private:
   _qtw_filter_halftoning_sfc *Qtw_filter_halftoning_sfc;
 };
@@ -161,4 +163,5 @@ private:
   _filter_halftoning_sfc_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
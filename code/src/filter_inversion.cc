@@ -15,7 +15,9 @@
 
 
 #include "filter_inversion.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 //using namespace _f_inversion;
 
@@ -53,31 +55,25 @@ void _filter_inversion::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
   else{// the same number of channels
-    Aux_input_image=new cv::Mat;
-    Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-    *Aux_input_image=Input_image_0->clone();
+    Aux_input_image=Input_image_0;
   }
   // Check the number of output channels
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       cv::bitwise_not(*Aux_input_image,*Aux_output_image);
       cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
@@ -88,8 +84,8 @@ void _filter_inversion::update()
     cv::bitwise_not(*Aux_input_image,*Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Input_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Input_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -99,10 +95,9 @@ void _filter_inversion::update()
  *
  *****************************************************************************/
 
-_filter_inversion_ui::_filter_inversion_ui(_gl_widget *GL_widget1,std::string Name1)
+void _filter_inversion::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_inversion=new _qtw_filter_inversion(GL_widget1,this,Name1);
+    Q_UNUSED(Parameters)
 }
 
 
@@ -112,23 +107,23 @@ _filter_inversion_ui::_filter_inversion_ui(_gl_widget *GL_widget1,std::string Na
  *
  *****************************************************************************/
 
-_filter_inversion_ui::_filter_inversion_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_inversion::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_inversion=new _qtw_filter_inversion(GL_widget1,this,Name1);
+    Q_UNUSED(Parameters)
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_inversion_ui::~_filter_inversion_ui()
+_filter_inversion_ui::_filter_inversion_ui(_gl_widget *GL_widget1,std::string Name1)
 {
-  delete Qtw_filter_inversion;
+  Name=Name1;
+  Qtw_filter_inversion=new _qtw_filter_inversion(GL_widget1,this,Name1);
 }
 
 
@@ -138,10 +133,11 @@ _filter_inversion_ui::~_filter_inversion_ui()
  *
  *****************************************************************************/
 
-void _filter_inversion_ui::reset_data()
+_filter_inversion_ui::_filter_inversion_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_inversion::reset_data();
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_inversion=new _qtw_filter_inversion(GL_widget1,this,Name1);
 }
 
 
@@ -151,9 +147,9 @@ void _filter_inversion_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_inversion_ui::show()
+_filter_inversion_ui::~_filter_inversion_ui()
 {
-  Qtw_filter_inversion->show();
+  delete Qtw_filter_inversion;
 }
 
 
@@ -163,9 +159,10 @@ void _filter_inversion_ui::show()
  *
  *****************************************************************************/
 
-void _filter_inversion_ui::hide()
+void _filter_inversion_ui::reset_data()
 {
-  Qtw_filter_inversion->hide();
+  _filter_inversion::reset_data();
+  hide();
 }
 
 
@@ -175,9 +172,9 @@ void _filter_inversion_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_inversion_ui::get_link()
+void _filter_inversion_ui::show()
 {
-  return Qtw_filter_inversion->get_link();
+  Qtw_filter_inversion->show();
 }
 
 
@@ -187,9 +184,9 @@ void *_filter_inversion_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_inversion_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_inversion_ui::hide()
 {
-    Q_UNUSED(Parameters)
+  Qtw_filter_inversion->hide();
 }
 
 
@@ -199,9 +196,9 @@ void _filter_inversion_ui::read_parameters(std::map<std::string,std::string> &Pa
  *
  *****************************************************************************/
 
-void _filter_inversion_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_inversion_ui::get_link()
 {
-    Q_UNUSED(Parameters)
+  return Qtw_filter_inversion->get_link();
 }
 
 
@@ -223,3 +220,4 @@ _qtw_filter_inversion::_qtw_filter_inversion(_gl_widget *GL_widget1,_filter_inve
 
   Group_box_main->hide();
 }
+#endif // HEADLESS
@@ -17,14 +17,18 @@
 #ifndef _FILTER_INVERSION_H
 #define _FILTER_INVERSION_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
+#endif
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -49,10 +53,15 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string, std::string> &Parameters);
+
     void update();
+    int halo(){return 0;};
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -70,8 +79,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
 
   private:
   _qtw_filter_inversion *Qtw_filter_inversion;
@@ -102,4 +109,5 @@ private:
   _filter_inversion_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
@@ -15,7 +15,9 @@
 
 
 #include "filter_kang.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_kang_ns;
 
@@ -106,8 +108,7 @@ void _filter_kang::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -115,9 +116,7 @@ void _filter_kang::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
   }
   else{// the same number of channels
@@ -128,8 +127,7 @@ void _filter_kang::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
       kang(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
     }
@@ -139,8 +137,8 @@ void _filter_kang::update()
     kang(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -191,14 +189,11 @@ void _filter_kang::edge_tangent_flow(cv::Mat *Input_image,cv::Mat *Output_image)
   float New_x;
   float New_y;
   float Module;
+  float Radius1=(float)proxy_length(Radius);
 
   // progress bar
   int Count_progress;
   int Num_pass=ETF_iterations*Input_image->rows;
-  QProgressDialog Progress("Computing ETF...", "Abort",0,Num_pass);
-  Progress.setWindowModality(Qt::WindowModal);
-  Progress.setMinimumDuration(0);
-  Progress.setCancelButton(0);
 
   // the process is repeated
   for (auto Iteration=0;Iteration<ETF_iterations;Iteration++){
@@ -207,19 +202,19 @@ void _filter_kang::edge_tangent_flow(cv::Mat *Input_image,cv::Mat *Output_image)
     // the image is traversed
     for (auto Row=0;Row<Input_image->rows;Row++){
       // progress bar
-      Progress.setValue(Count_progress++);
-      if (Progress.wasCanceled()) break;
+      progress("Computing ETF...",float(Count_progress++)/float(Num_pass));
+      if (cancelled()) return;
 
       for (auto Col=0;Col<Input_image->cols;Col++){
         // the inner loop for the kernel
         New_x=0;
         New_y=0;
-        for (auto Kernel_row=-Radius;Kernel_row<Radius;Kernel_row++){
-          for (auto Kernel_col=-Radius;Kernel_col<Radius;Kernel_col++){
+        for (auto Kernel_row=-Radius1;Kernel_row<Radius1;Kernel_row++){
+          for (auto Kernel_col=-Radius1;Kernel_col<Radius1;Kernel_col++){
             // check that the position is included in the image and can be computed
             if ((Row+Kernel_row)>=0 && (Row+Kernel_row)<Input_image->rows && (Col+Kernel_col)>=0 && (Col+Kernel_col)<Input_image->cols){
               // the spatia weight is computed with an if
-              if (sqrt(Kernel_row*Kernel_row+Kernel_col*Kernel_col)<Radius){
+              if (sqrt(Kernel_row*Kernel_row+Kernel_col*Kernel_col)<Radius1){
                 // compute the magnitude weight
                 Magnitude_weight=0.5*(1+tanh(Eta*(Gradient_magnitude.at<float>(Row+Kernel_row,Col+Kernel_col)-Gradient_magnitude.at<float>(Row,Col))));
                 // compute the direction weight as the dot product
@@ -243,7 +238,6 @@ void _filter_kang::edge_tangent_flow(cv::Mat *Input_image,cv::Mat *Output_image)
     }
   }
 
-  Progress.setValue(Num_pass);
 //  Gradient_magnitude.convertTo(*Output_image,CV_8U);
   Final_position=(ETF_iterations-1)%2;
   // To draw
@@ -339,12 +333,15 @@ float  _filter_kang::line(int Initial_row, int Initial_col, int Kernel_size_line
 void _filter_kang::line_extraction(cv::Mat *Image_lines, cv::Mat *Aux_input_image)
 {
   cv::Mat Input_image;
+  int Kernel_size_center1=proxy_kernel_size(Kernel_size_center);
+  int Kernel_size_surround1=proxy_kernel_size(Kernel_size_surround);
+  int Kernel_size_line_length1=proxy_kernel_size(Kernel_size_line_length);
 
   // copy the original image
   Aux_input_image->copyTo(Input_image);
 
-  cv::Mat Gaussian_center=cv::getGaussianKernel(Kernel_size_center,-1,CV_32F);
-  cv::Mat Gaussian_surround=cv::getGaussianKernel(Kernel_size_surround,-1,CV_32F);
+  cv::Mat Gaussian_center=cv::getGaussianKernel(Kernel_size_center1,-1,CV_32F);
+  cv::Mat Gaussian_surround=cv::getGaussianKernel(Kernel_size_surround1,-1,CV_32F);
 
   // vector with the values of the kernels
   std::vector<float> Vec_gaussian_center;
@@ -352,28 +349,24 @@ void _filter_kang::line_extraction(cv::Mat *Image_lines, cv::Mat *Aux_input_imag
   std::vector<float> Difference_of_gaussians;
   std::vector<float> Gauss_line_lenght;
 
-  Difference_of_gaussians.resize(Kernel_size_surround);
-  Vec_gaussian_center.resize(Kernel_size_surround);
-  Vec_gaussian_surround.resize(Kernel_size_surround);
+  Difference_of_gaussians.resize(Kernel_size_surround1);
+  Vec_gaussian_center.resize(Kernel_size_surround1);
+  Vec_gaussian_surround.resize(Kernel_size_surround1);
 
   //
   for (auto i=0;i<Gaussian_surround.rows;i++) Vec_gaussian_surround[i]=Ro*Gaussian_surround.at<float>(i);
-  int Aux=(Kernel_size_surround-Kernel_size_center)/2;
+  int Aux=(Kernel_size_surround1-Kernel_size_center1)/2;
   for (auto i=0;i<Gaussian_center.rows;i++) Vec_gaussian_center[i+Aux]=Gaussian_center.at<float>(i);
   for (unsigned int i=0;i<Difference_of_gaussians.size();i++) Difference_of_gaussians[i]=Vec_gaussian_center[i]-Vec_gaussian_surround[i];
 
   //
-  cv::Mat Gaussian_line=cv::getGaussianKernel(Kernel_size_line_length,-1,CV_32F);
-  Gauss_line_lenght.resize(Kernel_size_line_length);
+  cv::Mat Gaussian_line=cv::getGaussianKernel(Kernel_size_line_length1,-1,CV_32F);
+  Gauss_line_lenght.resize(Kernel_size_line_length1);
   for(unsigned int i=0;i<Gauss_line_lenght.size(); i++) Gauss_line_lenght[i]=Gaussian_line.at<float>(i);
 
   // progress bar
   int Count_progress;
   int Num_pass=Lines_iterations*Image_lines->rows;
-  QProgressDialog Progress("Computing lines...", "Abort",0,Num_pass);
-  Progress.setWindowModality(Qt::WindowModal);
-  Progress.setMinimumDuration(0);
-  Progress.setCancelButton(0);
 
   // repeat the process
   for(auto Iteration = 0; Iteration < Lines_iterations; Iteration++){
@@ -382,12 +375,12 @@ void _filter_kang::line_extraction(cv::Mat *Image_lines, cv::Mat *Aux_input_imag
     // create the values
     for(auto Row = 0; Row < Image_lines->rows; Row++){
       // progress bar
-      Progress.setValue(Count_progress++);
-      if (Progress.wasCanceled()) break;
+      progress("Computing lines...",float(Count_progress++)/float(Num_pass));
+      if (cancelled()) return;
       for(auto Col = 0; Col < Image_lines->cols; Col++){
         // for each pixel treats to create a line using the ETF
         // the kernel sizes
-        Image_lines->at<float>(Row,Col)=line(Row, Col, Kernel_size_line_length/2, Kernel_size_surround/2, &Input_image,Difference_of_gaussians, Gauss_line_lenght);
+        Image_lines->at<float>(Row,Col)=line(Row, Col, Kernel_size_line_length1/2, Kernel_size_surround1/2, &Input_image,Difference_of_gaussians, Gauss_line_lenght);
       }
     }
 
@@ -439,10 +432,30 @@ void _filter_kang::draw_vectors(cv::Mat *Input_image,cv::Mat *Output_image,cv::M
  *
  *****************************************************************************/
 
-_filter_kang_ui::_filter_kang_ui(_gl_widget *GL_widget1,std::string Name1)
+void _filter_kang::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_kang=new _qtw_filter_kang(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(RADIUS_DEFAULT);
+    parameter2(KERNEL_SIZE_LINE_LENGTH_DEFAULT);
+    parameter3(KERNEL_SIZE_SURROUND_DEFAULT);
+    parameter4(KERNEL_SIZE_CENTER_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["radius"]=="default") parameter1(RADIUS_DEFAULT);
+      else parameter1(atoi(Parameters["radius"].c_str()));
+      if (Parameters["line_lenght"]=="default") parameter2(KERNEL_SIZE_LINE_LENGTH_DEFAULT);
+      else parameter2(atoi(Parameters["line_lenght"].c_str()));
+      if (Parameters["surround_kernel_size"]=="default") parameter3(KERNEL_SIZE_SURROUND_DEFAULT);
+      else parameter3(atoi(Parameters["surround_kernel_size"].c_str()));
+      if (Parameters["center_kernel_size"]=="default") parameter4(KERNEL_SIZE_CENTER_DEFAULT);
+      else parameter4(atoi(Parameters["center_kernel_size"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of KANG filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -452,23 +465,32 @@ _filter_kang_ui::_filter_kang_ui(_gl_widget *GL_widget1,std::string Name1)
  *
  *****************************************************************************/
 
-_filter_kang_ui::_filter_kang_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_kang::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_kang=new _qtw_filter_kang(GL_widget1,this,Name1);
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["radius"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["line_lenght"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter3());
+  Parameters["surround_kernel_size"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter4());
+  Parameters["center_kernel_size"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_kang_ui::~_filter_kang_ui()
+_filter_kang_ui::_filter_kang_ui(_gl_widget *GL_widget1,std::string Name1)
 {
-  delete Qtw_filter_kang;
+  Name=Name1;
+  Qtw_filter_kang=new _qtw_filter_kang(GL_widget1,this,Name1);
 }
 
 
@@ -478,10 +500,11 @@ _filter_kang_ui::~_filter_kang_ui()
  *
  *****************************************************************************/
 
-void _filter_kang_ui::reset_data()
+_filter_kang_ui::_filter_kang_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_kang::reset_data();
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_kang=new _qtw_filter_kang(GL_widget1,this,Name1);
 }
 
 
@@ -491,9 +514,9 @@ void _filter_kang_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_kang_ui::show()
+_filter_kang_ui::~_filter_kang_ui()
 {
-  Qtw_filter_kang->show();
+  delete Qtw_filter_kang;
 }
 
 
@@ -503,9 +526,10 @@ void _filter_kang_ui::show()
  *
  *****************************************************************************/
 
-void _filter_kang_ui::hide()
+void _filter_kang_ui::reset_data()
 {
-  Qtw_filter_kang->hide();
+  _filter_kang::reset_data();
+  hide();
 }
 
 
@@ -515,9 +539,9 @@ void _filter_kang_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_kang_ui::get_link()
+void _filter_kang_ui::show()
 {
-  return Qtw_filter_kang->get_link();
+  Qtw_filter_kang->show();
 }
 
 
@@ -527,32 +551,9 @@ void *_filter_kang_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_kang_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_kang_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(RADIUS_DEFAULT);
-    parameter2(KERNEL_SIZE_LINE_LENGTH_DEFAULT);
-    parameter3(KERNEL_SIZE_SURROUND_DEFAULT);
-    parameter4(KERNEL_SIZE_CENTER_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["radius"]=="default") parameter1(RADIUS_DEFAULT);
-      else parameter1(atoi(Parameters["radius"].c_str()));
-      if (Parameters["line_lenght"]=="default") parameter2(KERNEL_SIZE_LINE_LENGTH_DEFAULT);
-      else parameter2(atoi(Parameters["line_lenght"].c_str()));
-      if (Parameters["surround_kernel_size"]=="default") parameter3(KERNEL_SIZE_SURROUND_DEFAULT);
-      else parameter3(atoi(Parameters["surround_kernel_size"].c_str()));
-      if (Parameters["center_kernel_size"]=="default") parameter4(KERNEL_SIZE_CENTER_DEFAULT);
-      else parameter4(atoi(Parameters["center_kernel_size"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of KANG filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_kang->hide();
 }
 
 
@@ -562,18 +563,9 @@ void _filter_kang_ui::read_parameters(std::map<std::string,std::string> &Paramet
  *
  *****************************************************************************/
 
-void _filter_kang_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_kang_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["radius"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["line_lenght"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter3());
-  Parameters["surround_kernel_size"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter4());
-  Parameters["center_kernel_size"]=std::string(Aux);
+  return Qtw_filter_kang->get_link();
 }
 
 
@@ -823,6 +815,7 @@ void _qtw_filter_kang::parameter4(int Value)
 
 void _qtw_filter_kang::parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -842,6 +835,7 @@ void _qtw_filter_kang::parameter1_slot(int Size)
 
 void _qtw_filter_kang::parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -863,6 +857,7 @@ void _qtw_filter_kang::parameter2_slot(int Size)
 
 void _qtw_filter_kang::parameter3_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{parameter3_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -888,6 +883,7 @@ void _qtw_filter_kang::parameter3_slot(int Size)
 
 void _qtw_filter_kang::parameter4_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{parameter4_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -903,3 +899,4 @@ void _qtw_filter_kang::parameter4_slot(int Size)
   Filter->parameter4(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
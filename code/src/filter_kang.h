@@ -17,12 +17,14 @@
 #ifndef _FILTER_KANG_H
 #define _FILTER_KANG_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -124,6 +126,21 @@ public:
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
 
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string, std::string> &Parameters);
+
+  void parameter1(int Value){radius((float)Value);};
+  int  parameter1(){return (int)radius();};
+
+  void parameter2(int Value){kernel_size_line_length(Value);};
+  int  parameter2(){return kernel_size_line_length();};
+
+  void parameter3(int Value){kernel_size_surround(Value);};
+  int  parameter3(){return kernel_size_surround();};
+
+  void parameter4(int Value){kernel_size_center(Value);};
+  int  parameter4(){return kernel_size_center();};
+
 
   void kang(cv::Mat *Aux_input_image, cv::Mat *Aux_output_image);
   void update();
@@ -167,6 +184,7 @@ private:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -184,20 +202,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Value){radius((float)Value);};
-  int  parameter1(){return (int)radius();};
-
-  void parameter2(int Value){kernel_size_line_length(Value);};
-  int  parameter2(){return kernel_size_line_length();};
-
-  void parameter3(int Value){kernel_size_surround(Value);};
-  int  parameter3(){return kernel_size_surround();};
-
-  void parameter4(int Value){kernel_size_center(Value);};
-  int  parameter4(){return kernel_size_center();};
 
   private:
   _qtw_filter_kang *Qtw_filter_kang;
@@ -261,4 +265,5 @@ private:
   _gl_widget *GL_widget;
 };
 
+#endif // HEADLESS
 #endif
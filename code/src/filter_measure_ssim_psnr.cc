@@ -15,7 +15,9 @@
 
 
 #include "filter_measure_ssim_psnr.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_measure_ssim_psnr_ns;
 
@@ -162,15 +164,11 @@ void _filter_measure_ssim_psnr::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   if (Input_image_0->channels()!=Input_image_1->channels() || Input_image_0->cols!=Input_image_1->cols || Input_image_0->rows!=Input_image_1->rows){
-    QMessageBox Message_box;
-    Message_box.setWindowTitle(QObject::tr("Warning"));
-    Message_box.setText("Error in the input images of filter measure_ssim_psnr (different number of channels or sizes)");
-    Message_box.exec();
+    warning("Error in the input images of filter measure_ssim_psnr (different number of channels or sizes)");
     return;
   }
 
@@ -178,9 +176,7 @@ void _filter_measure_ssim_psnr::update()
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image0=new cv::Mat;
-      Aux_input_image0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image0,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image0=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -192,9 +188,7 @@ void _filter_measure_ssim_psnr::update()
   if (Input_image_1->channels()!=Num_channels_input_image_1){// Different number of channels
     if (Input_image_1->channels()==3){
       // conversion
-      Aux_input_image1=new cv::Mat;
-      Aux_input_image1->create(Input_image_1->rows,Input_image_1->cols,CV_8UC1);
-      cvtColor(*Input_image_1,*Aux_input_image1,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image1=new_gray_image(Input_image_1);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -206,8 +200,7 @@ void _filter_measure_ssim_psnr::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       Aux_input_image0->copyTo(*Output_image_0);
       cv::Scalar MSSIM=getMSSIM(Aux_input_image0,Aux_input_image1);
@@ -228,12 +221,37 @@ void _filter_measure_ssim_psnr::update()
     set_info1(MSSIM[0]*100,PSNR);
   }
 
-  if (Aux_input_image0!=nullptr && Aux_input_image0!=Input_image_0) delete Aux_input_image0;
-  if (Aux_input_image1!=nullptr && Aux_input_image1!=Input_image_1) delete Aux_input_image1;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image0!=nullptr && Aux_input_image0!=Input_image_0) delete_aux_image(Aux_input_image0);
+  if (Aux_input_image1!=nullptr && Aux_input_image1!=Input_image_1) delete_aux_image(Aux_input_image1);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_measure_ssim_psnr::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  Q_UNUSED(Parameters)
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_measure_ssim_psnr::write_parameters(std::map<std::string,std::string> &Parameters)
+{
+  Q_UNUSED(Parameters)
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -328,21 +346,10 @@ void *_filter_measure_ssim_psnr_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_measure_ssim_psnr_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  Q_UNUSED(Parameters)
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_measure_ssim_psnr_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_measure_ssim_psnr_ui::set_info1(float SSIM1,float PSNR1)
 {
-  Q_UNUSED(Parameters)
+  SSIM=SSIM1;
+  PSNR=PSNR1;
 }
 
 
@@ -352,9 +359,9 @@ void _filter_measure_ssim_psnr_ui::write_parameters(std::map<std::string,std::st
  *
  *****************************************************************************/
 
-void _filter_measure_ssim_psnr_ui::set_info1(float SSIM1,float PSNR1)
+void _filter_measure_ssim_psnr_ui::update_widgets()
 {
-  Qtw_filter_measure_ssim_psnr->set_info1(SSIM1,PSNR1);
+  Qtw_filter_measure_ssim_psnr->set_info1(SSIM,PSNR);
 }
 
 
@@ -435,3 +442,4 @@ void _qtw_filter_measure_ssim_psnr::set_info1(float SSIM1,float PSNR1)
   Str=Str.number(PSNR1);
   Line_edit_info2->setText(Str);
 }
+#endif // HEADLESS
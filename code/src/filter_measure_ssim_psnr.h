@@ -17,11 +17,13 @@
 #ifndef _FILTER_MEASURE_SSIM_PSNR_H
 #define _FILTER_MEASURE_SSIM_PSNR_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -53,6 +55,11 @@ public:
     void reset_data();
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
+    // the result is the measure, not the image
+    bool cacheable(){return false;};
+
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string,std::string> &Parameters);
 
     void update();
 
@@ -63,6 +70,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -80,13 +88,14 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
 
   void set_info1(float SSIM1,float PSNR1);
+  void update_widgets();
 
 private:
   _qtw_filter_measure_ssim_psnr *Qtw_filter_measure_ssim_psnr;
+  float SSIM=0;
+  float PSNR=0;
 };
 
 
@@ -120,4 +129,5 @@ private:
   _filter_measure_ssim_psnr_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
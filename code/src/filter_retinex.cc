@@ -15,7 +15,9 @@
 
 
 #include "filter_retinex.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_retinex_ns;
 
@@ -98,8 +100,7 @@ void _filter_retinex::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // computes the weight to apply when there are several filters -> MSR
@@ -113,20 +114,14 @@ void _filter_retinex::update()
 
   if (Input_image_0->rows<255 || Input_image_0->cols<255){
     std::cout << "Bug: one dimension of the input image is less than 255" <<std::endl;
-    QMessageBox Message_box;
-    Message_box.setWindowTitle(QObject::tr("Warning"));
-    Message_box.setText(QObject::tr("The size of the input of the Retinex filter must grether or equal to 256 pixels"));
-    Message_box.exec();
+    warning("The size of the input of the Retinex filter must grether or equal to 256 pixels");
     return;
   }
 
   // first check the number of channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){
     // error withour conversion
-    QMessageBox Message_box;
-    Message_box.setWindowTitle(QObject::tr("Warning"));
-    Message_box.setText(QObject::tr("The input of the Retinex filter must be conected to a color image"));
-    Message_box.exec();
+    warning("The input of the Retinex filter must be conected to a color image");
     return;
   }
 
@@ -287,14 +282,13 @@ void _filter_retinex::update()
   // Check the number of output channels
   if (Output_image_0->channels()==1){// conversion 3 to 1 channel
     cv::Mat *Aux_output_image;
-    Aux_output_image=new cv::Mat;
-    Aux_output_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC3);
+    Aux_output_image=new_aux_image(Input_image_0->rows,Input_image_0->cols,CV_8UC3);
     // joining the channels to the final image
     merge(Vec_channels_out_uc,*Aux_output_image);
     // from rgb to gray
     cvtColor(*Aux_output_image,*Output_image_0,cv::COLOR_RGB2GRAY,1);
 
-    delete Aux_output_image;
+    delete_aux_image(Aux_output_image);
   }
   else{// the same number of channels
     // joining the channels to the final image
@@ -333,10 +327,21 @@ void _filter_retinex::kernel_size(unsigned int Pos,int Value)
  *
  *****************************************************************************/
 
-_filter_retinex_ui::_filter_retinex_ui(_gl_widget *GL_widget1,std::string Name1)
+void _filter_retinex::read_parameters(std::map<std::string,std::string> &Parameters)
 {
-  Name=Name1;
-  Qtw_filter_retinex=new _qtw_filter_retinex(GL_widget1,this,Name1);
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(RETINEX_COLOR_RESTORATION_VARIANCE_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["color_restoration_variance"]=="default") parameter1(RETINEX_COLOR_RESTORATION_VARIANCE_DEFAULT);
+      else parameter1(atof(Parameters["color_restoration_variance"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of RETINEX filter" << std::endl;
+      exit(-1);
+    }
+  }
 }
 
 
@@ -346,23 +351,26 @@ _filter_retinex_ui::_filter_retinex_ui(_gl_widget *GL_widget1,std::string Name1)
  *
  *****************************************************************************/
 
-_filter_retinex_ui::_filter_retinex_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
+void _filter_retinex::write_parameters(std::map<std::string,std::string> &Parameters)
 {
-  read_parameters(Parameters);
-  Name=Name1;
-  Qtw_filter_retinex=new _qtw_filter_retinex(GL_widget1,this,Name1);
+  char Aux[100];
+
+  sprintf(Aux,"%5.2f",parameter1());
+  Parameters["color_restoration_variance"]=std::string(Aux);
 }
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
  *
  *****************************************************************************/
 
-_filter_retinex_ui::~_filter_retinex_ui()
+_filter_retinex_ui::_filter_retinex_ui(_gl_widget *GL_widget1,std::string Name1)
 {
-  delete Qtw_filter_retinex;
+  Name=Name1;
+  Qtw_filter_retinex=new _qtw_filter_retinex(GL_widget1,this,Name1);
 }
 
 
@@ -372,11 +380,11 @@ _filter_retinex_ui::~_filter_retinex_ui()
  *
  *****************************************************************************/
 
-void _filter_retinex_ui::reset_data()
+_filter_retinex_ui::_filter_retinex_ui(_gl_widget *GL_widget1, std::map<std::string, std::string> &Parameters, std::string Name1)
 {
-  _filter_retinex::reset_data();
-  Qtw_filter_retinex->set_parameter1(parameter1());
-  hide();
+  read_parameters(Parameters);
+  Name=Name1;
+  Qtw_filter_retinex=new _qtw_filter_retinex(GL_widget1,this,Name1);
 }
 
 
@@ -386,9 +394,9 @@ void _filter_retinex_ui::reset_data()
  *
  *****************************************************************************/
 
-void _filter_retinex_ui::show()
+_filter_retinex_ui::~_filter_retinex_ui()
 {
-  Qtw_filter_retinex->show();
+  delete Qtw_filter_retinex;
 }
 
 
@@ -398,9 +406,11 @@ void _filter_retinex_ui::show()
  *
  *****************************************************************************/
 
-void _filter_retinex_ui::hide()
+void _filter_retinex_ui::reset_data()
 {
-  Qtw_filter_retinex->hide();
+  _filter_retinex::reset_data();
+  Qtw_filter_retinex->set_parameter1(parameter1());
+  hide();
 }
 
 
@@ -410,9 +420,9 @@ void _filter_retinex_ui::hide()
  *
  *****************************************************************************/
 
-void *_filter_retinex_ui::get_link()
+void _filter_retinex_ui::show()
 {
-  return Qtw_filter_retinex->get_link();
+  Qtw_filter_retinex->show();
 }
 
 
@@ -422,23 +432,9 @@ void *_filter_retinex_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_retinex_ui::read_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_retinex_ui::hide()
 {
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(RETINEX_COLOR_RESTORATION_VARIANCE_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["color_restoration_variance"]=="default") parameter1(RETINEX_COLOR_RESTORATION_VARIANCE_DEFAULT);
-      else parameter1(atof(Parameters["color_restoration_variance"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of RETINEX filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
+  Qtw_filter_retinex->hide();
 }
 
 
@@ -448,12 +444,9 @@ void _filter_retinex_ui::read_parameters(std::map<std::string,std::string> &Para
  *
  *****************************************************************************/
 
-void _filter_retinex_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void *_filter_retinex_ui::get_link()
 {
-  char Aux[100];
-
-  sprintf(Aux,"%5.2f",parameter1());
-  Parameters["color_restoration_variance"]=std::string(Aux);
+  return Qtw_filter_retinex->get_link();
 }
 
 
@@ -538,6 +531,7 @@ _qtw_filter_retinex::~_qtw_filter_retinex()
 
 void _qtw_filter_retinex::set_parameter1_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter1_slot(Value);})) return;
   QString Str;
   char Aux[100];
   float Variance;
@@ -570,3 +564,4 @@ void _qtw_filter_retinex::set_parameter1(float Value)
   Line_edit_parameter1->setText(Str);
   Slider_parameter1->setValue(Int_value);
 }
+#endif // HEADLESS
@@ -17,6 +17,7 @@
 #ifndef _FILTER_RETINEX_H
 #define _FILTER_RETINEX_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QRadioButton>
@@ -24,6 +25,7 @@
 #include <QGridLayout>
 #include <QSlider>
 #include "line_edit.h"
+#endif
 //#include "qslider1.h"
 #include <string>
 #include <limits>
@@ -81,6 +83,12 @@ public:
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
 
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string, std::string> &Parameters);
+
+  void parameter1(float Value){_filter_retinex::color_restoration_variance(Value);};
+  float parameter1(){return _filter_retinex::color_restoration_variance();};
+
   void update();
 
   void color_restoration_variance(float Color_restoration_variance1);
@@ -100,6 +108,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -117,11 +126,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(float Value){_filter_retinex::color_restoration_variance(Value);};
-  float parameter1(){return _filter_retinex::color_restoration_variance();};
 
 private:
   _qtw_filter_retinex *Qtw_filter_retinex;
@@ -163,4 +167,5 @@ private:
   _gl_widget *GL_widget;
 };
 
+#endif // HEADLESS
 #endif
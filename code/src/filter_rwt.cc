@@ -15,10 +15,20 @@
 
 
 #include "filter_rwt.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
+
+#include <cstring>
+
+#ifndef WINDOWS
+#include <sys/mman.h>
+#endif
 
 using namespace _f_rwt_ns;
 
+_rwt_tileset _filter_rwt::Tileset;
+
 
 /*****************************************************************************//**
  *
@@ -39,8 +49,8 @@ _filter_rwt::_filter_rwt()
   Change_output_image_size=false;
   Use_dots=false;
 
-  loadTileSet("aux_code/rwt/tileset.dat");
-  points = new Vec2[MAX_POINTS];
+  numSubtiles=0;
+  numPoints=0;
 }
 
 
@@ -93,39 +103,43 @@ float _filter_rwt::sampleDensMap(float x, float y)
  *
  *****************************************************************************/
 
-void _filter_rwt::recurseTile(Tile & t, float x, float y, int level)
+void _filter_rwt::recurseTile(int t, float x, float y, int level)
 {
   float tileSize = 1.f/powf(float(numSubtiles), float(level));
   if ((x+tileSize < clipMinX) || (x > clipMaxX) || (y+tileSize < clipMinY) || (y > clipMaxY))
     return;
 
-  int numTests = mini(t.numSubPoints, int(powf(vpos.z, -2.f)/powf(float(numSubtiles), 2.f*level)*toneScale-t.numPoints));
+  int tNumPoints = Tileset.num_points(t);
+  int tNumSubPoints = Tileset.num_subpoints(t);
+  const float *subPointsX = Tileset.subpoints_x(t);
+  const float *subPointsY = Tileset.subpoints_y(t);
+
+  int numTests = mini(tNumSubPoints, int(powf(vpos.z, -2.f)/powf(float(numSubtiles), 2.f*level)*toneScale-tNumPoints));
   float factor = 1.f/powf(vpos.z, -2.f)*powf(float(numSubtiles), 2.f*level)/toneScale;
 
   for (int i = 0; i < numTests; i++)
   {
-    float px = x+t.subPoints[i].x*tileSize, py = y+t.subPoints[i].y*tileSize;
+    float px = x+subPointsX[i]*tileSize, py = y+subPointsY[i]*tileSize;
 
     // skip point if it lies outside of the clipping window
     if ((px < clipMinX) || (px > clipMaxX) || (py < clipMinY) || (py > clipMaxY))
       continue;
 
     // reject point based on its rank
-    if (sampleDensMap(px, py) < (i+t.numPoints)*factor)
+    if (sampleDensMap(px, py) < (i+tNumPoints)*factor)
       continue;
 
     // "draw" point
-    points[numPoints].x = px;
-    points[numPoints].y = py;
+    points.push_back(Vec2(px, py));
     numPoints++;
   }
 
   // recursion
-  if (powf(vpos.z, -2.f)/powf(float(numSubtiles), 2.f*level)*toneScale-t.numPoints > t.numSubPoints)
+  if (powf(vpos.z, -2.f)/powf(float(numSubtiles), 2.f*level)*toneScale-tNumPoints > tNumSubPoints)
   {
     for (int ty = 0; ty < numSubtiles; ty++)
       for (int tx = 0; tx < numSubtiles; tx++)
-        recurseTile(tiles[t.subdivs[0][ty*numSubtiles+tx]], x+tx*tileSize/numSubtiles, y+ty*tileSize/numSubtiles, level+1);
+        recurseTile(Tileset.subtile(t, ty*numSubtiles+tx), x+tx*tileSize/numSubtiles, y+ty*tileSize/numSubtiles, level+1);
   }
 }
 
@@ -143,6 +157,8 @@ void _filter_rwt::paintPoints()
   clipMinY = vpos.y;
   clipMaxY = vpos.y+vpos.z;
   numPoints = 0;
+  points.clear();
+  numSubtiles = Tileset.num_subtiles();
 
 //	float startTime = getTime();
 
@@ -150,11 +166,14 @@ void _filter_rwt::paintPoints()
 //  cout << "Valor2=" << powf(vpos.z, -2.f) << endl;
 //  cout << "Valor3=" << vpos.z << endl;
 
-  int numTests = mini((int)tiles[0].numPoints, int(powf(vpos.z, -2.f)*toneScale));
+  const float *pointsX = Tileset.points_x(0);
+  const float *pointsY = Tileset.points_y(0);
+
+  int numTests = mini(Tileset.num_points(0), int(powf(vpos.z, -2.f)*toneScale));
   float factor = 1.f/powf(vpos.z, -2)/toneScale;
   for (int i = 0; i < numTests; i++)
   {
-    float px = tiles[0].points[i].x, py = tiles[0].points[i].y;
+    float px = pointsX[i], py = pointsY[i];
 
     // skip point if it lies outside of the clipping window
     if ((px < clipMinX) || (px > clipMaxX) || (py < clipMinY) || (py > clipMaxY))
@@ -165,15 +184,14 @@ void _filter_rwt::paintPoints()
       continue;
 
     // "draw" point
-    points[numPoints].x = px;
-    points[numPoints].y = py;
+    points.push_back(Vec2(px, py));
     numPoints++;
 
 //    cout << "Punto: " << px << " " << py << endl;
   }
 
   // recursion
-  recurseTile(tiles[0], 0, 0, 0);
+  recurseTile(0, 0, 0, 0);
 
 //	float endTime = getTime();
 
@@ -203,74 +221,107 @@ void _filter_rwt::savePoints(const char * fileName)
 
 
 /*****************************************************************************//**
- *
- *
+ * Reads the tile set the first time. The file is mapped in memory when it is
+ * possible, and read complete in other case
  *
  *****************************************************************************/
 
-void _filter_rwt::loadTileSet(const char * fileName)
+bool _rwt_tileset::read(std::string File_name)
 {
-  FILE *fin;
+  std::lock_guard<std::mutex> Lock(Mutex);
 
+  if (Read) return Valid;
+  Read=true;
 
-  if ((fin=fopen(fileName,"rb"))!=nullptr){
+  FILE *File=fopen(File_name.c_str(),"rb");
+  if (File==nullptr){
+    std::cout << "Error: cannot open the file " << File_name << std::endl;
+    return false;
+  }
 
-    numTiles = freadi(fin);
-    numSubtiles = freadi(fin);
-    numSubdivs = freadi(fin);
+  fseek(File,0,SEEK_END);
+  size_t Size=ftell(File);
+  fseek(File,0,SEEK_SET);
 
-//    cout << "Num tiles " << numTiles << endl;
-//    cout << "Num subtiles " << numSubtiles << endl;
-//    cout << "Num subdivs " << numSubdivs << endl;
+  #ifndef WINDOWS
+  void *Address=mmap(nullptr,Size,PROT_READ,MAP_PRIVATE,fileno(File),0);
+  if (Address!=MAP_FAILED){
+    madvise(Address,Size,MADV_SEQUENTIAL);
+    Valid=parse((const unsigned char *)Address,Size);
+    munmap(Address,Size);
+  }
+  else
+  #endif
+  {
+    std::vector<unsigned char> Data(Size);
+    if (fread(Data.data(),1,Size,File)==Size) Valid=parse(Data.data(),Size);
+  }
 
-    tiles = new Tile[numTiles];
+  fclose(File);
 
-    for (int i = 0; i < numTiles; i++)
-    {
-      tiles[i].n = freadi(fin);
-      tiles[i].e = freadi(fin);
-      tiles[i].s = freadi(fin);
-      tiles[i].w = freadi(fin);
+  if (Valid==false) std::cout << "Error: the file " << File_name << " is not a valid tile set" << std::endl;
+  return Valid;
+}
 
-      tiles[i].subdivs = new int * [numSubdivs];
-      for (int j = 0; j < numSubdivs; j++)
-      {
-        int * subdiv = new int[sqri(numSubtiles)];
-        for (int k = 0; k < sqri(numSubtiles); k++)
-          subdiv[k] = freadi(fin);
-        tiles[i].subdivs[j] = subdiv;
-      }
 
-      tiles[i].numPoints = freadi(fin);
-  //    cout << "NumPoints " << tiles[i].numPoints << endl;
+/*****************************************************************************//**
+ * For each tile: the 4 edges, the subdivisions, the points and the subpoints.
+ * Each point has x and y and 4 integers that are not used
+ *
+ *****************************************************************************/
 
-      tiles[i].points = new Vec2[tiles[i].numPoints];
-      for (int j = 0; j < tiles[i].numPoints; j++)
-      {
-        tiles[i].points[j].x = freadf(fin);
-        tiles[i].points[j].y = freadf(fin);
+bool _rwt_tileset::parse(const unsigned char *Data, size_t Size)
+{
+  const size_t POINT_SIZE=2*sizeof(float)+4*sizeof(int);
+  size_t Position=0;
 
-  //      cout << "Points " << tiles[i].points[j].x << " " << tiles[i].points[j].y << endl;
-        freadi(fin);freadi(fin);freadi(fin);freadi(fin);
-      }
+  auto read_int=[&](int &Value)->bool{
+    if (Position+sizeof(int)>Size) return false;
+    memcpy(&Value,Data+Position,sizeof(int));
+    Position+=sizeof(int);
+    return true;
+  };
 
-      tiles[i].numSubPoints = freadi(fin);
-      tiles[i].subPoints = new Vec2[tiles[i].numSubPoints];
-      for (int j = 0; j < tiles[i].numSubPoints; j++)
-      {
-        tiles[i].subPoints[j].x = freadf(fin);
-        tiles[i].subPoints[j].y = freadf(fin);
-  //      cout << "SubPoints " << tiles[i].subPoints[j].x << " " << tiles[i].subPoints[j].y << endl;
-        freadi(fin);freadi(fin);freadi(fin);freadi(fin);
+  auto read_points=[&](std::vector<float> &Vec_x,std::vector<float> &Vec_y,std::vector<int> &Start)->bool{
+    int Num_points;
+    if (read_int(Num_points)==false || Num_points<0 || Position+(size_t)Num_points*POINT_SIZE>Size) return false;
+    for (int i=0;i<Num_points;i++){
+      float Point[2];
+      memcpy(Point,Data+Position,sizeof(Point));
+      Vec_x.push_back(Point[0]);
+      Vec_y.push_back(Point[1]);
+      Position+=POINT_SIZE;
+    }
+    Start.push_back((int)Vec_x.size());
+    return true;
+  };
+
+  int Num_subdivs;
+  if (read_int(Num_tiles)==false || read_int(Num_subtiles)==false || read_int(Num_subdivs)==false) return false;
+  if (Num_tiles<=0 || Num_subtiles<=0 || Num_subdivs<=0) return false;
+
+  Subdiv_size=sqri(Num_subtiles);
+  Subdivs.resize((size_t)Num_tiles*Subdiv_size);
+  Points_start.assign(1,0);
+  Subpoints_start.assign(1,0);
+
+  for (int Tile=0;Tile<Num_tiles;Tile++){
+    // the edges are not used
+    Position+=4*sizeof(int);
+
+    for (int Subdiv=0;Subdiv<Num_subdivs;Subdiv++){
+      for (int i=0;i<Subdiv_size;i++){
+        int Value;
+        if (read_int(Value)==false || Value<0 || Value>=Num_tiles) return false;
+        if (Subdiv==0) Subdivs[(size_t)Tile*Subdiv_size+i]=Value;
       }
     }
 
-    fclose(fin);
-  }
-  else{
-    std::cout << "Error: cannot open the file "  << fileName << std::endl;
-    exit(-1);
+    if (read_points(Points_x,Points_y,Points_start)==false) return false;
+    if (read_points(Subpoints_x,Subpoints_y,Subpoints_start)==false) return false;
   }
+
+  return true;
 }
 
 
@@ -297,20 +348,19 @@ void _filter_rwt::stippling(cv::Mat *Input_image0,cv::Mat *Output_image0)
     vpos.y =0;
     vpos.z =1;
     paintPoints();
+  }
+  else Local_change=false;
 
-    Output_image0->setTo(255);
-    for (int i=0;i<numPoints;i++){
-      Output_image0->at<unsigned char>(points[i].y*densTexSize,points[i].x*densTexSize)=(unsigned char)0;
-    }
+  // the positions are normalized between 0 and 1
+  std::shared_ptr<_point_set> Point_set=std::make_shared<_point_set>(numPoints);
 
+  Output_image0->setTo(255);
+  for (int i=0;i<numPoints;i++){
+    Output_image0->at<unsigned char>(points[i].y*densTexSize,points[i].x*densTexSize)=(unsigned char)0;
+    (*Point_set)[i]={points[i].x*densTexSize,points[i].y*densTexSize,0,-1};
   }
-  else{
-    Output_image0->setTo(255);
-    for (int i=0;i<numPoints;i++){
-      Output_image0->at<unsigned char>(points[i].y*densTexSize,points[i].x*densTexSize)=(unsigned char)0;
-    }
-    Local_change=false;
-  }
+
+  set_output_points(Point_set);
 }
 
 
@@ -326,10 +376,16 @@ void _filter_rwt::update()
   cv::Mat *Aux_input_image=nullptr;
   cv::Mat *Aux_output_image=nullptr;
 
+  // the tile set is read the first time that it is used
+  if (Tileset.read(TILESET_FILE_DEFAULT)==false){
+    warning("Filter RWT","Error: the tile set cannot be read. The folder 'aux_code/rwt' must be in the working folder");
+    copy_input_to_output();
+    return;
+  }
+
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
@@ -337,9 +393,7 @@ void _filter_rwt::update()
     if (Input_image_0->channels()==3){
       // conversion
 
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -351,8 +405,7 @@ void _filter_rwt::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       stippling(Aux_input_image,Aux_output_image);
 
@@ -364,13 +417,38 @@ void _filter_rwt::update()
     stippling(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 
   set_info1(numPoints);
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_rwt::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  Q_UNUSED(Parameters)
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_rwt::write_parameters(std::map<std::string, std::string> &Parameters)
+{
+  Q_UNUSED(Parameters)
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -465,21 +543,9 @@ void *_filter_rwt_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_rwt_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  Q_UNUSED(Parameters)
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_rwt_ui::write_parameters(std::map<std::string, std::string> &Parameters)
+void _filter_rwt_ui::set_info1(unsigned int Value1)
 {
-  Q_UNUSED(Parameters)
+  Info1=Value1;
 }
 
 
@@ -489,9 +555,9 @@ void _filter_rwt_ui::write_parameters(std::map<std::string, std::string> &Parame
  *
  *****************************************************************************/
 
-void _filter_rwt_ui::set_info1(unsigned int Value1)
+void _filter_rwt_ui::update_widgets()
 {
-  Qtw_filter_rwt->set_info1(Value1);
+  Qtw_filter_rwt->set_info1(Info1);
 }
 
 
@@ -780,3 +846,4 @@ void fwriteuc(FILE * fOut, unsigned char uc)
 {
   fwrite(&uc, sizeof(unsigned char), 1, fOut);
 }
+#endif // HEADLESS
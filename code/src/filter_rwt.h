@@ -17,12 +17,14 @@
 #ifndef _FILTER_RWT_H
 #define _FILTER_RWT_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QCheckBox>
 #include <QSlider>
 #include <QLabel>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -215,19 +217,56 @@ namespace _f_rwt_ns
   const double M_PI = 3.1415926535897932;
 #endif
 
-  #define MAX_POINTS 1024*1024
+  const std::string TILESET_FILE_DEFAULT("aux_code/rwt/tileset.dat");
 }
 
-// rwt
-struct Tile
+
+/*****************************************************************************//**
+ * The tile set of RWT. It is read the first time that a filter uses it, and then
+ * it is shared by all the filters and threads without changes. The file is mapped
+ * in memory and parsed once. The points of all the tiles are saved together (x and y
+ * in different arrays), and the first point of each tile is saved in a table
+ *****************************************************************************/
+
+class _rwt_tileset
 {
-  int n, e, s, w;
-  int numSubtiles, numSubdivs, numPoints, numSubPoints;
-  int ** subdivs;
-  Vec2 * points, * subPoints;
+public:
+  // false if the file cannot be read. It is only tried once
+  bool read(std::string File_name);
+
+  int num_subtiles(){return Num_subtiles;};
+  int num_points(int Tile){return Points_start[Tile+1]-Points_start[Tile];};
+  int num_subpoints(int Tile){return Subpoints_start[Tile+1]-Subpoints_start[Tile];};
+  const float *points_x(int Tile){return &Points_x[Points_start[Tile]];};
+  const float *points_y(int Tile){return &Points_y[Points_start[Tile]];};
+  const float *subpoints_x(int Tile){return &Subpoints_x[Subpoints_start[Tile]];};
+  const float *subpoints_y(int Tile){return &Subpoints_y[Subpoints_start[Tile]];};
+  // the tile that is in Position of the subdivision of Tile
+  int subtile(int Tile,int Position){return Subdivs[(size_t)Tile*Subdiv_size+Position];};
+
+protected:
+  bool parse(const unsigned char *Data,size_t Size);
+
+  bool Read=false;
+  bool Valid=false;
+  int Num_tiles=0;
+  int Num_subtiles=0;
+  // only the first subdivision of each tile is used, so it is the only one saved
+  int Subdiv_size=0;
+
+  std::vector<int> Subdivs;
+  std::vector<int> Points_start;
+  std::vector<float> Points_x;
+  std::vector<float> Points_y;
+  std::vector<int> Subpoints_start;
+  std::vector<float> Subpoints_x;
+  std::vector<float> Subpoints_y;
+
+  std::mutex Mutex;
 };
 
 
+
 class _gl_widget;
 class _qtw_filter_rwt;
 
@@ -247,15 +286,17 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string,std::string> &Parameters);
+
     void stippling(cv::Mat *Input_image0,cv::Mat *Output_image0);
     void update();
 
     // rwt
     float sampleDensMap(float x, float y);
-    void recurseTile(Tile & t, float x, float y, int level);
+    void recurseTile(int t, float x, float y, int level);
     void paintPoints();
     void savePoints(const char * fileName);
-    void loadTileSet(const char * fileName);
     void recursive_wang_tiles(_gl_widget *GLWidget1);
 
     virtual void set_info1(unsigned int Value){Q_UNUSED(Value)};
@@ -280,16 +321,20 @@ public:
     float toneScale = 200000;
 
     float clipMinX, clipMaxX, clipMinY, clipMaxY;
-    int numTiles, numSubtiles, numSubdivs;
-    Tile *tiles;
-    Vec2 *points;
+    int numSubtiles;
+    // it grows with the number of points and it is reused
+    std::vector<Vec2> points;
     int numPoints;
     int densTexSize;
     float *densTex = 0;
     Vec3 vpos;
+
+    // shared by all the filters
+    static _rwt_tileset Tileset;
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -304,19 +349,20 @@ public:
   ~_filter_rwt_ui();
   void reset_data();
 
-
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
 
   void local_change(bool Value){Local_change=Value;};
 
   void set_info1(unsigned int Value1);
+  void update_widgets();
+  void write_results(std::map<std::string,std::string> &Results){Results["info1"]=std::to_string(Info1);};
+  void read_results(std::map<std::string,std::string> &Results){Info1=(unsigned int)atoi(Results["info1"].c_str());};
 
 private:
   _qtw_filter_rwt *Qtw_filter_rwt;
+  unsigned int Info1=0;
 };
 
 
@@ -349,6 +395,7 @@ private:
   _filter_rwt_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
 
 
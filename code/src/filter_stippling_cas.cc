@@ -15,7 +15,9 @@
 
 
 #include "filter_stippling_cas.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_stippling_cas_ns;
 
@@ -200,17 +202,14 @@ void _filter_stippling_cas::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -222,8 +221,7 @@ void _filter_stippling_cas::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
       stippling(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_input_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
     }
@@ -233,11 +231,71 @@ void _filter_stippling_cas::update()
     stippling(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_stippling_cas::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
+    parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
+    parameter3(HALFTONING_CAH_G_PLUS_DEFAULT);
+    parameter4(HALFTONING_CAH_G_MINUS_DEFAULT);
+    parameter5(HALFTONING_CAH_K_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      if (Parameters["kernel_size"]=="default") parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
+      else parameter1(atoi(Parameters["kernel_size"].c_str()));
+      if (Parameters["exponent"]=="default") parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
+      else parameter2(atof(Parameters["exponent"].c_str()));
+      if (Parameters["g+"]=="default") parameter3(HALFTONING_CAH_G_PLUS_DEFAULT);
+      else parameter3(atoi(Parameters["g+"].c_str()));
+      if (Parameters["g-"]=="default") parameter4(HALFTONING_CAH_G_MINUS_DEFAULT);
+      else parameter4(atoi(Parameters["g-"].c_str()));
+      if (Parameters["k"]=="default") parameter5(HALFTONING_CAH_K_DEFAULT);
+      else parameter5(atof(Parameters["k"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of STIPPLING_CAS filter" << std::endl;
+      exit(-1);
+    };
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_stippling_cas::write_parameters(std::map<std::string,std::string> &Parameters)
+{
+  char Aux[100];
+
+  sprintf(Aux,"%d",parameter1());
+  Parameters["kernel_size"]=std::string(Aux);
+  sprintf(Aux,"%5.2f",parameter2());
+  Parameters["exponent"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter3());
+  Parameters["g+"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter4());
+  Parameters["g-"]=std::string(Aux);
+  sprintf(Aux,"%5.2f",parameter5());
+  Parameters["k"]=std::string(Aux);
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -331,67 +389,6 @@ void *_filter_stippling_cas_ui::get_link()
 }
 
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_stippling_cas_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
-    parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
-    parameter3(HALFTONING_CAH_G_PLUS_DEFAULT);
-    parameter4(HALFTONING_CAH_G_MINUS_DEFAULT);
-    parameter5(HALFTONING_CAH_K_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      if (Parameters["kernel_size"]=="default") parameter1(HALFTONING_CAH_KERNEL_SIZE_DEFAULT);
-      else parameter1(atoi(Parameters["kernel_size"].c_str()));
-      if (Parameters["exponent"]=="default") parameter2(HALFTONING_CAH_EXPONENT_DEFAULT);
-      else parameter2(atof(Parameters["exponent"].c_str()));
-      if (Parameters["g+"]=="default") parameter3(HALFTONING_CAH_G_PLUS_DEFAULT);
-      else parameter3(atoi(Parameters["g+"].c_str()));
-      if (Parameters["g-"]=="default") parameter4(HALFTONING_CAH_G_MINUS_DEFAULT);
-      else parameter4(atoi(Parameters["g-"].c_str()));
-      if (Parameters["k"]=="default") parameter5(HALFTONING_CAH_K_DEFAULT);
-      else parameter5(atof(Parameters["k"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of STIPPLING_CAS filter");
-      MsgBox.exec();
-      exit(-1);
-    };
-  }
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_stippling_cas_ui::write_parameters(std::map<std::string,std::string> &Parameters)
-{
-  char Aux[100];
-
-  sprintf(Aux,"%d",parameter1());
-  Parameters["kernel_size"]=std::string(Aux);
-  sprintf(Aux,"%5.2f",parameter2());
-  Parameters["exponent"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter3());
-  Parameters["g+"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter4());
-  Parameters["g-"]=std::string(Aux);
-  sprintf(Aux,"%5.2f",parameter5());
-  Parameters["k"]=std::string(Aux);
-}
-
-
 /*****************************************************************************//**
  *
  *
@@ -692,6 +689,7 @@ void _qtw_filter_stippling_cas::set_parameter5(float Value)
 
 void _qtw_filter_stippling_cas::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -714,6 +712,7 @@ void _qtw_filter_stippling_cas::set_parameter1_slot(int Size)
 
 void _qtw_filter_stippling_cas::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
   float Value=(float)Size/Parameter2_factor;
@@ -734,6 +733,7 @@ void _qtw_filter_stippling_cas::set_parameter2_slot(int Size)
 
 void _qtw_filter_stippling_cas::set_parameter3_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter3_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -754,6 +754,7 @@ void _qtw_filter_stippling_cas::set_parameter3_slot(int Size)
 
 void _qtw_filter_stippling_cas::set_parameter4_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter4_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -774,6 +775,7 @@ void _qtw_filter_stippling_cas::set_parameter4_slot(int Size)
 
 void _qtw_filter_stippling_cas::set_parameter5_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter5_slot(Size);})) return;
   QString Str;
   char Aux[100];
   float Value=(float)Size/Parameter5_factor;
@@ -784,3 +786,4 @@ void _qtw_filter_stippling_cas::set_parameter5_slot(int Size)
   Filter->parameter5(Value);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
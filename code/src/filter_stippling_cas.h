@@ -17,14 +17,18 @@
 #ifndef _FILTER_STIPPLING_CA_H
 #define _FILTER_STIPPLING_CA_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
+#endif
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 
@@ -133,6 +137,24 @@ public:
     bool change_output_image_size(){return Change_output_image_size;};
     bool use_dots(){return Use_dots;};
 
+    void read_parameters(std::map<std::string,std::string> &Parameters);
+    void write_parameters(std::map<std::string, std::string> &Parameters);
+
+    void parameter1(int Value){_filter_stippling_cas::kernel_size(Value);};
+    int parameter1(){return _filter_stippling_cas::kernel_size();};
+
+    void parameter2(float Value){_filter_stippling_cas::exponent(Value);};
+    float parameter2(){return _filter_stippling_cas::exponent();};
+
+    void parameter3(int Value){_filter_stippling_cas::g_plus(Value);};
+    int parameter3(){return _filter_stippling_cas::g_plus();};
+
+    void parameter4(int Value){_filter_stippling_cas::g_minus(Value);};
+    int parameter4(){return _filter_stippling_cas::g_minus();};
+
+    void parameter5(float Value){_filter_stippling_cas::k(Value);};
+    float parameter5(){return _filter_stippling_cas::k();};
+
 
     void stippling(cv::Mat *Input_image0,cv::Mat *Output_image0);
     void update();
@@ -157,6 +179,7 @@ public:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -174,23 +197,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Value){_filter_stippling_cas::kernel_size(Value);};
-  int parameter1(){return _filter_stippling_cas::kernel_size();};
-
-  void parameter2(float Value){_filter_stippling_cas::exponent(Value);};
-  float parameter2(){return _filter_stippling_cas::exponent();};
-
-  void parameter3(int Value){_filter_stippling_cas::g_plus(Value);};
-  int parameter3(){return _filter_stippling_cas::g_plus();};
-
-  void parameter4(int Value){_filter_stippling_cas::g_minus(Value);};
-  int parameter4(){return _filter_stippling_cas::g_minus();};
-
-  void parameter5(float Value){_filter_stippling_cas::k(Value);};
-  float parameter5(){return _filter_stippling_cas::k();};
 
   private:
   _qtw_filter_stippling_cas *Qtw_filter_stippling_cas;
@@ -258,4 +264,5 @@ private:
   _filter_stippling_cas_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
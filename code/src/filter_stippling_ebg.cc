@@ -15,7 +15,9 @@
 
 
 #include "filter_stippling_ebg.h"
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_stippling_ebg_ns;
 
@@ -48,6 +50,8 @@ _filter_stippling_ebg::_filter_stippling_ebg()
   Seeds_initialized=false;
   Dots_texture_packet=0;
   Use_dots=true;
+
+  Dots=nullptr;
 }
 
 
@@ -71,18 +75,6 @@ void _filter_stippling_ebg::reset_data()
 }
 
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_stippling_ebg::set_dots_images(std::vector<std::vector<cv::Mat *> > *Dots1)
-{
-  Dots=Dots1;
-}
-
-
 /*****************************************************************************//**
  *
  *
@@ -131,7 +123,7 @@ void _filter_stippling_ebg::put_dot(cv::Mat *Output_image0,float Row1,float Col1
     for (Col=0;Col<(int)(Selected_dot_size1*Pixel_density_factor);Col++){
       // get the value of the image of dots of size Selected_dot_size1
 
-      Value=(*Dots)[Pixel_density][Selected_dot_size1]->at<unsigned char>(Row+Row_aux,Col+Col_aux);
+      Value=(*Dots)[Selected_dot_size1].at<unsigned char>(Row+Row_aux,Col+Col_aux);
       // output position
       Row_out=Row1+Row;
       Col_out=Col1+Col;
@@ -217,20 +209,24 @@ void _filter_stippling_ebg::update()
 
   int Width1,Height1;
 
+  // the images of dots are read the first time that they are used
+  Dots=dots_packet((int)Pixel_density);
+  if (Dots==nullptr){
+    copy_input_to_output();
+    return;
+  }
+
   output_image_size(Width1,Height1);
   // check the output size
   if (Input_image_0->cols!=Width1 || Input_image_0->rows!=Height1){
-    Output_image_0->release();
-    Output_image_0->create(Height1,Width1,CV_8UC1);
+    create_output_image(Height1,Width1,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -242,8 +238,7 @@ void _filter_stippling_ebg::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       // set the output image to white
       Output_image_0->setTo(cv::Scalar(255,255,255));
@@ -258,8 +253,8 @@ void _filter_stippling_ebg::update()
     stippling(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -305,6 +300,19 @@ void _filter_stippling_ebg::load_seeds()
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_stippling_ebg::write_internal_state(std::map<std::string,std::string> &State)
+{
+  State["_seeds"]=std::to_string(Index_row.Saved_seed)+" "+std::to_string(Index_col.Saved_seed)+" "+std::to_string(Displacement.Saved_seed)+" "+std::to_string(Dot_size.Saved_seed);
+  State["_dots_texture_packet"]=std::to_string(Dots_texture_packet);
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -327,6 +335,78 @@ void _filter_stippling_ebg::adjust_image_sizes(int &Width1, int &Height1)
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_stippling_ebg::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    parameter1(STIPPLING_EBG_PIXEL_DENSITY_DEFAULT);
+    parameter2(STIPPLING_EBG_DISPLACEMENT_DEFAULT);
+    parameter3(STIPPLING_EBG_OUTPUT_MODE_DEFAULT);
+    parameter4(STIPPLING_EBG_BLACK_LEVEL_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+
+      if (Parameters["pixel_density"]=="default") parameter1(STIPPLING_EBG_PIXEL_DENSITY_DEFAULT);
+      else{
+        if (Parameters["pixel_density"]=="300ppi") parameter1((int) PIXEL_DENSITY_300PPI);
+        if (Parameters["pixel_density"]=="600ppi") parameter1((int) PIXEL_DENSITY_600PPI);
+        if (Parameters["pixel_density"]=="1200ppi") parameter1((int) PIXEL_DENSITY_1200PPI);
+      }
+
+      if (Parameters["displacement_ramdomness"]=="default") parameter2(STIPPLING_EBG_DISPLACEMENT_DEFAULT);
+      else parameter2(atof(Parameters["displacement_ramdomness"].c_str()));
+
+      if (Parameters["black_dots"]=="default") parameter3(STIPPLING_EBG_OUTPUT_MODE_DEFAULT);
+      else{
+        if (Parameters["black_dots"]=="true") parameter3((int) OUTPUT_MODE_MONO_COLOR);
+        else parameter3((int) OUTPUT_MODE_GRAYSCALE);
+      }
+
+      if (Parameters["black_threshold"]=="default") parameter4(STIPPLING_EBG_BLACK_LEVEL_DEFAULT);
+      else parameter4(atoi(Parameters["black_threshold"].c_str()));
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of STIPPLING_EBG filter" << std::endl;
+      exit(-1);
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_stippling_ebg::write_parameters(std::map<std::string,std::string> &Parameters)
+{
+  char Aux[100];
+
+  switch (parameter1()){
+  case 0:Parameters["pixel_density"]=std::string("300ppi");break;
+  case 1:Parameters["pixel_density"]=std::string("600ppi");break;
+  case 2:Parameters["pixel_density"]=std::string("1200ppi");break;
+  }
+
+  sprintf(Aux,"%5.2f",parameter2());
+  Parameters["displacement_ramdomness"]=std::string(Aux);
+
+  if (parameter3()==(int) OUTPUT_MODE_MONO_COLOR) Parameters["black_dots"]=std::string("true");
+  else Parameters["black_dots"]=std::string("false");
+
+  sprintf(Aux,"%3d",parameter4());
+  Parameters["black_threshold"]=std::string(Aux);
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -422,70 +502,9 @@ void *_filter_stippling_ebg_ui::get_link()
  *
  *****************************************************************************/
 
-void _filter_stippling_ebg_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    parameter1(STIPPLING_EBG_PIXEL_DENSITY_DEFAULT);
-    parameter2(STIPPLING_EBG_DISPLACEMENT_DEFAULT);
-    parameter3(STIPPLING_EBG_OUTPUT_MODE_DEFAULT);
-    parameter4(STIPPLING_EBG_BLACK_LEVEL_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-
-      if (Parameters["pixel_density"]=="default") parameter1(STIPPLING_EBG_PIXEL_DENSITY_DEFAULT);
-      else{
-        if (Parameters["pixel_density"]=="300ppi") parameter1((int) PIXEL_DENSITY_300PPI);
-        if (Parameters["pixel_density"]=="600ppi") parameter1((int) PIXEL_DENSITY_600PPI);
-        if (Parameters["pixel_density"]=="1200ppi") parameter1((int) PIXEL_DENSITY_1200PPI);
-      }
-
-      if (Parameters["displacement_ramdomness"]=="default") parameter2(STIPPLING_EBG_DISPLACEMENT_DEFAULT);
-      else parameter2(atof(Parameters["displacement_ramdomness"].c_str()));
-
-      if (Parameters["black_dots"]=="default") parameter3(STIPPLING_EBG_OUTPUT_MODE_DEFAULT);
-      else{
-        if (Parameters["black_dots"]=="true") parameter3((int) OUTPUT_MODE_MONO_COLOR);
-        else parameter3((int) OUTPUT_MODE_GRAYSCALE);
-      }
-
-      if (Parameters["black_threshold"]=="default") parameter4(STIPPLING_EBG_BLACK_LEVEL_DEFAULT);
-      else parameter4(atoi(Parameters["black_threshold"].c_str()));
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of STIPPLING_EBG filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_stippling_ebg_ui::write_parameters(std::map<std::string,std::string> &Parameters)
+void _filter_stippling_ebg_ui::set_info1(unsigned int Value1)
 {
-  char Aux[100];
-
-  switch (parameter1()){
-  case 0:Parameters["pixel_density"]=std::string("300ppi");break;
-  case 1:Parameters["pixel_density"]=std::string("600ppi");break;
-  case 2:Parameters["pixel_density"]=std::string("1200ppi");break;
-  }
-
-  sprintf(Aux,"%5.2f",parameter2());
-  Parameters["displacement_ramdomness"]=std::string(Aux);
-
-  if (parameter3()==(int) OUTPUT_MODE_MONO_COLOR) Parameters["black_dots"]=std::string("true");
-  else Parameters["black_dots"]=std::string("false");
-
-  sprintf(Aux,"%3d",parameter4());
-  Parameters["black_threshold"]=std::string(Aux);
+  Info1=Value1;
 }
 
 
@@ -495,9 +514,9 @@ void _filter_stippling_ebg_ui::write_parameters(std::map<std::string,std::string
  *
  *****************************************************************************/
 
-void _filter_stippling_ebg_ui::set_info1(unsigned int Value1)
+void _filter_stippling_ebg_ui::update_widgets()
 {
-  Qtw_filter_stippling_ebg->set_info1(Value1);
+  Qtw_filter_stippling_ebg->set_info1(Info1);
 }
 
 
@@ -729,6 +748,7 @@ void _qtw_filter_stippling_ebg::set_info1(unsigned int Value)
 
 void _qtw_filter_stippling_ebg::set_parameter1_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter1_slot(Value);})) return;
   Filter->parameter1(Value);
   GL_widget->update_effect(Filter->Name);
 }
@@ -742,6 +762,7 @@ void _qtw_filter_stippling_ebg::set_parameter1_slot(int Value)
 
 void _qtw_filter_stippling_ebg::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
   float Value=(float)Size/(float)Parameter2_factor;
@@ -762,6 +783,7 @@ void _qtw_filter_stippling_ebg::set_parameter2_slot(int Size)
 
 void _qtw_filter_stippling_ebg::set_parameter3_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter3_slot(Value);})) return;
   switch((_output_mode) Value){
   case OUTPUT_MODE_GRAYSCALE:
     Group_box_parameter4->setEnabled(false);
@@ -784,6 +806,7 @@ void _qtw_filter_stippling_ebg::set_parameter3_slot(int Value)
 
 void _qtw_filter_stippling_ebg::set_parameter4_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter4_slot(Value);})) return;
 QString Str;
 char Aux[100];
 
@@ -793,3 +816,4 @@ char Aux[100];
   Filter->parameter4(Value);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
@@ -17,15 +17,18 @@
 #ifndef _FILTER_STIPPLING_EBG_H
 #define _FILTER_STIPPLING_EBG_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
 #include <QLabel>
 #include <QComboBox>
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 #include "random.h"
+#include "vertex.h"
 
 #define DEFINED_FILTER_EXAMPLE_GRAYSCALE_BASED_STIPPLING
 
@@ -118,6 +121,25 @@ public:
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
 
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string, std::string> &Parameters);
+
+  // the result depends on the seeds, that are produced in the first update
+  bool cacheable(){return Seeds_initialized;};
+  void write_internal_state(std::map<std::string,std::string> &State);
+
+  void parameter1(int Value){pixel_density(Value);};
+  int parameter1(){return pixel_density();};
+
+  void parameter2(float Value){_filter_stippling_ebg::displacement_ramdomness(Value);};
+  float parameter2(){return _filter_stippling_ebg::displacement_ramdomness();};
+
+  void parameter3(int Value){output_mode(Value);};
+  int parameter3(){return (int) output_mode();};
+
+  void parameter4(int Value){black_level(Value);};
+  int parameter4(){return black_level();};
+
   void output_image_size(int &Width1,int &Height1);
 
   void pixel_density(int Pixel_density1);
@@ -132,7 +154,6 @@ public:
   void black_level(int Black_level1){Black_level=Black_level1;};
   int black_level(){return Black_level;};
 
-  void set_dots_images(std::vector<std::vector<cv::Mat *>> *Dots);
   void set_dots_texture_packet(int Dots_texture_packet1){Dots_texture_packet=Dots_texture_packet1;}
 
   void put_dot(cv::Mat *Output_image1, float Row1, float Col1, unsigned int Selected_dot_size1, unsigned int Index_row1, unsigned int Index_col1);
@@ -152,7 +173,8 @@ public:
   int Output_mode;
   int Black_level;
 
-  std::vector<std::vector<cv::Mat *>> *Dots;
+  // the packet of the dots cache that is used in the computation
+  std::vector<cv::Mat> *Dots;
 
   _random_uniform_int Index_row,Index_col;
   _random_uniform_int Dot_size;
@@ -167,6 +189,7 @@ protected:
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -184,25 +207,15 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string, std::string> &Parameters);
-
-  void parameter1(int Value){pixel_density(Value);};
-  int parameter1(){return pixel_density();};
-
-  void parameter2(float Value){_filter_stippling_ebg::displacement_ramdomness(Value);};
-  float parameter2(){return _filter_stippling_ebg::displacement_ramdomness();};
-
-  void parameter3(int Value){output_mode(Value);};
-  int parameter3(){return (int) output_mode();};
-
-  void parameter4(int Value){black_level(Value);};
-  int parameter4(){return black_level();};
 
   void set_info1(unsigned int Value1);
+  void update_widgets();
+  void write_results(std::map<std::string,std::string> &Results){Results["info1"]=std::to_string(Info1);};
+  void read_results(std::map<std::string,std::string> &Results){Info1=(unsigned int)atoi(Results["info1"].c_str());};
 
 private:
   _qtw_filter_stippling_ebg *Qtw_filter_stippling_ebg;
+  unsigned int Info1=0;
 };
 
 
@@ -266,4 +279,5 @@ private:
   _filter_stippling_ebg_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
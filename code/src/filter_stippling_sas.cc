@@ -200,17 +200,14 @@ void _filter_stippling_sas::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,CV_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << endl;
   }
@@ -222,8 +219,7 @@ void _filter_stippling_sas::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
       stippling(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_input_image,*Output_image_0,CV_GRAY2RGB,3);
     }
@@ -233,8 +229,8 @@ void _filter_stippling_sas::update()
     stippling(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -692,6 +688,7 @@ void _qtw_filter_stippling_sas::set_parameter5(float Value)
 
 void _qtw_filter_stippling_sas::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -714,6 +711,7 @@ void _qtw_filter_stippling_sas::set_parameter1_slot(int Size)
 
 void _qtw_filter_stippling_sas::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
   float Value=(float)Size/Parameter2_factor;
@@ -734,6 +732,7 @@ void _qtw_filter_stippling_sas::set_parameter2_slot(int Size)
 
 void _qtw_filter_stippling_sas::set_parameter3_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter3_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -754,6 +753,7 @@ void _qtw_filter_stippling_sas::set_parameter3_slot(int Size)
 
 void _qtw_filter_stippling_sas::set_parameter4_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter4_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -774,6 +774,7 @@ void _qtw_filter_stippling_sas::set_parameter4_slot(int Size)
 
 void _qtw_filter_stippling_sas::set_parameter5_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter5_slot(Size);})) return;
   QString Str;
   char Aux[100];
   float Value=(float)Size/Parameter5_factor;
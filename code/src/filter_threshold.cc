@@ -71,16 +71,13 @@ void _filter_threshold::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,CV_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << endl;
   }
@@ -92,8 +89,7 @@ void _filter_threshold::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Output_image_0->rows,Output_image_0->cols,CV_8UC1);
 
       cv::threshold(*Aux_input_image,*Aux_output_image,Threshold,Max_binary_value,Threshold_type);
       cvtColor(*Aux_output_image,*Output_image_0,CV_GRAY2RGB,3);
@@ -104,8 +100,8 @@ void _filter_threshold::update()
     cv::threshold(*Aux_input_image,*Output_image_0,Threshold,Max_binary_value,Threshold_type);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 }
 
 
@@ -415,6 +411,7 @@ void _qtw_filter_threshold::set_parameter3(int Value)
 
 void _qtw_filter_threshold::set_parameter1_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter1_slot(Value);})) return;
   Filter->parameter1((_threshold_type) Value);
   GL_widget->update_effect(Filter->Name);
 }
@@ -428,6 +425,7 @@ void _qtw_filter_threshold::set_parameter1_slot(int Value)
 
 void _qtw_filter_threshold::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -447,6 +445,7 @@ void _qtw_filter_threshold::set_parameter2_slot(int Size)
 
 void _qtw_filter_threshold::set_parameter3_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter3_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -84,6 +84,7 @@ public:
 
 
     void update();
+    int halo(){return 0;};
 
     void threshold_type(_f_threshold::_threshold_type Threshold_type1){Threshold_type=Threshold_type1;};
     _f_threshold::_threshold_type threshold_type(){return Threshold_type;};
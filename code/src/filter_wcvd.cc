@@ -15,7 +15,11 @@
 
 
 #include "filter_wcvd.h"
+#include "result_cache.h"
+#include <algorithm>
+#ifndef HEADLESS
 #include "glwidget.h"
+#endif
 
 using namespace _f_wcvd_ns;
 
@@ -47,6 +51,7 @@ _filter_wcvd::_filter_wcvd()
   Dark_points_counted=false;
 
   Save_intermediate_images=false;
+  Warm_input_hash=0;
 
   Percent_fixed_centroidals=WCVD_PERCENT_FIXED_CENTROIDALS;
   Number_of_iteractions=WCVD_NUM_ITERACTIONS_DEFAULT;
@@ -74,6 +79,8 @@ void _filter_wcvd::reset_data()
 
   C1.init(0,1);
   C1.set_seed(1000);
+
+  clear_warm_start();
 }
 
 
@@ -229,6 +236,69 @@ void _filter_wcvd::create_random_points(cv::Mat *Input_image)
 }
 
 
+/*****************************************************************************//**
+ * The initial points are the points of the last WCVD, changed to the new number
+ * of dots. To add dots, the cells with more weight are split: the new point and
+ * the old one are put at both sides of the old position, at half of the radius
+ * of the cell, and the Lloyd iterations separate them. To remove dots, the cells
+ * with less weight are removed, and their neighbors take their pixels
+ *****************************************************************************/
+
+void _filter_wcvd::create_warm_points()
+{
+  std::vector<_vertex3f> Vec_points=Warm_points;
+  std::vector<float> Vec_weights=Warm_weights;
+  std::vector<int> Order;
+
+  while (Vec_points.size()!=Number_of_good_dots){
+    // from more to less weight
+    Order.resize(Vec_points.size());
+    for (unsigned int i=0;i<Order.size();i++) Order[i]=i;
+    std::stable_sort(Order.begin(),Order.end(),[&Vec_weights](int Point1,int Point2){return Vec_weights[Point1]>Vec_weights[Point2];});
+
+    if (Vec_points.size()>Number_of_good_dots){
+      std::vector<bool> Removed(Vec_points.size(),false);
+      for (unsigned int i=Number_of_good_dots;i<Order.size();i++) Removed[Order[i]]=true;
+
+      unsigned int Count=0;
+      for (unsigned int i=0;i<Vec_points.size();i++){
+        if (Removed[i]==false){
+          Vec_points[Count]=Vec_points[i];
+          Vec_weights[Count]=Vec_weights[i];
+          Count++;
+        }
+      }
+      Vec_points.resize(Count);
+      Vec_weights.resize(Count);
+    }
+    else{
+      // each cell is split once in each pass
+      unsigned int Num_splits=std::min((unsigned int)(Number_of_good_dots-Vec_points.size()),(unsigned int)Vec_points.size());
+      for (unsigned int i=0;i<Num_splits;i++){
+        int Point=Order[i];
+        float Distance=std::max(sqrtf(Vec_weights[Point]/(float)M_PI)/2.0f,MIN_DOTS_DISTANCE);
+        float Angle=(float)(2*M_PI*C1.value());
+        _vertex3f Offset(Distance*cosf(Angle),Distance*sinf(Angle),0);
+        _vertex3f Point1=Vec_points[Point]+Offset;
+        _vertex3f Point2=Vec_points[Point]-Offset;
+
+        Point1.x=std::min(std::max(Point1.x,2.0f),(float)Window_width-2);
+        Point1.y=std::min(std::max(Point1.y,2.0f),(float)Window_height-2);
+        Point2.x=std::min(std::max(Point2.x,2.0f),(float)Window_width-2);
+        Point2.y=std::min(std::max(Point2.y,2.0f),(float)Window_height-2);
+
+        Vec_points[Point]=Point1;
+        Vec_weights[Point]/=2;
+        Vec_points.push_back(Point2);
+        Vec_weights.push_back(Vec_weights[Point]);
+      }
+    }
+  }
+
+  for (unsigned int i=0;i<Number_of_good_dots;i++) New_positions[i]=Vec_points[i];
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -502,6 +572,7 @@ void _filter_wcvd::compute_centroids(cv::Mat *Input_image)
         New_positions[Count].y=New_positions[i].y;
         Moved_points++;
       }
+      Pixels_count[Count]=Pixels_count[i];
       Count++;
     }
   }
@@ -582,9 +653,14 @@ void _filter_wcvd::draw_triangles()
 
 void _filter_wcvd::draw_dots(cv::Mat *Output_image)
 {
+  std::shared_ptr<_point_set> Point_set=std::make_shared<_point_set>(Number_of_good_dots);
+
   for (unsigned int i=0;i<Number_of_good_dots;i++){
     Output_image->at<unsigned char>((int) Points[i].y,(int) Points[i].x)=0;
+    (*Point_set)[i]={Points[i].x,Points[i].y,0,-1};
   }
+
+  set_output_points(Point_set);
 }
 
 
@@ -638,8 +714,13 @@ void _filter_wcvd::wcvd(cv::Mat *Input_image0,cv::Mat *Output_image0)
     count_dark_pixels(Input_image0);
     initialize();
 
+    // only the number of dots or the stop condition have changed
+    uint64_t Input_hash=_result_cache::hash(Input_image0);
+    bool Warm_start=(Warm_points.size()>0 && Input_hash==Warm_input_hash);
+
     if (Number_of_good_dots>0){
-      create_random_points(Input_image0);
+      if (Warm_start) create_warm_points();
+      else create_random_points(Input_image0);
 
        GL_widget->makeCurrent();
 
@@ -713,6 +794,10 @@ void _filter_wcvd::wcvd(cv::Mat *Input_image0,cv::Mat *Output_image0)
       // the WCVD is computed. Now the obtained points must be drawn
       copy_points();
 
+      Warm_input_hash=Input_hash;
+      Warm_points.assign(Points.begin(),Points.begin()+Number_of_good_dots);
+      Warm_weights.assign(Pixels_count.begin(),Pixels_count.begin()+Number_of_good_dots);
+
       if (Save_intermediate_images){
         clear_window();
         create_drawing();
@@ -755,17 +840,14 @@ void _filter_wcvd::update()
 
   // check the output size
   if (Input_image_0->cols!=Output_image_0->cols || Input_image_0->rows!=Output_image_0->rows){
-    Output_image_0->release();
-    Output_image_0->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+    create_output_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
   }
 
   // Check the number of input channels
   if (Input_image_0->channels()!=Num_channels_input_image_0){// Different number of channels
     if (Input_image_0->channels()==3){
       // conversion
-      Aux_input_image=new cv::Mat;
-      Aux_input_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
-      cvtColor(*Input_image_0,*Aux_input_image,cv::COLOR_BGR2GRAY,1);
+      Aux_input_image=new_gray_image(Input_image_0);
     }
     else std::cout << "Error in the number of channels in the input image " << __LINE__ << " " << __FILE__ << std::endl;
   }
@@ -777,8 +859,7 @@ void _filter_wcvd::update()
   if (Output_image_0->channels()!=Num_channels_output_image_0){// Different number of channels
     if (Output_image_0->channels()==3){
       // conversion
-      Aux_output_image=new cv::Mat;
-      Aux_output_image->create(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
+      Aux_output_image=new_aux_image(Input_image_0->rows,Input_image_0->cols,CV_8UC1);
       Aux_output_image->setTo(255);
       wcvd(Aux_input_image,Aux_output_image);
       cvtColor(*Aux_input_image,*Output_image_0,cv::COLOR_GRAY2RGB,3);
@@ -790,8 +871,8 @@ void _filter_wcvd::update()
     wcvd(Aux_input_image,Output_image_0);
   }
 
-  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete Aux_input_image;
-  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete Aux_output_image;
+  if (Aux_input_image!=nullptr && Aux_input_image!=Input_image_0) delete_aux_image(Aux_input_image);
+  if (Aux_output_image!=nullptr && Aux_output_image!=Output_image_0) delete_aux_image(Aux_output_image);
 
   update_percent_of_dots();
   update_number_of_dots();
@@ -826,8 +907,6 @@ void _filter_wcvd::save_wcvd_image_to_file(std::string File_name)
   // File_name = Aux_string;
   // #endif
 
-  cv::flip(Aux_image,Aux_image,0);
-
   imwrite(File_name,Aux_image);
 }
 
@@ -883,6 +962,65 @@ void _filter_wcvd::restore_GL_state()
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_wcvd::read_parameters(std::map<std::string,std::string> &Parameters)
+{
+  if (Parameters["_INI_"]=="EDITOR"){// default parameters
+    // ¡¡¡ it is necessary to change the order of reading to guarantee that percentage has priority over number of points
+    parameter2(WCVD_NUMBER_OF_DOTS_DEFAULT);
+    parameter1(WCVD_PERCENT_OF_DOTS_DEFAULT);
+    parameter3(WCWD_SAVE_INTERMEDIATE_IMAGES_DEFAULT);
+  }
+  else{// Parameters from file or from initialised filter
+    try{
+      // ¡¡¡ it is necessary to change the order of reading to guarantee that percentage has priority over number of points
+      if (Parameters["number_of_dots"]=="default") parameter2(WCVD_NUMBER_OF_DOTS_DEFAULT);
+      else parameter2(atoi(Parameters["number_of_dots"].c_str()));
+
+      if (Parameters["percent_of_dots"]=="default") parameter1(WCVD_PERCENT_OF_DOTS_DEFAULT);
+      else parameter1(atoi(Parameters["percent_of_dots"].c_str()));
+
+      if (Parameters["save_intermediate_images"]=="default") parameter3(WCWD_SAVE_INTERMEDIATE_IMAGES_DEFAULT);
+      else{
+        if (Parameters["save_intermediate_images"]=="true") parameter3(true);
+        else parameter3(false);
+      }
+    }
+    catch (const std::out_of_range& oor) {
+      std::cout << "Error in the data of WCVD filter" << std::endl;
+      exit(-1);
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _filter_wcvd::write_parameters(std::map<std::string, std::string> &Parameters)
+{
+  char Aux[100];
+  
+  sprintf(Aux,"%d",parameter1());
+  Parameters["percent_of_dots"]=std::string(Aux);
+  sprintf(Aux,"%d",parameter2());
+  Parameters["number_of_dots"]=std::string(Aux);
+
+  if (parameter3()) sprintf(Aux,"%s","true");
+  else sprintf(Aux,"%s","false");
+  Parameters["save_intermediate_images"]=std::string(Aux);
+}
+
+
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -974,66 +1112,6 @@ void *_filter_wcvd_ui::get_link()
 }
 
 
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_wcvd_ui::read_parameters(std::map<std::string,std::string> &Parameters)
-{
-  if (Parameters["_INI_"]=="EDITOR"){// default parameters
-    // ¡¡¡ it is necessary to change the order of reading to guarantee that percentage has priority over number of points
-    parameter2(WCVD_NUMBER_OF_DOTS_DEFAULT);
-    parameter1(WCVD_PERCENT_OF_DOTS_DEFAULT);
-    parameter3(WCWD_SAVE_INTERMEDIATE_IMAGES_DEFAULT);
-  }
-  else{// Parameters from file or from initialised filter
-    try{
-      // ¡¡¡ it is necessary to change the order of reading to guarantee that percentage has priority over number of points
-      if (Parameters["number_of_dots"]=="default") parameter2(WCVD_NUMBER_OF_DOTS_DEFAULT);
-      else parameter2(atoi(Parameters["number_of_dots"].c_str()));
-
-      if (Parameters["percent_of_dots"]=="default") parameter1(WCVD_PERCENT_OF_DOTS_DEFAULT);
-      else parameter1(atoi(Parameters["percent_of_dots"].c_str()));
-
-      if (Parameters["save_intermediate_images"]=="default") parameter3(WCWD_SAVE_INTERMEDIATE_IMAGES_DEFAULT);
-      else{
-        if (Parameters["save_intermediate_images"]=="true") parameter3(true);
-        else parameter3(false);
-      }
-    }
-    catch (const std::out_of_range& oor) {
-      QMessageBox MsgBox;
-      MsgBox.setText("Error in the data of WCVD filter");
-      MsgBox.exec();
-      exit(-1);
-    }
-  }
-}
-
-
-/*****************************************************************************//**
- *
- *
- *
- *****************************************************************************/
-
-void _filter_wcvd_ui::write_parameters(std::map<std::string, std::string> &Parameters)
-{
-  char Aux[100];
-  
-  sprintf(Aux,"%d",parameter1());
-  Parameters["percent_of_dots"]=std::string(Aux);
-  sprintf(Aux,"%d",parameter2());
-  Parameters["number_of_dots"]=std::string(Aux);
-
-  if (parameter3()) sprintf(Aux,"%s","true");
-  else sprintf(Aux,"%s","false");
-  Parameters["save_intermediate_images"]=std::string(Aux);
-}
-
-
 /*****************************************************************************//**
  *
  *
@@ -1312,6 +1390,7 @@ void _qtw_filter_wcvd::set_parameter5(int Value)
 
 void _qtw_filter_wcvd::set_parameter1_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter1_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -1331,6 +1410,7 @@ void _qtw_filter_wcvd::set_parameter1_slot(int Size)
 
 void _qtw_filter_wcvd::set_parameter2_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter2_slot(Size);})) return;
   Filter->parameter2(Size);
   GL_widget->update_effect(Filter->Name);
 }
@@ -1344,6 +1424,7 @@ void _qtw_filter_wcvd::set_parameter2_slot(int Size)
 
 void _qtw_filter_wcvd::set_parameter3_slot(int Value)
 {
+  if (GL_widget->defer_change([this,Value]{set_parameter3_slot(Value);})) return;
   if (Value==Qt::Checked) Filter->parameter3(true);
   else Filter->parameter3(false);
 
@@ -1362,6 +1443,7 @@ void _qtw_filter_wcvd::set_parameter3_slot(int Value)
 
 void _qtw_filter_wcvd::set_parameter4_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter4_slot(Size);})) return;
   QString Str;
   char Aux[100];
 
@@ -1381,6 +1463,8 @@ void _qtw_filter_wcvd::set_parameter4_slot(int Size)
 
 void _qtw_filter_wcvd::set_parameter5_slot(int Size)
 {
+  if (GL_widget->defer_change([this,Size]{set_parameter5_slot(Size);})) return;
   Filter->parameter5(Size);
   GL_widget->update_effect(Filter->Name);
 }
+#endif // HEADLESS
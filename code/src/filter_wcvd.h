@@ -17,6 +17,7 @@
 #ifndef _FILTER_WCVD_H
 #define _FILTER_WCVD_H
 
+#ifndef HEADLESS
 #include <QDialog>
 #include <QGroupBox>
 #include <QSlider>
@@ -24,11 +25,14 @@
 #include <QCheckBox>
 #include <QSpinBox>
 #include <QProgressDialog>
+#endif
 #include <QCoreApplication>
 
 #include <opencv.hpp>
 
+#ifndef HEADLESS
 #include "line_edit.h"
+#endif
 #include <string>
 #include "filter.h"
 #include "vertex.h"
@@ -142,11 +146,32 @@ public:
   void reset_data();
   bool change_output_image_size(){return Change_output_image_size;};
   bool use_dots(){return Use_dots;};
+  // it uses the OpenGL context of the _gl_widget
+  bool main_thread_only(){return true;};
+
+  void read_parameters(std::map<std::string,std::string> &Parameters);
+  void write_parameters(std::map<std::string,std::string> &Parameters);
+
+  void parameter1(int Value){percent_of_dots((unsigned int)Value);};
+  int parameter1(){return (int)percent_of_dots();};
+
+  void parameter2(int Value){number_of_dots((unsigned int)Value);};
+  int parameter2(){return (int)number_of_dots();};
+
+  void parameter3(bool Value){save_intermediate_images(Value);};
+  bool parameter3(){return save_intermediate_images();};
+
+  void parameter4(int Value){percent_fixed_centroidals(Value);};
+  int parameter4(){return percent_fixed_centroidals();};
+
+  void parameter5(int Value){number_of_iteractions(Value);};
+  int parameter5(){return number_of_iteractions();};
 
   // aux functions
   void initialize();
   void count_dark_pixels(cv::Mat *Input_image);
   void create_random_points(cv::Mat *Input_image);
+  void create_warm_points();
   void copy_points();
   void create_primitive(unsigned int Index);
   void create();
@@ -166,6 +191,9 @@ public:
 
   void wcvd(cv::Mat *Input_image0,cv::Mat *Output_image0);
   void update();
+  void clear_warm_start(){Warm_points.clear();Warm_weights.clear();};
+  // the result depends on the last WCVD
+  bool cacheable(){return Warm_points.empty();};
 
   void percent_of_dots(unsigned int Percent_of_dots1);
   unsigned int percent_of_dots(){return Percent_of_dots;};
@@ -235,9 +263,16 @@ public:
 
   cv::Mat Aux_image;
   bool Save_intermediate_images;
+
+  // the points of the last WCVD that was finished and the weight of their cells. When
+  // the input image is the same, the next computation starts from them
+  uint64_t Warm_input_hash;
+  std::vector<_vertex3f> Warm_points;
+  std::vector<float> Warm_weights;
 };
 
 
+#ifndef HEADLESS
 /*****************************************************************************//**
  *
  *
@@ -255,23 +290,6 @@ public:
   void show();
   void hide();
   void *get_link();
-  void read_parameters(std::map<std::string,std::string> &Parameters);
-  void write_parameters(std::map<std::string,std::string> &Parameters);
-
-  void parameter1(int Value){percent_of_dots((unsigned int)Value);};
-  int parameter1(){return (int)percent_of_dots();};
-
-  void parameter2(int Value){number_of_dots((unsigned int)Value);};
-  int parameter2(){return (int)number_of_dots();};
-
-  void parameter3(bool Value){save_intermediate_images(Value);};
-  bool parameter3(){return save_intermediate_images();};
-
-  void parameter4(int Value){percent_fixed_centroidals(Value);};
-  int parameter4(){return percent_fixed_centroidals();};
-
-  void parameter5(int Value){number_of_iteractions(Value);};
-  int parameter5(){return number_of_iteractions();};
 
   void local_change(bool Value){Local_change=Value;};
 
@@ -340,4 +358,5 @@ private:
   _filter_wcvd_ui *Filter;
   _gl_widget *GL_widget;
 };
+#endif // HEADLESS
 #endif
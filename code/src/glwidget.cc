@@ -47,6 +47,7 @@ _gl_widget::_gl_widget(_window *Window1, QWidget *Parent)
   // create tabs
   Images_tab=new _images_tab(this);
   Filters_tab=new _filters_tab(this);
+  Trace_tab=new _trace_tab(this);
 
   // scale and tranlation values for each image
   // it must be initialized
@@ -72,17 +73,28 @@ _gl_widget::_gl_widget(_window *Window1, QWidget *Parent)
   Painting=false;
   Drawn=false;
 
-  // it is necessary the ppi level!!!!
-  // for the 5 textures packets of dots
-  Dots.resize(3); // 3 ppi level
-  for (int i=0;i<3;i++){
-    Dots[i].resize(9);
-    for (int j=4;j<=8;j++){
-      Dots[i][j]=new cv::Mat;
-    }
-  }
+  Num_updates_last_edit=0;
+  Num_updates_total=0;
+
+  Scheduler.set_result_cache(&Result_cache);
+  Scheduler.set_trace(&Trace);
+  // the filters that use OpenGL are computed in the main thread
+  Scheduler.set_main_thread_function([this](std::function<void()> Function){
+    QMetaObject::invokeMethod(this,Function,Qt::BlockingQueuedConnection);
+  });
 
-  read_dots();
+  Evaluation_running=false;
+  Evaluation_pending=false;
+  Applying_changes=false;
+  Last_progress=-1;
+
+  // tab2
+  Scale_drawing_mode[2].resize(5);
+  Translation[2].resize(5);
+  for (int i=0;i<5;i++){
+    Scale_drawing_mode[2][i]=1.0;
+    Translation[2][i]=_vertex2f(0,0);
+  }
 
   Active_dots_tabs=false;
   Image_loaded=false;
@@ -92,7 +104,6 @@ _gl_widget::_gl_widget(_window *Window1, QWidget *Parent)
   Image_cv_gray=std::make_shared<cv::Mat>();
   Image_cv_gray1=std::make_shared<cv::Mat>();
   Image_cv_color=std::make_shared<cv::Mat>();
-  Frame_buffer=std::make_shared<cv::Mat>();
   Original_image=std::make_shared<cv::Mat>();
 
 }
@@ -106,19 +117,7 @@ _gl_widget::_gl_widget(_window *Window1, QWidget *Parent)
 
 _gl_widget::~_gl_widget()
 {
-
-  #ifdef DEFINE_FILTER_EXAMPLE_BASED_STIPPLING
-  // delete images of dots
-  #ifdef FULL
-  for (int i=0;i<_f_stippling_ebg::LAST_RESOLUTION;i++){
-  #else
-  for (int i=_f_stippling_ebg::RESOLUTION_300PPI;i<_f_stippling_ebg::RESOLUTION_600PPI;i++){
-  #endif
-    for (int j=_f_stippling_ebg::MIN_DOT_SIZE;j<=_f_stippling_ebg::MAX_DOT_SIZE;j++){
-      delete Dots[i][j];
-    }
-  }
-  #endif
+  cancel_evaluation();
 
   clear_data();
 }
@@ -132,10 +131,15 @@ _gl_widget::~_gl_widget()
 
 void _gl_widget::clear_data()
 {
+  cancel_evaluation();
+
   Filters.clear();
   Images.clear();
   Graph.clear();
   Pipeline.clear();
+  Dirty.clear();
+  Num_updates_total=0;
+  _filter::Conversion_cache.clear();
 }
 
 
@@ -147,54 +151,42 @@ void _gl_widget::clear_data()
 
 void  _gl_widget::read_image(std::string File_name)
 {
-  // the original image is read
+  // the original image is read. With the preview, it is read reduced
   _image_IO Image_io;
+  cv::Mat Image;
+
+  // the current image is maintained if there is an error
+  if (Image_io.read_image_reduced(File_name,Image,Proxy_reduction)==false){
+    QMessageBox::warning(this,"Error","The image <b>"+QString::fromStdString(File_name)+"</b> cannot be read");
+    return;
+  }
+
+  // the input images are going to change
+  cancel_evaluation();
 
   // hide the widget meanwhile there are changes
   hide();
 
-  Image_io.read_image(File_name,*Original_image.get());
+  Image_file_name=File_name;
+  Current_reduction=Proxy_reduction;
+  *Original_image.get()=Image;
 
   int Width_aux=Original_image->cols;
   int Height_aux=Original_image->rows;
 
   adjust_image_sizes(Width_aux,Height_aux);
   if (Width_aux!=Original_image->cols || Height_aux!=Original_image->rows){
+    // the reduced image is adjusted without warning
+    if (Current_reduction==1){
       QMessageBox MsgBox;
       MsgBox.setText("The size of the input image is not even. Adjusted to the nearest value (cubic interpolation)");
       MsgBox.exec();
+    }
     cv::resize(*Original_image.get(),*Original_image.get(),cv::Size(Width_aux,Height_aux),0,0,cv::INTER_CUBIC);
   }
 
-  // flip the original image to adapt it to OpenGL
-  cv::flip(*Original_image.get(),*Original_image.get(),0);
-
-  if (Original_image->channels()==1){
-    //  Gray
-    *Image_cv_gray.get()=Original_image->clone();
-    Image_cv_color->release();
-    Image_cv_color->create(Original_image->rows,Original_image->cols,CV_8UC3);
-    Frame_buffer->release();
-    Frame_buffer->create(Original_image->rows,Original_image->cols,CV_8UC3);
-
-    // The input image is copied to the frame-buffer as an initial value
-    cvtColor(*Image_cv_gray.get(),*Image_cv_color.get(),cv::COLOR_GRAY2RGB,3);
-    // The input image is copied to the frame-buffer as an initial value
-    cvtColor(*Original_image.get(),*Frame_buffer.get(),cv::COLOR_GRAY2BGR,3);
-  }
-  else{
-    // Color
-    Image_cv_color->release();
-    *Image_cv_color.get()=Original_image->clone();
-    Image_cv_gray->release();
-    Image_cv_gray->create(Original_image->rows,Original_image->cols,CV_8U);
-
-    // the image is converted to gray escale
-    cvtColor(*Image_cv_color.get(),*Image_cv_gray.get(),cv::COLOR_BGR2GRAY,1);
-    // The input image is copied to the frame-buffer as an initial value
-    *Frame_buffer.get()=Original_image->clone();
-    //cvtColor(Original_image,Frame_buffer,CV_BGR2BGRA,4);
-  }
+  if (Current_reduction>1) Proxy_image=*Original_image.get();
+  else Proxy_image.release();
 
   show();
 
@@ -204,6 +196,8 @@ void  _gl_widget::read_image(std::string File_name)
     refresh_image();
   }
   else{
+    update_proxy_factor();
+    create_input_images();
     update_all_filters();
     refresh_image();
   }
@@ -211,20 +205,117 @@ void  _gl_widget::read_image(std::string File_name)
 
 
 /*****************************************************************************//**
+ * The effect is computed again with the input image reduced by Reduction. The
+ * output images change their size when the filters are computed
  *
+ *****************************************************************************/
+
+bool _gl_widget::change_resolution(int Reduction)
+{
+  cv::Mat Image;
+
+  if (Image_loaded==false || Reduction==Current_reduction) return true;
+
+  if (Reduction==Proxy_reduction && Proxy_image.empty()==false) Image=Proxy_image;
+  else{
+    _image_IO Image_io;
+
+    if (Image_io.read_image_reduced(Image_file_name,Image,Reduction)==false){
+      QMessageBox::warning(this,"Error","The image <b>"+QString::fromStdString(Image_file_name)+"</b> cannot be read");
+      return false;
+    }
+
+    int Width_aux=Image.cols;
+    int Height_aux=Image.rows;
+
+    adjust_image_sizes(Width_aux,Height_aux);
+    if (Width_aux!=Image.cols || Height_aux!=Image.rows){
+      cv::resize(Image,Image,cv::Size(Width_aux,Height_aux),0,0,cv::INTER_CUBIC);
+    }
+    if (Reduction==Proxy_reduction) Proxy_image=Image;
+  }
+
+  // the input images are going to change
+  cancel_evaluation();
+
+  *Original_image.get()=Image;
+  Current_reduction=Reduction;
+
+  update_proxy_factor();
+  create_input_images();
+  update_all_filters();
+  refresh_image();
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * The parameters of the filters are for the full resolution image
  *
  *
  *****************************************************************************/
 
-void  _gl_widget::save_image(std::string File_name)
+void _gl_widget::update_proxy_factor()
 {
-  _image_IO Image_io;
-  cv::Mat Aux_image;
+  for (auto &Filter: Pipeline){
+    Filter->set_proxy_factor(1.0f/(float)Current_reduction);
+  }
+}
+
 
-  Aux_image=Images.get_data(Selected_image)->clone();
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
 
-  cv::flip(Aux_image,Aux_image,0);
-  Image_io.write_image(File_name,Aux_image);
+void _gl_widget::preview_reduction(int Reduction)
+{
+  if (Reduction<1) Reduction=1;
+  if (Reduction==Proxy_reduction) return;
+
+  Proxy_reduction=Reduction;
+  Proxy_image.release();
+  change_resolution(Proxy_reduction);
+}
+
+
+/*****************************************************************************//**
+ * The input image is used as COLOR or GRAY without copying it. The other version
+ * is only computed if one filter reads it by its name (or when it is shown). The
+ * filters that read COLOR as gray, or GRAY as color, use the conversion cache
+ *
+ *****************************************************************************/
+
+void _gl_widget::create_input_images()
+{
+  bool Color_needed=false;
+  bool Gray_needed=false;
+
+  for (auto &Name: *Vec_order){
+    _block &Block=(*Map_data_blocks)[Name];
+    if (Block.In1=="COLOR" || Block.In2=="COLOR") Color_needed=true;
+    if (Block.In1=="GRAY" || Block.In2=="GRAY") Gray_needed=true;
+  }
+
+  // the views of the previous image are not valid
+  _filter::Conversion_cache.clear();
+
+  Image_cv_color->release();
+  Image_cv_gray->release();
+  if (Original_image->channels()==1){
+    *Image_cv_gray.get()=*Original_image.get();
+    if (Color_needed) cvtColor(*Image_cv_gray.get(),*Image_cv_color.get(),cv::COLOR_GRAY2RGB,3);
+  }
+  else{
+    *Image_cv_color.get()=*Original_image.get();
+    if (Gray_needed) cvtColor(*Image_cv_color.get(),*Image_cv_gray.get(),cv::COLOR_BGR2GRAY,1);
+  }
+
+  if (Image_cv_color->empty()==false && Image_cv_gray->empty()==false){
+    _filter::Conversion_cache.set_gray(Image_cv_color.get(),*Image_cv_gray.get());
+    _filter::Conversion_cache.set_color(Image_cv_gray.get(),*Image_cv_color.get());
+  }
 }
 
 
@@ -234,44 +325,27 @@ void  _gl_widget::save_image(std::string File_name)
  *
  *****************************************************************************/
 
-void _gl_widget::read_dots()
+void  _gl_widget::save_image(std::string File_name)
 {
-  std::string File_name;
   _image_IO Image_io;
-  char Name[200];
+  int Reduction=Current_reduction;
 
-  QDir Directory;
-  File_name=Directory.currentPath().toStdString();
+  // the last changes must be included
+  wait_evaluation();
 
-  // check that there is a dot folder
-  QDir Test(Directory.currentPath()+"/dots");
-  if(!Test.exists()) {
-    QMessageBox::critical(this,"Error","There is not <b>dots</b> folder. Abort.");
-    exit(-1);
+  // the preview is not saved. The effect is computed with the complete image and
+  // then the preview is computed again (the results are usually in the cache)
+  if (Reduction>1){
+    Window->show_message("Computing at full resolution...");
+    if (change_resolution(1)==false) return;
+    wait_evaluation();
   }
 
-//  printf("Reading dots files\n");
-  for (unsigned int i=_f_gl_widget_ns::RESOLUTION_300PPI;i<_f_gl_widget_ns::LAST_RESOLUTION;i++){
-    for (unsigned int j=_f_gl_widget_ns::MIN_DOT_SIZE;j<=_f_gl_widget_ns::MAX_DOT_SIZE;j++){
-      // to resolve the problem with absolute paths
-      sprintf(Name,"/dots/dots_%d_%d.pgm",j,_f_gl_widget_ns::VEC_RESOLUTION[i]);
-      std::string File_name_aux=File_name+std::string(Name);
-      Image_io.read_image(File_name_aux,*Dots[i][j]);
-      cv::flip(*Dots[i][j],*Dots[i][j],0);
-      if (Dots[i][j]->channels()!=1){
-        std::cout << "Error: number of channels incorrect in dots files" << std::endl;
-        exit(-1);
-      }
-    }
+  if (Image_io.write_image(File_name,*Images.get_data(Selected_image).get())==false){
+    QMessageBox::warning(this,"Error","The image <b>"+QString::fromStdString(File_name)+"</b> cannot be saved");
   }
 
-  // tab2
-  Scale_drawing_mode[2].resize(5);
-  Translation[2].resize(5);
-  for (int i=0;i<5;i++){
-    Scale_drawing_mode[2][i]=1.0;
-    Translation[2][i]=_vertex2f(0,0);
-  }
+  if (Reduction>1) change_resolution(Reduction);
 }
 
 
@@ -450,12 +524,14 @@ void _gl_widget::initializeGL()
   Vertices[4]=_vertex3f(Width1/2, Height1/2, 0.);
   Vertices[5]=_vertex3f(-Width1/2, Height1/2, 0.);
 
-  Tex_coordinates[0]=_vertex2f(0.0,0.0);
-  Tex_coordinates[1]=_vertex2f(1.0,0.0);
-  Tex_coordinates[2]=_vertex2f(0.0,1.0);
-  Tex_coordinates[3]=_vertex2f(1.0,0.0);
-  Tex_coordinates[4]=_vertex2f(1.0,1.0);
-  Tex_coordinates[5]=_vertex2f(0.0,1.0);
+  // the images have the orientation of the files (the first row is the top), so
+  // the texture is inverted instead of the data
+  Tex_coordinates[0]=_vertex2f(0.0,1.0);
+  Tex_coordinates[1]=_vertex2f(1.0,1.0);
+  Tex_coordinates[2]=_vertex2f(0.0,0.0);
+  Tex_coordinates[3]=_vertex2f(1.0,1.0);
+  Tex_coordinates[4]=_vertex2f(1.0,0.0);
+  Tex_coordinates[5]=_vertex2f(0.0,0.0);
 
   glCreateVertexArrays(1,&VAO1);
   glBindVertexArray(VAO1);
@@ -565,28 +641,17 @@ void _gl_widget::draw_objects()
 void _gl_widget::refresh_image()
 {
   if (Image_loaded){
-    if (Images.get_data(Selected_image_index)->channels()==1){
-      cv::cvtColor(*Images.get_data(Selected_image_index).get(),*Frame_buffer.get(),cv::COLOR_GRAY2BGR,3);
-    }
-    else{
-      Images.get_data(Selected_image_index)->copyTo(*Frame_buffer.get());
-    }
-
-    int Width1=Frame_buffer->cols;
-    int Height1=Frame_buffer->rows;
+    cv::Mat *Image=Images.get_data(Selected_image_index).get();
 
-    glDeleteTextures(1,&Texture1);
+    // the version of the input image that no filter reads is computed when it is shown
+    if (Image->empty() && Image==Image_cv_color.get()) cvtColor(*Image_cv_gray.get(),*Image,cv::COLOR_GRAY2RGB,3);
+    if (Image->empty() && Image==Image_cv_gray.get()) cvtColor(*Image_cv_color.get(),*Image,cv::COLOR_BGR2GRAY,1);
 
-    glCreateTextures(GL_TEXTURE_2D,1,&Texture1);
-    glTextureStorage2D(Texture1,1,GL_RGB8,Width1,Height1);
+    upload_texture(Image);
 
-    glBindTexture(GL_TEXTURE_2D,Texture1);
-    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    // fill with data
-    glTextureSubImage2D(Texture1,0,0,0,Width1,Height1,GL_BGR,GL_UNSIGNED_BYTE,Frame_buffer->data);
+    // the reduced images are drawn with the size of the complete image
+    int Width1=Image->cols*Current_reduction;
+    int Height1=Image->rows*Current_reduction;
 
     Vertices[0]=_vertex3f(-Width1/2, -Height1/2, 0.);
     Vertices[1]=_vertex3f(Width1/2, -Height1/2, 0.);
@@ -614,14 +679,7 @@ void _gl_widget::refresh_image()
 
 void _gl_widget::refresh_image(cv::Mat *Image)
 {
-  if (Image->channels()==1){
-    cv::cvtColor(*Image,*Frame_buffer.get(),cv::COLOR_GRAY2BGR,3);
-  }
-  else{
-    Image->copyTo(*Frame_buffer.get());
-  }
-
-  glTexImage2D(GL_TEXTURE_2D,0,3,Frame_buffer->cols,Frame_buffer->rows,0,GL_BGR,GL_UNSIGNED_BYTE,Frame_buffer->data);
+  upload_texture(Image);
 
   Drawn=false;
 
@@ -629,6 +687,39 @@ void _gl_widget::refresh_image(cv::Mat *Image)
 }
 
 
+/*****************************************************************************//**
+ * The pixels are copied directly to the texture. The gray images use one channel
+ * that is repeated in the three components (swizzle)
+ *
+ *****************************************************************************/
+
+void _gl_widget::upload_texture(cv::Mat *Image)
+{
+  cv::Mat Aux_image=*Image;
+
+  if (Aux_image.isContinuous()==false) Aux_image=Image->clone();
+
+  glDeleteTextures(1,&Texture1);
+
+  glCreateTextures(GL_TEXTURE_2D,1,&Texture1);
+  if (Aux_image.channels()==1){
+    GLint Swizzle[4]={GL_RED,GL_RED,GL_RED,GL_ONE};
+    glTextureStorage2D(Texture1,1,GL_R8,Aux_image.cols,Aux_image.rows);
+    glTextureParameteriv(Texture1,GL_TEXTURE_SWIZZLE_RGBA,Swizzle);
+  }
+  else glTextureStorage2D(Texture1,1,GL_RGB8,Aux_image.cols,Aux_image.rows);
+
+  glBindTexture(GL_TEXTURE_2D,Texture1);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  // fill with data
+  glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+  glTextureSubImage2D(Texture1,0,0,0,Aux_image.cols,Aux_image.rows,(Aux_image.channels()==1)?GL_RED:GL_BGR,GL_UNSIGNED_BYTE,Aux_image.data);
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -638,8 +729,9 @@ void _gl_widget::refresh_image(cv::Mat *Image)
 void _gl_widget::update_all_filters()
 {
   for (unsigned int i=0;i<(*Vec_order).size();i++){
-    Filters.get_data((*Vec_order)[i])->update();
+    Dirty[(*Vec_order)[i]]=true;
   }
+  update_dirty_filters();
 }
 
 
@@ -724,31 +816,353 @@ void _gl_widget::set_filter(std::string Filter_name)
  *
  *****************************************************************************/
 
-void _gl_widget::update_aux(std::string Name)
+void _gl_widget::mark_dirty(std::string Name)
 {
+  // the descendants of a dirty filter are already dirty
+  if (Dirty.find(Name)!=Dirty.end() && Dirty[Name]==true) return;
 
-  Filters.get_data(Name)->update();
+  Dirty[Name]=true;
   if (Graph.find(Name)!=Graph.end()){
-    // the element exist
     for (auto &Iterator: Graph[Name]){
-      update_aux(Iterator);
+      mark_dirty(Iterator);
     }
   }
 }
 
 
 /*****************************************************************************//**
+ * Each dirty filter is computed only once. Vec_order is a topological order, so
+ * all the inputs of a filter are computed before it.
+ * The computation is done in other thread. If there is a computation running, it
+ * is cancelled and the new one starts when it stops
+ *****************************************************************************/
+
+void _gl_widget::update_dirty_filters()
+{
+  std::map<cv::Mat *,cv::Mat *> Map_images;
+
+  if (Evaluation_running){
+    // the current results are not valid with the new values
+    Task_control->cancel();
+    Evaluation_pending=true;
+    return;
+  }
+
+  Vec_evaluation.clear();
+  for (unsigned int i=0;i<(*Vec_order).size();i++){
+    if (Dirty.find((*Vec_order)[i])!=Dirty.end() && Dirty[(*Vec_order)[i]]==true){
+      Vec_evaluation.push_back((*Vec_order)[i]);
+    }
+  }
+  Dirty.clear();
+
+  if (Vec_evaluation.size()==0) return;
+
+  // with zoom, the visible part of the shown image is computed first, in the other
+  // thread too
+  select_visible_region();
+
+  // the filters write in other output images, so the displayed images do not change
+  // until the end of the computation. They have the same size but not the contents,
+  // as the filters write all the pixels
+  for (auto &Name: Vec_evaluation){
+    cv::Mat *Image=Images.get_data(Name).get();
+    Evaluation_images[Name]=std::make_shared<cv::Mat>(_filter::Buffer_pool.get(Image->rows,Image->cols,Image->type()));
+    Map_images[Image]=Evaluation_images[Name].get();
+  }
+  change_images_of_filters(Map_images);
+
+  Task_control=std::make_shared<_task_control>();
+  Last_progress=-1;
+  Task_control->set_progress_function([this](const std::string &Text,float Value){
+    int Percentage=int(Value*100.0f);
+
+    // only the changes of the percentage are shown
+    if (Last_progress.exchange(Percentage)==Percentage) return;
+    std::string Message=Text+" "+std::to_string(Percentage)+"%";
+    QMetaObject::invokeMethod(Window,[this,Message]{Window->show_message(Message);},Qt::QueuedConnection);
+  });
+
+  Trace.clear();
+
+  Evaluation_running=true;
+  std::shared_ptr<_task_control> Task_control1=Task_control;
+  Evaluation_thread=std::thread([this,Task_control1]{
+    if (Vec_region_names.size()>0 && Task_control1->cancelled()==false && compute_visible_region()==true){
+      QMetaObject::invokeMethod(this,"visible_region_finished",Qt::QueuedConnection);
+    }
+    Scheduler.run(Vec_evaluation,*Map_data_blocks,Filters,Task_control1.get());
+    QMetaObject::invokeMethod(this,"evaluation_finished",Qt::QueuedConnection);
+  });
+}
+
+
+/*****************************************************************************//**
+ * The pixels of the image that are shown in the window, with the zoom and the
+ * translation of draw_objects. The image is drawn centered, with the size of the
+ * complete image and the first row at the top
+ *****************************************************************************/
+
+cv::Rect _gl_widget::visible_region(cv::Mat *Image)
+{
+  float Scale=Scale_drawing_mode[Selected_tab][Selected_index];
+  _vertex2f Position=Translation[Selected_tab][Selected_index];
+  float Reduction=(float)Current_reduction;
+
+  // the limits of the window in the coordinates of the image
+  float Col_start=(-Window_width*Scale/2-Position.x)/Reduction+(float)Image->cols/2;
+  float Col_end=(Window_width*Scale/2-Position.x)/Reduction+(float)Image->cols/2;
+  float Row_start=(float)Image->rows/2-(Window_height*Scale/2-Position.y)/Reduction;
+  float Row_end=(float)Image->rows/2-(-Window_height*Scale/2-Position.y)/Reduction;
+
+  cv::Rect Region((int)floorf(Col_start),(int)floorf(Row_start),(int)ceilf(Col_end-Col_start)+1,(int)ceilf(Row_end-Row_start)+1);
+  return Region & cv::Rect(0,0,Image->cols,Image->rows);
+}
+
+
+/*****************************************************************************//**
+ * The dirty filters that the shown image needs can be computed only for the
+ * visible region, by tiles. It is only possible when all of them have a halo and
+ * give the same pixels by tiles. The complete computation replaces these pixels
+ * later
+ *****************************************************************************/
+
+void _gl_widget::select_visible_region()
+{
+  std::vector<std::string> Vec_names;
+  std::set<std::string> Set_needed;
+  std::string Name;
+
+  Vec_region_names.clear();
+  if (Image_loaded==false || Selected_tab!=0) return;
+  if (std::find(Vec_evaluation.begin(),Vec_evaluation.end(),Selected_image)==Vec_evaluation.end()) return;
+
+  cv::Mat *Image=Images.get_data(Selected_image).get();
+  cv::Rect Region1=visible_region(Image);
+  if (Region1.area()==0 || (float)Region1.area()>(float)Image->total()*_f_gl_widget_ns::VISIBLE_REGION_MAX_FRACTION) return;
+
+  // the dirty filters that produce the inputs of the shown image, in the order of
+  // the evaluation
+  Set_needed.insert(Selected_image);
+  for (int i=(int)Vec_evaluation.size()-1;i>=0;i--){
+    Name=Vec_evaluation[i];
+    if (Set_needed.find(Name)==Set_needed.end()) continue;
+
+    Vec_names.insert(Vec_names.begin(),Name);
+    Set_needed.insert((*Map_data_blocks)[Name].In1);
+    if ((*Map_data_blocks)[Name].In2!="NULL") Set_needed.insert((*Map_data_blocks)[Name].In2);
+  }
+
+  _tiler Tiler;
+  // the visible pixels must not change when the complete image is shown
+  if (Tiler.tileable(Vec_names,Filters,Images,Name,true)==false) return;
+
+  Vec_region_names=Vec_names;
+  Region_name=Selected_image;
+  Region=Region1;
+}
+
+
+/*****************************************************************************//**
+ * It is called in the thread of the computation, before the complete images. The
+ * displayed images do not change, the result is saved in Region_image
+ *
+ *****************************************************************************/
+
+bool _gl_widget::compute_visible_region()
+{
+  _tiler Tiler;
+
+  try{
+    Tiler.run_region(Vec_region_names,*Map_data_blocks,Filters,Images,Region_name,Region,&Region_image);
+  }
+  catch (...){
+    // the error is shown by the complete computation
+    return false;
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * The visible region replaces its pixels in the shown image until the complete
+ * computation finishes
+ *
+ *****************************************************************************/
+
+void _gl_widget::visible_region_finished()
+{
+  cv::Mat *Image=Images.get_data(Region_name).get();
+
+  // the values have changed during the computation
+  if (Task_control->cancelled()==false && Region_image.size()==Region.size() && (Region & cv::Rect(0,0,Image->cols,Image->rows))==Region){
+    Region_image.copyTo((*Image)(Region));
+    // the views of the previous pixels are not valid
+    _filter::Conversion_cache.invalidate(Image);
+    refresh_image();
+  }
+  Region_image.release();
+}
+
+
+/*****************************************************************************//**
+ * The results of the computation replace the displayed images at once
+ *
+ *
+ *****************************************************************************/
+
+void _gl_widget::evaluation_finished()
+{
+  std::map<cv::Mat *,cv::Mat *> Map_images;
+
+  Evaluation_thread.join();
+  Evaluation_running=false;
+
+  // the filters use again the displayed images
+  for (auto &Name: Vec_evaluation){
+    Map_images[Evaluation_images[Name].get()]=Images.get_data(Name).get();
+  }
+  change_images_of_filters(Map_images);
+
+  // the results are not complete if one filter has failed
+  if (Task_control->cancelled()==false && Scheduler.failed()==false){
+    for (auto &Name: Vec_evaluation){
+      cv::swap(*Images.get_data(Name).get(),*Evaluation_images[Name].get());
+      _filter::Conversion_cache.swap(Images.get_data(Name).get(),Evaluation_images[Name].get());
+      // the data of the computation is shown now, in the main thread
+      Filters.get_data(Name)->update_widgets();
+    }
+
+    Num_updates_last_edit=Scheduler.num_updates();
+    Num_updates_total+=Num_updates_last_edit;
+
+    Window->show_message("Updates: "+std::to_string(Num_updates_last_edit)+"  Total: "+std::to_string(Num_updates_total)+"  Cache hits: "+std::to_string(Result_cache.hits()));
+    Trace_tab->set_events(Trace.events());
+
+    refresh_image();
+  }
+  else{
+    // the filters of the cancelled or failed computation must be computed again
+    for (auto &Name: Vec_evaluation){
+      Dirty[Name]=true;
+    }
+  }
+
+  // the previous displayed images (or the discarded results) return to the pool
+  for (auto &Name: Vec_evaluation){
+    _filter::Conversion_cache.invalidate(Evaluation_images[Name].get());
+    _filter::Buffer_pool.put(*Evaluation_images[Name].get());
+  }
+  Evaluation_images.clear();
+  Vec_evaluation.clear();
+
+  _filter::show_pending_warnings();
+
+  // the filters are not computed now, so the parameters can be changed. They only
+  // mark the filters as dirty, and all of them are computed together
+  std::vector<std::function<void()>> Changes;
+  Changes.swap(Pending_changes);
+  Applying_changes=true;
+  for (auto &Change: Changes) Change();
+  Applying_changes=false;
+
+  if (Evaluation_pending){
+    Evaluation_pending=false;
+    // the result at full resolution is replaced by the preview with the new values
+    if (Changes.size()>0 && Current_reduction!=Proxy_reduction) change_resolution(Proxy_reduction);
+    else update_dirty_filters();
+  }
+}
+
+
+/*****************************************************************************//**
+ * Changes the input and output images of the filters that are being computed
  *
  *
+ *****************************************************************************/
+
+void _gl_widget::change_images_of_filters(std::map<cv::Mat *,cv::Mat *> &Map_images)
+{
+  for (auto &Name: Vec_evaluation){
+    std::shared_ptr<_filter> Filter=Filters.get_data(Name);
+
+    if (Map_images.find(Filter->Input_image_0)!=Map_images.end()) Filter->Input_image_0=Map_images[Filter->Input_image_0];
+    if (Map_images.find(Filter->Output_image_0)!=Map_images.end()) Filter->Output_image_0=Map_images[Filter->Output_image_0];
+    if (Filter->Input_image_1!=nullptr && Map_images.find(Filter->Input_image_1)!=Map_images.end()){
+      Filter->Input_image_1=Map_images[Filter->Input_image_1];
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ * Computes the filter that has changed and all the filters that depend on it
+ *
  *
  *****************************************************************************/
 
 void _gl_widget::update_effect(std::string Name)
 {
-  // update all the affected filters
-  update_aux(Name);
+  if (Applying_changes){
+    mark_dirty(Name);
+    return;
+  }
 
-  refresh_image();
+  // the result at full resolution is replaced by the preview with the new values
+  if (Current_reduction!=Proxy_reduction){
+    change_resolution(Proxy_reduction);
+    return;
+  }
+
+  mark_dirty(Name);
+  update_dirty_filters();
+}
+
+
+/*****************************************************************************//**
+ * The slots of the widgets of the filters call it before changing a parameter.
+ * The change is done (calling the slot again) when the cancelled computation
+ * stops, so the filters never change while they are computed
+ *****************************************************************************/
+
+bool _gl_widget::defer_change(std::function<void()> Change)
+{
+  if (Evaluation_running==false) return false;
+
+  Pending_changes.push_back(Change);
+  Task_control->cancel();
+  Evaluation_pending=true;
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * Stops the computation. The filters that were not finished remain dirty
+ *
+ *
+ *****************************************************************************/
+
+void _gl_widget::cancel_evaluation()
+{
+  if (Evaluation_running){
+    Task_control->cancel();
+    Evaluation_pending=false;
+    wait_evaluation();
+  }
+}
+
+
+/*****************************************************************************//**
+ * The events must be processed because the filters that use OpenGL are computed
+ * in the main thread, and the end of the computation is a queued call
+ *
+ *****************************************************************************/
+
+void _gl_widget::wait_evaluation()
+{
+  while (Evaluation_running){
+    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::WaitForMoreEvents);
+  }
 }
 
 
@@ -859,6 +1273,7 @@ void _gl_widget::read_effect(std::string Name)
   }
   else{
     if (Image_loaded==true){ // there is one loaded image but with other effect
+      cancel_evaluation();
       hide();
         // sets initial tab
       Window->set_tab(0);
@@ -876,12 +1291,6 @@ void _gl_widget::read_effect(std::string Name)
 
       Images.set("COLOR",Image_cv_color);
       Images.set("GRAY",Image_cv_gray);
-      if (Original_image->channels()==1){//  Gray
-        cvtColor(*Original_image.get(),*Frame_buffer.get(),cv::COLOR_GRAY2BGR,3);
-      }
-      else{// Color
-        *Frame_buffer.get()=Original_image->clone();
-      }
 
       read_data_effect(Name);
       // scale and tranlation values for each image
@@ -901,7 +1310,7 @@ void _gl_widget::read_effect(std::string Name)
       // show the widget
       show();
 
-      glTexImage2D(GL_TEXTURE_2D,0,3,Frame_buffer->cols,Frame_buffer->rows,0,GL_BGR,GL_UNSIGNED_BYTE,Frame_buffer->data);
+      refresh_image();
 
       Drawn=false;
 
@@ -929,31 +1338,7 @@ void _gl_widget::create_filters_from_blocks()
   // clear all the data
   clear_data();
   if (Image_loaded==true){
-    // The input image is copied to the frame-buffer as an initial value
-    if (Original_image->channels()==1){
-      Image_cv_gray->release();
-      *Image_cv_gray.get()=Original_image->clone();
-      Image_cv_color->release();
-      Image_cv_color->create(Original_image->rows,Original_image->cols,CV_8UC3);
-      Frame_buffer->release();
-      Frame_buffer->create(Original_image->rows,Original_image->cols,CV_8UC3);
-
-      // The input image is copied to the color image
-      cvtColor(*Image_cv_gray.get(),*Image_cv_color.get(),cv::COLOR_GRAY2RGB,3);
-      // The input image is copied to the frame-buffer as an initial value
-      cvtColor(*Original_image.get(),*Frame_buffer.get(),cv::COLOR_GRAY2BGR,3);
-    }
-    else{
-      Image_cv_color->release();
-      *Image_cv_color.get()=Original_image->clone();
-      Image_cv_gray->release();
-      Image_cv_gray->create(Original_image->rows,Original_image->cols,CV_8U);
-
-      // the image is converted to gray escale
-      cvtColor(*Image_cv_color.get(),*Image_cv_gray.get(),cv::COLOR_BGR2GRAY,1);
-      // The input image is copied to the frame-buffer as an initial value
-      *Frame_buffer.get()=Original_image->clone();
-    }
+    create_input_images();
     Images.set("COLOR",Image_cv_color);
     // The gray version is saved as 1
     Images.set("GRAY",Image_cv_gray);
@@ -965,16 +1350,16 @@ void _gl_widget::create_filters_from_blocks()
     Image_cv_gray->setTo(255);
     Image_cv_color->release();
     Image_cv_color->create(256,256,CV_8UC3);
-    Frame_buffer->release();
-    Frame_buffer->create(256,256,CV_8UC3);
     // The input image is copied to the frame-buffer as an initial value
     cvtColor(*Image_cv_gray.get(),*Image_cv_color.get(),cv::COLOR_GRAY2RGB,3);
     // The color version is saved as 0
     Images.set("COLOR",Image_cv_color);
     // The gray version is saved as 1
     Images.set("GRAY",Image_cv_gray);
-    // The input image is copied to the frame-buffer as an initial value
-    *Frame_buffer.get()=Original_image->clone();
+
+    // the filters that read COLOR as gray use GRAY, and the reverse
+    _filter::Conversion_cache.set_gray(Image_cv_color.get(),*Image_cv_gray.get());
+    _filter::Conversion_cache.set_color(Image_cv_gray.get(),*Image_cv_color.get());
   }
 
   for (unsigned int i=0;i<Vec_order->size();i++){
@@ -1062,7 +1447,6 @@ void _gl_widget::create_filters_from_blocks()
     {
       std::shared_ptr<_filter_dot_ebg_ui> Filter1=std::make_shared<_filter_dot_ebg_ui>(this,(*Map_filters_parameters)[Name],Name);
       Filters.set(Name,Filter1);
-      Filter1->set_dots_images(&Dots);
 
       float Scaling_factor=Filter1->scaling_factor();
       Width_aux=(int)((float)Input_image0->cols*Scaling_factor);
@@ -1079,7 +1463,6 @@ void _gl_widget::create_filters_from_blocks()
     {
       std::shared_ptr<_filter_dot_svg_ui> Filter1=std::make_shared<_filter_dot_svg_ui>(this,(*Map_filters_parameters)[Name],Name);
       Filters.set(Name,Filter1);
-      Filter1->set_dots_images(&Dots);
 
       float Scaling_factor=Filter1->scaling_factor();
       Width_aux=(int)((float)Input_image0->cols*Scaling_factor);
@@ -1098,8 +1481,6 @@ void _gl_widget::create_filters_from_blocks()
     case FILTER_STIPPLING_EBG:{
         std::shared_ptr<_filter_stippling_ebg> Filter1=std::make_shared<_filter_stippling_ebg_ui>(this,(*Map_filters_parameters)[Name],Name);
         Filters.set(Name,Filter1);
-        Filter1->set_dots_images(&Dots);
-
         float Scaling_factor=Filter1->scaling_factor();
         Width_aux=(int)((float)Input_image0->cols*Scaling_factor);
         Height_aux=(int)(Input_image0->rows*Scaling_factor);
@@ -1236,6 +1617,7 @@ void _gl_widget::create_filters_from_blocks()
     Output_image0=Images.get_data(Name).get();
 
     Filters.get_data(Name)->set_images(Input_image0,Output_image0,Input_image1);
+    Filters.get_data(Name)->set_proxy_factor(1.0f/(float)Current_reduction);
     Pipeline.push_back(Filters.get_data(Name));
   }
 
@@ -1380,12 +1762,10 @@ void  _gl_widget::check2(std::string File_name1,std::string File_name2)
   // the original image is read
   _image_IO Image_io;
 
-  Image_io.read_image(File_name1,*Image_cv_gray.get());
-  cv::flip(*Image_cv_gray.get(),*Image_cv_gray.get(),0);
+  if (Image_io.read_image(File_name1,*Image_cv_gray.get())==false) return;
   Images.set("GRAY",Image_cv_gray);
 
-  Image_io.read_image(File_name2,*Image_cv_gray1.get());
-  cv::flip(*Image_cv_gray1.get(),*Image_cv_gray1.get(),0);
+  if (Image_io.read_image(File_name2,*Image_cv_gray1.get())==false) return;
   Images.set("GRAY1",Image_cv_gray1);
 
 
@@ -1401,5 +1781,6 @@ void  _gl_widget::check2(std::string File_name1,std::string File_name2)
 
   Filters.get_data(Name)->set_images(Image_cv_gray.get(),Output_image0,Image_cv_gray1.get());
   Filters.get_data(Name)->update();
+  Filters.get_data(Name)->update_widgets();
   #endif
 }
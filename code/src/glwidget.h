@@ -26,20 +26,30 @@
 #include <math.h>
 #include <string>
 #include <map>
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
 #include <sys/timeb.h>
 #include <QMessageBox>
+#include <QCoreApplication>
 #include <QSvgGenerator>
 #include <QPainter>
 
 #include "window.h"
 #include "images_tab.h"
 #include "filters_tab.h"
+#include "trace_tab.h"
 #include "shaders.h"
 #include "image_IO.h"
 #include "map_list.h"
+#include "scheduler.h"
+#include "tiler.h"
+#include "task_control.h"
+#include "trace.h"
 
 // filters
 
@@ -169,6 +179,10 @@ namespace _f_gl_widget_ns
 
   const unsigned int MIN_DOT_SIZE=4;
   const unsigned int MAX_DOT_SIZE=8;
+
+  // the visible part of the image is computed before the rest when it is smaller
+  // than this fraction of the image
+  const float VISIBLE_REGION_MAX_FRACTION=0.5f;
 }
 
 
@@ -201,8 +215,13 @@ public:
   void  update_images();
   void  read_image(std::string File_name);
   void  save_image(std::string File_name);
+  // the effect is computed with the image reduced by 1 (full resolution), 2, 4 or 8
+  // while the parameters are changed. The image is saved at full resolution
+  void  preview_reduction(int Reduction);
+  int   preview_reduction(){return Proxy_reduction;};
+  // the result at full resolution is shown until a parameter changes
+  void  compute_full_resolution(){change_resolution(1);};
 
-  void  read_dots();
   void  refresh_image();
   void  refresh_image(cv::Mat *Image);
   void  update_all_filters();
@@ -214,8 +233,16 @@ public:
   void  show_images();
   void  show_filters();
 
-  void  update_aux(std::string Name);
+  void  mark_dirty(std::string Name);
+  void  update_dirty_filters();
   void  update_effect(std::string Name);
+  // the parameters of the filters cannot change while they are computed in the other
+  // thread. Returns true if there is a computation: it is cancelled and Change is
+  // called when it stops
+  bool  defer_change(std::function<void()> Change);
+  void  cancel_evaluation();
+  void  wait_evaluation();
+  bool  save_trace(std::string File_name){return Trace.write_chrome_trace(File_name);};
 
   void read_data_effect(std::string Name);
   void write_data_effect(std::string Name);
@@ -242,6 +269,7 @@ public:
   // Tabs
   _images_tab *Images_tab;
   _filters_tab *Filters_tab;
+  _trace_tab *Trace_tab;
 
   std::map<std::string,_block> *Map_data_blocks;
   std::vector<std::string> *Vec_order;
@@ -261,6 +289,18 @@ protected:
   void refresh();
 
   void adjust_image_sizes(int &Width1, int &Height1);
+  void create_input_images();
+  bool change_resolution(int Reduction);
+  void update_proxy_factor();
+  void upload_texture(cv::Mat *Image);
+  void change_images_of_filters(std::map<cv::Mat *,cv::Mat *> &Map_images);
+  cv::Rect visible_region(cv::Mat *Image);
+  void select_visible_region();
+  bool compute_visible_region();
+
+protected slots:
+  void visible_region_finished();
+  void evaluation_finished();
 
 private:
   _window *Window;
@@ -311,11 +351,15 @@ private:
   std::shared_ptr<cv::Mat> Image_cv_gray;
   std::shared_ptr<cv::Mat> Image_cv_gray1;
   std::shared_ptr<cv::Mat> Image_cv_color;
-  std::shared_ptr<cv::Mat> Frame_buffer;
   std::shared_ptr<cv::Mat> Original_image;
 
-  // Images of dots for stippling (no ppi level)
-  std::vector<std::vector<cv::Mat *>> Dots;
+  // the file of the input image, that is read again to change the resolution
+  std::string Image_file_name;
+  // the reduction of the preview and the reduction of the current input image
+  int Proxy_reduction=1;
+  int Current_reduction=1;
+  // the reduced image, to return to the preview without reading the file
+  cv::Mat Proxy_image;
 
   // Image for paper
   cv::Mat Paper;
@@ -327,6 +371,41 @@ private:
   // for each filter name, it gives the list to other filters that has the filter name as input
   std::map<std::string,std::vector<std::string> > Graph;
 
+  // runs the independent branches of the effect in parallel
+  _scheduler Scheduler;
+  // the results of the filters, to avoid computing again the same image
+  _result_cache Result_cache;
+  // time and memory of each filter of the last computation
+  _trace Trace;
+
+  // the filters that must be recomputed
+  std::map<std::string,bool> Dirty;
+  // number of update() calls of the last edit and since the effect was created
+  unsigned int Num_updates_last_edit;
+  unsigned long Num_updates_total;
+
+  // the dirty filters are computed in other thread. The results are written in
+  // Evaluation_images and they replace the displayed images when all the filters
+  // have been computed
+  std::thread Evaluation_thread;
+  std::shared_ptr<_task_control> Task_control;
+  bool Evaluation_running;
+  // there are changes that arrived while the computation was being cancelled
+  bool Evaluation_pending;
+  // the changes of the parameters that arrived during the computation
+  std::vector<std::function<void()>> Pending_changes;
+  bool Applying_changes;
+  std::vector<std::string> Vec_evaluation;
+  std::map<std::string,std::shared_ptr<cv::Mat>> Evaluation_images;
+  // with zoom, the filters of Vec_region_names compute the visible Region of the
+  // shown image first, in Region_image
+  std::vector<std::string> Vec_region_names;
+  std::string Region_name;
+  cv::Rect Region;
+  cv::Mat Region_image;
+  // the last percentage that has been shown
+  std::atomic<int> Last_progress;
+
   bool Painting;
   bool Paper_loaded;
   bool Active_dots_tabs;
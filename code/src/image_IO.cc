@@ -15,6 +15,22 @@
 
 
 #include "image_IO.h"
+#include "binary_image.h"
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+#ifndef WINDOWS
+#include <sys/mman.h>
+#endif
+
+#ifdef DEFINE_IO_PNG
+#include <png.h>
+#endif
+
+#ifdef DEFINE_IO_TIFF
+#include <tiffio.h>
+#endif
 
 //using namespace std;
 
@@ -24,7 +40,7 @@
  *
  *****************************************************************************/
 
-void _image_IO::read_image(std::string Name,cv::Mat &Image_in)
+bool _image_IO::read_image(std::string Name,cv::Mat &Image_in)
 {
   // #ifdef WINDOWS
   // std::string Aux_string;
@@ -41,7 +57,7 @@ void _image_IO::read_image(std::string Name,cv::Mat &Image_in)
 
   if( !Image_in.data ){ // check if the image has been loaded properly
     std::cout << "Error reading the image: " << Name << std::endl;
-    exit(-1);
+    return false;
   }
 
   if (Image_in.channels()==4){
@@ -50,8 +66,560 @@ void _image_IO::read_image(std::string Name,cv::Mat &Image_in)
 
   if (Image_in.depth()!=CV_8U){
     std::cout << "Error in the depth of the image" << std::endl;
-    exit(-1);
+    Image_in.release();
+    return false;
+  }
+
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * The strips have a multiple of Reduction rows and they are reduced with the mean
+ * of the pixels. The last rows that do not complete a row of the result are not
+ * used. The other formats are decoded by OpenCV with the reduction (the DCT of JPEG
+ * is decoded at the reduced size), and they are always read as color
+ *****************************************************************************/
+
+bool _image_IO::read_image_reduced(std::string Name,cv::Mat &Image_in,int Reduction)
+{
+  if (Reduction<=1) return read_image(Name,Image_in);
+
+  if (_f_image_IO_ns::format(Name)!=_f_image_IO_ns::FORMAT_OTHER){
+    _image_reader Reader;
+    cv::Mat Strip;
+    cv::Mat Reduced_strip;
+
+    if (Reader.open(Name)==false) return false;
+
+    int Rows=Reader.rows()/Reduction;
+    int Cols=std::max(1,Reader.cols()/Reduction);
+    if (Rows==0){
+      std::cout << "Error: the image is too small to be reduced: " << Name << std::endl;
+      return false;
+    }
+
+    Image_in.create(Rows,Cols,(Reader.channels()==1)?CV_8UC1:CV_8UC3);
+    // 64 rows of the result in each strip
+    int Num_rows=64*Reduction;
+    for (int Row=0;Row<Rows;){
+      if (Reader.read_rows(Num_rows,Strip)==false || Strip.empty()){
+        Image_in.release();
+        return false;
+      }
+
+      int Rows_strip=std::min(Strip.rows/Reduction,Rows-Row);
+      if (Rows_strip==0) break;
+      cv::resize(Strip.rowRange(0,Rows_strip*Reduction),Reduced_strip,cv::Size(Cols,Rows_strip),0,0,cv::INTER_AREA);
+      Reduced_strip.copyTo(Image_in.rowRange(Row,Row+Rows_strip));
+      Row+=Rows_strip;
+    }
+    return true;
+  }
+
+  int Flags;
+  switch (Reduction){
+  case 2:Flags=cv::IMREAD_REDUCED_COLOR_2;break;
+  case 4:Flags=cv::IMREAD_REDUCED_COLOR_4;break;
+  default:Flags=cv::IMREAD_REDUCED_COLOR_8;break;
+  }
+
+  Image_in=cv::imread(Name,Flags);
+  if (!Image_in.data){
+    std::cout << "Error reading the image: " << Name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _image_IO::write_image(std::string Name,cv::Mat &Image_out)
+{
+  // the black and white images are saved with 1 bit in the formats that allow it
+  _f_image_IO_ns::_format Format=_f_image_IO_ns::format(Name);
+  if (Image_out.type()==CV_8UC1 && (Format==_f_image_IO_ns::FORMAT_PBM || Format==_f_image_IO_ns::FORMAT_PNG || Format==_f_image_IO_ns::FORMAT_TIFF)){
+    _binary_image Binary_image;
+    if (Binary_image.from_mat(Image_out)) return Binary_image.write(Name);
+  }
+
+  if (cv::imwrite(Name, Image_out)==false){
+    std::cout << "Error writing the image: " << Name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * By the extension. PNG and TIFF are only read by strips when the libraries are
+ * included
+ *
+ *****************************************************************************/
+
+_f_image_IO_ns::_format _f_image_IO_ns::format(std::string Name)
+{
+  size_t Position=Name.find_last_of('.');
+  if (Position==std::string::npos) return FORMAT_OTHER;
+
+  std::string Extension=Name.substr(Position+1);
+  std::transform(Extension.begin(),Extension.end(),Extension.begin(),[](unsigned char Char){return (char)tolower(Char);});
+
+  if (Extension=="pbm") return FORMAT_PBM;
+  if (Extension=="pgm") return FORMAT_PGM;
+  if (Extension=="ppm" || Extension=="pnm") return FORMAT_PPM;
+  #ifdef DEFINE_IO_PNG
+  if (Extension=="png") return FORMAT_PNG;
+  #endif
+  #ifdef DEFINE_IO_TIFF
+  if (Extension=="tif" || Extension=="tiff") return FORMAT_TIFF;
+  #endif
+  return FORMAT_OTHER;
+}
+
+
+/*****************************************************************************//**
+ * One number of the header of a PNM file. The comments are skipped and the white
+ * space after the number is read
+ *
+ *****************************************************************************/
+
+static bool read_pnm_value(FILE *File,int &Value)
+{
+  int Char=fgetc(File);
+
+  while (Char!=EOF && (isspace(Char) || Char=='#')){
+    if (Char=='#'){
+      while (Char!=EOF && Char!='\n') Char=fgetc(File);
+    }
+    else Char=fgetc(File);
+  }
+
+  if (Char==EOF || !isdigit(Char)) return false;
+
+  Value=0;
+  while (Char!=EOF && isdigit(Char)){
+    Value=Value*10+(Char-'0');
+    Char=fgetc(File);
+  }
+
+  return (Char!=EOF && isspace(Char));
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_image_reader::_image_reader()
+{
+  Format=_f_image_IO_ns::FORMAT_OTHER;
+  Rows=0;
+  Cols=0;
+  Channels=0;
+  Next_row=0;
+  File=nullptr;
+  Map=nullptr;
+  Map_size=0;
+  Data_offset=0;
+  Png=nullptr;
+  Png_info=nullptr;
+  Tiff=nullptr;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_image_reader::~_image_reader()
+{
+  close();
+}
+
+
+/*****************************************************************************//**
+ * Only the header is read
+ *
+ *
+ *****************************************************************************/
+
+bool _image_reader::open(std::string Name1)
+{
+  close();
+  Name=Name1;
+  Format=_f_image_IO_ns::format(Name);
+
+  switch (Format){
+  case _f_image_IO_ns::FORMAT_PBM:
+  case _f_image_IO_ns::FORMAT_PGM:
+  case _f_image_IO_ns::FORMAT_PPM:return open_pnm();
+  case _f_image_IO_ns::FORMAT_PNG:return open_png();
+  case _f_image_IO_ns::FORMAT_TIFF:return open_tiff();
+  default:return open_complete();
+  }
+}
+
+
+/*****************************************************************************//**
+ * The strips that use the mapped file are not valid after closing
+ *
+ *
+ *****************************************************************************/
+
+void _image_reader::close()
+{
+  #ifndef WINDOWS
+  if (Map!=nullptr) munmap(Map,Map_size);
+  #endif
+  Map=nullptr;
+  Map_size=0;
+
+  #ifdef DEFINE_IO_PNG
+  if (Png!=nullptr){
+    png_structp Png1=(png_structp)Png;
+    png_infop Png_info1=(png_infop)Png_info;
+    png_destroy_read_struct(&Png1,&Png_info1,nullptr);
+  }
+  #endif
+  Png=nullptr;
+  Png_info=nullptr;
+
+  #ifdef DEFINE_IO_TIFF
+  if (Tiff!=nullptr) TIFFClose((TIFF *)Tiff);
+  #endif
+  Tiff=nullptr;
+
+  if (File!=nullptr) fclose(File);
+  File=nullptr;
+
+  Image.release();
+  Row_buffer.clear();
+  Rows=0;
+  Cols=0;
+  Channels=0;
+  Next_row=0;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _image_reader::read_rows(int Num_rows, cv::Mat &Strip)
+{
+  int Num=std::min(Num_rows,Rows-Next_row);
+
+  if (Num<=0){
+    Strip=cv::Mat();
+    return true;
+  }
+
+  switch (Format){
+  case _f_image_IO_ns::FORMAT_PBM:
+  case _f_image_IO_ns::FORMAT_PGM:
+  case _f_image_IO_ns::FORMAT_PPM:return read_pnm_rows(Num,Strip);
+  case _f_image_IO_ns::FORMAT_PNG:return read_png_rows(Num,Strip);
+  case _f_image_IO_ns::FORMAT_TIFF:return read_tiff_rows(Num,Strip);
+  default:
+    Strip=Image.rowRange(Next_row,Next_row+Num);
+    Next_row+=Num;
+    return true;
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _image_reader::open_complete()
+{
+  _image_IO Image_io;
+
+  Format=_f_image_IO_ns::FORMAT_OTHER;
+  if (Image_io.read_image(Name,Image)==false) return false;
+
+  Rows=Image.rows;
+  Cols=Image.cols;
+  Channels=Image.channels();
+  Next_row=0;
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * Binary PBM (P4), PGM (P5) and PPM (P6) of 8 bits. The ASCII versions and the
+ * files of 16 bits are read complete
+ *
+ *****************************************************************************/
+
+bool _image_reader::open_pnm()
+{
+  char Magic[2];
+  int Values[3]={0,0,255};
+
+  File=fopen(Name.c_str(),"rb");
+  if (File==nullptr){
+    std::cout << "Error reading the image: " << Name << std::endl;
+    return false;
+  }
+
+  if (fread(Magic,1,2,File)!=2 || Magic[0]!='P' || Magic[1]<'4' || Magic[1]>'6'){
+    fclose(File);
+    File=nullptr;
+    return open_complete();
+  }
+
+  int Num_values=(Magic[1]=='4')?2:3;
+  for (int i=0;i<Num_values;i++){
+    if (read_pnm_value(File,Values[i])==false){
+      std::cout << "Error in the header of the image: " << Name << std::endl;
+      close();
+      return false;
+    }
+  }
+
+  if (Values[0]<=0 || Values[1]<=0 || Values[2]>255){
+    fclose(File);
+    File=nullptr;
+    return open_complete();
+  }
+
+  if (Magic[1]=='4') Format=_f_image_IO_ns::FORMAT_PBM;
+  else if (Magic[1]=='5') Format=_f_image_IO_ns::FORMAT_PGM;
+  else Format=_f_image_IO_ns::FORMAT_PPM;
+
+  Cols=Values[0];
+  Rows=Values[1];
+  Channels=(Format==_f_image_IO_ns::FORMAT_PPM)?3:1;
+  Next_row=0;
+  Data_offset=ftell(File);
+
+  #ifndef WINDOWS
+  // the pixels of PGM are used directly from the file
+  if (Format==_f_image_IO_ns::FORMAT_PGM){
+    fseek(File,0,SEEK_END);
+    size_t File_size=ftell(File);
+    fseek(File,Data_offset,SEEK_SET);
+
+    if (File_size>=Data_offset+(size_t)Rows*Cols){
+      void *Address=mmap(nullptr,File_size,PROT_READ,MAP_PRIVATE,fileno(File),0);
+      if (Address!=MAP_FAILED){
+        Map=(unsigned char *)Address;
+        Map_size=File_size;
+        madvise(Address,File_size,MADV_SEQUENTIAL);
+      }
+    }
+  }
+  #endif
+
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * In PBM 1 is black
+ *
+ *
+ *****************************************************************************/
+
+bool _image_reader::read_pnm_rows(int Num_rows, cv::Mat &Strip)
+{
+  if (Map!=nullptr){
+    Strip=cv::Mat(Num_rows,Cols,CV_8UC1,Map+Data_offset+(size_t)Next_row*Cols);
+    Next_row+=Num_rows;
+    return true;
+  }
+
+  Strip.create(Num_rows,Cols,(Channels==1)?CV_8UC1:CV_8UC3);
+
+  if (Format==_f_image_IO_ns::FORMAT_PBM){
+    size_t Row_bytes=(Cols+7)/8;
+    Row_buffer.resize(Row_bytes);
+    for (int Row=0;Row<Num_rows;Row++){
+      if (fread(Row_buffer.data(),1,Row_bytes,File)!=Row_bytes){
+        std::cout << "Error reading the image: " << Name << std::endl;
+        return false;
+      }
+      unsigned char *Pixels=Strip.ptr<unsigned char>(Row);
+      for (int Col=0;Col<Cols;Col++){
+        Pixels[Col]=(Row_buffer[Col>>3] & (0x80>>(Col & 7)))?0:255;
+      }
+    }
+  }
+  else{
+    size_t Row_bytes=(size_t)Cols*Channels;
+    for (int Row=0;Row<Num_rows;Row++){
+      if (fread(Strip.ptr<unsigned char>(Row),1,Row_bytes,File)!=Row_bytes){
+        std::cout << "Error reading the image: " << Name << std::endl;
+        return false;
+      }
+    }
+    if (Channels==3) cv::cvtColor(Strip,Strip,cv::COLOR_RGB2BGR);
+  }
+
+  Next_row+=Num_rows;
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * The PNG is converted to 8 bits, gray or BGR, without alpha. The interlaced
+ * files are read complete
+ *
+ *****************************************************************************/
+
+bool _image_reader::open_png()
+{
+  #ifdef DEFINE_IO_PNG
+  unsigned char Signature[8];
+
+  File=fopen(Name.c_str(),"rb");
+  if (File==nullptr){
+    std::cout << "Error reading the image: " << Name << std::endl;
+    return false;
+  }
+
+  if (fread(Signature,1,8,File)!=8 || png_sig_cmp(Signature,0,8)!=0){
+    fclose(File);
+    File=nullptr;
+    return open_complete();
+  }
+
+  png_structp Png1=png_create_read_struct(PNG_LIBPNG_VER_STRING,nullptr,nullptr,nullptr);
+  png_infop Png_info1=png_create_info_struct(Png1);
+  Png=Png1;
+  Png_info=Png_info1;
+
+  if (setjmp(png_jmpbuf(Png1))){
+    std::cout << "Error reading the image: " << Name << std::endl;
+    close();
+    return false;
+  }
+
+  png_init_io(Png1,File);
+  png_set_sig_bytes(Png1,8);
+  png_read_info(Png1,Png_info1);
+
+  if (png_get_interlace_type(Png1,Png_info1)!=PNG_INTERLACE_NONE){
+    close();
+    return open_complete();
+  }
+
+  int Color_type=png_get_color_type(Png1,Png_info1);
+  int Bit_depth=png_get_bit_depth(Png1,Png_info1);
+
+  if (Color_type==PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(Png1);
+  if (Color_type==PNG_COLOR_TYPE_GRAY && Bit_depth<8) png_set_expand_gray_1_2_4_to_8(Png1);
+  if (Bit_depth==16) png_set_strip_16(Png1);
+  // the transparency of a palette (tRNS) is expanded to an alpha channel
+  if ((Color_type & PNG_COLOR_MASK_ALPHA) || png_get_valid(Png1,Png_info1,PNG_INFO_tRNS)) png_set_strip_alpha(Png1);
+  png_set_bgr(Png1);
+  png_read_update_info(Png1,Png_info1);
+
+  Cols=png_get_image_width(Png1,Png_info1);
+  Rows=png_get_image_height(Png1,Png_info1);
+  Channels=png_get_channels(Png1,Png_info1);
+  // the rows are read in strips of 1 or 3 channels
+  if (Channels!=1 && Channels!=3){
+    close();
+    return open_complete();
+  }
+  Next_row=0;
+  return true;
+  #else
+  return open_complete();
+  #endif
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _image_reader::read_png_rows(int Num_rows, cv::Mat &Strip)
+{
+  #ifdef DEFINE_IO_PNG
+  png_structp Png1=(png_structp)Png;
+
+  Strip.create(Num_rows,Cols,(Channels==1)?CV_8UC1:CV_8UC3);
+
+  if (setjmp(png_jmpbuf(Png1))){
+    std::cout << "Error reading the image: " << Name << std::endl;
+    close();
+    return false;
+  }
+
+  for (int Row=0;Row<Num_rows;Row++) png_read_row(Png1,Strip.ptr<png_byte>(Row),nullptr);
+
+  Next_row+=Num_rows;
+  return true;
+  #else
+  (void)Num_rows;
+  (void)Strip;
+  return false;
+  #endif
+}
+
+
+/*****************************************************************************//**
+ * Scanlines of 8 bits, gray or RGB (the alpha is removed). The tiled files and
+ * the rest of types are read complete
+ *
+ *****************************************************************************/
+
+bool _image_reader::open_tiff()
+{
+  #ifdef DEFINE_IO_TIFF
+  uint32_t Width=0,Height=0;
+  uint16_t Samples=1,Bits=8,Planar=PLANARCONFIG_CONTIG,Photometric=PHOTOMETRIC_MINISBLACK;
+
+  TIFF *Tiff1=TIFFOpen(Name.c_str(),"r");
+  if (Tiff1==nullptr){
+    std::cout << "Error reading the image: " << Name << std::endl;
+    return false;
   }
+  Tiff=Tiff1;
+
+  TIFFGetField(Tiff1,TIFFTAG_IMAGEWIDTH,&Width);
+  TIFFGetField(Tiff1,TIFFTAG_IMAGELENGTH,&Height);
+  TIFFGetFieldDefaulted(Tiff1,TIFFTAG_SAMPLESPERPIXEL,&Samples);
+  TIFFGetFieldDefaulted(Tiff1,TIFFTAG_BITSPERSAMPLE,&Bits);
+  TIFFGetFieldDefaulted(Tiff1,TIFFTAG_PLANARCONFIG,&Planar);
+  TIFFGetField(Tiff1,TIFFTAG_PHOTOMETRIC,&Photometric);
+
+  bool Gray=(Samples==1 && Photometric==PHOTOMETRIC_MINISBLACK);
+  bool Color=(Samples>=3 && Photometric==PHOTOMETRIC_RGB);
+  if (TIFFIsTiled(Tiff1) || Bits!=8 || Planar!=PLANARCONFIG_CONTIG || (Gray==false && Color==false) || Width==0 || Height==0){
+    close();
+    return open_complete();
+  }
+
+  Cols=Width;
+  Rows=Height;
+  Channels=(Gray)?1:3;
+  Next_row=0;
+  Row_buffer.resize(TIFFScanlineSize(Tiff1));
+  return true;
+  #else
+  return open_complete();
+  #endif
 }
 
 
@@ -61,7 +629,339 @@ void _image_IO::read_image(std::string Name,cv::Mat &Image_in)
  *
  *****************************************************************************/
 
-void _image_IO::write_image(std::string Name,cv::Mat &Image_out)
+bool _image_reader::read_tiff_rows(int Num_rows, cv::Mat &Strip)
 {
-  cv::imwrite(Name, Image_out);
+  #ifdef DEFINE_IO_TIFF
+  TIFF *Tiff1=(TIFF *)Tiff;
+  int Samples=Row_buffer.size()/Cols;
+
+  Strip.create(Num_rows,Cols,(Channels==1)?CV_8UC1:CV_8UC3);
+
+  for (int Row=0;Row<Num_rows;Row++){
+    if (TIFFReadScanline(Tiff1,Row_buffer.data(),Next_row+Row,0)<0){
+      std::cout << "Error reading the image: " << Name << std::endl;
+      return false;
+    }
+
+    unsigned char *Pixels=Strip.ptr<unsigned char>(Row);
+    if (Channels==1) memcpy(Pixels,Row_buffer.data(),Cols);
+    else{
+      // RGB to BGR
+      for (int Col=0;Col<Cols;Col++){
+        Pixels[3*Col]=Row_buffer[Samples*Col+2];
+        Pixels[3*Col+1]=Row_buffer[Samples*Col+1];
+        Pixels[3*Col+2]=Row_buffer[Samples*Col];
+      }
+    }
+  }
+
+  Next_row+=Num_rows;
+  return true;
+  #else
+  (void)Num_rows;
+  (void)Strip;
+  return false;
+  #endif
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_image_writer::_image_writer()
+{
+  Format=_f_image_IO_ns::FORMAT_OTHER;
+  Rows=0;
+  Cols=0;
+  Channels=0;
+  Next_row=0;
+  File=nullptr;
+  Png=nullptr;
+  Png_info=nullptr;
+  Tiff=nullptr;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_image_writer::~_image_writer()
+{
+  close();
+}
+
+
+/*****************************************************************************//**
+ * The header is written. Channels is 1 (gray) or 3 (BGR). A gray image is saved
+ * in PPM as RGB and a color image in PGM or PBM as gray
+ *
+ *****************************************************************************/
+
+bool _image_writer::open(std::string Name1, int Rows1, int Cols1, int Channels1)
+{
+  close();
+
+  Name=Name1;
+  Rows=Rows1;
+  Cols=Cols1;
+  Channels=Channels1;
+  Next_row=0;
+  Format=_f_image_IO_ns::format(Name);
+
+  if (Rows<=0 || Cols<=0 || (Channels!=1 && Channels!=3)){
+    std::cout << "Error: the size of the image " << Name << " is not valid" << std::endl;
+    return false;
+  }
+
+  switch (Format){
+  case _f_image_IO_ns::FORMAT_PBM:
+  case _f_image_IO_ns::FORMAT_PGM:
+  case _f_image_IO_ns::FORMAT_PPM:
+    File=fopen(Name.c_str(),"wb");
+    if (File==nullptr) break;
+    if (Format==_f_image_IO_ns::FORMAT_PBM) fprintf(File,"P4\n%d %d\n",Cols,Rows);
+    else fprintf(File,"P%c\n%d %d\n255\n",(Format==_f_image_IO_ns::FORMAT_PGM)?'5':'6',Cols,Rows);
+    return true;
+  #ifdef DEFINE_IO_PNG
+  case _f_image_IO_ns::FORMAT_PNG:
+    {
+      File=fopen(Name.c_str(),"wb");
+      if (File==nullptr) break;
+
+      png_structp Png1=png_create_write_struct(PNG_LIBPNG_VER_STRING,nullptr,nullptr,nullptr);
+      png_infop Png_info1=png_create_info_struct(Png1);
+      Png=Png1;
+      Png_info=Png_info1;
+
+      if (setjmp(png_jmpbuf(Png1))) break;
+
+      png_init_io(Png1,File);
+      png_set_IHDR(Png1,Png_info1,Cols,Rows,8,(Channels==1)?PNG_COLOR_TYPE_GRAY:PNG_COLOR_TYPE_RGB,PNG_INTERLACE_NONE,PNG_COMPRESSION_TYPE_DEFAULT,PNG_FILTER_TYPE_DEFAULT);
+      png_write_info(Png1,Png_info1);
+      if (Channels==3) png_set_bgr(Png1);
+    }
+    return true;
+  #endif
+  #ifdef DEFINE_IO_TIFF
+  case _f_image_IO_ns::FORMAT_TIFF:
+    {
+      // BigTIFF when the pixels do not fit in 4GB
+      bool Big=((uint64_t)Rows*Cols*Channels>=((uint64_t)1<<32));
+      TIFF *Tiff1=TIFFOpen(Name.c_str(),(Big)?"w8":"w");
+      if (Tiff1==nullptr) break;
+      Tiff=Tiff1;
+
+      TIFFSetField(Tiff1,TIFFTAG_IMAGEWIDTH,(uint32_t)Cols);
+      TIFFSetField(Tiff1,TIFFTAG_IMAGELENGTH,(uint32_t)Rows);
+      TIFFSetField(Tiff1,TIFFTAG_SAMPLESPERPIXEL,(uint16_t)Channels);
+      TIFFSetField(Tiff1,TIFFTAG_BITSPERSAMPLE,(uint16_t)8);
+      TIFFSetField(Tiff1,TIFFTAG_PLANARCONFIG,PLANARCONFIG_CONTIG);
+      TIFFSetField(Tiff1,TIFFTAG_PHOTOMETRIC,(Channels==1)?PHOTOMETRIC_MINISBLACK:PHOTOMETRIC_RGB);
+      TIFFSetField(Tiff1,TIFFTAG_COMPRESSION,COMPRESSION_LZW);
+      TIFFSetField(Tiff1,TIFFTAG_ROWSPERSTRIP,TIFFDefaultStripSize(Tiff1,0));
+      Row_buffer.resize((size_t)Cols*Channels);
+    }
+    return true;
+  #endif
+  default:
+    Image.create(Rows,Cols,(Channels==1)?CV_8UC1:CV_8UC3);
+    return true;
+  }
+
+  std::cout << "Error writing the image: " << Name << std::endl;
+  close();
+  return false;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _image_writer::write_rows(cv::Mat &Strip)
+{
+  if (Strip.cols!=Cols || Strip.channels()!=Channels || Next_row+Strip.rows>Rows){
+    std::cout << "Error: the rows do not fit in the image " << Name << std::endl;
+    return false;
+  }
+
+  bool Result=true;
+
+  switch (Format){
+  case _f_image_IO_ns::FORMAT_PBM:
+  case _f_image_IO_ns::FORMAT_PGM:
+  case _f_image_IO_ns::FORMAT_PPM:Result=write_pnm_rows(Strip);break;
+  case _f_image_IO_ns::FORMAT_PNG:Result=write_png_rows(Strip);break;
+  case _f_image_IO_ns::FORMAT_TIFF:Result=write_tiff_rows(Strip);break;
+  default:
+    {
+      cv::Mat Image_rows=Image.rowRange(Next_row,Next_row+Strip.rows);
+      Strip.copyTo(Image_rows);
+    }
+    break;
+  }
+
+  if (Result) Next_row+=Strip.rows;
+  return Result;
+}
+
+
+/*****************************************************************************//**
+ * The images that are not saved by strips are written now
+ *
+ *
+ *****************************************************************************/
+
+bool _image_writer::close()
+{
+  if (File==nullptr && Png==nullptr && Tiff==nullptr && Image.empty()) return true;
+
+  bool Result=true;
+  if (Next_row!=Rows){
+    std::cout << "Error: the image " << Name << " is not complete" << std::endl;
+    Result=false;
+  }
+
+  #ifdef DEFINE_IO_PNG
+  if (Png!=nullptr){
+    png_structp Png1=(png_structp)Png;
+    png_infop Png_info1=(png_infop)Png_info;
+    if (Result){
+      if (setjmp(png_jmpbuf(Png1))==0) png_write_end(Png1,Png_info1);
+      else Result=false;
+    }
+    png_destroy_write_struct(&Png1,&Png_info1);
+  }
+  #endif
+  Png=nullptr;
+  Png_info=nullptr;
+
+  #ifdef DEFINE_IO_TIFF
+  if (Tiff!=nullptr) TIFFClose((TIFF *)Tiff);
+  #endif
+  Tiff=nullptr;
+
+  if (File!=nullptr && fclose(File)!=0) Result=false;
+  File=nullptr;
+
+  if (Image.empty()==false){
+    _image_IO Image_io;
+    if (Result) Result=Image_io.write_image(Name,Image);
+    Image.release();
+  }
+  else if (Result==false) std::cout << "Error writing the image: " << Name << std::endl;
+
+  Row_buffer.clear();
+  return Result;
+}
+
+
+/*****************************************************************************//**
+ * In PBM the pixels darker than 128 are black (1)
+ *
+ *
+ *****************************************************************************/
+
+bool _image_writer::write_pnm_rows(cv::Mat &Strip)
+{
+  cv::Mat Aux_image;
+
+  if (Format==_f_image_IO_ns::FORMAT_PPM){
+    if (Channels==1) cv::cvtColor(Strip,Aux_image,cv::COLOR_GRAY2RGB);
+    else cv::cvtColor(Strip,Aux_image,cv::COLOR_BGR2RGB);
+  }
+  else{
+    if (Channels==3) cv::cvtColor(Strip,Aux_image,cv::COLOR_BGR2GRAY);
+    else Aux_image=Strip;
+  }
+
+  for (int Row=0;Row<Aux_image.rows;Row++){
+    unsigned char *Pixels=Aux_image.ptr<unsigned char>(Row);
+    size_t Row_bytes=(size_t)Cols*Aux_image.channels();
+
+    if (Format==_f_image_IO_ns::FORMAT_PBM){
+      Row_bytes=(Cols+7)/8;
+      Row_buffer.assign(Row_bytes,0);
+      for (int Col=0;Col<Cols;Col++){
+        if (Pixels[Col]<128) Row_buffer[Col>>3]|=(0x80>>(Col & 7));
+      }
+      Pixels=Row_buffer.data();
+    }
+
+    if (fwrite(Pixels,1,Row_bytes,File)!=Row_bytes){
+      std::cout << "Error writing the image: " << Name << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _image_writer::write_png_rows(cv::Mat &Strip)
+{
+  #ifdef DEFINE_IO_PNG
+  png_structp Png1=(png_structp)Png;
+
+  if (setjmp(png_jmpbuf(Png1))){
+    std::cout << "Error writing the image: " << Name << std::endl;
+    return false;
+  }
+
+  for (int Row=0;Row<Strip.rows;Row++) png_write_row(Png1,Strip.ptr<png_byte>(Row));
+  return true;
+  #else
+  (void)Strip;
+  return false;
+  #endif
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _image_writer::write_tiff_rows(cv::Mat &Strip)
+{
+  #ifdef DEFINE_IO_TIFF
+  TIFF *Tiff1=(TIFF *)Tiff;
+
+  for (int Row=0;Row<Strip.rows;Row++){
+    unsigned char *Pixels=Strip.ptr<unsigned char>(Row);
+
+    if (Channels==1) memcpy(Row_buffer.data(),Pixels,Cols);
+    else{
+      // BGR to RGB
+      for (int Col=0;Col<Cols;Col++){
+        Row_buffer[3*Col]=Pixels[3*Col+2];
+        Row_buffer[3*Col+1]=Pixels[3*Col+1];
+        Row_buffer[3*Col+2]=Pixels[3*Col];
+      }
+    }
+
+    if (TIFFWriteScanline(Tiff1,Row_buffer.data(),Next_row+Row,0)<0){
+      std::cout << "Error writing the image: " << Name << std::endl;
+      return false;
+    }
+  }
+  return true;
+  #else
+  (void)Strip;
+  return false;
+  #endif
 }
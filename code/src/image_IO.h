@@ -26,6 +26,8 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <cstdio>
 
 
 /*****************************************************************************//**
@@ -39,8 +41,121 @@ class _image_IO
 public:
   std::string String;
 
-  void read_image(std::string Name,cv::Mat &Image_in);
-  void write_image(std::string Name, cv::Mat &Image_out);
+  // they return false if there is an error (the message is shown)
+  bool read_image(std::string Name,cv::Mat &Image_in);
+  // the image reduced by 2, 4 or 8 without having the complete image in memory: the
+  // formats that are read by strips are reduced by strips, and JPEG is decoded at
+  // the reduced size
+  bool read_image_reduced(std::string Name,cv::Mat &Image_in,int Reduction);
+  bool write_image(std::string Name, cv::Mat &Image_out);
+};
+
+namespace _f_image_IO_ns
+{
+  // the formats that can be read and written by strips. The other ones are read
+  // or written complete
+  typedef enum {FORMAT_OTHER,FORMAT_PBM,FORMAT_PGM,FORMAT_PPM,FORMAT_PNG,FORMAT_TIFF} _format;
+
+  _format format(std::string Name);
+}
+
+
+/*****************************************************************************//**
+ * Reads an image by strips of rows from the top, so the complete image is never
+ * in memory. PBM, PGM and PPM (binary) are read directly, PNG with libpng
+ * (DEFINE_IO_PNG) and TIFF with libtiff (DEFINE_IO_TIFF). The raw PGM files are
+ * mapped in memory and the strips use the pages of the file (they must not be
+ * changed). The rest of formats and files (interlaced PNG, tiled TIFF...) are
+ * read complete and returned by strips
+ *****************************************************************************/
+
+class _image_reader
+{
+public:
+  _image_reader();
+  ~_image_reader();
+
+  bool open(std::string Name);
+  void close();
+  // the next Num_rows rows (less at the end). The strip is CV_8UC1 or CV_8UC3 (BGR)
+  // and it is empty when all the rows have been read
+  bool read_rows(int Num_rows, cv::Mat &Strip);
+
+  int rows(){return Rows;};
+  int cols(){return Cols;};
+  int channels(){return Channels;};
+  int next_row(){return Next_row;};
+
+protected:
+  bool open_pnm();
+  bool open_png();
+  bool open_tiff();
+  bool open_complete();
+  bool read_pnm_rows(int Num_rows, cv::Mat &Strip);
+  bool read_png_rows(int Num_rows, cv::Mat &Strip);
+  bool read_tiff_rows(int Num_rows, cv::Mat &Strip);
+
+  std::string Name;
+  _f_image_IO_ns::_format Format;
+  int Rows;
+  int Cols;
+  int Channels;
+  int Next_row;
+
+  FILE *File;
+  // raw PGM in memory
+  unsigned char *Map;
+  size_t Map_size;
+  size_t Data_offset;
+  // libpng and libtiff data
+  void *Png;
+  void *Png_info;
+  void *Tiff;
+  std::vector<unsigned char> Row_buffer;
+  // the formats that cannot be read by strips
+  cv::Mat Image;
+};
+
+
+/*****************************************************************************//**
+ * Writes an image by strips of rows from the top. The same formats than
+ * _image_reader. The rest of formats are saved complete when it is closed
+ *
+ *
+ *****************************************************************************/
+
+class _image_writer
+{
+public:
+  _image_writer();
+  ~_image_writer();
+
+  bool open(std::string Name1, int Rows1, int Cols1, int Channels1);
+  // the strip must have the columns and channels of the image
+  bool write_rows(cv::Mat &Strip);
+  // returns false if not all the rows have been written
+  bool close();
+
+  int next_row(){return Next_row;};
+
+protected:
+  bool write_pnm_rows(cv::Mat &Strip);
+  bool write_png_rows(cv::Mat &Strip);
+  bool write_tiff_rows(cv::Mat &Strip);
+
+  std::string Name;
+  _f_image_IO_ns::_format Format;
+  int Rows;
+  int Cols;
+  int Channels;
+  int Next_row;
+
+  FILE *File;
+  void *Png;
+  void *Png_info;
+  void *Tiff;
+  std::vector<unsigned char> Row_buffer;
+  cv::Mat Image;
 };
 
 #endif
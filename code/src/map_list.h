@@ -22,7 +22,9 @@
 #include <string>
 #include <stdexcept>
 #include <iostream>
+#ifndef HEADLESS
 #include <QMessageBox>
+#endif
 
 
 
@@ -46,7 +48,8 @@ public:
   Type get_data(int Position);
   int get_position(std::string Name);
   std::string get_string(int Position);
-  
+  void error_message(std::string Error);
+
   std::map<std::string,Type> Data_by_string;
   std::map<int,Type> Data_by_position;
   std::map<std::string,int> Key_by_string;
@@ -70,6 +73,25 @@ void _map_list<Type>::clear()
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+template <class Type>
+void _map_list<Type>::error_message(std::string Error)
+{
+#ifdef HEADLESS
+  std::cout << Error << std::endl;
+#else
+  QMessageBox MsgBox;
+  MsgBox.setText(QString::fromStdString(Error));
+  MsgBox.exec();
+#endif
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -92,11 +114,7 @@ void _map_list<Type>::set(std::string Name,Type Data1)
     Key_by_position[Position]=Name;
     return;
   }
-  QString Error("Error: the name is duplicated:  ");
-  Error+=Name.c_str();
-  QMessageBox MsgBox;
-  MsgBox.setText(Error);
-  MsgBox.exec();
+  error_message(std::string("Error: the name is duplicated:  ")+Name);
 
 }
 
@@ -114,11 +132,7 @@ Type _map_list<Type>::get_data(std::string Name)
     Data_by_string.at(Name);
   }
   catch (const std::out_of_range& oor) {
-    QString Error("Error in the definition of filter with this text:  ");
-    Error+=Name.c_str();
-    QMessageBox MsgBox;
-    MsgBox.setText(Error);
-    MsgBox.exec();
+    error_message(std::string("Error in the definition of filter with this text:  ")+Name);
     return ((Type)nullptr);
   }
   return Data_by_string.at(Name);
@@ -138,10 +152,7 @@ Type _map_list<Type>::get_data(int Position)
     Data_by_position.at(Position);
   }
   catch (const std::out_of_range& oor) {
-    QString Error("Error: the position does not exist:  ");
-    QMessageBox MsgBox;
-    MsgBox.setText(Error);
-    MsgBox.exec();
+    error_message("Error: the position does not exist:  ");
     return ((Type) nullptr);
   }
   return Data_by_position.at(Position);
@@ -161,11 +172,7 @@ int _map_list< Type>::get_position(std::string Name)
     Key_by_string.at(Name);
   }
   catch (const std::out_of_range& oor) {
-    QString Error("Error: the name does not exist:  ");
-    Error+=Name.c_str();
-    QMessageBox MsgBox;
-    MsgBox.setText(Error);
-    MsgBox.exec();
+    error_message(std::string("Error: the name does not exist:  ")+Name);
     return (-1);
   }
   return Key_by_string.at(Name);
@@ -185,10 +192,7 @@ std::string _map_list< Type>::get_string(int Position)
     Key_by_position.at(Position);
   }
   catch (const std::out_of_range& oor) {
-    QString Error("Error: the position does not exist");
-    QMessageBox MsgBox;
-    MsgBox.setText(Error);
-    MsgBox.exec();
+    error_message("Error: the position does not exist");
     return ("");
   }
   return Key_by_position.at(Position);
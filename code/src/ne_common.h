@@ -17,6 +17,8 @@
 #ifndef NE_COMMON_H
 #define NE_COMMON_H
 
+#include <string>
+
 namespace _ne_common_ns {
   const int NUM_MAX_ROWS=10;
   const int NUM_MAX_COLS=10;
@@ -57,4 +59,14 @@ namespace _ne_common_ns {
 
 }
 
+// the data of each block of the effect. It does not depend on the widgets
+typedef struct {
+  std::string Type;
+  std::string Name;
+  std::string In1;
+  std::string In2;
+  int Row;
+  int Col;
+} _block;
+
 #endif
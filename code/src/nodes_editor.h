@@ -41,15 +41,6 @@ class _ne_block;
 class QNEMainWindow;
 
 
-typedef struct {
-  std::string Type;
-  std::string Name;
-  std::string In1;
-  std::string In2;
-  int Row;
-  int Col;
-} _block;
-
 typedef struct {
   int Row;
   int Col;
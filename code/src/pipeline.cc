@@ -0,0 +1,829 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include "pipeline.h"
+
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <algorithm>
+
+using namespace _f_filter_ns;
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_pipeline::_pipeline()
+{
+  Image_cv_gray=std::make_shared<cv::Mat>();
+  Image_cv_color=std::make_shared<cv::Mat>();
+  Original_image=std::make_shared<cv::Mat>();
+
+  // each filter is computed only once, so the cache of results only adds copies
+  Scheduler.set_trace(&Trace);
+  Scheduler.set_release_function([this](const std::string &Image_name){release_image(Image_name);});
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_pipeline::~_pipeline()
+{
+  clear_data();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _pipeline::clear_data()
+{
+  Filters.clear();
+  Images.clear();
+  Graph.clear();
+  Pipeline.clear();
+  Set_kept_images.clear();
+  _filter::Conversion_cache.clear();
+}
+
+
+/*****************************************************************************//**
+ * Reads the json file of the effect. The format is the same that is used by the
+ * nodes editor
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::read_effect(std::string File_name)
+{
+  QJsonObject Filter_object;
+  QStringList Key_list;
+  std::map<std::string,std::string> Values;
+
+  QFile File(File_name.c_str());
+
+  if (!File.open(QIODevice::ReadOnly)) {
+    std::cout << "Error: couldn't open the json file " << File_name << std::endl;
+    return false;
+  }
+
+  Filters_json_data.clear();
+
+  QByteArray Data=File.readAll();
+  // the file is converted to a Json document
+  QJsonDocument Document(QJsonDocument::fromJson(Data));
+  // A json object is obtained from the document
+  QJsonObject Object=Document.object();
+  // filters appear as an array
+  QJsonArray Filter_array=Object["effect"].toArray();
+  // each filter is treated
+  for (int i=0;i<Filter_array.size();i++) {
+    // the data of each filter is put on an json object
+    Filter_object=Filter_array[i].toObject();
+    Key_list=Filter_object.keys();
+
+    Values.clear();
+    for (int j=0;j<Key_list.size();j++){
+      Values[Key_list[j].toStdString()]=Filter_object.value(Key_list[j]).toString().toStdString();
+    }
+    Filters_json_data.push_back(Values);
+  }
+  File.close();
+
+  if (Filters_json_data.size()==0){
+    std::cout << "Error: the effect " << File_name << " has no filters" << std::endl;
+    return false;
+  }
+
+  return create_blocks_from_effect();
+}
+
+
+/*****************************************************************************//**
+ * The effect is given with the same data that is read from the json file
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::set_effect(std::vector<std::map<std::string,std::string>> &Filters_json_data1)
+{
+  Filters_json_data=Filters_json_data1;
+
+  if (Filters_json_data.size()==0){
+    std::cout << "Error: the effect has no filters" << std::endl;
+    return false;
+  }
+
+  return create_blocks_from_effect();
+}
+
+
+/*****************************************************************************//**
+ * Converts the json data to blocks and computes the order of execution: all the
+ * previous blocks must be computed before the current one
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::create_blocks_from_effect()
+{
+  std::string Name;
+  _block Block1;
+
+  Map_data_blocks.clear();
+  Map_filters_parameters.clear();
+  Vec_order.clear();
+
+  try
+  {
+    for (unsigned int i=0;i<Filters_json_data.size();i++){
+      Name=Filters_json_data[i].at("output_image_0");
+
+      // now check the name of the input images
+      if (Filters_json_data[i].at("input_image_0")=="NULL"){
+        std::cout << "Error: the input image of filter " << Filters_json_data[i].at("type_filter") <<" cannot be NULL. At least, it must be COLOR or GRAY" << std::endl;
+        return false;
+      }
+
+      Block1.Name=Name;
+      Block1.Type=Filters_json_data[i].at("type_filter");
+      Block1.In1=Filters_json_data[i].at("input_image_0");
+      Block1.In2=Filters_json_data[i].at("input_image_1");
+      Block1.Row=-1;
+      Block1.Col=-1;
+
+      Filters_json_data[i]["_INI_"]="FILE";
+      Map_filters_parameters[Name]=Filters_json_data[i];
+      Map_data_blocks[Name]=Block1;
+    }
+  }
+  catch (const std::out_of_range& oor) {
+    std::cout << "Error in the name of one or several filters or a final comma" << std::endl;
+    return false;
+  }
+
+  // check that all the inputs exist
+  for (auto &Block_aux: Map_data_blocks){
+    if (Block_aux.second.In1!="COLOR" && Block_aux.second.In1!="GRAY" && Map_data_blocks.find(Block_aux.second.In1)==Map_data_blocks.end()){
+      std::cout << "Error: the input image " << Block_aux.second.In1 << " of filter " << Block_aux.first << " does not exist" << std::endl;
+      return false;
+    }
+    if (Block_aux.second.In2!="NULL" && Block_aux.second.In2!="COLOR" && Block_aux.second.In2!="GRAY" && Map_data_blocks.find(Block_aux.second.In2)==Map_data_blocks.end()){
+      std::cout << "Error: the input image " << Block_aux.second.In2 << " of filter " << Block_aux.first << " does not exist" << std::endl;
+      return false;
+    }
+  }
+
+  // the order of the json file is kept when it is possible
+  std::map<std::string,bool> Visited;
+  for (unsigned int i=0;i<Filters_json_data.size();i++){
+    compute_order(Filters_json_data[i]["output_image_0"],Visited);
+  }
+
+  return true;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _pipeline::compute_order(std::string Name, std::map<std::string,bool> &Visited)
+{
+  if (Name=="COLOR" || Name=="GRAY" || Name=="NULL") return;
+  if (Visited.find(Name)!=Visited.end()) return;
+
+  Visited[Name]=true;
+  compute_order(Map_data_blocks[Name].In1,Visited);
+  compute_order(Map_data_blocks[Name].In2,Visited);
+  Vec_order.push_back(Name);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::read_image(std::string File_name)
+{
+  _image_IO Image_io;
+  cv::Mat Image;
+
+  if (Image_io.read_image(File_name,Image)==false) return false;
+
+  return set_image(Image);
+}
+
+
+/*****************************************************************************//**
+ * The image has the orientation of the files (the first row is the top), like in
+ * the interactive program. The pixels are shared with Image (they are not changed)
+ *
+ *****************************************************************************/
+
+bool _pipeline::set_image(cv::Mat &Image)
+{
+  *Original_image.get()=Image;
+
+  int Width_aux=Original_image->cols;
+  int Height_aux=Original_image->rows;
+
+  adjust_image_sizes(Width_aux,Height_aux);
+  if (Width_aux!=Original_image->cols || Height_aux!=Original_image->rows){
+    std::cout << "The size of the input image is not even. Adjusted to the nearest value (cubic interpolation)" << std::endl;
+    cv::resize(*Original_image.get(),*Original_image.get(),cv::Size(Width_aux,Height_aux),0,0,cv::INTER_CUBIC);
+  }
+
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * COLOR and GRAY are created from Image, without changes of size nor orientation.
+ * Image is used directly as COLOR or GRAY, and the other version is only computed
+ * if one filter reads it by its name
+ *****************************************************************************/
+
+void _pipeline::set_input_images(cv::Mat &Image)
+{
+  bool Color_needed=false;
+  bool Gray_needed=false;
+
+  if (Original_image.get()!=&Image) *Original_image.get()=Image;
+
+  for (auto &Name: Vec_order){
+    _block &Block=Map_data_blocks[Name];
+    if (Block.In1=="COLOR" || Block.In2=="COLOR") Color_needed=true;
+    if (Block.In1=="GRAY" || Block.In2=="GRAY") Gray_needed=true;
+  }
+
+  Image_cv_color->release();
+  Image_cv_gray->release();
+  if (Original_image->channels()==1){
+    *Image_cv_gray.get()=*Original_image.get();
+    if (Color_needed) cvtColor(*Image_cv_gray.get(),*Image_cv_color.get(),cv::COLOR_GRAY2RGB,3);
+  }
+  else{
+    *Image_cv_color.get()=*Original_image.get();
+    if (Gray_needed) cvtColor(*Image_cv_color.get(),*Image_cv_gray.get(),cv::COLOR_BGR2GRAY,1);
+  }
+}
+
+
+/*****************************************************************************//**
+ * The same construction that _gl_widget::create_filters_from_blocks but using the
+ * base classes of the filters
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::create_filters_from_blocks()
+{
+  std::string Type;
+  std::string Name;
+  cv::Mat *Input_image0;
+  cv::Mat *Output_image0;
+  cv::Mat *Input_image1;
+  _block Block;
+  std::shared_ptr<_filter> Filter;
+
+  clear_data();
+  set_input_images(*Original_image.get());
+
+  Images.set("COLOR",Image_cv_color);
+  Images.set("GRAY",Image_cv_gray);
+  // the filters that read COLOR as gray use GRAY, and the reverse. Otherwise the
+  // conversion is computed when it is needed
+  if (Image_cv_color->empty()==false && Image_cv_gray->empty()==false){
+    _filter::Conversion_cache.set_gray(Image_cv_color.get(),*Image_cv_gray.get());
+    _filter::Conversion_cache.set_color(Image_cv_gray.get(),*Image_cv_color.get());
+  }
+
+  for (unsigned int i=0;i<Vec_order.size();i++){
+    Name=Vec_order[i];
+    Block=Map_data_blocks[Name];
+
+    Type=Block.Type;
+    Input_image0=Images.Data_by_string[Block.In1].get();
+    if (Block.In2!="NULL"){
+      Input_image1=Images.Data_by_string[Block.In2].get();
+    }
+    else Input_image1=nullptr;
+
+    // save data for the graph
+    Graph[Block.In1].push_back(Name);
+    if (Block.In2!="NULL") Graph[Block.In2].push_back(Name);
+
+    int Width_aux=0;
+    int Height_aux=0;
+
+    Filter=nullptr;
+
+    switch((int)Type_filter_name[Type]){
+    #ifdef DEFINE_FILTER_BILATERAL
+    case FILTER_BILATERAL:Filter=std::make_shared<_filter_bilateral>();break; // Bilateral
+    #endif
+
+    #ifdef DEFINE_FILTER_CANNY
+    case FILTER_CANNY:Filter=std::make_shared<_filter_canny>();break; // CANNY
+    #endif
+
+    #ifdef DEFINE_FILTER_CCVT
+    case FILTER_CCVT:Filter=std::make_shared<_filter_ccvt>();break; // BALZER'S CCVT
+    #endif
+
+    #ifdef DEFINE_FILTER_COMBINATION
+    case FILTER_COMBINATION:
+      Filter=std::make_shared<_filter_combination>();
+      if (Input_image0->cols!=Original_image->cols || Input_image0->rows!=Original_image->rows){
+        Filter->set_change_output_image_size(true);
+        Width_aux=Input_image0->cols;
+        Height_aux=Input_image0->rows;
+      }
+      break; // COMBINATION
+    #endif
+
+    #ifdef DEFINE_FILTER_CONTRAST_BRIGHT
+    case FILTER_CONTRAST_BRIGHT:Filter=std::make_shared<_filter_contrast_bright>();break; // CONTRAST
+    #endif
+
+    #ifdef DEFINE_FILTER_DILATION
+    case FILTER_DILATION:Filter=std::make_shared<_filter_dilation>();break; // DILATION
+    #endif
+
+    #ifdef DEFINE_FILTER_DISTANCE_FIELD
+    case FILTER_DISTANCE_FIELD:Filter=std::make_shared<_filter_distance_field>();break; // FIELD DISTANCE
+    #endif
+
+    #ifdef DEFINE_FILTER_DOG
+    case FILTER_DOG:Filter=std::make_shared<_filter_dog>();break; // DOG
+    #endif
+
+    #ifdef DEFINE_FILTER_DOT_EBG
+    case FILTER_DOT_EBG:
+    {
+      std::shared_ptr<_filter_dot_ebg> Filter1=std::make_shared<_filter_dot_ebg>();
+      Filter1->read_parameters(Map_filters_parameters[Name]);
+
+      float Scaling_factor=Filter1->scaling_factor();
+      Width_aux=(int)((float)Input_image0->cols*Scaling_factor);
+      Height_aux=(int)(Input_image0->rows*Scaling_factor);
+
+      adjust_image_sizes(Width_aux,Height_aux);
+      Filter=Filter1;
+      break; // DOT_EBS
+    }
+    #endif
+
+    #ifdef DEFINE_FILTER_EROTION
+    case FILTER_EROTION:Filter=std::make_shared<_filter_erotion>();break; // EROTION
+    #endif
+
+    #ifdef DEFINE_FILTER_EXAMPLE_BASED_GRAYSCALE_STIPPLING
+    case FILTER_STIPPLING_EBG:
+    {
+      std::shared_ptr<_filter_stippling_ebg> Filter1=std::make_shared<_filter_stippling_ebg>();
+      Filter1->read_parameters(Map_filters_parameters[Name]);
+
+      float Scaling_factor=Filter1->scaling_factor();
+      Width_aux=(int)((float)Input_image0->cols*Scaling_factor);
+      Height_aux=(int)(Input_image0->rows*Scaling_factor);
+
+      adjust_image_sizes(Width_aux,Height_aux);
+      Filter=Filter1;
+      break; // STIPPLING_EBS
+    }
+    #endif
+
+    #ifdef DEFINE_FILTER_GAUSSIAN
+    case FILTER_GAUSSIAN:Filter=std::make_shared<_filter_gaussian>();break; // GAUSSIAN
+    #endif
+
+    #ifdef DEFINE_FILTER_HALFTONING_ADAPTIVE_CLUSTERING_SELECTIVE_PRECIPITATION
+    case FILTER_HALFTONING_ACSP:Filter=std::make_shared<_filter_halftoning_acsp>();break; // ADAPTIVE CLUSTERING SELECTIVE PRECIPITATION
+    #endif
+
+    #ifdef DEFINE_FILTER_HALFTONING_CONTRAST_AWARE
+    case FILTER_HALFTONING_CAH:Filter=std::make_shared<_filter_halftoning_cah>();break; // HALFTONING_CAH
+    #endif
+
+    #ifdef DEFINE_FILTER_HALFTONING_OSTROMOUKHOV
+    case FILTER_HALFTONING_OST:Filter=std::make_shared<_filter_halftoning_ost>();break; // HALFTONING
+    #endif
+
+    #ifdef DEFINE_FILTER_HALFTONING_SPACE_FILLING_CURVE
+    case FILTER_HALFTONING_SFC:Filter=std::make_shared<_filter_halftoning_sfc>();break; // SPACE FILLING CURVE
+    #endif
+
+    #ifdef DEFINE_FILTER_INVERSION
+    case FILTER_INVERSION:Filter=std::make_shared<_filter_inversion>();break; // INVERSION
+    #endif
+
+    #ifdef DEFINE_FILTER_KANG
+    case FILTER_KANG:Filter=std::make_shared<_filter_kang>();break; // KANG
+    #endif
+
+    #ifdef DEFINE_FILTER_MEASURE_SSIM_PSNR
+    case FILTER_MEASURE_SSIM_PSNR:Filter=std::make_shared<_filter_measure_ssim_psnr>();break; // MEASURE_SSIM_PSNR
+    #endif
+
+    #ifdef DEFINE_FILTER_RETINEX
+    case FILTER_RETINEX:Filter=std::make_shared<_filter_retinex>();break; // RETINEX
+    #endif
+
+    #ifdef DEFINE_FILTER_RWT
+    case FILTER_RWT:
+      if (Input_image0->cols!=Input_image0->rows){
+        std::cout << "Error: filter Recursive Wang Tiles. The image must be square" << std::endl;
+        return false;
+      }
+      Filter=std::make_shared<_filter_rwt>();
+      break; // STIPPLING_RWT
+    #endif
+
+    #ifdef DEFINE_FILTER_STIPPLING_CONTRAST_AWARE
+    case FILTER_STIPPLING_CAS:Filter=std::make_shared<_filter_stippling_cas>();break; // STIPPLING_CAS
+    #endif
+
+    default:break;
+    }// end switch
+
+    if (Filter==nullptr){
+      std::cout << "Error: the filter " << Type << " is not available in this program" << std::endl;
+      return false;
+    }
+
+    Filter->read_parameters(Map_filters_parameters[Name]);
+    Filter->Name=Name;
+    Filters.set(Name,Filter);
+
+    Images.set(Name,std::make_shared<cv::Mat>());
+    if (Filter->change_output_image_size()==false){ // not necessary to change
+      Images.get_data(Name)->create(Input_image0->rows,Input_image0->cols,CV_8U);
+    }
+    else{ // it is necessary to change the size of the output image
+      Images.get_data(Name)->create(Height_aux,Width_aux,CV_8U);
+    }
+
+    // output_image0
+    Output_image0=Images.get_data(Name).get();
+
+    Filter->set_images(Input_image0,Output_image0,Input_image1);
+    Pipeline.push_back(Filter);
+  }
+
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * Returns false if one filter has failed
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::update_all_filters()
+{
+  Set_kept_images.insert(final_image());
+  Trace.clear();
+  Scheduler.run(Vec_order,Map_data_blocks,Filters);
+  return Scheduler.failed()==false;
+}
+
+
+/*****************************************************************************//**
+ * Only the kept images are complete at the end. If one filter needs the complete
+ * image, the effect is computed as usual
+ *
+ *****************************************************************************/
+
+void _pipeline::update_all_filters_tiled(int Tile_size)
+{
+  _tiler Tiler(Tile_size);
+  std::string Name;
+
+  if (Tiler.tileable(Vec_order,Filters,Images,Name)==false){
+    std::cout << "The filter " << Name << " cannot be computed by tiles. The complete images are used" << std::endl;
+    update_all_filters();
+    return;
+  }
+
+  Set_kept_images.insert(final_image());
+  Trace.clear();
+  Tiler.run(Vec_order,Map_data_blocks,Filters,Images,Set_kept_images);
+}
+
+
+/*****************************************************************************//**
+ * The input image is read by strips and the outputs are written by strips, so
+ * the complete images are never in memory. Only the rows of the band of tiles
+ * that is computed (plus the halo) are read. If the effect cannot be computed by tiles, or one output is not
+ * produced by a filter, the complete image is used. It is also used when the size is not a multiple of 4,
+ * as set_image() resizes the complete image and the output must be the same one
+ *****************************************************************************/
+
+bool _pipeline::stream_effect(std::string Input_file, std::vector<std::pair<std::string,std::string>> &Outputs, int Tile_size)
+{
+  _image_reader Reader;
+  _tiler Tiler(Tile_size);
+  std::vector<std::pair<std::string,std::shared_ptr<_image_writer>>> Writers;
+  std::string Name;
+  cv::Mat Band;
+  int Band_row=0;
+  bool Result=true;
+
+  if (Reader.open(Input_file)==false) return false;
+
+  // the filters are created for the first band
+  if (Reader.read_rows(Tile_size,Band)==false) return false;
+  // the strips of mapped files are not valid after closing the reader
+  Band=Band.clone();
+  set_input_images(Band);
+
+  bool Streamable=create_filters_from_blocks();
+  if (Streamable && (Reader.rows()%4!=0 || Reader.cols()%4!=0)){
+    std::cout << "The size of the input image is not a multiple of 4" << std::endl;
+    Streamable=false;
+  }
+  if (Streamable && Tiler.tileable(Vec_order,Filters,Images,Name)==false){
+    std::cout << "The filter " << Name << " cannot be computed by tiles" << std::endl;
+    Streamable=false;
+  }
+  for (auto &Output: Outputs){
+    if (Output.first=="") Output.first=final_image();
+    if (Filters.Data_by_string.find(Output.first)==Filters.Data_by_string.end()) Streamable=false;
+  }
+
+  if (Streamable==false){
+    std::cout << "The effect cannot be streamed. The complete image is used" << std::endl;
+    Reader.close();
+    if (read_image(Input_file)==false || create_filters_from_blocks()==false) return false;
+
+    for (auto &Output: Outputs) keep_image(Output.first);
+    update_all_filters_tiled(Tile_size);
+
+    for (auto &Output: Outputs){
+      if (save_image(Output.first,Output.second)==false) Result=false;
+    }
+    return Result;
+  }
+
+  for (auto &Output: Outputs){
+    std::shared_ptr<_image_writer> Writer=std::make_shared<_image_writer>();
+    if (Writer->open(Output.second,Reader.rows(),Reader.cols(),Images.get_data(Output.first)->channels())==false) return false;
+    Writers.push_back(std::make_pair(Output.first,Writer));
+    keep_image(Output.first);
+  }
+
+  // the rows of the previous band that are needed again are maintained
+  Tiler.set_source_function(Reader.rows(),Reader.cols(),[&](int Row_start,int Row_end){
+    cv::Mat New_band(Row_end-Row_start,Reader.cols(),Band.type());
+    cv::Mat Strip;
+    int Row=Row_start;
+
+    if (Row<Band_row+Band.rows){
+      int Num_rows=std::min(Band_row+Band.rows,Row_end)-Row;
+      cv::Mat Band_rows=New_band.rowRange(0,Num_rows);
+      Band.rowRange(Row-Band_row,Row-Band_row+Num_rows).copyTo(Band_rows);
+      Row+=Num_rows;
+    }
+    // the rows that are not needed are skipped
+    if (Row<Row_end && Reader.next_row()<Row) Result&=Reader.read_rows(Row-Reader.next_row(),Strip);
+
+    while (Result && Row<Row_end){
+      if (Reader.read_rows(Row_end-Row,Strip)==false || Strip.empty()){
+        Result=false;
+        break;
+      }
+      cv::Mat Band_rows=New_band.rowRange(Row-Row_start,Row-Row_start+Strip.rows);
+      Strip.copyTo(Band_rows);
+      Row+=Strip.rows;
+    }
+
+    Band=New_band;
+    Band_row=Row_start;
+    set_input_images(Band);
+  });
+
+  Tiler.set_sink_function([&](const std::string &Image_name,cv::Mat &Rows){
+    for (auto &Writer: Writers){
+      if (Writer.first==Image_name && Writer.second->write_rows(Rows)==false) Result=false;
+    }
+  });
+
+  Trace.clear();
+  Tiler.run(Vec_order,Map_data_blocks,Filters,Images,Set_kept_images);
+
+  for (auto &Writer: Writers){
+    if (Writer.second->close()==false) Result=false;
+  }
+
+  return Result;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::save_image(std::string Image_name, std::string File_name)
+{
+  _image_IO Image_io;
+
+  if (Images.Data_by_string.find(Image_name)==Images.Data_by_string.end()){
+    std::cout << "Error: the image " << Image_name << " does not exist" << std::endl;
+    return false;
+  }
+
+  // the version of the input image that no filter reads is computed now
+  if (Image_name=="COLOR" && Image_cv_color->empty()) cvtColor(*Image_cv_gray.get(),*Image_cv_color.get(),cv::COLOR_GRAY2RGB,3);
+  if (Image_name=="GRAY" && Image_cv_gray->empty()) cvtColor(*Image_cv_color.get(),*Image_cv_gray.get(),cv::COLOR_BGR2GRAY,1);
+
+  return Image_io.write_image(File_name,*Images.get_data(Image_name).get());
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _pipeline::keep_inputs(std::string Filter_name)
+{
+  auto Position=Map_data_blocks.find(Filter_name);
+  if (Position==Map_data_blocks.end()) return;
+
+  if (Position->second.In1!="") keep_image(Position->second.In1);
+  if (Position->second.In2!="") keep_image(Position->second.In2);
+}
+
+
+/*****************************************************************************//**
+ * The dots are read from the input images of the filter, that must be kept
+ *
+ *
+ *****************************************************************************/
+
+bool _pipeline::save_dots(std::string Filter_name, std::string File_name)
+{
+  if (Filters.Data_by_string.find(Filter_name)==Filters.Data_by_string.end()){
+    std::cout << "Error: the filter " << Filter_name << " does not exist" << std::endl;
+    return false;
+  }
+
+  std::shared_ptr<_filter> Filter=Filters.get_data(Filter_name);
+
+  #ifdef DEFINE_FILTER_DOT_EBG
+  if (Filter->Type_filter==FILTER_DOT_EBG) return std::static_pointer_cast<_filter_dot_ebg>(Filter)->save_vector(File_name);
+  #endif
+
+  std::cout << "Error: the filter " << Filter_name << " does not draw dots that can be saved as vectors" << std::endl;
+  return false;
+}
+
+
+/*****************************************************************************//**
+ * The dots of a stippling filter keep their decimals. The dots of other images
+ * are their black pixels. The travel is shown before and after the ordering
+ *
+ *****************************************************************************/
+
+bool _pipeline::save_plot(std::string Image_name, std::string File_name, float Resolution)
+{
+  std::string Name=Image_name;
+  float Scaling_factor=1;
+
+  // the dots are in the positions of the input, at the scale of the output
+  if (Filters.Data_by_string.find(Image_name)!=Filters.Data_by_string.end()){
+    std::shared_ptr<_filter> Filter=Filters.get_data(Image_name);
+    if (Filter->Type_filter==FILTER_DOT_EBG){
+      Name=Map_data_blocks[Image_name].In1;
+      Scaling_factor=Filter->scaling_factor();
+    }
+  }
+
+  if (Images.Data_by_string.find(Name)==Images.Data_by_string.end()){
+    std::cout << "Error: the image " << Name << " does not exist" << std::endl;
+    return false;
+  }
+
+  cv::Mat *Image=Images.get_data(Name).get();
+  std::shared_ptr<const _point_set> Points=_filter::Conversion_cache.points(Image);
+  _point_set Dots;
+
+  if (Points!=nullptr) Dots=*Points;
+  else{
+    std::shared_ptr<const _binary_image> Binary_image=_filter::Conversion_cache.binary(Image);
+    if (Binary_image==nullptr){
+      std::cout << "Error: the image " << Name << " has pixels that are not black or white, so it has not dots" << std::endl;
+      return false;
+    }
+    Binary_image->for_each([&](int Row,int Col){Dots.push_back({(float)Col,(float)Row,0,-1});});
+  }
+
+  for (auto &Dot: Dots){
+    Dot.x*=Scaling_factor;
+    Dot.y*=Scaling_factor;
+  }
+
+  _plotter_writer Writer;
+  Writer.set_points(Dots,(int)((float)Image->rows*Scaling_factor));
+  Dots.clear();
+
+  float Millimeters=25.4f/Resolution;
+  double Travel=Writer.travel()*Millimeters;
+  Writer.optimize();
+  double Travel_optimized=Writer.travel()*Millimeters;
+
+  std::cout << "Travel of the pen up for " << Writer.num_points() << " dots: " << (long)Travel << " mm, ordered " << (long)Travel_optimized << " mm";
+  if (Travel>0) std::cout << " (" << (int)round(100.0*(Travel-Travel_optimized)/Travel) << "% less)";
+  std::cout << std::endl;
+
+  return Writer.write(File_name,Resolution);
+}
+
+
+/*****************************************************************************//**
+ * The image produced by the last filter of the effect
+ *
+ *
+ *****************************************************************************/
+
+std::string _pipeline::final_image()
+{
+  if (Vec_order.size()==0) return "GRAY";
+  return Vec_order[Vec_order.size()-1];
+}
+
+
+/*****************************************************************************//**
+ * The memory of the image returns to the pool of buffers of the filters. It is
+ * called by the scheduler when all the filters that read the image have finished
+ *
+ *****************************************************************************/
+
+void _pipeline::release_image(const std::string &Image_name)
+{
+  if (Set_kept_images.find(Image_name)!=Set_kept_images.end()) return;
+
+  auto Position=Images.Data_by_string.find(Image_name);
+  if (Position!=Images.Data_by_string.end()){
+    _filter::Conversion_cache.invalidate(Position->second.get());
+    _filter::Buffer_pool.put(*Position->second);
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _pipeline::adjust_image_sizes(int &Width1, int &Height1)
+{
+  float Rest;
+
+  if (Width1%4!=0){
+    Rest=round((float)Width1/4.0);
+    Width1=(int)Rest*4;
+  }
+  if (Height1%4!=0){
+    Rest=round((float)Height1/4.0);
+    Height1=(int)Rest*4;
+  }
+}
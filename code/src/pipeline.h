@@ -0,0 +1,198 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <opencv.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <set>
+#include <iostream>
+
+#include "image_IO.h"
+#include "map_list.h"
+#include "ne_common.h"
+#include "filter.h"
+#include "scheduler.h"
+#include "tiler.h"
+#include "plotter_writer.h"
+
+#ifdef DEFINE_FILTER_BILATERAL
+#include "filter_bilateral.h"
+#endif
+
+#ifdef DEFINE_FILTER_CANNY
+#include "filter_canny.h"
+#endif
+
+#ifdef DEFINE_FILTER_CCVT
+#include "filter_ccvt.h"
+#endif
+
+#ifdef DEFINE_FILTER_COMBINATION
+#include "filter_combination.h"
+#endif
+
+#ifdef DEFINE_FILTER_HALFTONING_CONTRAST_AWARE
+#include "filter_halftoning_cah.h"
+#endif
+
+#ifdef DEFINE_FILTER_CONTRAST_BRIGHT
+#include "filter_contrast_bright.h"
+#endif
+
+#ifdef DEFINE_FILTER_DILATION
+#include "filter_dilation.h"
+#endif
+
+#ifdef DEFINE_FILTER_DISTANCE_FIELD
+#include "filter_distance_field.h"
+#endif
+
+#ifdef DEFINE_FILTER_DOG
+#include "filter_dog.h"
+#endif
+
+#ifdef DEFINE_FILTER_DOT_EBG
+#include "filter_dot_ebg.h"
+#endif
+
+#ifdef DEFINE_FILTER_EROTION
+#include "filter_erotion.h"
+#endif
+
+#ifdef DEFINE_FILTER_GAUSSIAN
+#include "filter_gaussian.h"
+#endif
+
+#ifdef DEFINE_FILTER_HALFTONING_ADAPTIVE_CLUSTERING_SELECTIVE_PRECIPITATION
+#include "filter_halftoning_acsp.h"
+#endif
+
+#ifdef DEFINE_FILTER_HALFTONING_OSTROMOUKHOV
+#include "filter_halftoning_ost.h"
+#endif
+
+#ifdef DEFINE_FILTER_HALFTONING_SPACE_FILLING_CURVE
+#include "filter_halftoning_sfc.h"
+#endif
+
+#ifdef DEFINE_FILTER_INVERSION
+#include "filter_inversion.h"
+#endif
+
+#ifdef DEFINE_FILTER_KANG
+#include "filter_kang.h"
+#endif
+
+#ifdef DEFINE_FILTER_MEASURE_SSIM_PSNR
+#include "filter_measure_ssim_psnr.h"
+#endif
+
+#ifdef DEFINE_FILTER_RETINEX
+#include "filter_retinex.h"
+#endif
+
+#ifdef DEFINE_FILTER_EXAMPLE_BASED_GRAYSCALE_STIPPLING
+#include "filter_stippling_ebg.h"
+#endif
+
+#ifdef DEFINE_FILTER_STIPPLING_CONTRAST_AWARE
+#include "filter_stippling_cas.h"
+#endif
+
+#ifdef DEFINE_FILTER_RWT
+#include "filter_rwt.h"
+#endif
+
+/*****************************************************************************//**
+ * This class has the same data that _gl_widget uses to run an effect (Filters,
+ * Images, Graph...) but without widgets nor OpenGL. It is used for batch processing
+ *
+ *
+ *****************************************************************************/
+
+class _pipeline
+{
+public:
+  _pipeline();
+  ~_pipeline();
+
+  void clear_data();
+
+  bool read_effect(std::string File_name);
+  bool set_effect(std::vector<std::map<std::string,std::string>> &Filters_json_data1);
+  bool read_image(std::string File_name);
+  bool set_image(cv::Mat &Image);
+  bool create_filters_from_blocks();
+  bool update_all_filters();
+  // the same but by tiles of Tile_size x Tile_size pixels, when all the filters allow it
+  void update_all_filters_tiled(int Tile_size);
+  // reads the input file and writes the outputs (image name, file name) by strips.
+  // An empty image name is the final image
+  bool stream_effect(std::string Input_file, std::vector<std::pair<std::string,std::string>> &Outputs, int Tile_size);
+  // the intermediate images are freed after their last reader, except the final
+  // image and the images that are kept
+  void keep_image(std::string Image_name){Set_kept_images.insert(Image_name);};
+  bool save_image(std::string Image_name, std::string File_name);
+  // the input images of the filter are kept, so it can use them after the computation
+  void keep_inputs(std::string Filter_name);
+  // the dots of a DOT_EBG filter are saved as vectors (SVG, SVGZ, PDF or EPS)
+  bool save_dots(std::string Filter_name, std::string File_name);
+  // the dots of the image are saved for a pen plotter (HPGL or G-code), ordered to
+  // reduce the travel of the pen. For a DOT_EBG filter the dots of its input are used
+  bool save_plot(std::string Image_name, std::string File_name, float Resolution=_f_plotter_writer_ns::RESOLUTION_DEFAULT);
+  bool save_trace(std::string File_name){return Trace.write_chrome_trace(File_name);};
+
+  std::string final_image();
+
+  _map_list<std::shared_ptr<_filter>> Filters;
+  _map_list<std::shared_ptr<cv::Mat>> Images;
+  std::vector<std::shared_ptr<_filter>> Pipeline;
+
+  // for each image, the filters that use it as input
+  std::map<std::string,std::vector<std::string>> Graph;
+
+  // the data of the effect
+  std::vector<std::map<std::string,std::string>> Filters_json_data;
+  std::map<std::string,_block> Map_data_blocks;
+  std::vector<std::string> Vec_order;
+  std::map<std::string,std::map<std::string,std::string>> Map_filters_parameters;
+
+protected:
+  bool create_blocks_from_effect();
+  void compute_order(std::string Name, std::map<std::string,bool> &Visited);
+  void adjust_image_sizes(int &Width1, int &Height1);
+  void set_input_images(cv::Mat &Image);
+  void release_image(const std::string &Image_name);
+
+  std::shared_ptr<cv::Mat> Original_image;
+  std::shared_ptr<cv::Mat> Image_cv_gray;
+  std::shared_ptr<cv::Mat> Image_cv_color;
+
+  // runs the independent branches of the effect in parallel
+  _scheduler Scheduler;
+  // the images that are not released (they are saved after the computation)
+  std::set<std::string> Set_kept_images;
+  // time and memory of each filter of the last computation
+  _trace Trace;
+};
+
+#endif
@@ -0,0 +1,442 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#include "plotter_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+
+
+/*****************************************************************************//**
+ * By the extension
+ *
+ *
+ *****************************************************************************/
+
+_f_plotter_writer_ns::_format _f_plotter_writer_ns::format(std::string Name)
+{
+  size_t Position=Name.find_last_of('.');
+  if (Position==std::string::npos) return FORMAT_OTHER;
+
+  std::string Extension=Name.substr(Position+1);
+  std::transform(Extension.begin(),Extension.end(),Extension.begin(),[](unsigned char Char){return (char)tolower(Char);});
+
+  if (Extension=="hpgl" || Extension=="hpg" || Extension=="plt") return FORMAT_HPGL;
+  if (Extension=="gcode" || Extension=="gc" || Extension=="nc" || Extension=="ngc") return FORMAT_GCODE;
+  return FORMAT_OTHER;
+}
+
+
+/*****************************************************************************//**
+ * The initial order is the order of the dots
+ *
+ *
+ *****************************************************************************/
+
+void _plotter_writer::set_points(const _point_set &Points1, int Height1)
+{
+  Height=Height1;
+  Vec_x.resize(Points1.size());
+  Vec_y.resize(Points1.size());
+  Order.resize(Points1.size());
+  for (size_t i=0;i<Points1.size();i++){
+    Vec_x[i]=Points1[i].x;
+    Vec_y[i]=Points1[i].y;
+    Order[i]=(int)i;
+  }
+}
+
+
+/*****************************************************************************//**
+ * The improvements are repeated while they shorten the path enough
+ *
+ *
+ *****************************************************************************/
+
+void _plotter_writer::optimize()
+{
+  if (Order.size()<4) return;
+
+  sort_hilbert();
+  nearest_neighbour();
+
+  Path.resize(Order.size());
+  for (size_t i=0;i<Order.size();i++) Path[i]={Vec_x[Order[i]],Vec_y[Order[i]],Order[i]};
+
+  double Previous_travel=travel();
+  for (int Pass=0;Pass<_f_plotter_writer_ns::MAX_PASSES;Pass++){
+    bool Improved=two_opt();
+    if (or_opt()) Improved=true;
+    if (Improved==false) break;
+
+    for (size_t i=0;i<Path.size();i++) Order[i]=Path[i].Index;
+    double Travel=travel();
+    if (Previous_travel-Travel<Previous_travel*_f_plotter_writer_ns::MIN_IMPROVEMENT) break;
+    Previous_travel=Travel;
+  }
+
+  for (size_t i=0;i<Path.size();i++) Order[i]=Path[i].Index;
+  Path.clear();
+  Path.shrink_to_fit();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+double _plotter_writer::travel()
+{
+  double Travel=0;
+
+  for (size_t i=1;i<Order.size();i++) Travel+=distance(Order[i-1],Order[i]);
+  return Travel;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+float _plotter_writer::distance(int Point1, int Point2)
+{
+  float Diff_x=Vec_x[Point1]-Vec_x[Point2];
+  float Diff_y=Vec_y[Point1]-Vec_y[Point2];
+
+  return sqrtf(Diff_x*Diff_x+Diff_y*Diff_y);
+}
+
+
+/*****************************************************************************//**
+ * The Hilbert curve keeps together the points that are near, so it is a good
+ * first path, and it is used when the nearest neighbour is too far
+ *
+ *****************************************************************************/
+
+void _plotter_writer::sort_hilbert()
+{
+  const uint32_t Size=1<<16;
+
+  float Min_x=*std::min_element(Vec_x.begin(),Vec_x.end());
+  float Max_x=*std::max_element(Vec_x.begin(),Vec_x.end());
+  float Min_y=*std::min_element(Vec_y.begin(),Vec_y.end());
+  float Max_y=*std::max_element(Vec_y.begin(),Vec_y.end());
+  float Side=std::max(Max_x-Min_x,Max_y-Min_y);
+  float Scale=(Side>0)?(float)(Size-1)/Side:0;
+
+  std::vector<std::pair<uint64_t,int>> Keys(Order.size());
+
+  for (size_t i=0;i<Order.size();i++){
+    uint32_t x=(uint32_t)((Vec_x[i]-Min_x)*Scale);
+    uint32_t y=(uint32_t)((Vec_y[i]-Min_y)*Scale);
+    uint64_t Key=0;
+
+    // the position in the curve, from the biggest quadrants to the smallest ones
+    for (uint32_t Step=Size/2;Step>0;Step/=2){
+      uint32_t Right=(x & Step)?1:0;
+      uint32_t Up=(y & Step)?1:0;
+      Key+=(uint64_t)Step*Step*((3*Right)^Up);
+      if (Up==0){
+        if (Right==1){
+          x=Size-1-x;
+          y=Size-1-y;
+        }
+        std::swap(x,y);
+      }
+    }
+    Keys[i]=std::make_pair(Key,(int)i);
+  }
+
+  std::sort(Keys.begin(),Keys.end());
+  for (size_t i=0;i<Keys.size();i++) Order[i]=Keys[i].second;
+}
+
+
+/*****************************************************************************//**
+ * The points are saved in a grid of cells with about POINTS_PER_CELL points. The
+ * cells are searched by rings around the current point. A point in the ring R+1 is
+ * at R cells at least, so the search stops when the nearest point is nearer.
+ * The visited points are removed from their cells
+ *****************************************************************************/
+
+void _plotter_writer::nearest_neighbour()
+{
+  int Num_points=(int)Order.size();
+
+  float Min_x=*std::min_element(Vec_x.begin(),Vec_x.end());
+  float Max_x=*std::max_element(Vec_x.begin(),Vec_x.end());
+  float Min_y=*std::min_element(Vec_y.begin(),Vec_y.end());
+  float Max_y=*std::max_element(Vec_y.begin(),Vec_y.end());
+  float Area=std::max(Max_x-Min_x,1.0f)*std::max(Max_y-Min_y,1.0f);
+  float Cell_size=sqrtf(Area*_f_plotter_writer_ns::POINTS_PER_CELL/(float)Num_points);
+  int Grid_cols=(int)((Max_x-Min_x)/Cell_size)+1;
+  int Grid_rows=(int)((Max_y-Min_y)/Cell_size)+1;
+
+  std::vector<int> Cell_of(Num_points);
+  std::vector<int> Cell_start(Grid_cols*Grid_rows+1,0);
+  std::vector<int> Cell_count(Grid_cols*Grid_rows,0);
+  std::vector<int> Cell_points(Num_points);
+  std::vector<int> Position(Num_points);
+
+  // the points of each cell are together (counting sort)
+  for (int i=0;i<Num_points;i++){
+    int Col=std::min((int)((Vec_x[i]-Min_x)/Cell_size),Grid_cols-1);
+    int Row=std::min((int)((Vec_y[i]-Min_y)/Cell_size),Grid_rows-1);
+    Cell_of[i]=Row*Grid_cols+Col;
+    Cell_count[Cell_of[i]]++;
+  }
+  for (int i=0;i<Grid_cols*Grid_rows;i++) Cell_start[i+1]=Cell_start[i]+Cell_count[i];
+  std::vector<int> Next(Cell_start.begin(),Cell_start.end()-1);
+  for (int i=0;i<Num_points;i++){
+    Position[i]=Next[Cell_of[i]]++;
+    Cell_points[Position[i]]=i;
+  }
+
+  // the alive points of a cell are the first Cell_count ones
+  auto Remove=[&](int Point){
+    int Cell=Cell_of[Point];
+    int Last=Cell_start[Cell]+Cell_count[Cell]-1;
+    int Other=Cell_points[Last];
+
+    std::swap(Cell_points[Position[Point]],Cell_points[Last]);
+    Position[Other]=Position[Point];
+    Position[Point]=Last;
+    Cell_count[Cell]--;
+  };
+
+  std::vector<bool> Visited(Num_points,false);
+  std::vector<int> New_order;
+  int Next_in_curve=0;
+  int Current=Order[0];
+
+  New_order.reserve(Num_points);
+  New_order.push_back(Current);
+  Visited[Current]=true;
+  Remove(Current);
+
+  for (int k=1;k<Num_points;k++){
+    int Cell_col=Cell_of[Current]%Grid_cols;
+    int Cell_row=Cell_of[Current]/Grid_cols;
+    int Best=-1;
+    float Best_distance=std::numeric_limits<float>::max();
+
+    for (int Ring=0;Ring<=_f_plotter_writer_ns::MAX_RINGS;Ring++){
+      for (int Row=Cell_row-Ring;Row<=Cell_row+Ring;Row++){
+        if (Row<0 || Row>=Grid_rows) continue;
+        // only the border of the ring
+        int Step=(Row==Cell_row-Ring || Row==Cell_row+Ring)?1:2*Ring;
+        for (int Col=Cell_col-Ring;Col<=Cell_col+Ring;Col+=Step){
+          if (Col<0 || Col>=Grid_cols) continue;
+          int Cell=Row*Grid_cols+Col;
+          for (int i=Cell_start[Cell];i<Cell_start[Cell]+Cell_count[Cell];i++){
+            float Distance=distance(Current,Cell_points[i]);
+            if (Distance<Best_distance){
+              Best_distance=Distance;
+              Best=Cell_points[i];
+            }
+          }
+        }
+      }
+      if (Best>=0 && Best_distance<=(float)Ring*Cell_size) break;
+      if (Cell_col-Ring<0 && Cell_col+Ring>=Grid_cols && Cell_row-Ring<0 && Cell_row+Ring>=Grid_rows) break;
+    }
+
+    // the near cells are empty: the path continues with the curve
+    if (Best<0){
+      while (Visited[Order[Next_in_curve]]) Next_in_curve++;
+      Best=Order[Next_in_curve];
+    }
+
+    New_order.push_back(Best);
+    Visited[Best]=true;
+    Remove(Best);
+    Current=Best;
+  }
+
+  Order.swap(New_order);
+}
+
+
+/*****************************************************************************//**
+ * Two edges of the path (A,B) and (C,D) are changed by (A,C) and (B,D), reversing
+ * the points between them. C is at WINDOW positions from A at most. The path is
+ * open, so the last edge can be removed without adding (B,D)
+ *
+ *****************************************************************************/
+
+bool _plotter_writer::two_opt()
+{
+  int Num_points=(int)Path.size();
+  bool Improved=false;
+
+  for (int i=0;i<Num_points-2;i++){
+    _node A=Path[i];
+    float Distance_ab=distance(A,Path[i+1]);
+    int Last=std::min(i+_f_plotter_writer_ns::WINDOW,Num_points-1);
+
+    for (int j=i+2;j<=Last;j++){
+      _node C=Path[j];
+      float Gain;
+
+      if (j==Num_points-1) Gain=Distance_ab-distance(A,C);
+      else Gain=Distance_ab+distance(C,Path[j+1])-distance(A,C)-distance(Path[i+1],Path[j+1]);
+
+      if (Gain>1e-4f){
+        std::reverse(Path.begin()+i+1,Path.begin()+j+1);
+        Distance_ab=distance(A,Path[i+1]);
+        Improved=true;
+      }
+    }
+  }
+  return Improved;
+}
+
+
+/*****************************************************************************//**
+ * A segment of 1 to MAX_SEGMENT points is moved, maybe reversed, between two
+ * points that are at WINDOW positions at most, before or after it
+ *
+ *
+ *****************************************************************************/
+
+bool _plotter_writer::or_opt()
+{
+  int Num_points=(int)Path.size();
+  bool Improved=false;
+
+  for (int Length=1;Length<=_f_plotter_writer_ns::MAX_SEGMENT;Length++){
+    for (int i=0;i+Length<=Num_points;i++){
+      _node First=Path[i];
+      _node Last=Path[i+Length-1];
+      bool Has_previous=(i>0);
+      bool Has_next=(i+Length<Num_points);
+
+      // the distance that is saved removing the segment
+      float Removed=0;
+      if (Has_previous) Removed+=distance(Path[i-1],First);
+      if (Has_next) Removed+=distance(Last,Path[i+Length]);
+      if (Has_previous && Has_next) Removed-=distance(Path[i-1],Path[i+Length]);
+      if (Removed<=1e-4f) continue;
+
+      // the segment is inserted after position j
+      int Best_j=-1;
+      bool Best_reversed=false;
+      float Best_gain=1e-4f;
+      int Start=std::max(0,i-1-_f_plotter_writer_ns::WINDOW);
+      int End=std::min(Num_points-1,i+Length+_f_plotter_writer_ns::WINDOW);
+
+      for (int j=Start;j<=End;j++){
+        if (j>=i-1 && j<=i+Length-1) continue;
+
+        _node C=Path[j];
+        float Added,Added_reversed;
+        if (j+1<Num_points){
+          _node E=Path[j+1];
+          float Distance_ce=distance(C,E);
+          Added=distance(C,First)+distance(Last,E)-Distance_ce;
+          Added_reversed=distance(C,Last)+distance(First,E)-Distance_ce;
+        }
+        else{
+          Added=distance(C,First);
+          Added_reversed=distance(C,Last);
+        }
+
+        if (Removed-Added>Best_gain){
+          Best_gain=Removed-Added;
+          Best_j=j;
+          Best_reversed=false;
+        }
+        if (Length>1 && Removed-Added_reversed>Best_gain){
+          Best_gain=Removed-Added_reversed;
+          Best_j=j;
+          Best_reversed=true;
+        }
+      }
+
+      if (Best_j<0) continue;
+
+      int New_position;
+      if (Best_j>i){
+        std::rotate(Path.begin()+i,Path.begin()+i+Length,Path.begin()+Best_j+1);
+        New_position=Best_j-Length+1;
+      }
+      else{
+        std::rotate(Path.begin()+Best_j+1,Path.begin()+i,Path.begin()+i+Length);
+        New_position=Best_j+1;
+      }
+      if (Best_reversed) std::reverse(Path.begin()+New_position,Path.begin()+New_position+Length);
+      Improved=true;
+    }
+  }
+  return Improved;
+}
+
+
+/*****************************************************************************//**
+ * Each dot is a move with the pen up and a pen down. The origin is in the bottom
+ * left corner
+ *
+ *****************************************************************************/
+
+bool _plotter_writer::write(std::string Name, float Resolution)
+{
+  _f_plotter_writer_ns::_format Format=_f_plotter_writer_ns::format(Name);
+  if (Format==_f_plotter_writer_ns::FORMAT_OTHER){
+    std::cout << "Error: the dots can only be saved for plotters as HPGL or G-code: " << Name << std::endl;
+    return false;
+  }
+
+  FILE *File=fopen(Name.c_str(),"w");
+  if (File==nullptr){
+    std::cout << "Error: the file cannot be created: " << Name << std::endl;
+    return false;
+  }
+
+  float Millimeters=25.4f/Resolution;
+
+  if (Format==_f_plotter_writer_ns::FORMAT_HPGL){
+    float Scale=Millimeters*_f_plotter_writer_ns::HPGL_UNITS_PER_MM;
+
+    fprintf(File,"IN;SP1;PA;\n");
+    for (auto Point: Order){
+      fprintf(File,"PU%ld,%ld;PD;\n",lroundf(Vec_x[Point]*Scale),lroundf(((float)Height-Vec_y[Point])*Scale));
+    }
+    fprintf(File,"PU;SP0;\n");
+  }
+  else{
+    fprintf(File,"G21\nG90\nG0 Z%.2f\n",_f_plotter_writer_ns::GCODE_PEN_UP);
+    for (auto Point: Order){
+      fprintf(File,"G0 X%.2f Y%.2f\nG1 Z%.2f F%.0f\nG0 Z%.2f\n",Vec_x[Point]*Millimeters,((float)Height-Vec_y[Point])*Millimeters,
+              _f_plotter_writer_ns::GCODE_PEN_DOWN,_f_plotter_writer_ns::GCODE_FEED_RATE,_f_plotter_writer_ns::GCODE_PEN_UP);
+    }
+    fprintf(File,"G0 X0 Y0\nM2\n");
+  }
+
+  bool Result=(ferror(File)==0);
+  if (fclose(File)!=0) Result=false;
+
+  if (Result==false) std::cout << "Error writing the file: " << Name << std::endl;
+  return Result;
+}
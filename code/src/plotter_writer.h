@@ -0,0 +1,110 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#ifndef PLOTTER_WRITER_H
+#define PLOTTER_WRITER_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "point_set.h"
+
+
+namespace _f_plotter_writer_ns
+{
+  typedef enum {FORMAT_OTHER,FORMAT_HPGL,FORMAT_GCODE} _format;
+
+  // .hpgl, .plt or .hpg for HPGL. .gcode, .gc, .nc or .ngc for G-code
+  _format format(std::string Name);
+
+  // the resolution of the image in pixels per inch
+  const float RESOLUTION_DEFAULT=300;
+  // HPGL uses units of 0.025 mm
+  const float HPGL_UNITS_PER_MM=40;
+  // G-code: the height of the pen (mm) and the speed of the pen down (mm/min)
+  const float GCODE_PEN_UP=2;
+  const float GCODE_PEN_DOWN=0;
+  const float GCODE_FEED_RATE=1000;
+
+  // the points of each cell of the grid of the nearest neighbour search
+  const float POINTS_PER_CELL=2;
+  // the search stops at this ring of cells. The next point of the curve is used
+  const int MAX_RINGS=8;
+  // the moves of 2-opt and Or-opt only join points at this distance in the path
+  const int WINDOW=32;
+  // the longest segment that Or-opt moves
+  const int MAX_SEGMENT=3;
+  // the passes of 2-opt and Or-opt stop when the path is shortened less than this fraction
+  const double MIN_IMPROVEMENT=0.005;
+  const int MAX_PASSES=4;
+}
+
+
+/*****************************************************************************//**
+ * Writes the dots for a pen plotter. The plotter goes to each dot with the pen up
+ * and puts the pen down, so the time is spent in the travel between dots. The
+ * order is optimized as a travelling salesman path: the points are sorted along a
+ * Hilbert curve, the path is built taking the nearest neighbour in a grid, and
+ * it is improved with 2-opt and Or-opt moves between near positions of the path.
+ * All the steps are almost linear, so millions of dots take seconds
+ *****************************************************************************/
+
+class _plotter_writer
+{
+public:
+  // the positions are in pixels. Height is used to put the origin in the bottom left corner
+  void set_points(const _point_set &Points1,int Height1);
+  void optimize();
+  // the distance (pixels) with the pen up between the dots in the current order
+  double travel();
+  size_t num_points(){return Order.size();};
+
+  // the size of the pixels is 1/Resolution inches. It returns false if there is an error
+  // (the message is shown)
+  bool write(std::string Name,float Resolution=_f_plotter_writer_ns::RESOLUTION_DEFAULT);
+
+protected:
+  typedef struct {
+    float x;
+    float y;
+    int Index;
+  } _node;
+
+  float distance(int Point1,int Point2);
+  static float distance(const _node &Node1,const _node &Node2)
+  {
+    float Diff_x=Node1.x-Node2.x;
+    float Diff_y=Node1.y-Node2.y;
+    return sqrtf(Diff_x*Diff_x+Diff_y*Diff_y);
+  };
+  void sort_hilbert();
+  void nearest_neighbour();
+  bool two_opt();
+  bool or_opt();
+
+  std::vector<float> Vec_x;
+  std::vector<float> Vec_y;
+  int Height=0;
+  // the indices of the points in the order of the path
+  std::vector<int> Order;
+  // the points in the order of the path while it is improved, so the points that
+  // are near in the path are near in memory
+  std::vector<_node> Path;
+};
+
+#endif
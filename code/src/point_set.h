@@ -0,0 +1,42 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#ifndef POINT_SET_H
+#define POINT_SET_H
+
+#include <vector>
+
+
+/*****************************************************************************//**
+ * A dot computed by a stippling filter. The position is in pixels of the image
+ * with decimals (x is the column and y the row), so the pixel of the dot is
+ * (int)y,(int)x
+ *****************************************************************************/
+
+typedef struct {
+  float x;
+  float y;
+  // 0 if the filter does not compute the size
+  float Radius;
+  // from 0 (black) to 1 (white). -1 if the filter does not compute it
+  float Tone;
+} _stipple_point;
+
+// the dots of an image, in the order that they are computed
+typedef std::vector<_stipple_point> _point_set;
+
+#endif
@@ -0,0 +1,220 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include "result_cache.h"
+#include <cstring>
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_result_cache::_result_cache(size_t Max_bytes1)
+{
+  Max_bytes=Max_bytes1;
+  Bytes=0;
+  Hits=0;
+  Misses=0;
+}
+
+
+/*****************************************************************************//**
+ * FNV-1a of the size, type and pixels of the image
+ *
+ *
+ *****************************************************************************/
+
+uint64_t _result_cache::hash(cv::Mat *Image)
+{
+  uint64_t Hash=14695981039346656037ULL;
+  const uint64_t PRIME=1099511628211ULL;
+
+  // 8 bytes in each step
+  auto Add=[&Hash,PRIME](const unsigned char *Data,size_t Size){
+    uint64_t Word;
+    size_t i=0;
+
+    for (;i+8<=Size;i+=8){
+      memcpy(&Word,Data+i,8);
+      Hash^=Word;
+      Hash*=PRIME;
+    }
+    for (;i<Size;i++){
+      Hash^=Data[i];
+      Hash*=PRIME;
+    }
+  };
+
+  int Header[3]={Image->rows,Image->cols,Image->type()};
+  Add((const unsigned char *)Header,sizeof(Header));
+
+  size_t Row_size=Image->cols*Image->elemSize();
+  for (int Row=0;Row<Image->rows;Row++){
+    Add(Image->ptr<unsigned char>(Row),Row_size);
+  }
+
+  return Hash;
+}
+
+
+/*****************************************************************************//**
+ * Returns an empty string if the result of the filter must not be saved
+ *
+ *
+ *****************************************************************************/
+
+std::string _result_cache::key(_filter *Filter)
+{
+  std::map<std::string,std::string> Parameters;
+  std::string Key;
+  char Aux[100];
+
+  if (Filter->cacheable()==false) return "";
+
+  Filter->write_parameters(Parameters);
+  Filter->write_internal_state(Parameters);
+
+  // the size of the output is given by the inputs and the scaling factor. The size
+  // before the computation is not used, as it can be empty or the previous one
+  sprintf(Aux,"%d|%f|%f|",(int)Filter->type_filter(),Filter->scaling_factor(),Filter->proxy_factor());
+  Key=Aux;
+
+  for (auto &Parameter: Parameters){
+    Key+=Parameter.first+"="+Parameter.second+";";
+  }
+
+  sprintf(Aux,"|%016llx",(unsigned long long)hash(Filter->Input_image_0));
+  Key+=Aux;
+  if (Filter->Input_image_1!=nullptr){
+    sprintf(Aux,"|%016llx",(unsigned long long)hash(Filter->Input_image_1));
+    Key+=Aux;
+  }
+
+  return Key;
+}
+
+
+/*****************************************************************************//**
+ * The result is copied to Output_image. The saved image is not shared because the
+ * filters write on their output image. The dots are shared, as they are not changed
+ *
+ *****************************************************************************/
+
+bool _result_cache::get(const std::string &Key, cv::Mat &Output_image, std::shared_ptr<const _point_set> &Points, std::map<std::string,std::string> &Results)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  auto Position=Map_results.find(Key);
+  if (Position==Map_results.end()){
+    Misses++;
+    return false;
+  }
+
+  // now it is the most recently used
+  List_results.splice(List_results.begin(),List_results,Position->second);
+
+  _result &Result=Position->second->second;
+  Result.Image.copyTo(Output_image);
+  Points=Result.Points;
+  Results=Result.Results;
+  Hits++;
+  return true;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _result_cache::set(const std::string &Key, cv::Mat &Output_image, std::shared_ptr<const _point_set> Points, std::map<std::string,std::string> &Results)
+{
+  size_t Size=Output_image.total()*Output_image.elemSize();
+
+  // it does not fit
+  if (Size>Max_bytes) return;
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  auto Position=Map_results.find(Key);
+  if (Position!=Map_results.end()){
+    cv::Mat &Image=Position->second->second.Image;
+    Bytes-=Image.total()*Image.elemSize();
+    List_results.erase(Position->second);
+    Map_results.erase(Position);
+  }
+
+  _result Result;
+  Result.Image=Output_image.clone();
+  Result.Points=Points;
+  Result.Results=Results;
+  List_results.push_front(std::make_pair(Key,Result));
+  Map_results[Key]=List_results.begin();
+  Bytes+=Size;
+
+  remove_old_results();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _result_cache::clear()
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  List_results.clear();
+  Map_results.clear();
+  Bytes=0;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _result_cache::max_bytes(size_t Max_bytes1)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  Max_bytes=Max_bytes1;
+  remove_old_results();
+}
+
+
+/*****************************************************************************//**
+ * LRU: the results at the end of the list are removed. The mutex must be locked
+ *
+ *
+ *****************************************************************************/
+
+void _result_cache::remove_old_results()
+{
+  while (Bytes>Max_bytes && List_results.size()>0){
+    cv::Mat &Image=List_results.back().second.Image;
+    Bytes-=Image.total()*Image.elemSize();
+    Map_results.erase(List_results.back().first);
+    List_results.pop_back();
+  }
+}
@@ -0,0 +1,89 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <opencv.hpp>
+
+#include <string>
+#include <list>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <memory>
+
+#include "filter.h"
+#include "point_set.h"
+
+namespace _f_result_cache_ns
+{
+  const size_t MAX_BYTES_DEFAULT=512*1024*1024;
+}
+
+
+/*****************************************************************************//**
+ * Saves the output image of the filters. The key is built with the type of the
+ * filter, its parameters, its internal state (seeds...) and the contents of the
+ * input images, so the same computation is never done twice while the result is
+ * in the cache. The dots drawn in the image (with decimals) and the data that the
+ * filter shows in its widgets are saved with it, so a result taken from the cache
+ * is the same as a computed one. When the memory limit is reached, the least
+ * recently used results are removed
+ *****************************************************************************/
+
+class _result_cache
+{
+public:
+  _result_cache(size_t Max_bytes1=_f_result_cache_ns::MAX_BYTES_DEFAULT);
+
+  std::string key(_filter *Filter);
+  bool get(const std::string &Key, cv::Mat &Output_image, std::shared_ptr<const _point_set> &Points, std::map<std::string,std::string> &Results);
+  void set(const std::string &Key, cv::Mat &Output_image, std::shared_ptr<const _point_set> Points, std::map<std::string,std::string> &Results);
+  void clear();
+
+  void max_bytes(size_t Max_bytes1);
+  size_t max_bytes(){return Max_bytes;};
+  size_t bytes(){return Bytes;};
+  unsigned long hits(){return Hits;};
+  unsigned long misses(){return Misses;};
+
+  static uint64_t hash(cv::Mat *Image);
+
+protected:
+  void remove_old_results();
+
+  typedef struct {
+    cv::Mat Image;
+    std::shared_ptr<const _point_set> Points;
+    std::map<std::string,std::string> Results;
+  } _result;
+
+  typedef std::list<std::pair<std::string,_result>> _list_results;
+
+  // the first element is the most recently used
+  _list_results List_results;
+  std::map<std::string,_list_results::iterator> Map_results;
+
+  size_t Max_bytes;
+  size_t Bytes;
+  unsigned long Hits;
+  unsigned long Misses;
+
+  std::mutex Mutex;
+};
+
+#endif
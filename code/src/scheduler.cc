@@ -0,0 +1,279 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include "scheduler.h"
+
+#include <exception>
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_scheduler::_scheduler(unsigned int Num_threads1):Pool(Num_threads1)
+{
+  Num_done=0;
+  Num_updates=0;
+  Failed=false;
+  Result_cache=nullptr;
+  Trace=nullptr;
+  Task_control=nullptr;
+}
+
+
+/*****************************************************************************//**
+ * Vec_names has the filters to compute, in a valid order. The inputs that are not
+ * in Vec_names (COLOR, GRAY or filters that are not recomputed) are ready
+ *
+ *****************************************************************************/
+
+void _scheduler::run(std::vector<std::string> &Vec_names1, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _task_control *Task_control1)
+{
+  std::map<std::string,int> Map_index;
+  std::vector<int> Vec_ready;
+
+  Num_updates=0;
+  Failed=false;
+  if (Vec_names1.size()==0) return;
+
+  Task_control=Task_control1;
+  Vec_names=Vec_names1;
+
+  for (unsigned int i=0;i<Vec_names.size();i++) Map_index[Vec_names[i]]=i;
+
+  Vec_filters.resize(Vec_names.size());
+  Vec_consumers.clear();
+  Vec_consumers.resize(Vec_names.size());
+  Vec_inputs.clear();
+  Vec_inputs.resize(Vec_names.size());
+  Vec_num_remaining_readers.assign(Vec_names.size(),0);
+  Vec_num_remaining_inputs.resize(Vec_names.size());
+  Vec_main_thread_tasks.clear();
+  Num_done=0;
+
+  // the graph of dependencies
+  for (unsigned int i=0;i<Vec_names.size();i++){
+    _block &Block=Map_data_blocks[Vec_names[i]];
+
+    Vec_filters[i]=Filters.get_data(Vec_names[i]);
+    Vec_num_remaining_inputs[i]=0;
+
+    if (Map_index.find(Block.In1)!=Map_index.end()){
+      Vec_consumers[Map_index[Block.In1]].push_back(i);
+      Vec_inputs[i].push_back(Map_index[Block.In1]);
+      Vec_num_remaining_readers[Map_index[Block.In1]]++;
+      Vec_num_remaining_inputs[i]++;
+    }
+    // the two inputs can be the same image
+    if (Block.In2!=Block.In1 && Map_index.find(Block.In2)!=Map_index.end()){
+      Vec_consumers[Map_index[Block.In2]].push_back(i);
+      Vec_inputs[i].push_back(Map_index[Block.In2]);
+      Vec_num_remaining_readers[Map_index[Block.In2]]++;
+      Vec_num_remaining_inputs[i]++;
+    }
+
+    if (Vec_num_remaining_inputs[i]==0) Vec_ready.push_back(i);
+  }
+
+  for (auto Index: Vec_ready) launch(Index);
+
+  // the calling thread runs the filters that cannot be moved to other thread
+  while (true){
+    int Index;
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      Condition.wait(Lock,[this]{return Vec_main_thread_tasks.size()>0 || Num_done==Vec_filters.size();});
+      if (Vec_main_thread_tasks.size()==0) break;
+
+      Index=Vec_main_thread_tasks.front();
+      Vec_main_thread_tasks.erase(Vec_main_thread_tasks.begin());
+    }
+    if (Main_thread_function) Main_thread_function([this,Index]{execute(Index);});
+    else execute(Index);
+  }
+
+  Vec_filters.clear();
+  Vec_names.clear();
+  Task_control=nullptr;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _scheduler::launch(int Index)
+{
+  if (Vec_filters[Index]->main_thread_only()){
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      Vec_main_thread_tasks.push_back(Index);
+    }
+    Condition.notify_all();
+  }
+  else{
+    Pool.push([this,Index]{execute(Index);});
+  }
+}
+
+
+/*****************************************************************************//**
+ * Computes the filter and launches the consumers that have all their inputs.
+ * If the result is in the cache, the filter is not computed. If the task has been
+ * cancelled, or a filter has failed, the filter is not computed and the consumers
+ * are released anyway. The exceptions of the filter are caught, so the node is
+ * always counted as done and run() does not wait forever.
+ * The inputs that have no more readers are released (and the output if nobody
+ * reads it)
+ *****************************************************************************/
+
+void _scheduler::execute(int Index)
+{
+  std::vector<int> Vec_ready;
+  std::vector<int> Vec_released;
+  std::shared_ptr<_filter> Filter=Vec_filters[Index];
+  std::string Key;
+  bool Cached=false;
+  double Start=0;
+  double Start_cpu_time=0;
+  size_t Peak_bytes=0;
+  bool Failed1;
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Failed1=Failed;
+  }
+
+  if ((Task_control==nullptr || Task_control->cancelled()==false) && Failed1==false){
+    std::string Error;
+
+    try{
+      if (Trace!=nullptr){
+        Start=Trace->now();
+        Start_cpu_time=_trace::thread_cpu_time();
+      }
+
+      // the views of the previous contents are not valid. It is done before the computation
+      // so the filter can save the dots that it draws
+      _filter::Conversion_cache.invalidate(Filter->Output_image_0);
+
+      if (Result_cache!=nullptr) Key=Result_cache->key(Filter.get());
+
+      std::shared_ptr<const _point_set> Points;
+      std::map<std::string,std::string> Results;
+
+      if (Key!="" && Result_cache->get(Key,*Filter->Output_image_0,Points,Results)==true){
+        // the dots and the data of the widgets of the computation are restored
+        if (Points!=nullptr) _filter::Conversion_cache.set_points(Filter->Output_image_0,Points);
+        Filter->read_results(Results);
+        Cached=true;
+      }
+      else{
+        {
+          std::lock_guard<std::mutex> Lock(Mutex);
+          Num_updates++;
+        }
+        if (Trace!=nullptr) _allocation_counter::start();
+        Filter->update(Task_control);
+        if (Trace!=nullptr) Peak_bytes=_allocation_counter::peak();
+        // the result of a cancelled filter is not complete
+        if (Key!="" && (Task_control==nullptr || Task_control->cancelled()==false)){
+          Filter->write_results(Results);
+          Result_cache->set(Key,*Filter->Output_image_0,_filter::Conversion_cache.points(Filter->Output_image_0),Results);
+        }
+      }
+
+      if (Trace!=nullptr) add_trace_event(Filter.get(),Start,Start_cpu_time,Peak_bytes,Cached);
+    }
+    catch (std::exception &Exception){
+      Error=Exception.what();
+      if (Error=="") Error="Unknown error";
+    }
+    catch (...){
+      Error="Unknown error";
+    }
+
+    if (Error!=""){
+      {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Failed=true;
+      }
+      Filter->warning("Error in the filter "+Filter->name()+". The rest of filters are not computed",Error);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (auto Consumer: Vec_consumers[Index]){
+      Vec_num_remaining_inputs[Consumer]--;
+      if (Vec_num_remaining_inputs[Consumer]==0) Vec_ready.push_back(Consumer);
+    }
+
+    if (Release_function){
+      for (auto Input: Vec_inputs[Index]){
+        Vec_num_remaining_readers[Input]--;
+        if (Vec_num_remaining_readers[Input]==0) Vec_released.push_back(Input);
+      }
+      if (Vec_consumers[Index].size()==0) Vec_released.push_back(Index);
+    }
+  }
+
+  for (auto Input: Vec_released) Release_function(Vec_names[Input]);
+
+  for (auto Consumer: Vec_ready) launch(Consumer);
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Num_done++;
+  }
+  Condition.notify_all();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _scheduler::add_trace_event(_filter *Filter, double Start, double Start_cpu_time, size_t Peak_bytes, bool Cached)
+{
+  _trace_event Event;
+
+  Event.Name=Filter->name();
+  auto Position=_f_filter_ns::Filter_name_parameters.find(Filter->type_filter());
+  if (Position!=_f_filter_ns::Filter_name_parameters.end()) Event.Type=Position->second.Type;
+
+  Event.Start=Start;
+  Event.Wall_time=Trace->now()-Start;
+  Event.Cpu_time=_trace::thread_cpu_time()-Start_cpu_time;
+  Event.Cached=Cached;
+
+  Event.Input_rows=Filter->Input_image_0->rows;
+  Event.Input_cols=Filter->Input_image_0->cols;
+  Event.Input_channels=Filter->Input_image_0->channels();
+  Event.Output_rows=Filter->Output_image_0->rows;
+  Event.Output_cols=Filter->Output_image_0->cols;
+  Event.Output_channels=Filter->Output_image_0->channels();
+  Event.Output_bytes=Filter->Output_image_0->total()*Filter->Output_image_0->elemSize();
+  Event.Peak_bytes=Peak_bytes;
+
+  Trace->add(Event);
+}
@@ -0,0 +1,101 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "ne_common.h"
+#include "map_list.h"
+#include "filter.h"
+#include "thread_pool.h"
+#include "result_cache.h"
+#include "task_control.h"
+#include "trace.h"
+
+
+/*****************************************************************************//**
+ * Runs the filters of an effect in parallel. A filter is launched when all its
+ * input images (In1 and In2 of its block) have been computed, so the independent
+ * branches of the graph run at the same time and the filters with two inputs wait
+ * for both of them.
+ * The filters that must run in the main thread (OpenGL, dialogs) are executed by
+ * the thread that calls run, or by the main thread function if it is set (when
+ * run is called from other thread).
+ * When the task is cancelled the remaining filters are not computed. When a filter
+ * throws an exception, it is shown as a warning and the remaining filters are not
+ * computed either.
+ * If the release function is set, each image is released after its last reader
+ *****************************************************************************/
+
+class _scheduler
+{
+public:
+  _scheduler(unsigned int Num_threads1=0);
+
+  void run(std::vector<std::string> &Vec_names1, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _task_control *Task_control1=nullptr);
+  unsigned int num_threads(){return Pool.num_threads();};
+  // number of calls to update() in the last run. The results taken from the cache and
+  // the filters that are not computed (cancelled or failed) are not counted
+  unsigned int num_updates(){return Num_updates;};
+  // one filter of the last run has thrown an exception
+  bool failed(){return Failed;};
+  // the results of the filters are saved and reused. nullptr disables the cache
+  void set_result_cache(_result_cache *Result_cache1){Result_cache=Result_cache1;};
+  // the time and memory of each filter are saved. nullptr disables the trace
+  void set_trace(_trace *Trace1){Trace=Trace1;};
+  // executes the function in the main thread and waits until it finishes
+  void set_main_thread_function(std::function<void(std::function<void()>)> Main_thread_function1){Main_thread_function=Main_thread_function1;};
+  // it is called with the name of each computed image when all the filters that read
+  // it have finished, so its memory can be freed. It can be called from any thread
+  void set_release_function(std::function<void(const std::string &)> Release_function1){Release_function=Release_function1;};
+
+protected:
+  void launch(int Index);
+  void execute(int Index);
+  void add_trace_event(_filter *Filter, double Start, double Start_cpu_time, size_t Peak_bytes, bool Cached);
+
+  _thread_pool Pool;
+  _result_cache *Result_cache;
+  _trace *Trace;
+  std::function<void(std::function<void()>)> Main_thread_function;
+  std::function<void(const std::string &)> Release_function;
+
+  // data of the current run
+  _task_control *Task_control;
+  std::vector<std::shared_ptr<_filter>> Vec_filters;
+  std::vector<std::string> Vec_names;
+  std::vector<std::vector<int>> Vec_consumers;
+  std::vector<std::vector<int>> Vec_inputs;
+  std::vector<int> Vec_num_remaining_readers;
+  std::vector<int> Vec_num_remaining_inputs;
+  std::vector<int> Vec_main_thread_tasks;
+  unsigned int Num_done;
+  unsigned int Num_updates;
+  bool Failed;
+
+  std::mutex Mutex;
+  std::condition_variable Condition;
+};
+
+#endif
@@ -0,0 +1,48 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef TASK_CONTROL_H
+#define TASK_CONTROL_H
+
+#include <string>
+#include <atomic>
+#include <functional>
+
+
+/*****************************************************************************//**
+ * Control of one computation of the effect. The filters check cancelled() in
+ * their long loops and stop as soon as possible. The progress is sent to the
+ * function that has been set (it can be called from any thread)
+ *****************************************************************************/
+
+class _task_control
+{
+public:
+  _task_control(){Cancelled=false;};
+
+  void cancel(){Cancelled=true;};
+  bool cancelled(){return Cancelled;};
+
+  void set_progress_function(std::function<void(const std::string &,float)> Progress_function1){Progress_function=Progress_function1;};
+  // Value is between 0 and 1
+  void progress(const std::string &Text,float Value){if (Progress_function) Progress_function(Text,Value);};
+
+protected:
+  std::atomic<bool> Cancelled;
+  std::function<void(const std::string &,float)> Progress_function;
+};
+
+#endif
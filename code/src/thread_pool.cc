@@ -0,0 +1,217 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+// the pool and the index of the worker that is running in this thread. -1 for the other threads
+static thread_local _thread_pool *Worker_pool=nullptr;
+static thread_local int Worker_index=-1;
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_thread_pool::_thread_pool(unsigned int Num_threads1)
+{
+  Num_threads=Num_threads1;
+  if (Num_threads==0) Num_threads=std::thread::hardware_concurrency();
+  if (Num_threads==0) Num_threads=1;
+
+  Num_pending_tasks=0;
+  Next_queue=0;
+  Stop=false;
+
+  Queues.resize(Num_threads);
+  for (unsigned int i=0;i<Num_threads;i++){
+    Queue_mutexes.push_back(std::unique_ptr<std::mutex>(new std::mutex));
+  }
+
+  for (unsigned int i=0;i<Num_threads;i++){
+    Threads.push_back(std::thread(&_thread_pool::worker,this,i));
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_thread_pool::~_thread_pool()
+{
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Stop=true;
+  }
+  Condition.notify_all();
+
+  for (auto &Thread: Threads) Thread.join();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+int _thread_pool::worker_index()
+{
+  return Worker_index;
+}
+
+
+/*****************************************************************************//**
+ * A worker puts the new task in its own queue (it will be the next one that it
+ * runs). Other threads distribute the tasks between all the queues
+ *
+ *****************************************************************************/
+
+void _thread_pool::push(std::function<void()> Task)
+{
+  unsigned int Index;
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (Worker_pool==this) Index=(unsigned int)Worker_index;
+    else{
+      Index=Next_queue;
+      Next_queue=(Next_queue+1)%Num_threads;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(*Queue_mutexes[Index]);
+    Queues[Index].push_back(Task);
+  }
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Num_pending_tasks++;
+  }
+  Condition.notify_one();
+}
+
+
+/*****************************************************************************//**
+ * The indices are taken in chunks by the calling thread and by one task for each
+ * other thread, so the threads that finish first take more chunks
+ *
+ *****************************************************************************/
+
+void _thread_pool::parallel_for(int Count, std::function<void(int)> Function)
+{
+  if (Count<=0) return;
+
+  int Chunk_size=std::max(1,Count/(int)(Num_threads*4));
+  if (Num_threads==1 || Count<=Chunk_size){
+    for (int i=0;i<Count;i++) Function(i);
+    return;
+  }
+
+  std::atomic<int> Next(0);
+  auto Run_chunks=[&](){
+    int First;
+    while ((First=Next.fetch_add(Chunk_size))<Count){
+      int Last=std::min(First+Chunk_size,Count);
+      for (int i=First;i<Last;i++) Function(i);
+    }
+  };
+
+  // the tasks use the variables of this function, so it waits for all of them
+  std::mutex Mutex_done;
+  std::condition_variable Condition_done;
+  unsigned int Num_running=Num_threads-1;
+
+  for (unsigned int i=0;i<Num_threads-1;i++){
+    push([&](){
+      Run_chunks();
+      std::lock_guard<std::mutex> Lock(Mutex_done);
+      if (--Num_running==0) Condition_done.notify_one();
+    });
+  }
+  Run_chunks();
+
+  std::unique_lock<std::mutex> Lock(Mutex_done);
+  Condition_done.wait(Lock,[&]{return Num_running==0;});
+}
+
+
+/*****************************************************************************//**
+ * First the own queue (LIFO), then steal from the others (FIFO)
+ *
+ *
+ *****************************************************************************/
+
+bool _thread_pool::pop(unsigned int Index, std::function<void()> &Task)
+{
+  {
+    std::lock_guard<std::mutex> Lock(*Queue_mutexes[Index]);
+    if (!Queues[Index].empty()){
+      Task=std::move(Queues[Index].back());
+      Queues[Index].pop_back();
+      return true;
+    }
+  }
+
+  for (unsigned int i=1;i<Num_threads;i++){
+    unsigned int Victim=(Index+i)%Num_threads;
+    std::lock_guard<std::mutex> Lock(*Queue_mutexes[Victim]);
+    if (!Queues[Victim].empty()){
+      Task=std::move(Queues[Victim].front());
+      Queues[Victim].pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _thread_pool::worker(unsigned int Index)
+{
+  std::function<void()> Task;
+
+  Worker_pool=this;
+  Worker_index=(int)Index;
+
+  while (true){
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      Condition.wait(Lock,[this]{return Stop || Num_pending_tasks>0;});
+      if (Stop && Num_pending_tasks==0) return;
+      // this task is reserved for this thread
+      Num_pending_tasks--;
+    }
+
+    // there is one task in the queues for each reservation
+    while (pop(Index,Task)==false) std::this_thread::yield();
+
+    Task();
+    Task=nullptr;
+  }
+}
@@ -0,0 +1,68 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+/*****************************************************************************//**
+ * Pool of threads with one queue of tasks for each thread. Each thread takes
+ * the tasks from the back of its own queue. When it is empty, the tasks are
+ * stolen from the front of the queues of the other threads
+ *
+ *****************************************************************************/
+
+class _thread_pool
+{
+public:
+  _thread_pool(unsigned int Num_threads1=0);
+  ~_thread_pool();
+
+  void push(std::function<void()> Task);
+  // calls Function(i) for i in [0,Count) with all the threads and waits until they finish.
+  // It cannot be called from a task of this pool
+  void parallel_for(int Count,std::function<void(int)> Function);
+  unsigned int num_threads(){return Num_threads;};
+
+  static int worker_index();
+
+protected:
+  void worker(unsigned int Index);
+  bool pop(unsigned int Index, std::function<void()> &Task);
+
+  unsigned int Num_threads;
+  std::vector<std::thread> Threads;
+  std::vector<std::deque<std::function<void()>>> Queues;
+  std::vector<std::unique_ptr<std::mutex>> Queue_mutexes;
+
+  // the workers sleep when there are no tasks
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  unsigned int Num_pending_tasks;
+  unsigned int Next_queue;
+  bool Stop;
+};
+
+#endif
@@ -0,0 +1,327 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#include "tiler.h"
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_tiler::_tiler(int Tile_size1)
+{
+  Tile_size=Tile_size1;
+  Source_rows=0;
+  Source_cols=0;
+  Source_row=0;
+  Region_image=nullptr;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+bool _tiler::tileable(std::vector<std::string> &Vec_names, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::string &Name, bool Exact)
+{
+  cv::Mat *Image=input_image(Images);
+
+  for (auto &Name_filter: Vec_names){
+    cv::Mat *Output_image=Images.get_data(Name_filter).get();
+    std::shared_ptr<_filter> Filter=Filters.get_data(Name_filter);
+    if (Filter->halo()<0 || (Exact && Filter->exact_by_tiles()==false) || Output_image->rows!=Image->rows || Output_image->cols!=Image->cols){
+      Name=Name_filter;
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * GRAY or COLOR, the one that exists (the other one is only created when a filter
+ * reads it)
+ *
+ *****************************************************************************/
+
+cv::Mat *_tiler::input_image(_map_list<std::shared_ptr<cv::Mat>> &Images)
+{
+  cv::Mat *Image=Images.get_data("GRAY").get();
+
+  if (Image->empty()) Image=Images.get_data("COLOR").get();
+  return Image;
+}
+
+
+/*****************************************************************************//**
+ * The pixels of Rect of one input of the filter. The tile is copied, so the
+ * filters always receive a continuous image
+ *
+ *****************************************************************************/
+
+cv::Mat _tiler::input_tile(int Input, std::string &Name_input, cv::Rect &Rect, _map_list<std::shared_ptr<cv::Mat>> &Images)
+{
+  if (Input==-1) return (*Images.get_data(Name_input))(Rect-cv::Point(0,Source_row)).clone();
+  else return Vec_tiles[Input](Rect-Vec_needed[Input].tl()).clone();
+}
+
+
+/*****************************************************************************//**
+ * The regions of the tile that each filter must produce, from the end to the
+ * start. Returns the region of the input images (COLOR, GRAY) that is read
+ *
+ *****************************************************************************/
+
+cv::Rect _tiler::needed_regions(cv::Rect &Tile, cv::Rect &Image_rect)
+{
+  cv::Rect Source_rect;
+  int Num_nodes=Vec_nodes.size();
+
+  Vec_needed.assign(Num_nodes,cv::Rect());
+  for (int i=Num_nodes-1;i>=0;i--){
+    _node &Node=Vec_nodes[i];
+
+    if (Node.Kept) Vec_needed[i]|=Tile;
+    if (Vec_needed[i].area()==0) continue;
+
+    int Halo=Node.Filter->halo();
+    cv::Rect Input_rect=cv::Rect(Vec_needed[i].x-Halo,Vec_needed[i].y-Halo,Vec_needed[i].width+2*Halo,Vec_needed[i].height+2*Halo) & Image_rect;
+
+    if (Node.Input0!=-1) Vec_needed[Node.Input0]|=Input_rect;
+    else Source_rect|=Input_rect;
+    if (Node.Input1!=-1) Vec_needed[Node.Input1]|=Input_rect;
+    else if (Node.Name_input1!="") Source_rect|=Input_rect;
+  }
+
+  return Source_rect;
+}
+
+
+/*****************************************************************************//**
+ * The data of each filter. The images of the filters are saved to use them again
+ * at the end
+ *
+ *****************************************************************************/
+
+void _tiler::create_nodes(std::vector<std::string> &Vec_names, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::set<std::string> &Set_kept_images)
+{
+  std::map<std::string,int> Map_index;
+  int Num_nodes=Vec_names.size();
+
+  Vec_nodes.resize(Num_nodes);
+  Vec_input_image0.clear();
+  Vec_input_image1.clear();
+  Vec_output_image0.clear();
+  for (int i=0;i<Num_nodes;i++){
+    _block &Block=Map_data_blocks[Vec_names[i]];
+    _node &Node=Vec_nodes[i];
+
+    Map_index[Vec_names[i]]=i;
+
+    Node.Filter=Filters.get_data(Vec_names[i]);
+    Node.Name=Vec_names[i];
+    Node.Name_input0=Block.In1;
+    Node.Input0=(Map_index.find(Block.In1)!=Map_index.end())?Map_index[Block.In1]:-1;
+    Node.Name_input1=(Node.Filter->Input_image_1!=nullptr)?Block.In2:"";
+    Node.Input1=(Node.Name_input1!="" && Map_index.find(Block.In2)!=Map_index.end())?Map_index[Block.In2]:-1;
+    Node.Kept=(Set_kept_images.find(Vec_names[i])!=Set_kept_images.end());
+    Node.Type=Images.get_data(Vec_names[i])->type();
+
+    Vec_input_image0.push_back(Node.Filter->Input_image_0);
+    Vec_input_image1.push_back(Node.Filter->Input_image_1);
+    Vec_output_image0.push_back(Node.Filter->Output_image_0);
+  }
+}
+
+
+/*****************************************************************************//**
+ * The filters are applied to the regions that the tile needs. The tile of the
+ * kept images is copied to their band (with the sink) or to the complete image
+ *
+ *****************************************************************************/
+
+void _tiler::compute_tile(cv::Rect &Tile, cv::Rect &Image_rect, _map_list<std::shared_ptr<cv::Mat>> &Images, cv::Rect &Band, std::vector<cv::Mat> &Vec_bands)
+{
+  int Num_nodes=Vec_nodes.size();
+
+  needed_regions(Tile,Image_rect);
+
+  Vec_tiles.assign(Num_nodes,cv::Mat());
+  for (int i=0;i<Num_nodes;i++){
+    _node &Node=Vec_nodes[i];
+
+    if (Vec_needed[i].area()==0) continue;
+
+    int Halo=Node.Filter->halo();
+    cv::Rect Input_rect=cv::Rect(Vec_needed[i].x-Halo,Vec_needed[i].y-Halo,Vec_needed[i].width+2*Halo,Vec_needed[i].height+2*Halo) & Image_rect;
+
+    cv::Mat Input_image0=input_tile(Node.Input0,Node.Name_input0,Input_rect,Images);
+    cv::Mat Input_image1;
+    if (Node.Name_input1!="") Input_image1=input_tile(Node.Input1,Node.Name_input1,Input_rect,Images);
+    cv::Mat Output_image0(Input_rect.height,Input_rect.width,Node.Type);
+
+    Node.Filter->set_images(&Input_image0,&Output_image0,(Node.Name_input1!="")?&Input_image1:nullptr);
+    Node.Filter->set_tile(true,Input_rect.tl());
+    Node.Filter->update();
+
+    // the next tile can use the same addresses
+    _filter::Conversion_cache.invalidate(&Input_image0);
+    _filter::Conversion_cache.invalidate(&Input_image1);
+    _filter::Conversion_cache.invalidate(&Output_image0);
+
+    Vec_tiles[i]=Output_image0(Vec_needed[i]-Input_rect.tl());
+    if (Node.Kept){
+      if (Sink_function){
+        cv::Mat Band_tile=Vec_bands[i](Tile-Band.tl());
+        Output_image0(Tile-Input_rect.tl()).copyTo(Band_tile);
+      }
+      else if (Region_image!=nullptr) Output_image0(Tile-Input_rect.tl()).copyTo((*Region_image)(Tile-Region_origin));
+      else Output_image0(Tile-Input_rect.tl()).copyTo((*Images.get_data(Node.Name))(Tile));
+    }
+  }
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _tiler::restore_filters()
+{
+  for (unsigned int i=0;i<Vec_nodes.size();i++){
+    Vec_nodes[i].Filter->set_images(Vec_input_image0[i],Vec_output_image0[i],Vec_input_image1[i]);
+    Vec_nodes[i].Filter->set_tile(false);
+  }
+
+  Vec_nodes.clear();
+  Vec_needed.clear();
+  Vec_tiles.clear();
+  Vec_input_image0.clear();
+  Vec_input_image1.clear();
+  Vec_output_image0.clear();
+}
+
+
+/*****************************************************************************//**
+ * The images that are not kept are released before the computation. The filters
+ * use their own images again at the end
+ *
+ *****************************************************************************/
+
+void _tiler::run(std::vector<std::string> &Vec_names, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::set<std::string> &Set_kept_images)
+{
+  int Num_nodes=Vec_names.size();
+
+  if (Num_nodes==0) return;
+
+  cv::Rect Image_rect(0,0,input_image(Images)->cols,input_image(Images)->rows);
+  if (Source_function) Image_rect=cv::Rect(0,0,Source_cols,Source_rows);
+  Source_row=0;
+
+  // the kept images that are sent to the sink only have the rows of one band
+  std::vector<cv::Mat> Vec_bands(Num_nodes);
+
+  create_nodes(Vec_names,Map_data_blocks,Filters,Images,Set_kept_images);
+  for (int i=0;i<Num_nodes;i++){
+    // the complete image is only needed for the kept images
+    if (Vec_nodes[i].Kept==false || Sink_function) Images.get_data(Vec_names[i])->release();
+    else Images.get_data(Vec_names[i])->create(Image_rect.height,Image_rect.width,Vec_nodes[i].Type);
+  }
+
+  for (int Row=0;Row<Image_rect.height;Row+=Tile_size){
+    cv::Rect Band=cv::Rect(0,Row,Image_rect.width,Tile_size) & Image_rect;
+
+    // the input rows of all the tiles of the band
+    if (Source_function){
+      cv::Rect Source_rect=needed_regions(Band,Image_rect);
+      Source_function(Source_rect.y,Source_rect.y+Source_rect.height);
+      Source_row=Source_rect.y;
+    }
+
+    if (Sink_function){
+      for (int i=0;i<Num_nodes;i++){
+        if (Vec_nodes[i].Kept) Vec_bands[i].create(Band.height,Band.width,Vec_nodes[i].Type);
+      }
+    }
+
+    for (int Col=0;Col<Image_rect.width;Col+=Tile_size){
+      cv::Rect Tile=cv::Rect(Col,Row,Tile_size,Tile_size) & Image_rect;
+
+      compute_tile(Tile,Image_rect,Images,Band,Vec_bands);
+    }
+
+    if (Sink_function){
+      for (int i=0;i<Num_nodes;i++){
+        if (Vec_nodes[i].Kept) Sink_function(Vec_names[i],Vec_bands[i]);
+      }
+    }
+  }
+
+  restore_filters();
+}
+
+
+/*****************************************************************************//**
+ * Only the pixels of Region of the image Name are computed, and the rest of the
+ * pixels are not changed. The images of the filters that are not in Vec_names
+ * must be complete, because they are read as inputs. The images are not released
+ *
+ *****************************************************************************/
+
+void _tiler::run_region(std::vector<std::string> &Vec_names, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::string Name, cv::Rect Region, cv::Mat *Region_image1)
+{
+  std::set<std::string> Set_kept_images={Name};
+  std::vector<cv::Mat> Vec_bands;
+  cv::Rect Band;
+
+  if (Vec_names.size()==0 || Sink_function) return;
+
+  cv::Rect Image_rect(0,0,input_image(Images)->cols,input_image(Images)->rows);
+  Region&=Image_rect;
+  Source_row=0;
+
+  create_nodes(Vec_names,Map_data_blocks,Filters,Images,Set_kept_images);
+
+  Region_image=Region_image1;
+  Region_origin=Region.tl();
+  if (Region_image!=nullptr) Region_image->create(Region.height,Region.width,Images.get_data(Name)->type());
+
+  try{
+    for (int Row=Region.y;Row<Region.y+Region.height;Row+=Tile_size){
+      for (int Col=Region.x;Col<Region.x+Region.width;Col+=Tile_size){
+        cv::Rect Tile=cv::Rect(Col,Row,Tile_size,Tile_size) & Region;
+
+        compute_tile(Tile,Image_rect,Images,Band,Vec_bands);
+      }
+    }
+  }
+  catch (...){
+    // the filters must use their images again
+    Region_image=nullptr;
+    restore_filters();
+    throw;
+  }
+
+  Region_image=nullptr;
+  restore_filters();
+}
@@ -0,0 +1,117 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#ifndef TILER_H
+#define TILER_H
+
+#include <opencv.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <functional>
+
+#include "ne_common.h"
+#include "map_list.h"
+#include "filter.h"
+
+namespace _f_tiler_ns
+{
+  const int TILE_SIZE_DEFAULT=1024;
+}
+
+
+/*****************************************************************************//**
+ * Computes an effect by tiles, so the intermediate images are never complete.
+ * For each tile of the result, the region that each filter needs is computed
+ * going back through the graph: the region of the consumers plus their halo.
+ * Then the filters are applied to those regions in order. Only the kept images
+ * (the final image, the saved ones) have all their pixels.
+ * It can only be used when all the filters have a halo (see _filter::halo) and
+ * all the images have the size of the input image.
+ * With the source and sink functions the images are streamed: COLOR and GRAY only
+ * have the rows needed by each band of tiles, and the rows of the kept images are
+ * sent to the sink when the band is finished
+ *****************************************************************************/
+
+class _tiler
+{
+public:
+  _tiler(int Tile_size1=_f_tiler_ns::TILE_SIZE_DEFAULT);
+
+  // returns false and the name of the first filter that cannot be computed by tiles.
+  // With Exact, the filters that give a different result by tiles are not accepted
+  bool tileable(std::vector<std::string> &Vec_names, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::string &Name, bool Exact=false);
+  void run(std::vector<std::string> &Vec_names, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::set<std::string> &Set_kept_images);
+  // computes only Region of the image Name, that is the output of the last filter
+  // of Vec_names. The other filters of Vec_names compute the part that it needs.
+  // With Region_image1, the pixels are saved in it (with the size of Region) and the
+  // image Name does not change
+  void run_region(std::vector<std::string> &Vec_names, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::string Name, cv::Rect Region, cv::Mat *Region_image1=nullptr);
+
+  void tile_size(int Tile_size1){Tile_size=Tile_size1;};
+  int tile_size(){return Tile_size;};
+  // the input image has Rows1 x Cols1 pixels. The function must put the rows from
+  // Row_start to Row_end (not included) in COLOR and GRAY
+  void set_source_function(int Rows1, int Cols1, std::function<void(int Row_start,int Row_end)> Source_function1){Source_rows=Rows1;Source_cols=Cols1;Source_function=Source_function1;};
+  // it receives the next rows of each kept image, from the top
+  void set_sink_function(std::function<void(const std::string &,cv::Mat &)> Sink_function1){Sink_function=Sink_function1;};
+
+protected:
+  typedef struct {
+    std::shared_ptr<_filter> Filter;
+    std::string Name;
+    // index of the filter that produces the input, or -1 for COLOR and GRAY
+    int Input0;
+    int Input1;
+    std::string Name_input0;
+    std::string Name_input1;
+    bool Kept;
+    int Type;
+  } _node;
+
+  void create_nodes(std::vector<std::string> &Vec_names, std::map<std::string,_block> &Map_data_blocks, _map_list<std::shared_ptr<_filter>> &Filters, _map_list<std::shared_ptr<cv::Mat>> &Images, std::set<std::string> &Set_kept_images);
+  void compute_tile(cv::Rect &Tile, cv::Rect &Image_rect, _map_list<std::shared_ptr<cv::Mat>> &Images, cv::Rect &Band, std::vector<cv::Mat> &Vec_bands);
+  void restore_filters();
+  cv::Mat input_tile(int Input, std::string &Name_input, cv::Rect &Rect, _map_list<std::shared_ptr<cv::Mat>> &Images);
+  cv::Rect needed_regions(cv::Rect &Tile, cv::Rect &Image_rect);
+  cv::Mat *input_image(_map_list<std::shared_ptr<cv::Mat>> &Images);
+
+  int Tile_size;
+  int Source_rows;
+  int Source_cols;
+  std::function<void(int,int)> Source_function;
+  std::function<void(const std::string &,cv::Mat &)> Sink_function;
+
+  // data of the current run
+  std::vector<_node> Vec_nodes;
+  std::vector<cv::Rect> Vec_needed;
+  std::vector<cv::Mat> Vec_tiles;
+  // the images of the filters before the run
+  std::vector<cv::Mat *> Vec_input_image0;
+  std::vector<cv::Mat *> Vec_input_image1;
+  std::vector<cv::Mat *> Vec_output_image0;
+  // first row of COLOR and GRAY
+  int Source_row;
+  // the result of run_region when it is not saved in the image
+  cv::Mat *Region_image;
+  cv::Point Region_origin;
+};
+
+#endif
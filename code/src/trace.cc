@@ -0,0 +1,195 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include "trace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef WINDOWS
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_trace::_trace()
+{
+  Origin=std::chrono::steady_clock::now();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _trace::clear()
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  Vec_events.clear();
+  Map_threads.clear();
+  Origin=std::chrono::steady_clock::now();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+double _trace::now()
+{
+  return std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-Origin).count();
+}
+
+
+/*****************************************************************************//**
+ * CPU time of the calling thread in microseconds
+ *
+ *
+ *****************************************************************************/
+
+double _trace::thread_cpu_time()
+{
+  #ifdef WINDOWS
+  FILETIME Creation_time,Exit_time,Kernel_time,User_time;
+  GetThreadTimes(GetCurrentThread(),&Creation_time,&Exit_time,&Kernel_time,&User_time);
+  // units of 100 nanoseconds
+  unsigned long long Kernel=((unsigned long long)Kernel_time.dwHighDateTime<<32) | Kernel_time.dwLowDateTime;
+  unsigned long long User=((unsigned long long)User_time.dwHighDateTime<<32) | User_time.dwLowDateTime;
+  return double(Kernel+User)/10.0;
+  #else
+  timespec Time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID,&Time);
+  return double(Time.tv_sec)*1e6+double(Time.tv_nsec)/1e3;
+  #endif
+}
+
+
+/*****************************************************************************//**
+ * It must be called from the thread that has computed the filter
+ *
+ *
+ *****************************************************************************/
+
+void _trace::add(_trace_event &Event)
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  auto Position=Map_threads.find(std::this_thread::get_id());
+  if (Position==Map_threads.end()){
+    int Index=Map_threads.size();
+    Map_threads[std::this_thread::get_id()]=Index;
+    Event.Thread=Index;
+  }
+  else Event.Thread=Position->second;
+
+  Vec_events.push_back(Event);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+std::vector<_trace_event> _trace::events()
+{
+  std::lock_guard<std::mutex> Lock(Mutex);
+
+  return Vec_events;
+}
+
+
+/*****************************************************************************//**
+ * The names of the filters are written by the user, so they can have quotes,
+ * backslashes or control characters. The rest of bytes are copied (UTF-8)
+ *
+ *****************************************************************************/
+
+std::string _trace::json_string(const std::string &Text)
+{
+  std::string Result="\"";
+
+  for (unsigned char Character: Text){
+    switch (Character){
+    case '"': Result+="\\\"";break;
+    case '\\': Result+="\\\\";break;
+    case '\b': Result+="\\b";break;
+    case '\f': Result+="\\f";break;
+    case '\n': Result+="\\n";break;
+    case '\r': Result+="\\r";break;
+    case '\t': Result+="\\t";break;
+    default:
+      if (Character<0x20){
+        char Code[8];
+        snprintf(Code,sizeof(Code),"\\u%04x",Character);
+        Result+=Code;
+      }
+      else Result+=(char)Character;
+    }
+  }
+  Result+="\"";
+  return Result;
+}
+
+
+/*****************************************************************************//**
+ * Trace Event Format: a complete event ("ph":"X") for each filter. Each thread
+ * is a row of the viewer
+ *
+ *****************************************************************************/
+
+bool _trace::write_chrome_trace(const std::string &File_name)
+{
+  std::vector<_trace_event> Vec_events1=events();
+  std::ofstream File(File_name);
+
+  if (!File.good()) return false;
+
+  File << "{\"traceEvents\":[\n";
+  for (unsigned int i=0;i<Vec_events1.size();i++){
+    _trace_event &Event=Vec_events1[i];
+    std::ostringstream Text;
+
+    Text << "{\"name\":" << json_string(Event.Name) << ",\"cat\":" << json_string(Event.Type) << ",\"ph\":\"X\"";
+    Text << ",\"ts\":" << std::fixed << Event.Start << ",\"dur\":" << Event.Wall_time;
+    Text << ",\"pid\":1,\"tid\":" << Event.Thread;
+    Text << ",\"args\":{\"cpu_time_us\":" << Event.Cpu_time;
+    Text << ",\"output_bytes\":" << Event.Output_bytes;
+    Text << ",\"peak_bytes\":" << Event.Peak_bytes;
+    Text << ",\"input\":\"" << Event.Input_cols << "x" << Event.Input_rows << "x" << Event.Input_channels << "\"";
+    Text << ",\"output\":\"" << Event.Output_cols << "x" << Event.Output_rows << "x" << Event.Output_channels << "\"";
+    Text << ",\"cached\":" << (Event.Cached?"true":"false") << "}}";
+    if (i<Vec_events1.size()-1) Text << ",";
+    File << Text.str() << "\n";
+  }
+  File << "],\"displayTimeUnit\":\"ms\"}\n";
+
+  return File.good();
+}
@@ -0,0 +1,86 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+
+/*****************************************************************************//**
+ * Data of one computation of a filter. The times are in microseconds. Start is
+ * relative to the beginning of the trace
+ *
+ *****************************************************************************/
+
+class _trace_event
+{
+public:
+  std::string Name;
+  std::string Type;
+  int Thread=0;
+  double Start=0;
+  double Wall_time=0;
+  double Cpu_time=0;
+  // bytes of the output image
+  size_t Output_bytes=0;
+  // maximum of bytes allocated by the thread during the computation
+  size_t Peak_bytes=0;
+  int Input_rows=0,Input_cols=0,Input_channels=0;
+  int Output_rows=0,Output_cols=0,Output_channels=0;
+  // the result was taken from the cache
+  bool Cached=false;
+};
+
+
+/*****************************************************************************//**
+ * Saves the time and the memory used by each filter of a computation of the
+ * effect. It can be saved as a trace of events in JSON format that can be loaded
+ * in chrome://tracing or Perfetto
+ *****************************************************************************/
+
+class _trace
+{
+public:
+  _trace();
+
+  void clear();
+  // time since the beginning of the trace
+  double now();
+  static double thread_cpu_time();
+
+  void add(_trace_event &Event);
+  std::vector<_trace_event> events();
+  bool write_chrome_trace(const std::string &File_name);
+
+protected:
+  // the text between quotes in JSON, with the escape sequences
+  static std::string json_string(const std::string &Text);
+
+  std::chrono::steady_clock::time_point Origin;
+  std::vector<_trace_event> Vec_events;
+  // the threads are numbered in order of appearance
+  std::map<std::thread::id,int> Map_threads;
+
+  std::mutex Mutex;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#include "trace_tab.h"
+#include "glwidget.h"
+
+using namespace _f_trace_tab_ns;
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_trace_tab::_trace_tab(_gl_widget *GL_widget1, QWidget *Parent)
+: QWidget(Parent)
+{
+  GL_widget=GL_widget1;
+
+  Table=new QTableWidget(0,NUM_COLUMNS);
+  Table->setHorizontalHeaderLabels(HEADER_LABELS);
+  Table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  Table->setSortingEnabled(true);
+  Table->verticalHeader()->setVisible(false);
+  Table->setToolTip(tr("Time and memory of each filter in the last computation"));
+
+  Button_save=new QPushButton(tr("Save trace.json"));
+  Button_save->setToolTip(tr("Saves the trace in the format of chrome://tracing and Perfetto"));
+
+  connect(Button_save,SIGNAL(clicked()),this,SLOT(save_trace_slot()));
+
+  QVBoxLayout *Vertical_layout=new QVBoxLayout;
+
+  Vertical_layout->addWidget(Table);
+  Vertical_layout->addWidget(Button_save);
+
+  setLayout(Vertical_layout);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _trace_tab::set_events(std::vector<_trace_event> Vec_events)
+{
+  QTableWidgetItem *Item;
+
+  // the sorting must be disabled while the items are inserted
+  Table->setSortingEnabled(false);
+  Table->setRowCount(Vec_events.size());
+
+  for (unsigned int i=0;i<Vec_events.size();i++){
+    _trace_event &Event=Vec_events[i];
+
+    Table->setItem(i,0,new QTableWidgetItem(QString::fromStdString(Event.Name)));
+    Table->setItem(i,1,new QTableWidgetItem(QString::fromStdString(Event.Type)));
+
+    // numbers
+    Item=new QTableWidgetItem;
+    Item->setData(Qt::DisplayRole,Event.Wall_time/1000.0);
+    Table->setItem(i,2,Item);
+
+    Item=new QTableWidgetItem;
+    Item->setData(Qt::DisplayRole,Event.Cpu_time/1000.0);
+    Table->setItem(i,3,Item);
+
+    Item=new QTableWidgetItem;
+    Item->setData(Qt::DisplayRole,qulonglong(Event.Output_bytes/1024));
+    Table->setItem(i,4,Item);
+
+    Item=new QTableWidgetItem;
+    Item->setData(Qt::DisplayRole,qulonglong(Event.Peak_bytes/1024));
+    Table->setItem(i,5,Item);
+
+    Table->setItem(i,6,new QTableWidgetItem(QString("%1x%2x%3").arg(Event.Input_cols).arg(Event.Input_rows).arg(Event.Input_channels)));
+    Table->setItem(i,7,new QTableWidgetItem(QString("%1x%2x%3").arg(Event.Output_cols).arg(Event.Output_rows).arg(Event.Output_channels)));
+    Table->setItem(i,8,new QTableWidgetItem(Event.Cached?tr("yes"):tr("no")));
+  }
+
+  Table->setSortingEnabled(true);
+  Table->resizeColumnsToContents();
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _trace_tab::save_trace_slot()
+{
+  QString File_name=QFileDialog::getSaveFileName(this,tr("Save trace"),"./trace.json",tr("Trace (*.json)"));
+
+  if (!File_name.isEmpty()){
+    if (GL_widget->save_trace(File_name.toStdString())==false){
+      QMessageBox::warning(this,tr("Warning"),tr("The trace cannot be saved in %1").arg(File_name));
+    }
+  }
+}
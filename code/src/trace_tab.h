@@ -0,0 +1,65 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+#ifndef TRACE_TAB_H
+#define TRACE_TAB_H
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+class _gl_widget;
+
+namespace _f_trace_tab_ns
+{
+  const int NUM_COLUMNS=9;
+  const QStringList HEADER_LABELS={"Filter","Type","Wall (ms)","CPU (ms)","Output (KB)","Peak (KB)","Input","Output","Cached"};
+}
+
+
+/*****************************************************************************//**
+ * class for the tab that shows the time and memory used by each filter in the
+ * last computation of the effect
+ *
+ *****************************************************************************/
+
+class _trace_tab: public QWidget
+{
+  Q_OBJECT
+
+public:
+        _trace_tab(_gl_widget *GL_widget, QWidget *Parent = 0);
+  void  set_events(std::vector<_trace_event> Vec_events);
+  void  clear(){Table->setRowCount(0);};
+
+protected slots:
+  void save_trace_slot();
+
+private:
+  QTableWidget *Table;
+  QPushButton *Button_save;
+  _gl_widget *GL_widget;
+};
+
+#endif
@@ -0,0 +1,428 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#include "vector_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+
+/*****************************************************************************//**
+ * By the extension. SVGZ is only written when zlib is included
+ *
+ *
+ *****************************************************************************/
+
+_f_vector_writer_ns::_format _f_vector_writer_ns::format(std::string Name)
+{
+  size_t Position=Name.find_last_of('.');
+  if (Position==std::string::npos) return FORMAT_OTHER;
+
+  std::string Extension=Name.substr(Position+1);
+  std::transform(Extension.begin(),Extension.end(),Extension.begin(),[](unsigned char Char){return (char)tolower(Char);});
+
+  if (Extension=="svg") return FORMAT_SVG;
+  #ifdef DEFINE_IO_ZLIB
+  if (Extension=="svgz") return FORMAT_SVGZ;
+  #endif
+  if (Extension=="pdf") return FORMAT_PDF;
+  if (Extension=="eps") return FORMAT_EPS;
+  return FORMAT_OTHER;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+_vector_writer::~_vector_writer()
+{
+  if (File!=nullptr) close();
+}
+
+
+/*****************************************************************************//**
+ * Writes the header and the background. The objects of PDF that do not depend on
+ * the dots are written now, and the stream of the dots is started
+ *
+ *****************************************************************************/
+
+bool _vector_writer::open(std::string Name1, int Width1, int Height1)
+{
+  Name=Name1;
+  Format=_f_vector_writer_ns::format(Name);
+  if (Format==_f_vector_writer_ns::FORMAT_OTHER){
+    std::cout << "Error: the dots can only be saved as SVG, SVGZ, PDF or EPS: " << Name << std::endl;
+    return false;
+  }
+
+  File=fopen(Name.c_str(),"wb");
+  if (File==nullptr){
+    std::cout << "Error: the file cannot be created: " << Name << std::endl;
+    return false;
+  }
+
+  Width=Width1;
+  Height=Height1;
+  Buffer.clear();
+  Buffer.reserve(_f_vector_writer_ns::BUFFER_SIZE+256);
+  Written=0;
+  Num_dots=0;
+  Error=false;
+  Dots_in_path=0;
+  Line_width=-1;
+  Object_positions.clear();
+
+  switch (Format){
+  case _f_vector_writer_ns::FORMAT_SVGZ:
+    if (begin_compression(true)==false){
+      Error=true;
+      break;
+    }
+    // falls through
+  case _f_vector_writer_ns::FORMAT_SVG:
+    text("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    text("<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" width=\"");
+    number(Width);
+    text("\" height=\"");
+    number(Height);
+    text("\" viewBox=\"0 0 ");
+    number(Width);
+    text(" ");
+    number(Height);
+    text("\">\n<rect width=\"100%\" height=\"100%\" fill=\"#fff\"/>\n");
+    break;
+  case _f_vector_writer_ns::FORMAT_PDF:
+    // the binary characters of the comment mark the file as binary
+    text("%PDF-1.4\n%\xe2\xe3\xcf\xd3\n");
+    Object_positions.push_back(position());
+    text("1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+    Object_positions.push_back(position());
+    text("2 0 obj\n<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n");
+    Object_positions.push_back(position());
+    text("3 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 ");
+    number(Width);
+    text(" ");
+    number(Height);
+    text("] /Contents 4 0 R >>\nendobj\n");
+    // the length of the stream is not known, so it is an object that is written at the end
+    Object_positions.push_back(position());
+    #ifdef DEFINE_IO_ZLIB
+    text("4 0 obj\n<< /Length 5 0 R /Filter /FlateDecode >>\nstream\n");
+    flush();
+    Stream_start=Written;
+    if (begin_compression(false)==false){
+      Error=true;
+      break;
+    }
+    #else
+    text("4 0 obj\n<< /Length 5 0 R >>\nstream\n");
+    flush();
+    Stream_start=Written;
+    #endif
+    // white background, black dots with round ends
+    text("1 g 0 0 ");
+    number(Width);
+    text(" ");
+    number(Height);
+    text(" re f\n0 G 1 J\n");
+    break;
+  case _f_vector_writer_ns::FORMAT_EPS:
+    text("%!PS-Adobe-3.0 EPSF-3.0\n%%BoundingBox: 0 0 ");
+    number(Width);
+    text(" ");
+    number(Height);
+    text("\n%%Creator: StippleShop\n%%EndComments\n");
+    // x y radius d
+    text("/d {0 360 arc fill} bind def\n");
+    text("1 setgray 0 0 ");
+    number(Width);
+    text(" ");
+    number(Height);
+    text(" rectfill 0 setgray\n");
+    break;
+  default:break;
+  }
+
+  if (Error){
+    close();
+    return false;
+  }
+  return true;
+}
+
+
+/*****************************************************************************//**
+ * PDF and EPS have the origin in the bottom left corner
+ *
+ *
+ *****************************************************************************/
+
+void _vector_writer::dot(float x, float y, float Radius)
+{
+  switch (Format){
+  case _f_vector_writer_ns::FORMAT_SVG:
+  case _f_vector_writer_ns::FORMAT_SVGZ:
+    if (Dots_in_path==0) text("<path d=\"");
+    text("M");
+    number(x-Radius);
+    text(" ");
+    number(y);
+    text("a");
+    number(Radius);
+    text(" ");
+    number(Radius);
+    text(" 0 1 0 ");
+    number(2*Radius);
+    text(" 0a");
+    number(Radius);
+    text(" ");
+    number(Radius);
+    text(" 0 1 0 ");
+    number(-2*Radius);
+    text(" 0z");
+    Dots_in_path++;
+    if (Dots_in_path==_f_vector_writer_ns::SVG_DOTS_PER_PATH){
+      text("\"/>\n");
+      Dots_in_path=0;
+    }
+    break;
+  case _f_vector_writer_ns::FORMAT_PDF:
+    // the width of the line is only written when it changes
+    if (2*Radius!=Line_width){
+      Line_width=2*Radius;
+      number(Line_width);
+      text(" w\n");
+    }
+    number(x);
+    text(" ");
+    number(Height-y);
+    text(" m ");
+    number(x);
+    text(" ");
+    number(Height-y);
+    text(" l S\n");
+    break;
+  case _f_vector_writer_ns::FORMAT_EPS:
+    number(x);
+    text(" ");
+    number(Height-y);
+    text(" ");
+    number(Radius);
+    text(" d\n");
+    break;
+  default:break;
+  }
+
+  Num_dots++;
+  if (Buffer.size()>=_f_vector_writer_ns::BUFFER_SIZE) flush();
+}
+
+
+/*****************************************************************************//**
+ * PDF needs the length of the stream and the position of each object
+ *
+ *
+ *****************************************************************************/
+
+bool _vector_writer::close()
+{
+  if (File==nullptr) return false;
+
+  switch (Format){
+  case _f_vector_writer_ns::FORMAT_SVG:
+  case _f_vector_writer_ns::FORMAT_SVGZ:
+    if (Dots_in_path>0) text("\"/>\n");
+    text("</svg>\n");
+    end_compression();
+    break;
+  case _f_vector_writer_ns::FORMAT_PDF:
+    {
+      char Aux[100];
+
+      end_compression();
+      flush();
+      size_t Length=Written-Stream_start;
+      text("\nendstream\nendobj\n");
+      Object_positions.push_back(position());
+      snprintf(Aux,100,"5 0 obj\n%lu\nendobj\n",(unsigned long)Length);
+      text(Aux);
+
+      size_t Xref_position=position();
+      snprintf(Aux,100,"xref\n0 %d\n0000000000 65535 f \n",(int)Object_positions.size()+1);
+      text(Aux);
+      for (auto Position: Object_positions){
+        snprintf(Aux,100,"%010lu 00000 n \n",(unsigned long)Position);
+        text(Aux);
+      }
+      snprintf(Aux,100,"trailer\n<< /Size %d /Root 1 0 R >>\nstartxref\n%lu\n%%%%EOF\n",(int)Object_positions.size()+1,(unsigned long)Xref_position);
+      text(Aux);
+    }
+    break;
+  case _f_vector_writer_ns::FORMAT_EPS:
+    text("showpage\n%%EOF\n");
+    break;
+  default:break;
+  }
+
+  flush();
+  if (fclose(File)!=0) Error=true;
+  File=nullptr;
+
+  if (Error) std::cout << "Error writing the file: " << Name << std::endl;
+  return !Error;
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _vector_writer::text(const char *Text)
+{
+  Buffer.append(Text);
+}
+
+
+/*****************************************************************************//**
+ * Rounded to 2 decimals, without the zeros at the right. It is faster than printf
+ *
+ *
+ *****************************************************************************/
+
+void _vector_writer::number(float Value)
+{
+  char Aux[32];
+  int Position=sizeof(Aux);
+  long long Hundredths=std::llround((double)Value*100.0);
+  bool Negative=(Hundredths<0);
+
+  if (Negative) Hundredths=-Hundredths;
+
+  int Decimals=(int)(Hundredths%100);
+  long long Integer=Hundredths/100;
+
+  if (Decimals!=0){
+    if (Decimals%10!=0) Aux[--Position]=(char)('0'+Decimals%10);
+    Aux[--Position]=(char)('0'+Decimals/10);
+    Aux[--Position]='.';
+  }
+  do{
+    Aux[--Position]=(char)('0'+Integer%10);
+    Integer/=10;
+  } while (Integer!=0);
+  if (Negative) Aux[--Position]='-';
+
+  Buffer.append(Aux+Position,sizeof(Aux)-Position);
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _vector_writer::write_file(const char *Data, size_t Size)
+{
+  if (Error || Size==0) return;
+
+  if (fwrite(Data,1,Size,File)!=Size) Error=true;
+  Written+=Size;
+}
+
+
+/*****************************************************************************//**
+ * The text of the buffer is written to the file, compressed if it is needed.
+ * Finish ends the compressed stream
+ *
+ *****************************************************************************/
+
+void _vector_writer::flush(bool Finish)
+{
+  #ifdef DEFINE_IO_ZLIB
+  if (Compressing){
+    Stream.next_in=(Bytef *)Buffer.data();
+    Stream.avail_in=(uInt)Buffer.size();
+    do{
+      Stream.next_out=Compressed.data();
+      Stream.avail_out=(uInt)Compressed.size();
+      deflate(&Stream,Finish?Z_FINISH:Z_NO_FLUSH);
+      write_file((const char *)Compressed.data(),Compressed.size()-Stream.avail_out);
+    } while (Stream.avail_out==0);
+    Buffer.clear();
+    return;
+  }
+  #else
+  (void)Finish;
+  #endif
+
+  write_file(Buffer.data(),Buffer.size());
+  Buffer.clear();
+}
+
+
+/*****************************************************************************//**
+ * The text that is written after this is compressed with deflate. Gzip adds the
+ * header of the gzip files (for SVGZ). Without it, it is a zlib stream (for PDF)
+ *
+ *****************************************************************************/
+
+bool _vector_writer::begin_compression(bool Gzip)
+{
+  #ifdef DEFINE_IO_ZLIB
+  flush();
+
+  memset(&Stream,0,sizeof(Stream));
+  // the fastest level. With millions of dots the higher levels take more time than writing
+  if (deflateInit2(&Stream,Z_BEST_SPEED,Z_DEFLATED,Gzip?15+16:15,8,Z_DEFAULT_STRATEGY)!=Z_OK){
+    std::cout << "Error: the compression cannot be started: " << Name << std::endl;
+    return false;
+  }
+
+  Compressed.resize(_f_vector_writer_ns::BUFFER_SIZE);
+  Compressing=true;
+  return true;
+  #else
+  (void)Gzip;
+  return false;
+  #endif
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _vector_writer::end_compression()
+{
+  #ifdef DEFINE_IO_ZLIB
+  if (Compressing==false) return;
+
+  flush(true);
+  deflateEnd(&Stream);
+  Compressing=false;
+  #endif
+}
@@ -0,0 +1,100 @@
+/*! \file
+ * Copyright Domingo Martín Perandres
+ * email: dmartin@ugr.es
+ * web: http://calipso.ugr.es/dmartin
+ * 2019
+ * GPL
+ *
+ * In case that you use all or part of this code, please include a reference to this article:
+
+ * Domingo Martín, Germán Arroyo, Alejandro Rodríguez and Tobias Isenberg.
+ * A survey of digital stippling.
+ * Computer & Graphics 67, PP. 24-44, 2017.
+ * DOI information: https://doi.org/10.1016/j.cag.2017.05.001
+ */
+
+
+
+#ifndef VECTOR_WRITER_H
+#define VECTOR_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef DEFINE_IO_ZLIB
+#include <zlib.h>
+#endif
+
+
+namespace _f_vector_writer_ns
+{
+  // SVGZ is SVG with gzip. It needs zlib, that is also used to compress the dots of PDF
+  typedef enum {FORMAT_OTHER,FORMAT_SVG,FORMAT_SVGZ,FORMAT_PDF,FORMAT_EPS} _format;
+
+  _format format(std::string Name);
+
+  // the text is written to the file in blocks of this size
+  const size_t BUFFER_SIZE=1<<16;
+  // the dots are divided in paths of SVG of this size, because some viewers are
+  // very slow with long paths
+  const int SVG_DOTS_PER_PATH=10000;
+}
+
+
+/*****************************************************************************//**
+ * Writes the dots of a stippling as vectors, one by one, so the memory does not
+ * depend on the number of dots. Each format uses the shortest command for a dot:
+ * two arcs in SVG, a procedure in EPS, and a line of length 0 with round ends in
+ * PDF. The numbers have 2 decimals at most
+ *****************************************************************************/
+
+class _vector_writer
+{
+public:
+  ~_vector_writer();
+
+  // the size is in pixels (points in PDF and EPS). The background is white.
+  // They return false if there is an error (the message is shown)
+  bool open(std::string Name,int Width1,int Height1);
+  // a black circle. The position is in pixels from the top left corner
+  void dot(float x,float y,float Radius);
+  bool close();
+
+  size_t num_dots(){return Num_dots;};
+
+protected:
+  void text(const char *Text);
+  void number(float Value);
+  // the offset in the file of the next character. Not valid while compressing
+  size_t position(){return Written+Buffer.size();};
+  void flush(bool Finish=false);
+  void write_file(const char *Data,size_t Size);
+  bool begin_compression(bool Gzip);
+  void end_compression();
+
+  std::string Name;
+  _f_vector_writer_ns::_format Format=_f_vector_writer_ns::FORMAT_OTHER;
+  FILE *File=nullptr;
+  int Width=0;
+  int Height=0;
+  std::string Buffer;
+  size_t Written=0;
+  size_t Num_dots=0;
+  bool Error=false;
+
+  // SVG
+  int Dots_in_path=0;
+  // PDF
+  float Line_width=-1;
+  size_t Stream_start=0;
+  std::vector<size_t> Object_positions;
+
+  #ifdef DEFINE_IO_ZLIB
+  z_stream Stream;
+  bool Compressing=false;
+  std::vector<unsigned char> Compressed;
+  #endif
+};
+
+#endif
@@ -62,6 +62,7 @@ _window::_window()
   // and the widgets to the tab
   Tab_widget->addTab(GL_widget->Images_tab, tr("Images"));
   Tab_widget->addTab(GL_widget->Filters_tab, tr("Filters"));
+  Tab_widget->addTab(GL_widget->Trace_tab, tr("Trace"));
 
   QFontMetrics Font_metric(Tab_widget->font());
   int Width_text = Font_metric.horizontalAdvance("M");
@@ -183,6 +184,24 @@ _window::_window()
   connect(Save_effect_file, SIGNAL(triggered()), this, SLOT(save_effect_file_slot()));
   Save_effect_file->setEnabled(false);
 
+  // actions for the resolution of the preview. The result is saved at full resolution
+  QActionGroup *Preview_resolution=new QActionGroup(this);
+  Preview_resolution->setExclusive(true);
+  const char *Vec_preview_names[4]={"Full","1/2","1/4","1/8"};
+  for (int i=0;i<4;i++){
+    QAction *Action=new QAction(tr(Vec_preview_names[i]),Preview_resolution);
+    Action->setCheckable(true);
+    Action->setData(1<<i);
+    if (i==0) Action->setChecked(true);
+  }
+  connect(Preview_resolution, SIGNAL(triggered(QAction *)), this, SLOT(preview_resolution_slot(QAction *)));
+
+  Full_resolution = new QAction(tr("&Compute at full resolution"), this);
+  Full_resolution->setShortcut(tr("Ctrl+R"));
+  Full_resolution->setToolTip(tr("Compute the effect with the complete image. It returns to the preview when a parameter changes"));
+  connect(Full_resolution, SIGNAL(triggered()), this, SLOT(full_resolution_slot()));
+  Full_resolution->setEnabled(false);
+
   QAction *Exit = new QAction(QIcon(":/icons/exit.png"), tr("&Exit..."), this);
   Exit->setShortcut(tr("Ctrl+Q"));
   Exit->setToolTip(tr("Exit the application"));
@@ -197,6 +216,10 @@ _window::_window()
   File_menu->addAction(Open_effect_file);
   File_menu->addAction(Save_effect_file);
   File_menu->addSeparator();
+  QMenu *Preview_menu=File_menu->addMenu(tr("&Preview resolution"));
+  Preview_menu->addActions(Preview_resolution->actions());
+  File_menu->addAction(Full_resolution);
+  File_menu->addSeparator();
   File_menu->addAction(Exit);
   File_menu->setAttribute(Qt::WA_AlwaysShowToolTips);
 
@@ -230,6 +253,7 @@ void _window::open_file_slot()
     // the name is saved
     File_name=File_name1.toStdString();
     Save_file->setEnabled(true);
+    Full_resolution->setEnabled(true);
   }
 }
 
@@ -262,6 +286,30 @@ bool _window::save_file_slot()
 }
 
 
+/*****************************************************************************//**
+ * The image is read again reduced and the effect is computed with it
+ *
+ *
+ *****************************************************************************/
+
+void _window::preview_resolution_slot(QAction *Action)
+{
+  GL_widget->preview_reduction(Action->data().toInt());
+}
+
+
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _window::full_resolution_slot()
+{
+  GL_widget->compute_full_resolution();
+}
+
+
 /*****************************************************************************//**
  *
  *
@@ -390,6 +438,18 @@ void _window::set_frame_warning(bool Estate)
 }
 
 
+/*****************************************************************************//**
+ *
+ *
+ *
+ *****************************************************************************/
+
+void _window::show_message(std::string Text)
+{
+  statusBar()->showMessage(QString::fromStdString(Text));
+}
+
+
 /*****************************************************************************//**
  *
  *
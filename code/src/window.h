@@ -27,6 +27,7 @@
 #include <QAction>
 #include <QMenu>
 #include <QMenuBar>
+#include <QActionGroup>
 #include <QFileDialog>
 #include <QTimer>
 #include <QHBoxLayout>
@@ -36,6 +37,7 @@
 #include <QScrollBar>
 #include <QRect>
 #include <QScreen>
+#include <QStatusBar>
 
 #include <string>
 #include <map>
@@ -98,6 +100,7 @@ public:
   void read_settings();
   void write_settings();
   void set_frame_warning(bool Estate);
+  void show_message(std::string Text);
   void set_tab(int Pos){Tab_widget->setCurrentIndex(Pos);};
 
   void add_filter(int Filter_pos);
@@ -115,6 +118,8 @@ private slots:
   void new_effect_slot();
   void open_effect_file_slot();
   void save_effect_file_slot();
+  void preview_resolution_slot(QAction *Action);
+  void full_resolution_slot();
 
   void tabbar_clicked_slot(int Index1);
   void filter_selected_slot(QTreeWidgetItem * item, int column);
@@ -154,6 +159,8 @@ private:
 
   QAction *Save_svg_file;
 
+  QAction *Full_resolution;
+
   int Previous_tab=0;
 
   _f_filter_ns::_filter_parameters Filter_parameters;
@@ -87,6 +87,9 @@ HEADERS+= \
     src/vertex.h \
     src/graphics_scene.h \
     src/image_IO.h \
+    src/binary_image.h \
+    src/vector_writer.h \
+    src/plotter_writer.h \
     src/random.h \
     src/images_tab.h \
     src/tree_widget_item.h \
@@ -103,10 +106,24 @@ HEADERS+= \
     src/nodes_editor.h \
     src/graphics_view.h \
     src/shaders.h \
-    src/filter.h
+    src/filter.h \
+    src/thread_pool.h \
+    src/scheduler.h \
+    src/result_cache.h \
+    src/buffer_pool.h \
+    src/conversion_cache.h \
+    src/point_set.h \
+    src/dots_cache.h \
+    src/tiler.h \
+    src/task_control.h \
+    src/trace.h \
+    src/trace_tab.h
 
 SOURCES+= \
     src/image_IO.cc \
+    src/binary_image.cc \
+    src/vector_writer.cc \
+    src/plotter_writer.cc \
     src/random.cc \
     src/tree_widget.cc \
     src/images_tab.cc \
@@ -121,6 +138,15 @@ SOURCES+= \
     src/nodes_editor.cc \
     src/graphics_view.cc \
     src/shaders.cc \
+    src/thread_pool.cc \
+    src/scheduler.cc \
+    src/result_cache.cc \
+    src/buffer_pool.cc \
+    src/conversion_cache.cc \
+    src/dots_cache.cc \
+    src/tiler.cc \
+    src/trace.cc \
+    src/trace_tab.cc \
     src/main.cc
 
 
@@ -232,6 +258,10 @@ LIBS += \
     -L/home/dmartin/codigo/funciontecas/opencv-4.6.0/lib -lopencv_core -lopencv_highgui \
     -lopencv_imgproc -lopencv_imgcodecs \
     -lGL
+
+# the dots are saved as SVGZ and compressed PDF with zlib
+DEFINES+=DEFINE_IO_ZLIB
+LIBS += -lz
 }
 
 DESTDIR=.